@@ -0,0 +1,61 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+
+#include "tcc/metrics.hpp"
+#include "tcc/numa.hpp"
+#include "tcc/simd.hpp"
+#include "tcc/startup.hpp"
+#include "tcc/thread_pool.hpp"
+#include "tcc/version.hpp"
+
+namespace {
+
+// TCC_STARTUP_PROFILE=1: build every lazy singleton once so each shows up
+// as a phase, then write the trace (TCC_STARTUP_PROFILE_PATH, default
+// startup_trace.json) and a summary on stderr. A normal run builds none.
+int write_startup_profile() {
+  {
+    tcc::startup::Phase phase("components");
+    static_cast<void>(tcc::simd::active_isa());
+    static_cast<void>(tcc::numa::topology());
+    static_cast<void>(tcc::metrics::Registry::global());
+    static_cast<void>(tcc::ThreadPool::global());
+  }
+  const char* path = std::getenv("TCC_STARTUP_PROFILE_PATH");
+  if (path == nullptr || *path == '\0') path = "startup_trace.json";
+  try {
+    tcc::startup::write_trace(path);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "test_cmake_cpp: startup profile: %s\n", e.what());
+    return 1;
+  }
+  std::fprintf(stderr, "startup profile -> %s\n", path);
+  for (const tcc::startup::PhaseTiming& p : tcc::startup::phases()) {
+    std::fprintf(stderr, "  %10.3f ms  %s\n", static_cast<double>(p.duration.count()) / 1e6, p.name.c_str());
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  tcc::startup::main_entered();
+  int status = 0;
+  bool printed = false;
+  for (int i = 1; i < argc && !printed; ++i) {
+    if (std::strcmp(argv[i], "--version") == 0) {
+      std::printf("test_cmake_cpp %.*s (%.*s)\n",
+                  static_cast<int>(tcc::version().size()), tcc::version().data(),
+                  static_cast<int>(tcc::build_info().size()), tcc::build_info().data());
+      printed = true;
+    }
+  }
+  if (!printed) {
+    std::printf("test_cmake_cpp %.*s\n", static_cast<int>(tcc::version().size()),
+                tcc::version().data());
+  }
+  if (tcc::startup::enabled()) status = write_startup_profile();
+  return status;
+}
@@ -0,0 +1,115 @@
+// Request-scoped allocation: N small objects that all die together, served
+// by new/delete, std::pmr::monotonic_buffer_resource and tcc::Arena.
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/arena.hpp"
+
+namespace {
+
+struct Node {
+  long long key;
+  long long value;
+  Node* next;
+  int flags;
+};
+
+void BM_AllocNewDelete(tcc::bench::State& state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  std::vector<Node*> nodes(n);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < n; ++i) nodes[i] = new Node{static_cast<long long>(i), 0, nullptr, 0};
+    tcc::bench::DoNotOptimize(nodes.data());
+    for (Node* node : nodes) delete node;
+  }
+  state.set_items_processed(state.iterations() * state.range(0));
+}
+TCC_BENCHMARK(BM_AllocNewDelete)->range(64, 4096, 8);
+
+void BM_AllocPmrMonotonic(tcc::bench::State& state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  std::vector<Node*> nodes(n);
+  for (auto _ : state) {
+    std::pmr::monotonic_buffer_resource resource;
+    for (std::size_t i = 0; i < n; ++i) {
+      nodes[i] = ::new (resource.allocate(sizeof(Node), alignof(Node))) Node{static_cast<long long>(i), 0, nullptr, 0};
+    }
+    tcc::bench::DoNotOptimize(nodes.data());
+  }
+  state.set_items_processed(state.iterations() * state.range(0));
+}
+TCC_BENCHMARK(BM_AllocPmrMonotonic)->range(64, 4096, 8);
+
+void BM_AllocArena(tcc::bench::State& state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  std::vector<Node*> nodes(n);
+  tcc::Arena arena;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < n; ++i) nodes[i] = arena.create<Node>(static_cast<long long>(i), 0LL, nullptr, 0);
+    tcc::bench::DoNotOptimize(nodes.data());
+    arena.reset();
+  }
+  state.set_items_processed(state.iterations() * state.range(0));
+}
+TCC_BENCHMARK(BM_AllocArena)->range(64, 4096, 8);
+
+void BM_AllocFixedPool(tcc::bench::State& state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  std::vector<Node*> nodes(n);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < n; ++i) nodes[i] = tcc::pool_new<Node>(static_cast<long long>(i), 0LL, nullptr, 0);
+    tcc::bench::DoNotOptimize(nodes.data());
+    for (Node* node : nodes) tcc::pool_delete(node);
+  }
+  state.set_items_processed(state.iterations() * state.range(0));
+}
+TCC_BENCHMARK(BM_AllocFixedPool)->range(64, 4096, 8);
+
+// A realistic request: a vector of short strings built and dropped.
+template <class MakeResource>
+void run_strings(tcc::bench::State& state, MakeResource make) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    auto scope = make();
+    std::pmr::vector<std::pmr::string> names(scope.resource());
+    for (std::size_t i = 0; i < n; ++i) names.emplace_back("request-header-value-that-exceeds-sso");
+    tcc::bench::DoNotOptimize(names.data());
+  }
+  state.set_items_processed(state.iterations() * state.range(0));
+}
+
+struct DefaultScope {
+  std::pmr::memory_resource* resource() { return std::pmr::new_delete_resource(); }
+};
+
+struct MonotonicScope {
+  std::pmr::monotonic_buffer_resource monotonic;
+  std::pmr::memory_resource* resource() { return &monotonic; }
+};
+
+void BM_StringsNewDelete(tcc::bench::State& state) {
+  run_strings(state, [] { return DefaultScope{}; });
+}
+TCC_BENCHMARK(BM_StringsNewDelete)->arg(256);
+
+void BM_StringsPmrMonotonic(tcc::bench::State& state) {
+  run_strings(state, [] { return MonotonicScope{}; });
+}
+TCC_BENCHMARK(BM_StringsPmrMonotonic)->arg(256);
+
+void BM_StringsArena(tcc::bench::State& state) {
+  tcc::Arena arena;
+  struct ArenaScope {
+    tcc::Arena* arena;
+    tcc::ArenaResource adapter{*arena};
+    ~ArenaScope() { arena->reset(); }
+    std::pmr::memory_resource* resource() { return &adapter; }
+  };
+  run_strings(state, [&] { return ArenaScope{&arena}; });
+}
+TCC_BENCHMARK(BM_StringsArena)->arg(256);
+
+}  // namespace
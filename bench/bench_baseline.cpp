@@ -0,0 +1,41 @@
+// Reference points for the harness itself: loop overhead and raw memory
+// bandwidth, useful when judging whether a regression is machine noise.
+
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#include "harness.hpp"
+
+namespace {
+
+void BM_EmptyLoop(tcc::bench::State& state) {
+  for (auto _ : state) {
+    tcc::bench::ClobberMemory();
+  }
+}
+TCC_BENCHMARK(BM_EmptyLoop);
+
+void BM_Memcpy(tcc::bench::State& state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  std::vector<char> src(size, 'x'), dst(size);
+  for (auto _ : state) {
+    std::memcpy(dst.data(), src.data(), size);
+    tcc::bench::ClobberMemory();
+  }
+  state.set_bytes_processed(state.iterations() * state.range(0));
+}
+TCC_BENCHMARK(BM_Memcpy)->range(64, 1 << 22, 64);
+
+void BM_Accumulate(tcc::bench::State& state) {
+  std::vector<int> values(static_cast<std::size_t>(state.range(0)));
+  std::iota(values.begin(), values.end(), 0);
+  for (auto _ : state) {
+    long long sum = std::accumulate(values.begin(), values.end(), 0LL);
+    tcc::bench::DoNotOptimize(sum);
+  }
+  state.set_items_processed(state.iterations() * state.range(0));
+}
+TCC_BENCHMARK(BM_Accumulate)->arg(1 << 16);
+
+}  // namespace
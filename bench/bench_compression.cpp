@@ -0,0 +1,125 @@
+// Block-parallel compression throughput per worker count: CompressStream
+// and DecompressStream over 32 MiB of log-like text (about 4:1 with lz4),
+// and FrameReader random 4 KiB reads that each decode one block. Bytes are
+// raw (uncompressed) bytes, so MB/s compare directly across codecs and
+// thread counts; the single-threaded zstd writer we replace is the zstd
+// row at /1.
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/compression.hpp"
+
+namespace {
+
+constexpr std::size_t kInputBytes = std::size_t{32} << 20;
+constexpr std::size_t kChunk = std::size_t{256} << 10;
+
+const std::vector<std::byte>& input() {
+  static const std::vector<std::byte> data = [] {
+    std::vector<std::byte> out;
+    out.reserve(kInputBytes);
+    std::uint32_t seed = 11;
+    char line[160];
+    while (out.size() < kInputBytes) {
+      seed = seed * 1664525u + 1013904223u;
+      const int n = std::snprintf(line, sizeof line, "2024-05-%02u %02u:%02u:%02u.%06u INFO  svc-%u req=%08x latency_us=%u %s\n",
+                                  seed % 28 + 1, seed >> 8 & 15, seed >> 12 & 63, seed >> 18 & 63, seed & 0xfffff,
+                                  seed >> 28, seed, seed >> 20, (seed & 3) == 0 ? "path=/api/v1/orders" : "ok");
+      for (int i = 0; i < n && out.size() < kInputBytes; ++i) out.push_back(static_cast<std::byte>(line[i]));
+    }
+    return out;
+  }();
+  return data;
+}
+
+std::vector<std::byte> compress_all(tcc::ThreadPool& pool, tcc::Codec codec) {
+  tcc::CompressStream z(pool, tcc::span_source(input()), {.codec = codec});
+  std::vector<std::byte> frame;
+  std::vector<std::byte> buf(kChunk);
+  while (std::size_t n = z.read(buf)) frame.insert(frame.end(), buf.begin(), buf.begin() + static_cast<std::ptrdiff_t>(n));
+  return frame;
+}
+
+// One compressed frame per codec, built on first use.
+const std::vector<std::byte>& shared_frame(tcc::Codec codec) {
+  static std::vector<std::byte> frames[3];
+  auto& frame = frames[static_cast<int>(codec)];
+  if (frame.empty()) {
+    tcc::ThreadPool pool;
+    frame = compress_all(pool, codec);
+  }
+  return frame;
+}
+
+template <tcc::Codec C>
+void compress(tcc::bench::State& state) {
+  tcc::ThreadPool pool(static_cast<std::size_t>(state.range(0)));
+  std::vector<std::byte> buf(kChunk);
+  std::uint64_t compressed = 0;
+  for (auto _ : state) {
+    tcc::CompressStream z(pool, tcc::span_source(input()), {.codec = C});
+    while (z.read(buf) != 0) tcc::bench::ClobberMemory();
+    compressed = z.compressed_bytes();
+  }
+  state.set_bytes_processed(state.iterations() * static_cast<std::int64_t>(kInputBytes));
+  state.counters["ratio"] = static_cast<double>(kInputBytes) / static_cast<double>(compressed);
+}
+
+template <tcc::Codec C>
+void decompress(tcc::bench::State& state) {
+  const std::vector<std::byte>& frame = shared_frame(C);
+  tcc::ThreadPool pool(static_cast<std::size_t>(state.range(0)));
+  std::vector<std::byte> buf(kChunk);
+  for (auto _ : state) {
+    tcc::DecompressStream d(pool, tcc::span_source(frame));
+    while (d.read(buf) != 0) tcc::bench::ClobberMemory();
+  }
+  state.set_bytes_processed(state.iterations() * static_cast<std::int64_t>(kInputBytes));
+}
+
+// Seekable access: each 4 KiB read decodes the one 1 MiB block holding it.
+template <tcc::Codec C>
+void random_read(tcc::bench::State& state) {
+  const tcc::FrameReader reader(shared_frame(C));
+  std::vector<std::byte> out(4096);
+  std::uint64_t x = 0x2545f4914f6cdd1dull;
+  for (auto _ : state) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    reader.read(x % (reader.size() - out.size()), out);
+    tcc::bench::DoNotOptimize(out.data());
+  }
+  state.set_items_processed(state.iterations());
+  state.set_bytes_processed(state.iterations() * static_cast<std::int64_t>(out.size()));
+}
+
+const bool compression_registered = [] {
+  struct Case {
+    const char* name;
+    tcc::Codec codec;
+    void (*compress)(tcc::bench::State&);
+    void (*decompress)(tcc::bench::State&);
+    void (*random_read)(tcc::bench::State&);
+  };
+  const Case cases[] = {
+      {"Lz4", tcc::Codec::lz4, compress<tcc::Codec::lz4>, decompress<tcc::Codec::lz4>,
+       random_read<tcc::Codec::lz4>},
+      {"Zstd", tcc::Codec::zstd, compress<tcc::Codec::zstd>, decompress<tcc::Codec::zstd>,
+       random_read<tcc::Codec::zstd>},
+  };
+  for (const Case& c : cases) {
+    if (!tcc::codec_available(c.codec)) continue;
+    const std::string suffix = c.name;
+    tcc::bench::register_benchmark("BM_Compress" + suffix, c.compress)->arg(1)->arg(2)->arg(4)->arg(8);
+    tcc::bench::register_benchmark("BM_Decompress" + suffix, c.decompress)->arg(1)->arg(2)->arg(4)->arg(8);
+    tcc::bench::register_benchmark("BM_FrameRandomRead" + suffix, c.random_read);
+  }
+  return true;
+}();
+
+}  // namespace
@@ -0,0 +1,104 @@
+// Read-mostly cache traffic (95% get, 5% put, Zipf-like keys) from 1..16
+// threads: tcc::ConcurrentCache against the mutex-guarded std::list +
+// std::unordered_map LRU it replaces. Both hold 16K entries out of a 64K
+// key space. Every thread runs the same operation count, so items/s shows
+// how throughput scales with readers.
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/concurrent_cache.hpp"
+
+namespace {
+
+constexpr std::size_t kCapacity = 1 << 14;
+constexpr std::uint64_t kKeys = 1 << 16;
+constexpr int kOpsPerThread = 1 << 15;
+
+class MutexLru {
+ public:
+  std::optional<std::uint64_t> get(std::uint64_t key) {
+    std::lock_guard lock(mutex_);
+    const auto it = index_.find(key);
+    if (it == index_.end()) return std::nullopt;
+    order_.splice(order_.begin(), order_, it->second);
+    return it->second->second;
+  }
+
+  void put(std::uint64_t key, std::uint64_t value) {
+    std::lock_guard lock(mutex_);
+    if (const auto it = index_.find(key); it != index_.end()) {
+      it->second->second = value;
+      order_.splice(order_.begin(), order_, it->second);
+      return;
+    }
+    if (index_.size() == kCapacity) {
+      index_.erase(order_.back().first);
+      order_.pop_back();
+    }
+    order_.emplace_front(key, value);
+    index_.emplace(key, order_.begin());
+  }
+
+ private:
+  std::mutex mutex_;
+  std::list<std::pair<std::uint64_t, std::uint64_t>> order_;
+  std::unordered_map<std::uint64_t, std::list<std::pair<std::uint64_t, std::uint64_t>>::iterator> index_;
+};
+
+// Squaring a uniform draw skews it towards small keys, roughly Zipf-like.
+template <class Cache>
+std::uint64_t traffic(Cache& cache, std::uint64_t seed) {
+  std::uint64_t x = seed * 0x9e3779b97f4a7c15ull + 1, hits = 0;
+  for (int i = 0; i < kOpsPerThread; ++i) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    const std::uint64_t u = (x >> 40) % kKeys;
+    const std::uint64_t key = u * u / kKeys;
+    if (i % 20 == 0) {
+      cache.put(key, key);
+    } else {
+      hits += cache.get(key).has_value();
+    }
+  }
+  return hits;
+}
+
+template <class Cache>
+void run_threads(tcc::bench::State& state, Cache& cache) {
+  const auto threads = static_cast<std::size_t>(state.range(0));
+  for (std::uint64_t k = 0; k < kKeys; k += 4) cache.put(k * k / kKeys, k);
+  std::uint64_t hits = 0;
+  for (auto _ : state) {
+    std::vector<std::uint64_t> per(threads);
+    std::vector<std::thread> pool;
+    for (std::size_t t = 0; t < threads; ++t) pool.emplace_back([&, t] { per[t] = traffic(cache, t + 1); });
+    for (auto& th : pool) th.join();
+    for (auto h : per) hits += h;
+  }
+  tcc::bench::DoNotOptimize(hits);
+  state.set_items_processed(state.iterations() * static_cast<std::int64_t>(threads * kOpsPerThread));
+}
+
+void BM_CacheMutexLru(tcc::bench::State& state) {
+  MutexLru cache;
+  run_threads(state, cache);
+}
+TCC_BENCHMARK(BM_CacheMutexLru)->range(1, 16, 2);
+
+void BM_CacheConcurrent(tcc::bench::State& state) {
+  tcc::ConcurrentCache<std::uint64_t, std::uint64_t> cache({.capacity = kCapacity});
+  run_threads(state, cache);
+  const auto s = cache.stats();
+  state.counters["hit_rate"] = static_cast<double>(s.hits) / static_cast<double>(s.hits + s.misses);
+}
+TCC_BENCHMARK(BM_CacheConcurrent)->range(1, 16, 2);
+
+}  // namespace
@@ -0,0 +1,108 @@
+// Cost of the coroutine layer: co_await of a fresh leaf Task (frame
+// allocation, symmetric transfer in and out), generator iteration, a hop
+// onto the pool per co_await, and the frame allocator against plain
+// operator new. Per-await numbers are items/s; the target is < 20 ns.
+
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/coro.hpp"
+
+namespace {
+
+constexpr int kAwaits = 1024;
+
+tcc::Task<std::int64_t> leaf(int x) { co_return x + 1; }
+
+tcc::Task<std::int64_t> await_loop(int n) {
+  std::int64_t sum = 0;
+  for (int i = 0; i < n; ++i) sum += co_await leaf(i);
+  co_return sum;
+}
+
+void BM_CoAwaitTask(tcc::bench::State& state) {
+  for (auto _ : state) {
+    std::int64_t sum = tcc::sync_wait(await_loop(kAwaits));
+    tcc::bench::DoNotOptimize(sum);
+  }
+  state.set_items_processed(state.iterations() * kAwaits);
+}
+TCC_BENCHMARK(BM_CoAwaitTask);
+
+// Depth-d chain: every level is a frame plus two transfers.
+tcc::Task<std::int64_t> chain(int depth) {
+  if (depth == 0) co_return 1;
+  co_return 1 + co_await chain(depth - 1);
+}
+
+void BM_CoAwaitChain(tcc::bench::State& state) {
+  const auto depth = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    std::int64_t n = tcc::sync_wait(chain(depth));
+    tcc::bench::DoNotOptimize(n);
+  }
+  state.set_items_processed(state.iterations() * state.range(0));
+}
+TCC_BENCHMARK(BM_CoAwaitChain)->arg(16)->arg(1024);
+
+tcc::Generator<std::int64_t> iota(std::int64_t n) {
+  for (std::int64_t i = 0; i < n; ++i) co_yield i;
+}
+
+void BM_GeneratorSum(tcc::bench::State& state) {
+  for (auto _ : state) {
+    std::int64_t sum = 0;
+    for (std::int64_t v : iota(kAwaits)) sum += v;
+    tcc::bench::DoNotOptimize(sum);
+  }
+  state.set_items_processed(state.iterations() * kAwaits);
+}
+TCC_BENCHMARK(BM_GeneratorSum);
+
+tcc::Task<int> hop_loop(tcc::ThreadPool& pool, int n) {
+  for (int i = 0; i < n; ++i) co_await tcc::schedule(pool);
+  co_return n;
+}
+
+void BM_CoSchedule(tcc::bench::State& state) {
+  tcc::ThreadPool pool(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    int n = tcc::sync_wait(hop_loop(pool, kAwaits));
+    tcc::bench::DoNotOptimize(n);
+  }
+  state.set_items_processed(state.iterations() * kAwaits);
+}
+TCC_BENCHMARK(BM_CoSchedule)->arg(1)->arg(4);
+
+// Allocate a batch of frame-sized blocks and free them in order, as a burst
+// of short-lived coroutines would.
+template <bool Recycled>
+void frame_churn(tcc::bench::State& state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  std::vector<void*> frames(64);
+  for (auto _ : state) {
+    for (void*& f : frames) {
+      f = Recycled ? tcc::detail::frame_allocate(size) : ::operator new(size);
+      tcc::bench::DoNotOptimize(f);
+    }
+    for (void* f : frames) {
+      if constexpr (Recycled) {
+        tcc::detail::frame_deallocate(f, size);
+      } else {
+        ::operator delete(f, size);
+      }
+    }
+    tcc::bench::ClobberMemory();
+  }
+  state.set_items_processed(state.iterations() * static_cast<std::int64_t>(frames.size()));
+}
+
+void BM_FrameAllocRecycled(tcc::bench::State& state) { frame_churn<true>(state); }
+TCC_BENCHMARK(BM_FrameAllocRecycled)->arg(96)->arg(512);
+
+void BM_FrameAllocNew(tcc::bench::State& state) { frame_churn<false>(state); }
+TCC_BENCHMARK(BM_FrameAllocNew)->arg(96)->arg(512);
+
+}  // namespace
@@ -0,0 +1,76 @@
+// Sorting 64-bit keys: std::sort against tcc::radix_sort, sequential and on
+// the ThreadPool, then tcc::external_sort end to end with a run size that
+// forces spilling and a multi-way merge (64 MiB of records in 8 MiB runs).
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/external_sort.hpp"
+#include "tcc/thread_pool.hpp"
+
+namespace {
+
+std::vector<std::uint64_t> random_keys(std::size_t n) {
+  std::mt19937_64 rng(1234);
+  std::vector<std::uint64_t> keys(n);
+  for (auto& k : keys) k = rng();
+  return keys;
+}
+
+void BM_SortStd(tcc::bench::State& state) {
+  const auto input = random_keys(static_cast<std::size_t>(state.range(0)));
+  std::vector<std::uint64_t> keys;
+  for (auto _ : state) {
+    keys = input;
+    std::sort(keys.begin(), keys.end());
+    tcc::bench::DoNotOptimize(keys.data());
+  }
+  state.set_items_processed(state.iterations() * state.range(0));
+}
+TCC_BENCHMARK(BM_SortStd)->range(1 << 12, 1 << 22, 32);
+
+void BM_SortRadix(tcc::bench::State& state) {
+  const auto input = random_keys(static_cast<std::size_t>(state.range(0)));
+  std::vector<std::uint64_t> keys;
+  for (auto _ : state) {
+    keys = input;
+    tcc::radix_sort(std::span(keys));
+    tcc::bench::DoNotOptimize(keys.data());
+  }
+  state.set_items_processed(state.iterations() * state.range(0));
+}
+TCC_BENCHMARK(BM_SortRadix)->range(1 << 12, 1 << 22, 32);
+
+void BM_SortRadixParallel(tcc::bench::State& state) {
+  const auto input = random_keys(static_cast<std::size_t>(state.range(0)));
+  std::vector<std::uint64_t> keys, scratch(input.size());
+  tcc::ThreadPool& pool = tcc::ThreadPool::global();
+  for (auto _ : state) {
+    keys = input;
+    tcc::radix_sort(pool, std::span(keys), std::span(scratch));
+    tcc::bench::DoNotOptimize(keys.data());
+  }
+  state.set_items_processed(state.iterations() * state.range(0));
+  state.counters["threads"] = static_cast<double>(pool.size());
+}
+TCC_BENCHMARK(BM_SortRadixParallel)->range(1 << 12, 1 << 22, 32);
+
+void BM_ExternalSort(tcc::bench::State& state) {
+  const auto input = random_keys(std::size_t{8} << 20);
+  const auto output = std::filesystem::temp_directory_path() / "tcc_bench_sorted.bin";
+  tcc::ExternalSortStats stats;
+  for (auto _ : state) {
+    stats = tcc::external_sort<std::uint64_t>(std::span(input), output, {.run_bytes = std::size_t{8} << 20});
+  }
+  std::filesystem::remove(output);
+  state.set_bytes_processed(state.iterations() * static_cast<std::int64_t>(input.size() * sizeof(input[0])));
+  state.counters["runs"] = static_cast<double>(stats.runs);
+}
+TCC_BENCHMARK(BM_ExternalSort);
+
+}  // namespace
@@ -0,0 +1,145 @@
+// tcc::FlatHashMap against std::unordered_map on 64-bit keys: insertion
+// with and without reserve(), successful and failed lookups, and erasure,
+// at 1K keys (cache-resident), 1M keys (L2/L3 spill) and, with
+// TCC_BENCH_LARGE, 100M keys (DRAM-bound; ~3 GiB, FlatHashMap only).
+// Lookups visit keys in pseudo-random order in batches of kBatch.
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+#include "harness.hpp"
+#include "tcc/flat_hash_map.hpp"
+
+namespace {
+
+using Flat = tcc::FlatHashMap<std::uint64_t, std::uint64_t>;
+using Std = std::unordered_map<std::uint64_t, std::uint64_t>;
+
+constexpr std::int64_t kBatch = 1024;
+
+// Distinct keys for i < 2^64 (odd multiplier), spread over the whole range.
+constexpr std::uint64_t key(std::uint64_t i) noexcept { return i * 0x9e3779b97f4a7c15ull + 1; }
+
+// Key indices in pseudo-random order without a stored permutation.
+class IndexStream {
+ public:
+  explicit IndexStream(std::uint64_t n) noexcept : n_(n) {}
+  std::uint64_t next() noexcept {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 7;
+    state_ ^= state_ << 17;
+    return state_ % n_;
+  }
+
+ private:
+  std::uint64_t n_;
+  std::uint64_t state_ = 0x2545f4914f6cdd1dull;
+};
+
+template <class Map>
+void fill(Map& map, std::uint64_t n) {
+  for (std::uint64_t i = 0; i < n; ++i) map.emplace(key(i), i);
+}
+
+// One prebuilt table per map type, rebuilt when the size changes, so the
+// lookup benchmarks do not pay for construction on every sample and at
+// most one large table is alive at a time.
+template <class Map>
+Map& shared_table(std::uint64_t n) {
+  static std::unique_ptr<Map> table;
+  static std::uint64_t size = 0;
+  if (!table || size != n) {
+    table.reset();
+    table = std::make_unique<Map>();
+    table->reserve(n);
+    fill(*table, n);
+    size = n;
+  }
+  return *table;
+}
+
+template <class Map, bool Reserve>
+void insert(tcc::bench::State& state) {
+  const auto n = static_cast<std::uint64_t>(state.range(0));
+  for (auto _ : state) {
+    Map map;
+    if constexpr (Reserve) map.reserve(n);
+    fill(map, n);
+    tcc::bench::DoNotOptimize(map.size());
+    state.pause_timing();
+    {
+      Map dying(std::move(map));  // destruction is not part of insertion
+    }
+    state.resume_timing();
+  }
+  state.set_items_processed(state.iterations() * state.range(0));
+}
+
+template <class Map, bool Hit>
+void find(tcc::bench::State& state) {
+  const auto n = static_cast<std::uint64_t>(state.range(0));
+  const Map& map = shared_table<Map>(n);
+  IndexStream indices(n);
+  for (auto _ : state) {
+    std::uint64_t found = 0;
+    for (std::int64_t i = 0; i < kBatch; ++i) {
+      // Indices >= n are never inserted, so `n + index` always misses.
+      const std::uint64_t k = key(Hit ? indices.next() : n + indices.next());
+      found += map.find(k) != map.end();
+    }
+    tcc::bench::DoNotOptimize(found);
+  }
+  state.set_items_processed(state.iterations() * kBatch);
+}
+
+template <class Map>
+void erase(tcc::bench::State& state) {
+  const auto n = static_cast<std::uint64_t>(state.range(0));
+  Map& map = shared_table<Map>(n);
+  IndexStream indices(n);
+  std::uint64_t erased[kBatch];
+  for (auto _ : state) {
+    std::int64_t count = 0;
+    for (std::int64_t i = 0; i < kBatch; ++i) {
+      const std::uint64_t index = indices.next();
+      if (map.erase(key(index))) erased[count++] = index;
+    }
+    state.pause_timing();
+    for (std::int64_t i = 0; i < count; ++i) map.emplace(key(erased[i]), erased[i]);
+    state.resume_timing();
+  }
+  state.set_items_processed(state.iterations() * kBatch);
+}
+
+const bool registered = [] {
+  struct Case {
+    const char* name;
+    void (*fn)(tcc::bench::State&);
+    bool large;  // also worth running at 100M keys
+  };
+  const Case cases[] = {
+      {"BM_FlatMapInsert", insert<Flat, false>, true},
+      {"BM_FlatMapInsertReserved", insert<Flat, true>, true},
+      {"BM_FlatMapFindHit", find<Flat, true>, true},
+      {"BM_FlatMapFindMiss", find<Flat, false>, true},
+      {"BM_FlatMapErase", erase<Flat>, true},
+      {"BM_StdUnorderedMapInsert", insert<Std, false>, false},
+      {"BM_StdUnorderedMapInsertReserved", insert<Std, true>, false},
+      {"BM_StdUnorderedMapFindHit", find<Std, true>, false},
+      {"BM_StdUnorderedMapFindMiss", find<Std, false>, false},
+      {"BM_StdUnorderedMapErase", erase<Std>, false},
+  };
+  for (const Case& c : cases) {
+    auto* bench = tcc::bench::register_benchmark(c.name, c.fn)->arg(1'000)->arg(1'000'000);
+#if defined(TCC_BENCH_LARGE)
+    if (c.large) bench->arg(100'000'000);
+#else
+    (void)bench;
+#endif
+  }
+  return true;
+}();
+
+}  // namespace
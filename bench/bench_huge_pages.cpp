@@ -0,0 +1,46 @@
+// Random 8-byte reads over a 256 MiB table, far beyond what the dTLB maps
+// with 4 KiB pages: tcc::HugePageResource with small pages, transparent
+// huge pages and hugetlb pages (arg 0/1/2). Tables are pre-faulted so that
+// page faults stay out of the loop. The TLB-entries counter is the page
+// walk footprint reported by tcc::page_backing. Unavailable tiers fall back
+// and then show the numbers of the tier that served them.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "harness.hpp"
+#include "tcc/huge_pages.hpp"
+
+namespace {
+
+constexpr std::size_t kTableBytes = std::size_t{256} << 20;
+constexpr std::size_t kReads = 1 << 20;
+
+void BM_RandomReadPages(tcc::bench::State& state) {
+  constexpr tcc::PagePolicy kPolicy[] = {tcc::PagePolicy::small, tcc::PagePolicy::transparent,
+                                         tcc::PagePolicy::hugetlb};
+  tcc::HugePageResource resource({.policy = kPolicy[state.range(0)], .prefault = true});
+  auto* table = static_cast<std::uint64_t*>(resource.allocate(kTableBytes));
+  constexpr std::size_t kWords = kTableBytes / sizeof(std::uint64_t);
+  for (std::size_t i = 0; i < kWords; i += 512) table[i] = i;
+  for (auto _ : state) {
+    std::uint64_t x = 88172645463325252ull, sum = 0;
+    for (std::size_t i = 0; i < kReads; ++i) {
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      sum += table[x % kWords];
+    }
+    tcc::bench::DoNotOptimize(sum);
+  }
+  state.set_items_processed(state.iterations() * static_cast<std::int64_t>(kReads));
+  const tcc::PageBacking backing = tcc::page_backing({reinterpret_cast<std::byte*>(table), kTableBytes});
+  state.counters["tlb_entries"] = static_cast<double>(backing.tlb_entries());
+  state.counters["huge_fraction"] =
+      backing.resident == 0 ? 0.0 : static_cast<double>(backing.huge) / static_cast<double>(backing.resident);
+  resource.deallocate(table, kTableBytes);
+}
+TCC_BENCHMARK(BM_RandomReadPages)->arg(0)->arg(1)->arg(2);
+
+}  // namespace
@@ -0,0 +1,131 @@
+// Per-request cost of 4 KiB reads from a page-cached file: one pread per
+// request against tcc::io::Ring batches of 1..64 on each backend. The Ring
+// numbers include the hop of every callback onto the pool, as a real
+// completion would.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "harness.hpp"
+#include "tcc/io_ring.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr std::size_t kBlock = 4096;
+constexpr std::size_t kBlocks = 256;
+
+class DataFile {
+ public:
+  DataFile() : path_(fs::temp_directory_path() / "tcc_bench_io.bin") {
+    std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+    std::vector<char> block(kBlock, 'x');
+    for (std::size_t i = 0; i < kBlocks; ++i) out.write(block.data(), static_cast<std::streamsize>(kBlock));
+    out.close();
+    fd_ = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+  }
+  ~DataFile() {
+    if (fd_ >= 0) ::close(fd_);
+    std::error_code ec;
+    fs::remove(path_, ec);
+  }
+
+  int fd() const noexcept { return fd_; }
+
+ private:
+  fs::path path_;
+  int fd_ = -1;
+};
+
+const DataFile& data_file() {
+  static DataFile file;
+  return file;
+}
+
+std::uint64_t block_offset(std::size_t i) { return (i * 97 % kBlocks) * kBlock; }
+
+void BM_IoPread(tcc::bench::State& state) {
+  const int fd = data_file().fd();
+  const auto batch = static_cast<std::size_t>(state.range(0));
+  std::vector<std::byte> buffer(kBlock * batch);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < batch; ++i) {
+      ssize_t n = ::pread(fd, buffer.data() + i * kBlock, kBlock, static_cast<off_t>(block_offset(i)));
+      tcc::bench::DoNotOptimize(n);
+    }
+  }
+  state.set_items_processed(state.iterations() * state.range(0));
+}
+TCC_BENCHMARK(BM_IoPread)->arg(1)->arg(16)->arg(64);
+
+// Waits for one batch of callbacks without touching the Ring's own drain().
+struct Countdown {
+  std::atomic<std::size_t> remaining{0};
+
+  void arm(std::size_t n) { remaining.store(n, std::memory_order_relaxed); }
+  void done() {
+    if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) remaining.notify_one();
+  }
+  void wait() {
+    for (std::size_t n = remaining.load(std::memory_order_acquire); n != 0;
+         n = remaining.load(std::memory_order_acquire)) {
+      remaining.wait(n, std::memory_order_acquire);
+    }
+  }
+};
+
+void ring_read(tcc::bench::State& state, tcc::io::Ring& ring, bool fixed) {
+  const int fd = data_file().fd();
+  const auto batch = static_cast<std::size_t>(state.range(0));
+  std::vector<std::byte> buffer(kBlock * batch);
+  if (fixed) {
+    const std::span<std::byte> whole(buffer);
+    ring.register_buffers({&whole, 1});
+  }
+  Countdown countdown;
+  const auto on_done = [&countdown](int) { countdown.done(); };
+  for (auto _ : state) {
+    countdown.arm(batch);
+    for (std::size_t i = 0; i < batch; ++i) {
+      const std::span<std::byte> slot(buffer.data() + i * kBlock, kBlock);
+      if (fixed) {
+        ring.read_fixed(fd, 0, slot, block_offset(i), on_done);
+      } else {
+        ring.read(fd, slot, block_offset(i), on_done);
+      }
+    }
+    ring.submit();
+    countdown.wait();
+  }
+  state.set_items_processed(state.iterations() * state.range(0));
+}
+
+const bool io_registered = [] {
+  for (bool fallback : {false, true}) {
+    if (!fallback && !tcc::io::io_uring_supported()) continue;
+    tcc::io::RingOptions options;
+    options.force_fallback = fallback;
+    const auto kind = fallback ? tcc::io::BackendKind::fallback : tcc::io::BackendKind::io_uring;
+    for (bool fixed : {false, true}) {
+      std::string name = fixed ? "BM_IoRingReadFixed" : "BM_IoRingRead";
+      name.append("_").append(tcc::io::backend_name(kind));
+      tcc::bench::register_benchmark(std::move(name), [options, fixed](tcc::bench::State& state) {
+        tcc::io::Ring ring(options);
+        ring_read(state, ring, fixed);
+      })->arg(1)->arg(16)->arg(64);
+    }
+  }
+  return true;
+}();
+
+}  // namespace
@@ -0,0 +1,120 @@
+// Scanning a text file line by line: tcc::MappedFile + tcc::lines() against
+// fread into a fixed buffer and std::ifstream + std::getline. Every variant
+// opens the file, visits each line and sums line lengths, so the work per
+// iteration is the same; the file stays in the page cache between runs.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/mapped_file.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// Log-like lines of 40..119 bytes. Created on first use, removed at exit.
+class LineFile {
+ public:
+  explicit LineFile(std::size_t bytes)
+      : path_(fs::temp_directory_path() / ("tcc_bench_lines_" + std::to_string(bytes) + ".txt")) {
+    std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+    std::uint32_t seed = 7;
+    std::string line;
+    std::size_t written = 0;
+    while (written < bytes) {
+      seed = seed * 1664525u + 1013904223u;
+      line.assign(40 + (seed >> 8) % 80, 'a' + static_cast<char>(seed % 26));
+      line.back() = '\n';
+      out.write(line.data(), static_cast<std::streamsize>(line.size()));
+      written += line.size();
+    }
+    size_ = written;
+  }
+  ~LineFile() {
+    std::error_code ec;
+    fs::remove(path_, ec);
+  }
+
+  const fs::path& path() const noexcept { return path_; }
+  std::size_t size() const noexcept { return size_; }
+
+ private:
+  fs::path path_;
+  std::size_t size_ = 0;
+};
+
+const LineFile& line_file(std::int64_t bytes) {
+  static std::map<std::int64_t, LineFile> files;
+  auto it = files.find(bytes);
+  if (it == files.end()) it = files.try_emplace(bytes, static_cast<std::size_t>(bytes)).first;
+  return it->second;
+}
+
+constexpr std::int64_t kSmallFile = 1 << 20;
+constexpr std::int64_t kLargeFile = 64 << 20;
+
+void BM_ReadLinesMapped(tcc::bench::State& state) {
+  const LineFile& file = line_file(state.range(0));
+  for (auto _ : state) {
+    tcc::MappedFile mapped(file.path(), tcc::Advice::sequential | tcc::Advice::willneed);
+    std::size_t total = 0;
+    for (std::string_view line : tcc::lines(mapped)) total += line.size();
+    tcc::bench::DoNotOptimize(total);
+  }
+  state.set_bytes_processed(state.iterations() * static_cast<std::int64_t>(file.size()));
+}
+TCC_BENCHMARK(BM_ReadLinesMapped)->arg(kSmallFile)->arg(kLargeFile);
+
+// fread into a reusable buffer; lines straddling a refill are carried over,
+// which is the best a copying reader can do.
+void BM_ReadLinesFread(tcc::bench::State& state) {
+  const LineFile& file = line_file(state.range(0));
+  std::vector<char> buffer(1 << 16);
+  for (auto _ : state) {
+    std::FILE* f = std::fopen(file.path().string().c_str(), "rb");
+    std::size_t total = 0;
+    std::size_t carry = 0;
+    for (;;) {
+      const std::size_t got = std::fread(buffer.data() + carry, 1, buffer.size() - carry, f);
+      const std::size_t filled = carry + got;
+      std::size_t start = 0;
+      while (const void* nl = std::memchr(buffer.data() + start, '\n', filled - start)) {
+        const auto end = static_cast<std::size_t>(static_cast<const char*>(nl) - buffer.data());
+        total += end - start;
+        start = end + 1;
+      }
+      carry = filled - start;
+      if (got == 0) {
+        total += carry;
+        break;
+      }
+      std::memmove(buffer.data(), buffer.data() + start, carry);
+    }
+    std::fclose(f);
+    tcc::bench::DoNotOptimize(total);
+  }
+  state.set_bytes_processed(state.iterations() * static_cast<std::int64_t>(file.size()));
+}
+TCC_BENCHMARK(BM_ReadLinesFread)->arg(kSmallFile)->arg(kLargeFile);
+
+void BM_ReadLinesIfstream(tcc::bench::State& state) {
+  const LineFile& file = line_file(state.range(0));
+  for (auto _ : state) {
+    std::ifstream in(file.path(), std::ios::binary);
+    std::string line;
+    std::size_t total = 0;
+    while (std::getline(in, line)) total += line.size();
+    tcc::bench::DoNotOptimize(total);
+  }
+  state.set_bytes_processed(state.iterations() * static_cast<std::int64_t>(file.size()));
+}
+TCC_BENCHMARK(BM_ReadLinesIfstream)->arg(kSmallFile)->arg(kLargeFile);
+
+}  // namespace
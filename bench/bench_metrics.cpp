@@ -0,0 +1,102 @@
+// Metric update cost with 1..8 writer threads, each doing kOps increments of
+// one shared metric: the sharded tcc::metrics::Counter against a single
+// std::atomic and against the mutex-wrapped map services usually start
+// with. Items are increments across all threads, so items/s is aggregate
+// throughput. Also histogram record() and a full Prometheus scrape of a
+// registry with 100 counters and 100 histograms.
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/metrics.hpp"
+
+namespace {
+
+constexpr std::int64_t kOps = 1 << 18;
+
+template <class Fn>
+void run_threads(std::int64_t threads, Fn fn) {
+  std::vector<std::thread> workers;
+  workers.reserve(static_cast<std::size_t>(threads));
+  for (std::int64_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&] {
+      for (std::int64_t i = 0; i < kOps; ++i) fn();
+    });
+  }
+  for (auto& w : workers) w.join();
+}
+
+void BM_MetricsCounterSharded(tcc::bench::State& state) {
+  static tcc::metrics::Registry registry;
+  tcc::metrics::Counter& c = registry.counter("bench_sharded_total", "bench");
+  for (auto _ : state) run_threads(state.range(0), [&] { c.inc(); });
+  tcc::bench::DoNotOptimize(c.value());
+  state.set_items_processed(state.iterations() * state.range(0) * kOps);
+}
+TCC_BENCHMARK(BM_MetricsCounterSharded)->arg(1)->arg(2)->arg(4)->arg(8);
+
+void BM_MetricsCounterAtomic(tcc::bench::State& state) {
+  static std::atomic<std::uint64_t> c{0};
+  for (auto _ : state) run_threads(state.range(0), [&] { c.fetch_add(1, std::memory_order_relaxed); });
+  state.set_items_processed(state.iterations() * state.range(0) * kOps);
+}
+TCC_BENCHMARK(BM_MetricsCounterAtomic)->arg(1)->arg(2)->arg(4)->arg(8);
+
+void BM_MetricsCounterMutexMap(tcc::bench::State& state) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::uint64_t> counters;
+  const std::string name = "bench_mutex_total";
+  for (auto _ : state) {
+    run_threads(state.range(0), [&] {
+      std::lock_guard lock(mutex);
+      ++counters[name];
+    });
+  }
+  state.set_items_processed(state.iterations() * state.range(0) * kOps);
+}
+TCC_BENCHMARK(BM_MetricsCounterMutexMap)->arg(1)->arg(2)->arg(4)->arg(8);
+
+void BM_MetricsHistogramRecord(tcc::bench::State& state) {
+  static tcc::metrics::Registry registry;
+  tcc::metrics::Histogram& h = registry.histogram("bench_latency_seconds", "bench");
+  std::uint64_t x = 0x2545f4914f6cdd1dull;
+  for (auto _ : state) {
+    for (std::int64_t i = 0; i < 4096; ++i) {
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      h.record(x >> 40);  // 0 .. 16 ms of nanoseconds
+    }
+  }
+  state.set_items_processed(state.iterations() * 4096);
+}
+TCC_BENCHMARK(BM_MetricsHistogramRecord);
+
+void BM_MetricsScrape(tcc::bench::State& state) {
+  static tcc::metrics::Registry& registry = []() -> tcc::metrics::Registry& {
+    static tcc::metrics::Registry r;
+    for (int i = 0; i < 100; ++i) {
+      const tcc::metrics::Labels labels{{"shard", std::to_string(i)}};
+      r.counter("bench_requests_total", "Requests", labels).inc(static_cast<std::uint64_t>(i));
+      r.histogram("bench_request_duration_seconds", "Latency", labels).record(static_cast<std::uint64_t>(i) * 1000);
+    }
+    return r;
+  }();
+  std::size_t bytes = 0;
+  for (auto _ : state) {
+    const std::string text = registry.prometheus_text();
+    bytes = text.size();
+    tcc::bench::DoNotOptimize(text.data());
+  }
+  state.set_items_processed(state.iterations());
+  state.set_bytes_processed(state.iterations() * static_cast<std::int64_t>(bytes));
+}
+TCC_BENCHMARK(BM_MetricsScrape);
+
+}  // namespace
@@ -0,0 +1,57 @@
+// A three-stage source -> transform -> sink pipeline over 1M rows, by batch
+// size. At batch_rows = 1 every row pays a queue handoff, a virtual step
+// and a stage call, which is the item-at-a-time ETL shape; from a few
+// hundred rows on, the loops inside the stages dominate. Items are rows.
+
+#include <cstddef>
+#include <cstdint>
+
+#include "harness.hpp"
+#include "tcc/pipeline.hpp"
+#include "tcc/thread_pool.hpp"
+
+namespace {
+
+constexpr std::uint32_t kRows = 1 << 20;
+
+template <template <class> class F = tcc::soa::Value>
+struct Reading {
+  F<std::uint32_t> id;
+  F<float> value;
+};
+
+template <template <class> class F = tcc::soa::Value>
+struct Scaled {
+  F<std::uint32_t> id;
+  F<double> value;
+};
+
+void BM_PipelineBatchRows(tcc::bench::State& state) {
+  const auto rows = static_cast<std::size_t>(state.range(0));
+  tcc::ThreadPool pool(2);
+  double checksum = 0;
+  for (auto _ : state) {
+    tcc::Pipeline p({.batch_rows = rows, .queue_batches = 8, .pool = &pool});
+    std::uint32_t next = 0;
+    p.source<Reading>([&](tcc::SoaVector<Reading>& out) {
+       for (std::size_t i = 0; i < rows && next < kRows; ++i, ++next) {
+         out.emplace_back(next, static_cast<float>(next & 1023));
+       }
+       return next < kRows;
+     })
+        .transform<Scaled>([](const tcc::SoaVector<Reading>& in, tcc::SoaVector<Scaled>& out) {
+          const auto ids = in.column<0>();
+          const auto values = in.column<1>();
+          for (std::size_t i = 0; i < in.size(); ++i) out.emplace_back(ids[i], values[i] * 1.5);
+        })
+        .sink([&](const tcc::SoaVector<Scaled>& in) {
+          for (double v : in.column<1>()) checksum += v;
+        });
+    p.run();
+  }
+  tcc::bench::DoNotOptimize(checksum);
+  state.set_items_processed(state.iterations() * kRows);
+}
+TCC_BENCHMARK(BM_PipelineBatchRows)->arg(1)->arg(16)->arg(256)->arg(4096);
+
+}  // namespace
@@ -0,0 +1,173 @@
+// Queue handoff throughput with 1..16 producer/consumer pairs. Every pair
+// moves kMessages integers per iteration; the mutex-guarded std::deque is
+// the baseline the rings replace. Threads are started inside the timed
+// region, which is negligible next to the message volume.
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/mpmc_ring.hpp"
+#include "tcc/platform.hpp"
+#include "tcc/spsc_ring.hpp"
+
+namespace {
+
+constexpr std::size_t kMessages = 1 << 14;
+constexpr std::size_t kRingSize = 1024;
+constexpr std::size_t kRingBatch = 32;
+
+// Spin briefly, then yield so oversubscribed runs still make progress.
+class Backoff {
+ public:
+  void pause() {
+    if (spins_ < 64) {
+      ++spins_;
+      tcc::cpu_relax();
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  void reset() { spins_ = 0; }
+
+ private:
+  int spins_ = 0;
+};
+
+class MutexDeque {
+ public:
+  bool try_push(std::uint64_t v) {
+    std::lock_guard lock(mutex_);
+    items_.push_back(v);
+    return true;
+  }
+  bool try_pop(std::uint64_t& out) {
+    std::lock_guard lock(mutex_);
+    if (items_.empty()) return false;
+    out = items_.front();
+    items_.pop_front();
+    return true;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::deque<std::uint64_t> items_;
+};
+
+template <class Produce, class Consume>
+void run_pairs(tcc::bench::State& state, Produce produce, Consume consume) {
+  const auto pairs = static_cast<std::size_t>(state.range(0));
+  std::uint64_t checksum = 0;
+  for (auto _ : state) {
+    std::vector<std::uint64_t> sums(pairs);
+    std::vector<std::thread> threads;
+    threads.reserve(2 * pairs);
+    for (std::size_t p = 0; p < pairs; ++p) {
+      threads.emplace_back([&, p] { produce(p); });
+      threads.emplace_back([&, p] { sums[p] = consume(p); });
+    }
+    for (auto& t : threads) t.join();
+    for (auto s : sums) checksum += s;
+  }
+  tcc::bench::DoNotOptimize(checksum);
+  state.set_items_processed(state.iterations() * static_cast<std::int64_t>(pairs * kMessages));
+}
+
+template <class Queue>
+void push_all(Queue& q) {
+  Backoff backoff;
+  for (std::uint64_t i = 0; i < kMessages; ++i) {
+    while (!q.try_push(i)) backoff.pause();
+    backoff.reset();
+  }
+}
+
+template <class Queue>
+std::uint64_t pop_all(Queue& q) {
+  Backoff backoff;
+  std::uint64_t sum = 0, v = 0;
+  for (std::size_t n = 0; n < kMessages; ++n) {
+    while (!q.try_pop(v)) backoff.pause();
+    backoff.reset();
+    sum += v;
+  }
+  return sum;
+}
+
+template <class Queue>
+void push_all_batched(Queue& q) {
+  Backoff backoff;
+  std::uint64_t batch[kRingBatch];
+  for (std::uint64_t i = 0; i < kMessages;) {
+    const std::size_t n = std::min<std::size_t>(kRingBatch, kMessages - i);
+    for (std::size_t k = 0; k < n; ++k) batch[k] = i + k;
+    std::size_t done = 0;
+    while (done < n) {
+      const std::size_t pushed = q.try_push_batch(batch + done, n - done);
+      if (pushed == 0) backoff.pause();
+      done += pushed;
+    }
+    backoff.reset();
+    i += n;
+  }
+}
+
+template <class Queue>
+std::uint64_t pop_all_batched(Queue& q) {
+  Backoff backoff;
+  std::uint64_t sum = 0;
+  std::uint64_t batch[kRingBatch];
+  for (std::size_t remaining = kMessages; remaining > 0;) {
+    const std::size_t n = q.try_pop_batch(batch, std::min(kRingBatch, remaining));
+    if (n == 0) {
+      backoff.pause();
+      continue;
+    }
+    backoff.reset();
+    for (std::size_t k = 0; k < n; ++k) sum += batch[k];
+    remaining -= n;
+  }
+  return sum;
+}
+
+void BM_QueueMutexDeque(tcc::bench::State& state) {
+  MutexDeque q;
+  run_pairs(state, [&](std::size_t) { push_all(q); }, [&](std::size_t) { return pop_all(q); });
+}
+TCC_BENCHMARK(BM_QueueMutexDeque)->range(1, 16, 2);
+
+void BM_QueueMpmc(tcc::bench::State& state) {
+  tcc::MpmcRing<std::uint64_t> q(kRingSize);
+  run_pairs(state, [&](std::size_t) { push_all(q); }, [&](std::size_t) { return pop_all(q); });
+}
+TCC_BENCHMARK(BM_QueueMpmc)->range(1, 16, 2);
+
+void BM_QueueMpmcBatch(tcc::bench::State& state) {
+  tcc::MpmcRing<std::uint64_t> q(kRingSize);
+  run_pairs(state, [&](std::size_t) { push_all_batched(q); }, [&](std::size_t) { return pop_all_batched(q); });
+}
+TCC_BENCHMARK(BM_QueueMpmcBatch)->range(1, 16, 2);
+
+// One ring per pair: the SPSC contract, so pairs scale independently.
+void BM_QueueSpsc(tcc::bench::State& state) {
+  using Ring = tcc::SpscRing<std::uint64_t, kRingSize>;
+  std::vector<std::unique_ptr<Ring>> rings;
+  for (std::int64_t p = 0; p < state.range(0); ++p) rings.push_back(std::make_unique<Ring>());
+  run_pairs(state, [&](std::size_t p) { push_all(*rings[p]); }, [&](std::size_t p) { return pop_all(*rings[p]); });
+}
+TCC_BENCHMARK(BM_QueueSpsc)->range(1, 16, 2);
+
+void BM_QueueSpscBatch(tcc::bench::State& state) {
+  using Ring = tcc::SpscRing<std::uint64_t, kRingSize>;
+  std::vector<std::unique_ptr<Ring>> rings;
+  for (std::int64_t p = 0; p < state.range(0); ++p) rings.push_back(std::make_unique<Ring>());
+  run_pairs(state, [&](std::size_t p) { push_all_batched(*rings[p]); },
+            [&](std::size_t p) { return pop_all_batched(*rings[p]); });
+}
+TCC_BENCHMARK(BM_QueueSpscBatch)->range(1, 16, 2);
+
+}  // namespace
@@ -0,0 +1,93 @@
+// Cost of the C++/Rust boundary in tcc::rust. BM_RustFnv1aBorrowed passes
+// the caller's bytes in place. BM_RustFnv1aCopied first copies them into an
+// owned vector, as a std::string/Vec-based binding would, so the gap
+// between the two is the copy the borrowed-slice ABI removes. The split
+// rows compare string_view fields pointing into the input with a
+// std::string per field.
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/rust.hpp"
+
+namespace {
+
+std::vector<std::byte> payload(std::size_t n) {
+  std::vector<std::byte> out(n);
+  for (std::size_t i = 0; i < n; ++i) out[i] = static_cast<std::byte>(i * 131 + 7);
+  return out;
+}
+
+void BM_RustFnv1aBorrowed(tcc::bench::State& state) {
+  const auto bytes = payload(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) tcc::bench::DoNotOptimize(tcc::rust::fnv1a(bytes));
+  state.set_bytes_processed(state.iterations() * state.range(0));
+}
+TCC_BENCHMARK(BM_RustFnv1aBorrowed)->range(64, 1 << 20, 64);
+
+void BM_RustFnv1aCopied(tcc::bench::State& state) {
+  const auto bytes = payload(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    const std::vector<std::byte> owned(bytes);
+    tcc::bench::DoNotOptimize(tcc::rust::fnv1a(owned));
+  }
+  state.set_bytes_processed(state.iterations() * state.range(0));
+}
+TCC_BENCHMARK(BM_RustFnv1aCopied)->range(64, 1 << 20, 64);
+
+const std::string& csv_line() {
+  static const std::string line = [] {
+    std::string out;
+    for (int i = 0; i < 32; ++i) out += "field-" + std::to_string(i * 7919) + ',';
+    out.pop_back();
+    return out;
+  }();
+  return line;
+}
+
+void BM_RustSplitViews(tcc::bench::State& state) {
+  std::vector<std::string_view> fields;
+  fields.reserve(64);
+  for (auto _ : state) {
+    fields.clear();
+    tcc::rust::split(csv_line(), ',', [&](std::string_view f) { fields.push_back(f); });
+    tcc::bench::DoNotOptimize(fields.data());
+  }
+  state.set_items_processed(state.iterations() * 32);
+}
+TCC_BENCHMARK(BM_RustSplitViews);
+
+void BM_RustSplitStrings(tcc::bench::State& state) {
+  std::vector<std::string> fields;
+  fields.reserve(64);
+  for (auto _ : state) {
+    fields.clear();
+    tcc::rust::split(csv_line(), ',', [&](std::string_view f) { fields.emplace_back(f); });
+    tcc::bench::DoNotOptimize(fields.data());
+  }
+  state.set_items_processed(state.iterations() * 32);
+}
+TCC_BENCHMARK(BM_RustSplitStrings);
+
+// Fills a Rust-owned buffer in place, 4 KiB at a time, as a reader would.
+void BM_RustBufferFill(tcc::bench::State& state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const auto chunk = payload(4096);
+  for (auto _ : state) {
+    tcc::rust::Buffer buf = tcc::rust::Buffer::with_capacity(n);
+    while (buf.size() < n) {
+      const std::size_t step = std::min(chunk.size(), n - buf.size());
+      std::memcpy(buf.spare().data(), chunk.data(), step);
+      buf.commit(step);
+    }
+    tcc::bench::DoNotOptimize(buf.data());
+  }
+  state.set_bytes_processed(state.iterations() * state.range(0));
+}
+TCC_BENCHMARK(BM_RustBufferFill)->range(4096, 1 << 22, 32);
+
+}  // namespace
@@ -0,0 +1,125 @@
+// tcc::simd kernels at every ISA level this CPU supports, so one run shows
+// what each level buys. Sizes: 16 KiB of floats (L1/L2 resident) and 16 MiB
+// (memory-bound). Throughput is reported in bytes of input per second.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/simd.hpp"
+
+namespace {
+
+using tcc::simd::Isa;
+using tcc::simd::Kernels;
+
+constexpr std::int64_t kSmall = 1 << 12;
+constexpr std::int64_t kLarge = 1 << 22;
+
+std::vector<float> make_floats(std::size_t n, std::uint32_t seed) {
+  std::vector<float> v(n);
+  for (auto& x : v) {
+    seed = seed * 1664525u + 1013904223u;
+    x = static_cast<float>(seed >> 8) * (1.0f / 16777216.0f) - 0.5f;
+  }
+  return v;
+}
+
+void bytes_done(tcc::bench::State& state, std::size_t bytes_per_iteration) {
+  state.set_bytes_processed(state.iterations() * static_cast<std::int64_t>(bytes_per_iteration));
+}
+
+template <float (*Kernels::*Fn)(const float*, std::size_t)>
+void reduce_bench(tcc::bench::State& state, const Kernels& k) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const std::vector<float> data = make_floats(n, 1);
+  for (auto _ : state) {
+    float r = (k.*Fn)(data.data(), n);
+    tcc::bench::DoNotOptimize(r);
+  }
+  bytes_done(state, n * sizeof(float));
+}
+
+void dot_bench(tcc::bench::State& state, const Kernels& k) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const std::vector<float> a = make_floats(n, 1);
+  const std::vector<float> b = make_floats(n, 2);
+  for (auto _ : state) {
+    float r = k.dot(a.data(), b.data(), n);
+    tcc::bench::DoNotOptimize(r);
+  }
+  bytes_done(state, 2 * n * sizeof(float));
+}
+
+// The needle sits in the last byte, so find scans the whole buffer.
+std::vector<std::byte> make_haystack(std::size_t n) {
+  std::vector<std::byte> v(n);
+  for (std::size_t i = 0; i < n; ++i) v[i] = static_cast<std::byte>('a' + i % 26);
+  if (n > 0) v[n - 1] = std::byte{'\n'};
+  return v;
+}
+
+void find_bench(tcc::bench::State& state, const Kernels& k) {
+  const auto n = static_cast<std::size_t>(state.range(0)) * sizeof(float);
+  const std::vector<std::byte> hay = make_haystack(n);
+  for (auto _ : state) {
+    std::size_t pos = k.find_byte(hay.data(), n, std::byte{'\n'});
+    tcc::bench::DoNotOptimize(pos);
+  }
+  bytes_done(state, n);
+}
+
+void count_bench(tcc::bench::State& state, const Kernels& k) {
+  const auto n = static_cast<std::size_t>(state.range(0)) * sizeof(float);
+  const std::vector<std::byte> hay = make_haystack(n);
+  for (auto _ : state) {
+    std::size_t count = k.count_byte(hay.data(), n, std::byte{'e'});
+    tcc::bench::DoNotOptimize(count);
+  }
+  bytes_done(state, n);
+}
+
+void prefix_bench(tcc::bench::State& state, const Kernels& k) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  std::vector<std::uint32_t> in(n), out(n);
+  for (std::size_t i = 0; i < n; ++i) in[i] = static_cast<std::uint32_t>(i * 2654435761u);
+  for (auto _ : state) {
+    k.prefix_sum(in.data(), out.data(), n);
+    tcc::bench::ClobberMemory();
+  }
+  bytes_done(state, n * sizeof(std::uint32_t));
+}
+
+using KernelBench = void (*)(tcc::bench::State&, const Kernels&);
+
+// Registered at startup, one instance per (kernel, supported level), e.g.
+// "BM_SimdSum_avx2/4096".
+const bool simd_registered = [] {
+  const struct {
+    const char* name;
+    KernelBench fn;
+  } benches[] = {
+      {"BM_SimdSum", reduce_bench<&Kernels::sum>},
+      {"BM_SimdMin", reduce_bench<&Kernels::min>},
+      {"BM_SimdMax", reduce_bench<&Kernels::max>},
+      {"BM_SimdDot", dot_bench},
+      {"BM_SimdFindByte", find_bench},
+      {"BM_SimdCountByte", count_bench},
+      {"BM_SimdPrefixSum", prefix_bench},
+  };
+  for (const auto& bench : benches) {
+    for (Isa isa : tcc::simd::supported_isas()) {
+      const Kernels& k = tcc::simd::kernels(isa);
+      std::string name = bench.name;
+      name.append("_").append(tcc::simd::isa_name(isa));
+      tcc::bench::register_benchmark(std::move(name), [fn = bench.fn, &k](tcc::bench::State& state) {
+        fn(state, k);
+      })->arg(kSmall)->arg(kLarge);
+    }
+  }
+  return true;
+}();
+
+}  // namespace
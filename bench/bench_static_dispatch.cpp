@@ -0,0 +1,100 @@
+// One of several element operations chosen at run time, applied to 64K
+// floats: a virtual call per element against tcc::StaticDispatch, which
+// visits once and runs a loop the compiler can inline and vectorize, and
+// the same loop hard-coded as the bound. BM_Crc32 runs the make_table-built
+// slicing-by-8 CRC over 1 MiB.
+
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/static_dispatch.hpp"
+
+namespace {
+
+constexpr std::size_t kDispatchElements = 1 << 16;
+
+struct Op {
+  virtual ~Op() = default;
+  virtual float apply(float x) const = 0;
+};
+struct VirtualScale final : Op {
+  float k;
+  explicit VirtualScale(float k) : k(k) {}
+  float apply(float x) const override { return x * k; }
+};
+struct VirtualOffset final : Op {
+  float d;
+  explicit VirtualOffset(float d) : d(d) {}
+  float apply(float x) const override { return x + d; }
+};
+
+struct Scale : tcc::BatchPolicy<Scale> {
+  float k = 1.0f;
+  float apply(float x) const noexcept { return x * k; }
+};
+struct Offset : tcc::BatchPolicy<Offset> {
+  float d = 0.0f;
+  float apply(float x) const noexcept { return x + d; }
+};
+
+// The benchmark argument picks the operation, so the compiler cannot
+// resolve the call statically in either variant.
+std::unique_ptr<Op> make_virtual(std::int64_t which) {
+  if (which == 0) return std::make_unique<VirtualScale>(1.0001f);
+  return std::make_unique<VirtualOffset>(0.5f);
+}
+
+void BM_DispatchVirtual(tcc::bench::State& state) {
+  const auto op = make_virtual(state.range(0) % 2 == 0 ? 0 : 1);
+  std::vector<float> in(kDispatchElements), out(kDispatchElements);
+  std::iota(in.begin(), in.end(), 0.0f);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < kDispatchElements; ++i) out[i] = op->apply(in[i]);
+    tcc::bench::DoNotOptimize(out.data());
+  }
+  state.set_items_processed(state.iterations() * static_cast<std::int64_t>(kDispatchElements));
+}
+TCC_BENCHMARK(BM_DispatchVirtual)->arg(0);
+
+void BM_DispatchStatic(tcc::bench::State& state) {
+  using Dispatch = tcc::StaticDispatch<Scale, Offset>;
+  const Dispatch op = state.range(0) % 2 == 0 ? Dispatch(Scale{{}, 1.0001f}) : Dispatch(Offset{{}, 0.5f});
+  std::vector<float> in(kDispatchElements), out(kDispatchElements);
+  std::iota(in.begin(), in.end(), 0.0f);
+  for (auto _ : state) {
+    op.transform(std::span(in), std::span(out));
+    tcc::bench::DoNotOptimize(out.data());
+  }
+  state.set_items_processed(state.iterations() * static_cast<std::int64_t>(kDispatchElements));
+}
+TCC_BENCHMARK(BM_DispatchStatic)->arg(0);
+
+void BM_DispatchHardCoded(tcc::bench::State& state) {
+  std::vector<float> in(kDispatchElements), out(kDispatchElements);
+  std::iota(in.begin(), in.end(), 0.0f);
+  const float k = 1.0f + static_cast<float>(state.range(0)) * 1e-4f;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < kDispatchElements; ++i) out[i] = in[i] * k;
+    tcc::bench::DoNotOptimize(out.data());
+  }
+  state.set_items_processed(state.iterations() * static_cast<std::int64_t>(kDispatchElements));
+}
+TCC_BENCHMARK(BM_DispatchHardCoded)->arg(1);
+
+void BM_Crc32(tcc::bench::State& state) {
+  std::vector<std::byte> data(1 << 20);
+  for (std::size_t i = 0; i < data.size(); ++i) data[i] = static_cast<std::byte>(i * 31);
+  std::uint32_t crc = 0;
+  for (auto _ : state) {
+    crc = tcc::crc32(data, crc);
+    tcc::bench::DoNotOptimize(crc);
+  }
+  state.set_bytes_processed(state.iterations() * static_cast<std::int64_t>(data.size()));
+}
+TCC_BENCHMARK(BM_Crc32);
+
+}  // namespace
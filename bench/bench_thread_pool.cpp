@@ -0,0 +1,119 @@
+// Scaling curve of tcc::ThreadPool: the same compute-bound loop at 1..64
+// workers, plus the fixed cost of spawning and joining fine-grained tasks.
+// std::async per chunk is the pattern the pool replaces. BM_PoolAffinity
+// runs a memory-bound pass with unpinned, node-pinned and core-pinned
+// workers (arg 0/1/2). Expect identical rows on a one-node machine, and the
+// pinned rows ahead on multi-socket hosts, where pinned workers keep their
+// first-touched pages and steal locally.
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/thread_pool.hpp"
+
+namespace {
+
+constexpr std::size_t kElements = 1 << 18;
+constexpr std::size_t kGrain = 2048;
+
+// Enough arithmetic per element that the loop is compute- not memory-bound.
+inline double work(std::size_t i) {
+  double x = static_cast<double>(i) * 1e-6;
+  for (int k = 0; k < 8; ++k) x = std::sqrt(x * x + 1.0) * 0.5;
+  return x;
+}
+
+void BM_PoolParallelFor(tcc::bench::State& state) {
+  tcc::ThreadPool pool(static_cast<std::size_t>(state.range(0)));
+  std::vector<double> out(kElements);
+  for (auto _ : state) {
+    tcc::parallel_for(pool, {0, kElements}, kGrain, [&](tcc::IndexRange r) {
+      for (std::size_t i = r.begin; i < r.end; ++i) out[i] = work(i);
+    });
+    tcc::bench::ClobberMemory();
+  }
+  state.set_items_processed(state.iterations() * static_cast<std::int64_t>(kElements));
+  state.counters["threads"] = static_cast<double>(pool.size());
+}
+TCC_BENCHMARK(BM_PoolParallelFor)->range(1, 64, 2);
+
+void BM_PoolParallelReduce(tcc::bench::State& state) {
+  tcc::ThreadPool pool(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    double sum = tcc::parallel_reduce(
+        pool, {0, kElements}, kGrain, 0.0,
+        [](tcc::IndexRange r) {
+          double s = 0;
+          for (std::size_t i = r.begin; i < r.end; ++i) s += work(i);
+          return s;
+        },
+        std::plus<>{});
+    tcc::bench::DoNotOptimize(sum);
+  }
+  state.set_items_processed(state.iterations() * static_cast<std::int64_t>(kElements));
+  state.counters["threads"] = static_cast<double>(pool.size());
+}
+TCC_BENCHMARK(BM_PoolParallelReduce)->range(1, 64, 2);
+
+void BM_StdAsyncFor(tcc::bench::State& state) {
+  const auto threads = static_cast<std::size_t>(state.range(0));
+  std::vector<double> out(kElements);
+  for (auto _ : state) {
+    std::vector<std::future<void>> futures;
+    const std::size_t chunk = (kElements + threads - 1) / threads;
+    for (std::size_t lo = 0; lo < kElements; lo += chunk) {
+      futures.push_back(std::async(std::launch::async, [&, lo] {
+        const std::size_t hi = std::min(kElements, lo + chunk);
+        for (std::size_t i = lo; i < hi; ++i) out[i] = work(i);
+      }));
+    }
+    for (auto& f : futures) f.get();
+    tcc::bench::ClobberMemory();
+  }
+  state.set_items_processed(state.iterations() * static_cast<std::int64_t>(kElements));
+}
+TCC_BENCHMARK(BM_StdAsyncFor)->range(1, 64, 2);
+
+// Per-task overhead: 1024 one-index chunks, i.e. 1023 splits and joins.
+void BM_PoolSpawnJoin(tcc::bench::State& state) {
+  tcc::ThreadPool pool(static_cast<std::size_t>(state.range(0)));
+  std::vector<std::uint64_t> out(1024);
+  for (auto _ : state) {
+    tcc::parallel_for(pool, {0, out.size()}, 1, [&](tcc::IndexRange r) { out[r.begin] += r.begin; });
+  }
+  tcc::bench::DoNotOptimize(out.data());
+  state.set_items_processed(state.iterations() * static_cast<std::int64_t>(out.size()));
+}
+TCC_BENCHMARK(BM_PoolSpawnJoin)->arg(1)->arg(4);
+
+void BM_PoolAffinity(tcc::bench::State& state) {
+  constexpr tcc::Affinity kAffinity[] = {tcc::Affinity::none, tcc::Affinity::node, tcc::Affinity::core};
+  tcc::ThreadPool pool({.affinity = kAffinity[state.range(0)]});
+  constexpr std::size_t kFloats = std::size_t{1} << 24;  // 64 MiB, well past the LLC
+  const auto data = std::make_unique_for_overwrite<float[]>(kFloats);
+  // First touch on the workers, so each page lands on the node that wrote it.
+  tcc::parallel_for(pool, {0, kFloats}, 1 << 16, [&](tcc::IndexRange r) {
+    for (std::size_t i = r.begin; i < r.end; ++i) data[i] = 1.0f;
+  });
+  for (auto _ : state) {
+    const float total = tcc::parallel_reduce(
+        pool, {0, kFloats}, 1 << 16, 0.0f,
+        [&](tcc::IndexRange r) {
+          float s = 0;
+          for (std::size_t i = r.begin; i < r.end; ++i) s += data[i];
+          return s;
+        },
+        std::plus<>{});
+    tcc::bench::DoNotOptimize(total);
+  }
+  state.set_bytes_processed(state.iterations() * static_cast<std::int64_t>(kFloats * sizeof(float)));
+  state.counters["threads"] = static_cast<double>(pool.size());
+}
+TCC_BENCHMARK(BM_PoolAffinity)->arg(0)->arg(1)->arg(2);
+
+}  // namespace
@@ -0,0 +1,73 @@
+// Cost of one TCC_TRACE_SCOPE: not started (a relaxed load and a branch)
+// and recording (two cycle-counter reads and a ring store), against an
+// empty loop and against the cycle-counter read alone, which dominates and
+// varies a lot between bare metal (~7 ns) and VMs that trap it. Rings are
+// drained outside the timed region so no event is dropped. Items are scopes.
+
+#include <cstdint>
+#include <filesystem>
+
+#include "harness.hpp"
+#include "tcc/trace.hpp"
+
+namespace {
+
+constexpr std::int64_t kScopesPerIteration = 4096;
+
+void BM_TraceBaseline(tcc::bench::State& state) {
+  for (auto _ : state) {
+    for (std::int64_t i = 0; i < kScopesPerIteration; ++i) tcc::bench::DoNotOptimize(i);
+  }
+  state.set_items_processed(state.iterations() * kScopesPerIteration);
+}
+TCC_BENCHMARK(BM_TraceBaseline);
+
+void BM_TraceTicks(tcc::bench::State& state) {
+  for (auto _ : state) {
+    for (std::int64_t i = 0; i < kScopesPerIteration; ++i) tcc::bench::DoNotOptimize(tcc::trace::detail::ticks());
+  }
+  state.set_items_processed(state.iterations() * kScopesPerIteration);
+}
+TCC_BENCHMARK(BM_TraceTicks);
+
+void BM_TraceScopeDisabled(tcc::bench::State& state) {
+  for (auto _ : state) {
+    for (std::int64_t i = 0; i < kScopesPerIteration; ++i) {
+      TCC_TRACE_SCOPE("disabled");
+      tcc::bench::DoNotOptimize(i);
+    }
+  }
+  state.set_items_processed(state.iterations() * kScopesPerIteration);
+}
+TCC_BENCHMARK(BM_TraceScopeDisabled);
+
+template <bool Counter>
+void recording(tcc::bench::State& state) {
+  const auto path = std::filesystem::temp_directory_path() / "tcc_bench_trace.json";
+  tcc::trace::start({.path = path, .flush_interval = std::chrono::hours(1), .buffer_events = 2 * kScopesPerIteration});
+  for (auto _ : state) {
+    for (std::int64_t i = 0; i < kScopesPerIteration; ++i) {
+      if constexpr (Counter) {
+        TCC_TRACE_COUNTER("bench_counter", i);
+      } else {
+        TCC_TRACE_SCOPE("bench_scope");
+      }
+      tcc::bench::DoNotOptimize(i);
+    }
+    state.pause_timing();
+    tcc::trace::flush();
+    state.resume_timing();
+  }
+  state.counters["dropped"] = static_cast<double>(tcc::trace::dropped_events());
+  tcc::trace::stop();
+  std::filesystem::remove(path);
+  state.set_items_processed(state.iterations() * kScopesPerIteration);
+}
+
+void BM_TraceScopeEnabled(tcc::bench::State& state) { recording<false>(state); }
+TCC_BENCHMARK(BM_TraceScopeEnabled);
+
+void BM_TraceCounterEnabled(tcc::bench::State& state) { recording<true>(state); }
+TCC_BENCHMARK(BM_TraceCounterEnabled);
+
+}  // namespace
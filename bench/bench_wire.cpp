@@ -0,0 +1,94 @@
+// tcc::wire encode and decode throughput on an order message with N fills:
+// building the buffer (Builder reused, so steady-state allocation is nil),
+// and reading every field in place through root() (with verification) and
+// root_unchecked(). Bytes are message bytes.
+
+#include <cstdint>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/wire.hpp"
+
+namespace {
+
+namespace w = tcc::wire;
+
+using Fill = w::Schema<w::Field<"qty", std::int32_t>, w::Field<"price", double>, w::Field<"venue", std::uint16_t>>;
+using Order = w::Schema<w::Field<"id", std::uint64_t>, w::Field<"symbol", w::String>,
+                        w::Field<"levels", w::Vector<float>>, w::Field<"fills", w::Vector<w::Table<Fill>>>,
+                        w::Field<"limit", double>>;
+
+void encode_order(w::Builder& b, std::size_t fills, std::vector<w::TableRef<Fill>>& refs) {
+  static const std::vector<float> levels(16, 1.5f);
+  b.clear();
+  const auto symbol = b.add_string("ACME.XNAS");
+  const auto lv = b.add_vector<float>(levels);
+  refs.clear();
+  for (std::size_t i = 0; i < fills; ++i) {
+    refs.push_back(b.add_table<Fill>(static_cast<std::int32_t>(i), 100.0 + static_cast<double>(i), 7));
+  }
+  const auto fv = b.add_vector<Fill>(std::span<const w::TableRef<Fill>>(refs));
+  b.finish(b.add_table<Order>(42, symbol, lv, fv, 101.5));
+}
+
+double read_order(w::View<Order> order) {
+  double sum = static_cast<double>(order.get<"id">()) + order.get<"limit">();
+  sum += static_cast<double>(order.get<"symbol">().size());
+  for (float l : order.get<"levels">()) sum += l;
+  const auto fills = order.get<"fills">();
+  for (std::size_t i = 0; i < fills.size(); ++i) {
+    const auto f = fills[i];
+    sum += f.get<"qty">() * f.get<"price">() + f.get<"venue">();
+  }
+  return sum;
+}
+
+void BM_WireEncode(tcc::bench::State& state) {
+  const auto fills = static_cast<std::size_t>(state.range(0));
+  w::Builder b;
+  std::vector<w::TableRef<Fill>> refs;
+  encode_order(b, fills, refs);
+  const std::size_t bytes = b.data().size();
+  for (auto _ : state) {
+    encode_order(b, fills, refs);
+    tcc::bench::DoNotOptimize(b.data().data());
+    tcc::bench::ClobberMemory();
+  }
+  state.set_bytes_processed(state.iterations() * static_cast<std::int64_t>(bytes));
+  state.set_items_processed(state.iterations());
+  state.counters["message_bytes"] = static_cast<double>(bytes);
+}
+TCC_BENCHMARK(BM_WireEncode)->arg(8)->arg(1024);
+
+template <bool Verify>
+void decode(tcc::bench::State& state) {
+  w::Builder b;
+  std::vector<w::TableRef<Fill>> refs;
+  encode_order(b, static_cast<std::size_t>(state.range(0)), refs);
+  const std::span<const std::byte> message = b.data();
+  for (auto _ : state) {
+    const auto order = Verify ? w::root<Order>(message) : w::root_unchecked<Order>(message);
+    tcc::bench::DoNotOptimize(read_order(order));
+  }
+  state.set_bytes_processed(state.iterations() * static_cast<std::int64_t>(message.size()));
+  state.set_items_processed(state.iterations());
+}
+
+void BM_WireDecodeVerified(tcc::bench::State& state) { decode<true>(state); }
+TCC_BENCHMARK(BM_WireDecodeVerified)->arg(8)->arg(1024);
+
+void BM_WireDecodeUnchecked(tcc::bench::State& state) { decode<false>(state); }
+TCC_BENCHMARK(BM_WireDecodeUnchecked)->arg(8)->arg(1024);
+
+// Verification alone: the fixed cost root() adds before the first read.
+void BM_WireVerify(tcc::bench::State& state) {
+  w::Builder b;
+  std::vector<w::TableRef<Fill>> refs;
+  encode_order(b, static_cast<std::size_t>(state.range(0)), refs);
+  const std::span<const std::byte> message = b.data();
+  for (auto _ : state) tcc::bench::DoNotOptimize(w::root<Order>(message).offset());
+  state.set_bytes_processed(state.iterations() * static_cast<std::int64_t>(message.size()));
+}
+TCC_BENCHMARK(BM_WireVerify)->arg(8)->arg(1024);
+
+}  // namespace
@@ -0,0 +1,227 @@
+// tcc_bench_compare: regression gate between two tcc_bench JSON reports.
+//
+//   tcc_bench_compare <baseline.json> <current.json> [--threshold=0.05] [--alpha=0.05]
+//                     [--require-cycles]
+//
+// A benchmark regresses when its median slowed down by more than
+// --threshold (relative) AND a one-sided Mann-Whitney U test over the
+// per-repetition samples says the slowdown is significant at --alpha. The
+// second condition keeps a noisy run from failing the gate on its own.
+//
+// When both reports carry hardware counters (tcc_bench --perf-counters),
+// the instructions and IPC change per benchmark are shown, and the verdict
+// of a slowdown names its cause: "+insn" when the code now does more work,
+// "-ipc" when the same work stalls more (cache or branch misses), "clock"
+// when cycles are flat and only wall time grew (CPU frequency, preemption,
+// or time blocked outside user space). --require-cycles stops "clock"
+// slowdowns from failing the gate; leave it off for benchmarks that block.
+// Exit status: 0 clean, 1 at least one regression, 2 usage or input error.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "json.hpp"
+
+namespace {
+
+using tcc::bench::json::Value;
+
+struct Entry {
+  double median_ns = 0;
+  std::vector<double> samples;
+  double cycles = -1;  // per iteration; -1 without counters
+  double instructions = -1;
+};
+
+const Value& require(const Value& obj, std::string_view key, const std::string& path) {
+  const Value* v = obj.find(key);
+  if (v == nullptr) throw std::runtime_error(path + ": benchmark entry without \"" + std::string(key) + "\"");
+  return *v;
+}
+
+std::map<std::string, Entry> load_report(const std::string& path) {
+  const Value doc = tcc::bench::json::parse_file(path);
+  const Value* benchmarks = doc.find("benchmarks");
+  if (benchmarks == nullptr) throw std::runtime_error(path + ": missing \"benchmarks\"");
+
+  std::map<std::string, Entry> entries;
+  for (const Value& bm : benchmarks->array()) {
+    Entry e;
+    e.median_ns = require(bm, "median_ns", path).number();
+    if (const Value* samples = bm.find("samples_ns")) {
+      for (const Value& s : samples->array()) e.samples.push_back(s.number());
+    }
+    if (const Value* hw = bm.find("hw_counters")) {
+      const auto count = [&](std::string_view key) {
+        const Value* v = hw->find(key);
+        return v != nullptr && v->is_number() ? v->number() : -1.0;
+      };
+      e.cycles = count("cycles");
+      e.instructions = count("instructions");
+    }
+    entries[require(bm, "name", path).string()] = std::move(e);
+  }
+  return entries;
+}
+
+/// P(current > baseline) under H0, from the normal approximation to the
+/// Mann-Whitney U distribution with tie and continuity correction.
+double mann_whitney_greater(const std::vector<double>& current, const std::vector<double>& baseline) {
+  const double n1 = static_cast<double>(current.size());
+  const double n2 = static_cast<double>(baseline.size());
+  const double n = n1 + n2;
+
+  struct Obs {
+    double value;
+    bool current;
+  };
+  std::vector<Obs> all;
+  for (double v : current) all.push_back({v, true});
+  for (double v : baseline) all.push_back({v, false});
+  std::sort(all.begin(), all.end(), [](const Obs& a, const Obs& b) { return a.value < b.value; });
+
+  double rank_sum = 0;
+  double tie_term = 0;
+  for (std::size_t i = 0; i < all.size();) {
+    std::size_t j = i;
+    while (j < all.size() && all[j].value == all[i].value) ++j;
+    const double avg_rank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2.0;
+    for (std::size_t k = i; k < j; ++k) {
+      if (all[k].current) rank_sum += avg_rank;
+    }
+    const double t = static_cast<double>(j - i);
+    tie_term += t * t * t - t;
+    i = j;
+  }
+
+  const double u = rank_sum - n1 * (n1 + 1) / 2.0;
+  const double mean = n1 * n2 / 2.0;
+  const double var = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1)));
+  if (var <= 0) return 1.0;
+  const double z = (u - mean - 0.5) / std::sqrt(var);
+  return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+bool parse_double_flag(std::string_view arg, std::string_view name, double& out) {
+  if (arg.substr(0, name.size()) != name || arg.size() <= name.size() || arg[name.size()] != '=') {
+    return false;
+  }
+  out = std::atof(std::string(arg.substr(name.size() + 1)).c_str());
+  return true;
+}
+
+int usage() {
+  std::fprintf(stderr,
+               "usage: tcc_bench_compare <baseline.json> <current.json> "
+               "[--threshold=0.05] [--alpha=0.05] [--require-cycles]\n");
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::vector<std::string> files;
+  double threshold = 0.05;
+  double alpha = 0.05;
+  bool require_cycles = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (parse_double_flag(arg, "--threshold", threshold) || parse_double_flag(arg, "--alpha", alpha)) {
+      continue;
+    }
+    if (arg == "--require-cycles") {
+      require_cycles = true;
+      continue;
+    }
+    if (arg.substr(0, 2) == "--") return usage();
+    files.emplace_back(arg);
+  }
+  if (files.size() != 2) return usage();
+
+  std::map<std::string, Entry> baseline, current;
+  try {
+    baseline = load_report(files[0]);
+    current = load_report(files[1]);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "tcc_bench_compare: %s\n", e.what());
+    return 2;
+  }
+
+  std::printf("%-44s %12s %12s %9s %9s %8s %8s  %s\n", "benchmark", "base(ns)", "cur(ns)", "change",
+              "p-value", "insn", "ipc", "verdict");
+  int regressions = 0;
+  for (const auto& [name, cur] : current) {
+    auto it = baseline.find(name);
+    if (it == baseline.end()) {
+      std::printf("%-44s %12s %12.2f %9s %9s %8s %8s  new\n", name.c_str(), "-", cur.median_ns, "-", "-", "-",
+                  "-");
+      continue;
+    }
+    const Entry& base = it->second;
+    const double change = base.median_ns > 0 ? cur.median_ns / base.median_ns - 1.0 : 0.0;
+
+    // Too few samples for a rank test: fall back to the median threshold.
+    const bool testable = cur.samples.size() >= 3 && base.samples.size() >= 3;
+    const double p = testable ? mann_whitney_greater(cur.samples, base.samples) : 0.0;
+
+    // Counter deltas, as relative changes; only with counters on both sides.
+    const bool counted = base.cycles > 0 && cur.cycles > 0 && base.instructions > 0 && cur.instructions > 0;
+    const double cycles_change = counted ? cur.cycles / base.cycles - 1.0 : 0.0;
+    const double insn_change = counted ? cur.instructions / base.instructions - 1.0 : 0.0;
+    const double ipc_change =
+        counted ? (cur.instructions / cur.cycles) / (base.instructions / base.cycles) - 1.0 : 0.0;
+
+    std::string verdict = "ok";
+    if (change > threshold && p < alpha) {
+      const char* cause = nullptr;
+      if (counted) {
+        if (cycles_change <= threshold) {
+          cause = "clock";
+        } else {
+          cause = insn_change > threshold / 2 ? "+insn" : "-ipc";
+        }
+      }
+      if (require_cycles && counted && cycles_change <= threshold) {
+        verdict = "noise";
+      } else {
+        verdict = "REGRESSION";
+        ++regressions;
+      }
+      if (cause != nullptr) verdict.append(" (").append(cause).append(")");
+    } else if (change > threshold) {
+      verdict = "noise";
+    } else if (change < -threshold) {
+      verdict = "improved";
+    }
+    char p_buf[16] = "-", insn_buf[16] = "-", ipc_buf[16] = "-";
+    if (testable) std::snprintf(p_buf, sizeof p_buf, "%.4f", p);
+    if (counted) {
+      std::snprintf(insn_buf, sizeof insn_buf, "%+.1f%%", insn_change * 100.0);
+      std::snprintf(ipc_buf, sizeof ipc_buf, "%+.1f%%", ipc_change * 100.0);
+    }
+    std::printf("%-44s %12.2f %12.2f %+8.1f%% %9s %8s %8s  %s\n", name.c_str(), base.median_ns, cur.median_ns,
+                change * 100.0, p_buf, insn_buf, ipc_buf, verdict.c_str());
+  }
+  for (const auto& [name, base] : baseline) {
+    if (!current.count(name)) {
+      std::printf("%-44s %12.2f %12s %9s %9s %8s %8s  missing\n", name.c_str(), base.median_ns, "-", "-", "-",
+                  "-", "-");
+    }
+  }
+
+  if (regressions > 0) {
+    std::printf("\n%d benchmark(s) regressed by more than %.1f%% (alpha=%.3f)\n", regressions,
+                threshold * 100.0, alpha);
+    return 1;
+  }
+  std::printf("\nno regressions beyond %.1f%% (alpha=%.3f)\n", threshold * 100.0, alpha);
+  return 0;
+}
@@ -0,0 +1,610 @@
+#include "harness.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <regex>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include "perf_counters.hpp"
+#include "tcc/version.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <stdio.h>
+#endif
+
+#ifndef TCC_BENCH_BUILD_TYPE
+#define TCC_BENCH_BUILD_TYPE "unknown"
+#endif
+
+namespace tcc::bench {
+
+namespace {
+
+std::int64_t now_ns() noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+std::vector<std::unique_ptr<Benchmark>>& registry() {
+  static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+  return benchmarks;
+}
+
+struct Options {
+  std::string filter;
+  int repetitions = 10;
+  double min_time = 0.02;
+  double warmup = 0.02;
+  std::string out = "bench_output.txt";
+  std::string history;
+  bool list = false;
+  bool check_scaling = false;
+  bool perf_counters = false;
+};
+
+struct Instance {
+  const Benchmark* benchmark;
+  std::vector<std::int64_t> args;
+  std::string name;
+};
+
+struct Result {
+  std::string name;
+  std::int64_t iterations = 0;
+  std::vector<double> samples_ns;  // ns per iteration, one per repetition
+  double min_ns = 0, median_ns = 0, mean_ns = 0, p99_ns = 0, max_ns = 0, stddev_ns = 0;
+  double items_per_iteration = 0;
+  double bytes_per_iteration = 0;
+  std::map<std::string, double> counters;
+  bool has_hw = false;
+  HwCounters hw;  // per iteration, averaged over the repetitions
+};
+
+bool parse_flag(std::string_view arg, std::string_view name, std::string_view& value) {
+  if (arg.substr(0, name.size()) != name) return false;
+  arg.remove_prefix(name.size());
+  if (arg.empty() || arg.front() != '=') return false;
+  value = arg.substr(1);
+  return true;
+}
+
+Options parse_options(int argc, char** argv) {
+  Options opts;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    std::string_view value;
+    if (parse_flag(arg, "--filter", value)) {
+      opts.filter = value;
+    } else if (parse_flag(arg, "--repetitions", value)) {
+      opts.repetitions = std::max(1, std::atoi(std::string(value).c_str()));
+    } else if (parse_flag(arg, "--min-time", value)) {
+      opts.min_time = std::atof(std::string(value).c_str());
+    } else if (parse_flag(arg, "--warmup", value)) {
+      opts.warmup = std::atof(std::string(value).c_str());
+    } else if (parse_flag(arg, "--out", value)) {
+      opts.out = value;
+    } else if (parse_flag(arg, "--history", value)) {
+      opts.history = value;
+    } else if (arg == "--perf-counters") {
+      opts.perf_counters = true;
+    } else if (arg == "--list") {
+      opts.list = true;
+    } else if (arg == "--check-scaling") {
+      opts.check_scaling = true;
+    } else {
+      throw std::invalid_argument("unknown option: " + std::string(arg));
+    }
+  }
+  return opts;
+}
+
+std::vector<Instance> instantiate(const Options& opts) {
+  std::regex filter(opts.filter.empty() ? std::string(".*") : opts.filter);
+  std::vector<Instance> instances;
+  for (const auto& bm : registry()) {
+    auto arg_sets = bm->arg_sets();
+    if (arg_sets.empty()) arg_sets.emplace_back();
+    for (auto& args : arg_sets) {
+      std::string name = bm->name();
+      for (auto a : args) name.append("/").append(std::to_string(a));
+      if (std::regex_search(name, filter)) {
+        instances.push_back({bm.get(), std::move(args), std::move(name)});
+      }
+    }
+  }
+  return instances;
+}
+
+State run_once(const Instance& inst, std::int64_t iterations, PerfCounters* perf = nullptr) {
+  State state(iterations, inst.args);
+  state.count_events(perf);
+  inst.benchmark->function()(state);
+  return state;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+  if (sorted.size() == 1) return sorted.front();
+  const double rank = p * static_cast<double>(sorted.size() - 1);
+  const auto lo = static_cast<std::size_t>(rank);
+  const auto hi = std::min(lo + 1, sorted.size() - 1);
+  const double frac = rank - static_cast<double>(lo);
+  return sorted[lo] + (sorted[hi] - sorted[lo]) * frac;
+}
+
+Result run_instance(const Instance& inst, const Options& opts, PerfCounters* perf) {
+  const double min_time = inst.benchmark->min_time() > 0 ? inst.benchmark->min_time() : opts.min_time;
+  constexpr std::int64_t kMaxIterations = 1'000'000'000;
+
+  // Warmup doubles as calibration: grow the iteration count until a single
+  // run lasts min_time, and keep running until the warmup budget is spent.
+  std::int64_t iterations = 1;
+  double warmed = 0.0;
+  for (;;) {
+    const double elapsed = run_once(inst, iterations).elapsed_seconds();
+    warmed += elapsed;
+    if (elapsed >= min_time || iterations >= kMaxIterations) {
+      if (warmed >= opts.warmup) break;
+      continue;
+    }
+    double multiplier = elapsed > 0 ? min_time * 1.4 / elapsed : 10.0;
+    multiplier = std::clamp(multiplier, 1.0, 10.0);
+    iterations = std::min(kMaxIterations,
+                          std::max(iterations + 1, static_cast<std::int64_t>(iterations * multiplier)));
+  }
+
+  Result result;
+  result.name = inst.name;
+  result.iterations = iterations;
+  double items = 0, bytes = 0;
+  for (int rep = 0; rep < opts.repetitions; ++rep) {
+    State state = run_once(inst, iterations, perf);
+    if (perf != nullptr) result.hw += perf->read();
+    result.samples_ns.push_back(state.elapsed_seconds() * 1e9 / static_cast<double>(iterations));
+    items += static_cast<double>(state.items_processed()) / static_cast<double>(iterations);
+    bytes += static_cast<double>(state.bytes_processed()) / static_cast<double>(iterations);
+    for (const auto& [key, value] : state.counters) result.counters[key] += value;
+  }
+  const double reps = static_cast<double>(opts.repetitions);
+  result.items_per_iteration = items / reps;
+  result.bytes_per_iteration = bytes / reps;
+  for (auto& [key, value] : result.counters) value /= reps;
+  if (perf != nullptr) {
+    result.has_hw = true;
+    const double total = reps * static_cast<double>(iterations);
+    for (double* v : {&result.hw.cycles, &result.hw.instructions, &result.hw.cache_misses, &result.hw.branch_misses}) {
+      if (*v >= 0) *v /= total;
+    }
+  }
+
+  std::vector<double> sorted = result.samples_ns;
+  std::sort(sorted.begin(), sorted.end());
+  result.min_ns = sorted.front();
+  result.max_ns = sorted.back();
+  result.median_ns = percentile(sorted, 0.5);
+  result.p99_ns = percentile(sorted, 0.99);
+  result.mean_ns = std::accumulate(sorted.begin(), sorted.end(), 0.0) / reps;
+  double var = 0;
+  for (double s : sorted) var += (s - result.mean_ns) * (s - result.mean_ns);
+  result.stddev_ns = sorted.size() > 1 ? std::sqrt(var / (reps - 1)) : 0.0;
+  return result;
+}
+
+// --- Reporting --------------------------------------------------------------
+
+std::string format_time(double ns) {
+  char buf[32];
+  if (ns < 1e3) {
+    std::snprintf(buf, sizeof buf, "%.2f ns", ns);
+  } else if (ns < 1e6) {
+    std::snprintf(buf, sizeof buf, "%.2f us", ns / 1e3);
+  } else if (ns < 1e9) {
+    std::snprintf(buf, sizeof buf, "%.2f ms", ns / 1e6);
+  } else {
+    std::snprintf(buf, sizeof buf, "%.2f s", ns / 1e9);
+  }
+  return buf;
+}
+
+std::string format_rate(double per_second, const char* unit) {
+  static constexpr const char* kPrefixes[] = {"", "k", "M", "G", "T"};
+  int prefix = 0;
+  while (per_second >= 1000.0 && prefix < 4) {
+    per_second /= 1000.0;
+    ++prefix;
+  }
+  char buf[48];
+  std::snprintf(buf, sizeof buf, "%.2f %s%s/s", per_second, kPrefixes[prefix], unit);
+  return buf;
+}
+
+void print_result(const Result& r) {
+  std::string extra;
+  const double seconds = r.median_ns * 1e-9;
+  if (r.bytes_per_iteration > 0 && seconds > 0) {
+    extra += " " + format_rate(r.bytes_per_iteration / seconds, "B");
+  }
+  if (r.items_per_iteration > 0 && seconds > 0) {
+    extra += " " + format_rate(r.items_per_iteration / seconds, "items");
+  }
+  if (r.has_hw && r.hw.cycles > 0 && r.hw.instructions >= 0) {
+    char buf[48];
+    std::snprintf(buf, sizeof buf, " ipc=%.2f insn=%.4g", r.hw.instructions / r.hw.cycles, r.hw.instructions);
+    extra += buf;
+  }
+  for (const auto& [key, value] : r.counters) {
+    char buf[64];
+    std::snprintf(buf, sizeof buf, " %s=%g", key.c_str(), value);
+    extra += buf;
+  }
+  std::printf("%-44s %12lld %12s %12s %12s%s\n", r.name.c_str(),
+              static_cast<long long>(r.iterations), format_time(r.min_ns).c_str(),
+              format_time(r.median_ns).c_str(), format_time(r.p99_ns).c_str(), extra.c_str());
+  std::fflush(stdout);
+}
+
+std::string json_string(std::string_view s) {
+  std::string out = "\"";
+  for (char c : s) {
+    switch (c) {
+      case '"': out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\t': out += "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char buf[8];
+          std::snprintf(buf, sizeof buf, "\\u%04x", c);
+          out += buf;
+        } else {
+          out += c;
+        }
+    }
+  }
+  return out + "\"";
+}
+
+std::string json_number(double v) {
+  if (!std::isfinite(v)) return "null";
+  char buf[32];
+  std::snprintf(buf, sizeof buf, "%.10g", v);
+  return buf;
+}
+
+std::string utc_timestamp() {
+  std::time_t t = std::time(nullptr);
+  std::tm tm{};
+#if defined(_WIN32)
+  gmtime_s(&tm, &t);
+#else
+  gmtime_r(&t, &tm);
+#endif
+  char buf[32];
+  std::strftime(buf, sizeof buf, "%Y-%m-%dT%H:%M:%SZ", &tm);
+  return buf;
+}
+
+// --- Run identity -----------------------------------------------------------
+
+struct RunInfo {
+  std::string date;
+  std::string git_sha = "unknown";
+  bool git_dirty = false;
+  std::string cpu_model = "unknown";
+};
+
+/// First line printed by `command`, or "" when it cannot run.
+std::string first_line_of(const std::string& command) {
+  std::string line;
+#if defined(__unix__) || defined(__APPLE__)
+  if (FILE* pipe = ::popen(command.c_str(), "r")) {
+    char buf[256];
+    if (std::fgets(buf, sizeof buf, pipe) != nullptr) line = buf;
+    ::pclose(pipe);
+  }
+#else
+  (void)command;
+#endif
+  while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) line.pop_back();
+  return line;
+}
+
+/// The checkout the binary was built from, asked at run time: a configure
+/// time SHA would go stale on the next `git checkout` plus incremental build.
+void read_git_state(RunInfo& info) {
+#if defined(TCC_BENCH_SOURCE_DIR)
+  const std::string git = "git -C \"" TCC_BENCH_SOURCE_DIR "\" ";
+  const std::string sha = first_line_of(git + "rev-parse HEAD 2>/dev/null");
+  if (sha.empty()) return;
+  info.git_sha = sha;
+  info.git_dirty = !first_line_of(git + "status --porcelain --untracked-files=no 2>/dev/null").empty();
+#else
+  (void)info;
+#endif
+}
+
+std::string cpu_model() {
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line)) {
+    // "model name" on x86, "Model" or "Hardware" on some ARM kernels.
+    for (std::string_view key : {"model name", "Model", "Hardware"}) {
+      if (line.compare(0, key.size(), key) != 0) continue;
+      const auto colon = line.find(':');
+      if (colon == std::string::npos) continue;
+      const auto begin = line.find_first_not_of(" \t", colon + 1);
+      if (begin != std::string::npos) return line.substr(begin);
+    }
+  }
+  return "unknown";
+}
+
+RunInfo run_info() {
+  RunInfo info;
+  info.date = utc_timestamp();
+  read_git_state(info);
+  info.cpu_model = cpu_model();
+  return info;
+}
+
+/// Per-iteration event counts; null for an event the PMU did not count.
+void write_hw_counters(std::ostream& out, const HwCounters& hw) {
+  const auto count = [](double v) { return v < 0 ? std::string("null") : json_number(v); };
+  const double ipc = hw.cycles > 0 && hw.instructions >= 0 ? hw.instructions / hw.cycles : -1.0;
+  out << "{\"cycles\": " << count(hw.cycles) << ", \"instructions\": " << count(hw.instructions)
+      << ", \"ipc\": " << count(ipc) << ", \"cache_misses\": " << count(hw.cache_misses)
+      << ", \"branch_misses\": " << count(hw.branch_misses) << "}";
+}
+
+void write_json(const std::string& path, const Options& opts, const RunInfo& info,
+                const std::vector<Result>& results) {
+  std::ofstream out(path, std::ios::trunc);
+  if (!out) throw std::runtime_error("cannot open " + path + " for writing");
+
+  out << "{\n  \"context\": {\n"
+      << "    \"date\": " << json_string(info.date) << ",\n"
+      << "    \"git_sha\": " << json_string(info.git_sha) << ",\n"
+      << "    \"git_dirty\": " << (info.git_dirty ? "true" : "false") << ",\n"
+      << "    \"cpu_model\": " << json_string(info.cpu_model) << ",\n"
+      << "    \"version\": " << json_string(tcc::version()) << ",\n"
+      << "    \"build\": " << json_string(tcc::build_info()) << ",\n"
+      << "    \"build_type\": " << json_string(TCC_BENCH_BUILD_TYPE) << ",\n"
+      << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+      << "    \"repetitions\": " << opts.repetitions << ",\n"
+      << "    \"min_time\": " << json_number(opts.min_time) << "\n"
+      << "  },\n  \"benchmarks\": [";
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const Result& r = results[i];
+    const double seconds = r.median_ns * 1e-9;
+    out << (i ? "," : "") << "\n    {\n"
+        << "      \"name\": " << json_string(r.name) << ",\n"
+        << "      \"iterations\": " << r.iterations << ",\n"
+        << "      \"min_ns\": " << json_number(r.min_ns) << ",\n"
+        << "      \"median_ns\": " << json_number(r.median_ns) << ",\n"
+        << "      \"mean_ns\": " << json_number(r.mean_ns) << ",\n"
+        << "      \"p99_ns\": " << json_number(r.p99_ns) << ",\n"
+        << "      \"max_ns\": " << json_number(r.max_ns) << ",\n"
+        << "      \"stddev_ns\": " << json_number(r.stddev_ns) << ",\n";
+    if (r.items_per_iteration > 0) {
+      out << "      \"items_per_iteration\": " << json_number(r.items_per_iteration) << ",\n"
+          << "      \"items_per_second\": " << json_number(r.items_per_iteration / seconds) << ",\n";
+    }
+    if (r.bytes_per_iteration > 0) {
+      out << "      \"bytes_per_iteration\": " << json_number(r.bytes_per_iteration) << ",\n"
+          << "      \"bytes_per_second\": " << json_number(r.bytes_per_iteration / seconds) << ",\n";
+    }
+    out << "      \"counters\": {";
+    bool first = true;
+    for (const auto& [key, value] : r.counters) {
+      out << (first ? "" : ", ") << json_string(key) << ": " << json_number(value);
+      first = false;
+    }
+    out << "},\n";
+    if (r.has_hw) {
+      out << "      \"hw_counters\": ";
+      write_hw_counters(out, r.hw);
+      out << ",\n";
+    }
+    out << "      \"samples_ns\": [";
+    for (std::size_t s = 0; s < r.samples_ns.size(); ++s) {
+      out << (s ? ", " : "") << json_number(r.samples_ns[s]);
+    }
+    out << "]\n    }";
+  }
+  out << "\n  ]\n}\n";
+  if (!out) throw std::runtime_error("failed writing " + path);
+}
+
+/// Appends one JSON object per run, on one line, so the file stays valid
+/// JSON Lines however many runs it holds and `grep <sha>` finds a run.
+void append_history(const std::string& path, const Options& opts, const RunInfo& info,
+                    const std::vector<Result>& results) {
+  std::ofstream out(path, std::ios::app);
+  if (!out) throw std::runtime_error("cannot open " + path + " for appending");
+  out << "{\"git_sha\": " << json_string(info.git_sha) << ", \"git_dirty\": " << (info.git_dirty ? "true" : "false")
+      << ", \"cpu_model\": " << json_string(info.cpu_model) << ", \"date\": " << json_string(info.date)
+      << ", \"build_type\": " << json_string(TCC_BENCH_BUILD_TYPE) << ", \"repetitions\": " << opts.repetitions
+      << ", \"benchmarks\": {";
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const Result& r = results[i];
+    out << (i ? ", " : "") << json_string(r.name) << ": {\"median_ns\": " << json_number(r.median_ns)
+        << ", \"stddev_ns\": " << json_number(r.stddev_ns);
+    if (r.has_hw) {
+      out << ", \"hw_counters\": ";
+      write_hw_counters(out, r.hw);
+    }
+    out << "}";
+  }
+  out << "}}\n";
+  if (!out) throw std::runtime_error("failed appending to " + path);
+}
+
+// --- Scaling check ----------------------------------------------------------
+
+/// Cost of one item (or byte) processed, or 0 when the result reports neither.
+double unit_cost(const Result& r) {
+  if (r.items_per_iteration > 0) return r.median_ns / r.items_per_iteration;
+  if (r.bytes_per_iteration > 0) return r.median_ns / r.bytes_per_iteration;
+  return 0;
+}
+
+double units(const Result& r) {
+  return r.items_per_iteration > 0 ? r.items_per_iteration : r.bytes_per_iteration;
+}
+
+/// For every benchmark with several single-argument instances whose work
+/// grows with the argument, compares the per-item cost at the largest
+/// argument with that at the smallest. Linear code changes by cache effects
+/// only; growth beyond max(10, sqrt(arg ratio)) means the cost per item
+/// depends on n, i.e. an accidentally super-linear path. Returns the number
+/// of offenders, each printed to stderr.
+int check_scaling(const std::vector<Instance>& instances, const std::vector<Result>& results) {
+  std::map<const Benchmark*, std::pair<std::size_t, std::size_t>> extremes;  // smallest, largest arg
+  for (std::size_t i = 0; i < instances.size(); ++i) {
+    const Instance& inst = instances[i];
+    if (inst.args.size() != 1 || inst.args[0] <= 0 || unit_cost(results[i]) <= 0) continue;
+    auto [it, inserted] = extremes.try_emplace(inst.benchmark, i, i);
+    if (inserted) continue;
+    if (inst.args[0] < instances[it->second.first].args[0]) it->second.first = i;
+    if (inst.args[0] > instances[it->second.second].args[0]) it->second.second = i;
+  }
+  int failures = 0;
+  for (const auto& [bm, pair] : extremes) {
+    const auto [lo, hi] = pair;
+    if (lo == hi) continue;
+    const double arg_ratio =
+        static_cast<double>(instances[hi].args[0]) / static_cast<double>(instances[lo].args[0]);
+    const double unit_ratio = units(results[hi]) / units(results[lo]);
+    if (unit_ratio < 0.5 * arg_ratio || unit_ratio > 2.0 * arg_ratio) continue;  // work not proportional to n
+    const double growth = unit_cost(results[hi]) / unit_cost(results[lo]);
+    const double limit = std::max(10.0, std::sqrt(arg_ratio));
+    if (growth > limit) {
+      std::fprintf(stderr, "tcc_bench: %s costs %.1fx more per item than %s (limit %.1fx)\n",
+                   instances[hi].name.c_str(), growth, instances[lo].name.c_str(), limit);
+      ++failures;
+    }
+  }
+  return failures;
+}
+
+}  // namespace
+
+#if !defined(__GNUC__) && !defined(__clang__)
+namespace detail {
+void use_char_pointer(char const volatile*) {}
+}  // namespace detail
+#endif
+
+// --- State ------------------------------------------------------------------
+
+State::State(std::int64_t iterations, std::vector<std::int64_t> args) noexcept
+    : iterations_(iterations), args_(std::move(args)) {}
+
+State::Iterator State::begin() {
+  running_ = true;
+  if (perf_ != nullptr) {
+    perf_->reset();
+    perf_->enable();
+  }
+  start_ns_ = now_ns();
+  return Iterator(this, iterations_);
+}
+
+void State::pause_timing() {
+  if (!running_) return;
+  elapsed_ns_ += now_ns() - start_ns_;
+  if (perf_ != nullptr) perf_->disable();
+  running_ = false;
+}
+
+void State::resume_timing() {
+  if (running_) return;
+  if (perf_ != nullptr) perf_->enable();
+  start_ns_ = now_ns();
+  running_ = true;
+}
+
+void State::finish_timing() { pause_timing(); }
+
+// --- Benchmark --------------------------------------------------------------
+
+Benchmark::Benchmark(std::string name, Function fn) : name_(std::move(name)), fn_(std::move(fn)) {}
+
+Benchmark* Benchmark::arg(std::int64_t value) {
+  arg_sets_.push_back({value});
+  return this;
+}
+
+Benchmark* Benchmark::args(std::vector<std::int64_t> values) {
+  arg_sets_.push_back(std::move(values));
+  return this;
+}
+
+Benchmark* Benchmark::range(std::int64_t lo, std::int64_t hi, std::int64_t mult) {
+  if (lo <= 0 || mult < 2) throw std::invalid_argument("range() needs lo > 0 and mult >= 2");
+  for (std::int64_t v = lo; v < hi; v *= mult) arg(v);
+  return arg(hi);
+}
+
+Benchmark* Benchmark::min_time(double seconds) {
+  min_time_ = seconds;
+  return this;
+}
+
+Benchmark* register_benchmark(std::string name, Function fn) {
+  registry().push_back(std::make_unique<Benchmark>(std::move(name), std::move(fn)));
+  return registry().back().get();
+}
+
+int run_main(int argc, char** argv) {
+  try {
+    const Options opts = parse_options(argc, argv);
+    const std::vector<Instance> instances = instantiate(opts);
+    if (opts.list) {
+      for (const auto& inst : instances) std::printf("%s\n", inst.name.c_str());
+      return 0;
+    }
+
+    std::unique_ptr<PerfCounters> perf;
+    if (opts.perf_counters) {
+      try {
+        perf = std::make_unique<PerfCounters>();
+      } catch (const std::exception& e) {
+        std::fprintf(stderr, "tcc_bench: no hardware counters, timing only: %s\n", e.what());
+      }
+    }
+
+    std::printf("%-44s %12s %12s %12s %12s\n", "benchmark", "iterations", "min", "median", "p99");
+    std::printf("%s\n", std::string(100, '-').c_str());
+    std::vector<Result> results;
+    results.reserve(instances.size());
+    for (const auto& inst : instances) {
+      results.push_back(run_instance(inst, opts, perf.get()));
+      print_result(results.back());
+    }
+    const RunInfo info = run_info();
+    write_json(opts.out, opts, info, results);
+    std::printf("\nwrote %zu results to %s\n", results.size(), opts.out.c_str());
+    if (!opts.history.empty()) {
+      append_history(opts.history, opts, info, results);
+      std::printf("appended run %.12s to %s\n", info.git_sha.c_str(), opts.history.c_str());
+    }
+    if (opts.check_scaling && check_scaling(instances, results) > 0) return 1;
+    return 0;
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "tcc_bench: %s\n", e.what());
+    return 2;
+  }
+}
+
+}  // namespace tcc::bench
@@ -0,0 +1,211 @@
+#pragma once
+
+// Minimal Google-Benchmark-style harness used by tcc_bench.
+//
+//   static void BM_Memcpy(tcc::bench::State& state) {
+//     std::vector<char> src(state.range(0)), dst(state.range(0));
+//     for (auto _ : state) {
+//       std::memcpy(dst.data(), src.data(), src.size());
+//       tcc::bench::ClobberMemory();
+//     }
+//     state.set_bytes_processed(state.iterations() * state.range(0));
+//   }
+//   TCC_BENCHMARK(BM_Memcpy)->range(64, 1 << 20);
+//
+// Each registered instance is warmed up, calibrated to an iteration count
+// that runs for at least --min-time seconds, then timed --repetitions times.
+// The per-repetition ns/iteration samples are summarised as min/median/p99
+// and written, together with the raw samples, to bench_output.txt as JSON.
+// With --perf-counters the timed region also counts cycles, instructions,
+// cache misses and branch misses (perf_counters.hpp), reported per
+// iteration next to the times.
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace tcc::bench {
+
+class PerfCounters;
+
+// --- Optimization barriers --------------------------------------------------
+
+#if defined(__GNUC__) || defined(__clang__)
+
+/// Forces `value` to be materialised, so the computation producing it cannot
+/// be elided. The optimizer must also assume `value` was read and modified.
+template <class T>
+inline __attribute__((always_inline)) void DoNotOptimize(T const& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+template <class T>
+inline __attribute__((always_inline)) void DoNotOptimize(T& value) {
+  if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void*)) {
+    asm volatile("" : "+r,m"(value) : : "memory");
+  } else {
+    asm volatile("" : "+m,r"(value) : : "memory");
+  }
+}
+
+/// Acts as a compiler-level read/write barrier for all memory: pending stores
+/// must be emitted and later loads cannot be served from registers.
+inline __attribute__((always_inline)) void ClobberMemory() {
+  asm volatile("" : : : "memory");
+}
+
+#else
+
+namespace detail {
+void use_char_pointer(char const volatile*);
+}  // namespace detail
+
+template <class T>
+inline void DoNotOptimize(T const& value) {
+  detail::use_char_pointer(&reinterpret_cast<char const volatile&>(value));
+  _ReadWriteBarrier();
+}
+
+inline void ClobberMemory() { _ReadWriteBarrier(); }
+
+#endif
+
+// --- State ------------------------------------------------------------------
+
+/// Per-run state handed to a benchmark function. The function must iterate
+/// over it exactly once (`for (auto _ : state)`); only the loop is timed.
+class State {
+ public:
+  struct [[maybe_unused]] Value {};
+
+  class Iterator {
+   public:
+    Value operator*() const noexcept { return {}; }
+    Iterator& operator++() noexcept {
+      --remaining_;
+      return *this;
+    }
+    bool operator!=(const Iterator&) noexcept {
+      if (remaining_ != 0) [[likely]] {
+        return true;
+      }
+      parent_->finish_timing();
+      return false;
+    }
+
+   private:
+    friend class State;
+    Iterator(State* parent, std::int64_t remaining) noexcept
+        : parent_(parent), remaining_(remaining) {}
+
+    State* parent_;
+    std::int64_t remaining_;
+  };
+
+  State(std::int64_t iterations, std::vector<std::int64_t> args) noexcept;
+
+  Iterator begin();
+  Iterator end() noexcept { return Iterator(this, 0); }
+
+  /// Argument `index` of this instance, as registered through arg()/range().
+  std::int64_t range(std::size_t index = 0) const { return args_.at(index); }
+  std::int64_t iterations() const noexcept { return iterations_; }
+
+  /// Excludes setup work inside the loop from the measurement.
+  void pause_timing();
+  void resume_timing();
+
+  /// Totals over all iterations; reported as items/s and bytes/s.
+  void set_items_processed(std::int64_t items) noexcept { items_processed_ = items; }
+  void set_bytes_processed(std::int64_t bytes) noexcept { bytes_processed_ = bytes; }
+
+  /// Free-form per-run values, averaged across repetitions in the report.
+  std::map<std::string, double> counters;
+
+  // Harness-side accessors.
+  double elapsed_seconds() const noexcept { return elapsed_ns_ * 1e-9; }
+  std::int64_t items_processed() const noexcept { return items_processed_; }
+  std::int64_t bytes_processed() const noexcept { return bytes_processed_; }
+  /// Counts hardware events while the timer runs; the harness reads them.
+  void count_events(PerfCounters* perf) noexcept { perf_ = perf; }
+
+ private:
+  void finish_timing();
+
+  std::int64_t iterations_;
+  std::vector<std::int64_t> args_;
+  std::int64_t start_ns_ = 0;
+  std::int64_t elapsed_ns_ = 0;
+  bool running_ = false;
+  PerfCounters* perf_ = nullptr;
+  std::int64_t items_processed_ = 0;
+  std::int64_t bytes_processed_ = 0;
+};
+
+// --- Registration -----------------------------------------------------------
+
+using Function = std::function<void(State&)>;
+
+/// A registered benchmark and the argument sets it is instantiated with.
+class Benchmark {
+ public:
+  Benchmark(std::string name, Function fn);
+
+  /// Adds one instance taking a single argument.
+  Benchmark* arg(std::int64_t value);
+  /// Adds one instance taking several arguments (state.range(0..n-1)).
+  Benchmark* args(std::vector<std::int64_t> values);
+  /// Adds instances for lo, lo*mult, ... up to and including hi.
+  Benchmark* range(std::int64_t lo, std::int64_t hi, std::int64_t mult = 8);
+  /// Overrides the global --min-time for this benchmark.
+  Benchmark* min_time(double seconds);
+
+  const std::string& name() const noexcept { return name_; }
+  const Function& function() const noexcept { return fn_; }
+  const std::vector<std::vector<std::int64_t>>& arg_sets() const noexcept { return arg_sets_; }
+  double min_time() const noexcept { return min_time_; }
+
+ private:
+  std::string name_;
+  Function fn_;
+  std::vector<std::vector<std::int64_t>> arg_sets_;
+  double min_time_ = 0.0;
+};
+
+Benchmark* register_benchmark(std::string name, Function fn);
+
+/// Runs every registered benchmark using the command line options below and
+/// returns the process exit code.
+///
+///   --filter=<regex>     only run benchmarks whose full name matches
+///   --repetitions=<n>    timed samples per benchmark (default 10)
+///   --min-time=<s>       minimum duration of one sample (default 0.02)
+///   --warmup=<s>         untimed warmup per benchmark (default 0.02)
+///   --out=<path>         JSON report path (default bench_output.txt)
+///   --perf-counters      also count hardware events per iteration; warns
+///                        and carries on with times only where the kernel
+///                        or the VM gives no access to the PMU
+///   --history=<path>     append a one-line summary of the run, keyed by
+///                        git SHA and CPU model, to a JSON Lines file
+///   --list               print benchmark names and exit
+///   --check-scaling      exit 1 if per-item cost at a benchmark's largest
+///                        argument exceeds max(10, sqrt(arg ratio)) times
+///                        that at its smallest (the perf-smoke CTest tier)
+int run_main(int argc, char** argv);
+
+}  // namespace tcc::bench
+
+#define TCC_BENCH_CONCAT_IMPL(a, b) a##b
+#define TCC_BENCH_CONCAT(a, b) TCC_BENCH_CONCAT_IMPL(a, b)
+
+/// Registers `fn` under its own name; chain ->arg()/->range() to instantiate.
+#define TCC_BENCHMARK(fn)                                                  \
+  [[maybe_unused]] static ::tcc::bench::Benchmark* TCC_BENCH_CONCAT(       \
+      tcc_bench_registration_, __COUNTER__) = ::tcc::bench::register_benchmark(#fn, fn)
@@ -0,0 +1,207 @@
+#include "json.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace tcc::bench::json {
+
+namespace {
+
+class Parser {
+ public:
+  explicit Parser(std::string_view text) : text_(text) {}
+
+  Value parse_document() {
+    Value v = parse_value();
+    skip_ws();
+    if (pos_ != text_.size()) fail("trailing characters");
+    return v;
+  }
+
+ private:
+  [[noreturn]] void fail(const char* what) const {
+    throw std::runtime_error("json: " + std::string(what) + " at offset " + std::to_string(pos_));
+  }
+
+  void skip_ws() {
+    while (pos_ < text_.size() &&
+           (text_[pos_] == ' ' || text_[pos_] == '\n' || text_[pos_] == '\r' || text_[pos_] == '\t')) {
+      ++pos_;
+    }
+  }
+
+  char peek() {
+    skip_ws();
+    if (pos_ >= text_.size()) fail("unexpected end of input");
+    return text_[pos_];
+  }
+
+  void expect(char c) {
+    if (peek() != c) fail("unexpected character");
+    ++pos_;
+  }
+
+  bool consume_literal(std::string_view lit) {
+    if (text_.substr(pos_, lit.size()) != lit) return false;
+    pos_ += lit.size();
+    return true;
+  }
+
+  Value parse_value() {
+    switch (peek()) {
+      case '{': return parse_object();
+      case '[': return parse_array();
+      case '"': return Value{parse_string()};
+      case 't':
+        if (consume_literal("true")) return Value{true};
+        break;
+      case 'f':
+        if (consume_literal("false")) return Value{false};
+        break;
+      case 'n':
+        if (consume_literal("null")) return Value{nullptr};
+        break;
+      default: return parse_number();
+    }
+    fail("invalid literal");
+  }
+
+  Value parse_object() {
+    expect('{');
+    auto obj = std::make_shared<Object>();
+    if (peek() == '}') {
+      ++pos_;
+      return Value{obj};
+    }
+    for (;;) {
+      if (peek() != '"') fail("expected object key");
+      std::string key = parse_string();
+      expect(':');
+      (*obj)[std::move(key)] = parse_value();
+      if (peek() == ',') {
+        ++pos_;
+        continue;
+      }
+      expect('}');
+      return Value{obj};
+    }
+  }
+
+  Value parse_array() {
+    expect('[');
+    auto arr = std::make_shared<Array>();
+    if (peek() == ']') {
+      ++pos_;
+      return Value{arr};
+    }
+    for (;;) {
+      arr->push_back(parse_value());
+      if (peek() == ',') {
+        ++pos_;
+        continue;
+      }
+      expect(']');
+      return Value{arr};
+    }
+  }
+
+  std::string parse_string() {
+    expect('"');
+    std::string out;
+    while (pos_ < text_.size()) {
+      char c = text_[pos_++];
+      if (c == '"') return out;
+      if (c != '\\') {
+        out += c;
+        continue;
+      }
+      if (pos_ >= text_.size()) break;
+      switch (char e = text_[pos_++]) {
+        case '"': out += '"'; break;
+        case '\\': out += '\\'; break;
+        case '/': out += '/'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        case 'u': {
+          if (pos_ + 4 > text_.size()) fail("truncated \\u escape");
+          const unsigned long cp = std::strtoul(std::string(text_.substr(pos_, 4)).c_str(), nullptr, 16);
+          pos_ += 4;
+          // Reports only escape control characters; anything wider is kept as UTF-8.
+          if (cp < 0x80) {
+            out += static_cast<char>(cp);
+          } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+          } else {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+          }
+          break;
+        }
+        default:
+          (void)e;
+          fail("invalid escape");
+      }
+    }
+    fail("unterminated string");
+  }
+
+  Value parse_number() {
+    const std::string rest(text_.substr(pos_, 64));
+    char* end = nullptr;
+    const double v = std::strtod(rest.c_str(), &end);
+    if (end == rest.c_str()) fail("expected a value");
+    pos_ += static_cast<std::size_t>(end - rest.c_str());
+    return Value{v};
+  }
+
+  std::string_view text_;
+  std::size_t pos_ = 0;
+};
+
+}  // namespace
+
+double Value::number() const {
+  if (!is_number()) throw std::runtime_error("json: value is not a number");
+  return std::get<double>(data);
+}
+
+const std::string& Value::string() const {
+  if (!is_string()) throw std::runtime_error("json: value is not a string");
+  return std::get<std::string>(data);
+}
+
+const Array& Value::array() const {
+  if (!is_array()) throw std::runtime_error("json: value is not an array");
+  return *std::get<std::shared_ptr<Array>>(data);
+}
+
+const Object& Value::object() const {
+  if (!is_object()) throw std::runtime_error("json: value is not an object");
+  return *std::get<std::shared_ptr<Object>>(data);
+}
+
+const Value* Value::find(std::string_view key) const {
+  if (!is_object()) return nullptr;
+  const Object& obj = object();
+  auto it = obj.find(key);
+  return it == obj.end() ? nullptr : &it->second;
+}
+
+Value parse(std::string_view text) { return Parser(text).parse_document(); }
+
+Value parse_file(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) throw std::runtime_error("cannot open " + path);
+  std::ostringstream ss;
+  ss << in.rdbuf();
+  return parse(ss.str());
+}
+
+}  // namespace tcc::bench::json
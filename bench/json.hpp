@@ -0,0 +1,46 @@
+#pragma once
+
+// Just enough JSON to read back the reports tcc_bench writes. Not a general
+// purpose parser: numbers are doubles, and duplicate keys keep the last one.
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace tcc::bench::json {
+
+struct Value;
+using Array = std::vector<Value>;
+using Object = std::map<std::string, Value, std::less<>>;
+
+struct Value {
+  std::variant<std::nullptr_t, bool, double, std::string, std::shared_ptr<Array>,
+               std::shared_ptr<Object>>
+      data = nullptr;
+
+  bool is_null() const noexcept { return std::holds_alternative<std::nullptr_t>(data); }
+  bool is_number() const noexcept { return std::holds_alternative<double>(data); }
+  bool is_string() const noexcept { return std::holds_alternative<std::string>(data); }
+  bool is_array() const noexcept { return std::holds_alternative<std::shared_ptr<Array>>(data); }
+  bool is_object() const noexcept { return std::holds_alternative<std::shared_ptr<Object>>(data); }
+
+  /// Typed accessors; throw std::runtime_error on a type mismatch.
+  double number() const;
+  const std::string& string() const;
+  const Array& array() const;
+  const Object& object() const;
+
+  /// Member lookup; returns nullptr when this is not an object or lacks `key`.
+  const Value* find(std::string_view key) const;
+};
+
+/// Parses `text`; throws std::runtime_error with an offset on malformed input.
+Value parse(std::string_view text);
+
+/// Reads and parses the file at `path`.
+Value parse_file(const std::string& path);
+
+}  // namespace tcc::bench::json
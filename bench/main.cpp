@@ -0,0 +1,3 @@
+#include "harness.hpp"
+
+int main(int argc, char** argv) { return tcc::bench::run_main(argc, argv); }
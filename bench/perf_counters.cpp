@@ -0,0 +1,98 @@
+#include "perf_counters.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace tcc::bench {
+
+HwCounters& HwCounters::operator+=(const HwCounters& other) noexcept {
+  const auto add = [](double& a, double b) { a = a < 0 || b < 0 ? -1.0 : a + b; };
+  add(cycles, other.cycles);
+  add(instructions, other.instructions);
+  add(cache_misses, other.cache_misses);
+  add(branch_misses, other.branch_misses);
+  return *this;
+}
+
+#if defined(__linux__)
+
+namespace {
+
+constexpr std::uint64_t kConfigs[] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                      PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+int open_event(std::uint64_t config, int group_fd) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof attr);
+  attr.size = sizeof attr;
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = group_fd == -1 ? 1 : 0;  // members follow the leader
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC));
+}
+
+}  // namespace
+
+PerfCounters::PerfCounters() {
+  fds_[0] = open_event(kConfigs[0], -1);
+  if (fds_[0] < 0) {
+    const int err = errno;
+    std::string reason = std::strerror(err);
+    if (err == EACCES || err == EPERM) reason += " (see /proc/sys/kernel/perf_event_paranoid)";
+    if (err == ENOENT || err == EOPNOTSUPP) reason += " (no hardware PMU; a VM or container?)";
+    throw std::runtime_error("perf_event_open(cycles): " + reason);
+  }
+  for (int i = 1; i < kEvents; ++i) fds_[i] = open_event(kConfigs[i], fds_[0]);
+}
+
+PerfCounters::~PerfCounters() {
+  for (int fd : fds_) {
+    if (fd >= 0) ::close(fd);
+  }
+}
+
+void PerfCounters::reset() noexcept { ::ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP); }
+void PerfCounters::enable() noexcept { ::ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP); }
+void PerfCounters::disable() noexcept { ::ioctl(fds_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP); }
+
+HwCounters PerfCounters::read() const {
+  // PERF_FORMAT_GROUP layout: nr, time_enabled, time_running, value[nr],
+  // with the values in the order the members were opened.
+  std::uint64_t buf[3 + kEvents] = {};
+  if (::read(fds_[0], buf, sizeof buf) < 0) {
+    throw std::runtime_error(std::string("read(perf group): ") + std::strerror(errno));
+  }
+  const std::uint64_t enabled = buf[1], running = buf[2];
+  const double scale = running > 0 ? static_cast<double>(enabled) / static_cast<double>(running) : 0.0;
+  double values[kEvents];
+  std::uint64_t next = 0;
+  for (int i = 0; i < kEvents; ++i) {
+    values[i] = fds_[i] >= 0 && next < buf[0] ? static_cast<double>(buf[3 + next++]) * scale : -1.0;
+  }
+  return {values[0], values[1], values[2], values[3]};
+}
+
+#else
+
+PerfCounters::PerfCounters() { throw std::runtime_error("hardware counters need Linux perf_event_open"); }
+PerfCounters::~PerfCounters() = default;
+void PerfCounters::reset() noexcept {}
+void PerfCounters::enable() noexcept {}
+void PerfCounters::disable() noexcept {}
+HwCounters PerfCounters::read() const { return {-1.0, -1.0, -1.0, -1.0}; }
+
+#endif
+
+}  // namespace tcc::bench
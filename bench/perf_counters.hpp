@@ -0,0 +1,56 @@
+#pragma once
+
+// Hardware performance counters for tcc_bench, through Linux perf_event_open.
+//
+//   PerfCounters perf;              // throws std::runtime_error if unavailable
+//   perf.reset();
+//   perf.enable();
+//   work();
+//   perf.disable();
+//   HwCounters c = perf.read();     // c.instructions / c.cycles is the IPC
+//
+// The events form one group led by the cycle counter, so the kernel
+// schedules them on the PMU together and their ratios are taken over the
+// same instructions. Only user-space work of the calling thread is counted
+// (exclude_kernel), which perf_event_paranoid <= 2 allows to unprivileged
+// processes. Threads the benchmark hands work to are not counted. When the
+// PMU is shared with other users the group is multiplexed and the values are
+// scaled from the fraction of the enabled time it was actually running.
+//
+// Many VMs and containers expose no PMU, or block the syscall; open fails
+// there and the harness reports wall time only.
+
+#include <string>
+
+namespace tcc::bench {
+
+/// Event totals since the last reset. An event the PMU could not count (the
+/// group still opens without it) is negative.
+struct HwCounters {
+  double cycles = 0;
+  double instructions = 0;
+  double cache_misses = 0;
+  double branch_misses = 0;
+
+  HwCounters& operator+=(const HwCounters& other) noexcept;
+};
+
+class PerfCounters {
+ public:
+  PerfCounters();
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  void reset() noexcept;
+  void enable() noexcept;
+  void disable() noexcept;
+  HwCounters read() const;
+
+ private:
+  static constexpr int kEvents = 4;  // in HwCounters order
+  int fds_[kEvents] = {-1, -1, -1, -1};
+};
+
+}  // namespace tcc::bench
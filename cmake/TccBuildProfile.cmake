@@ -0,0 +1,185 @@
+# Build profile shared by every target in the project.
+#
+#   tcc_apply_build_profile(<target>)
+#       Applies warnings, the tuned Release/RelWithDebInfo flags and, when
+#       enabled, LTO (TCC_ENABLE_LTO), PGO (TCC_PGO), sanitizers
+#       (TCC_SANITIZE), -march=native (TCC_NATIVE_ARCH) and frame pointers
+#       (TCC_FRAME_POINTERS) to <target>, plus section GC from TccLinkage
+#       and the unity/time-trace switches from TccCompileTime.
+#
+#   tcc_print_build_profile()
+#       Prints a one-line summary of the active profile at configure time.
+#
+# PGO is a two-stage workflow:
+#
+#   cmake -B build -DTCC_PGO=generate && cmake --build build
+#   ./build/test_cmake_cpp <representative workload>     # writes profiles
+#   cmake -B build -DTCC_PGO=use && cmake --build build  # rebuilds with them
+#
+# With Clang the raw profiles must be merged between the two stages:
+#   llvm-profdata merge -o ${TCC_PGO_DIR}/default.profdata ${TCC_PGO_DIR}
+
+include_guard(GLOBAL)
+
+include(TccCompileTime)
+include(TccLinkage)
+
+string(TOLOWER "${TCC_PGO}" _tcc_pgo)
+if(NOT _tcc_pgo MATCHES "^(off|generate|use)$")
+  message(FATAL_ERROR "TCC_PGO must be one of off, generate or use (got '${TCC_PGO}')")
+endif()
+
+set(_tcc_gnu_like "$<OR:$<CXX_COMPILER_ID:GNU>,$<CXX_COMPILER_ID:Clang>,$<CXX_COMPILER_ID:AppleClang>>")
+
+# --- LTO --------------------------------------------------------------------
+
+set(TCC_LTO_ACTIVE OFF)
+if(TCC_ENABLE_LTO)
+  include(CheckIPOSupported)
+  check_ipo_supported(RESULT _tcc_ipo_ok OUTPUT _tcc_ipo_msg LANGUAGES CXX)
+  if(_tcc_ipo_ok)
+    set(TCC_LTO_ACTIVE ON)
+  else()
+    message(WARNING "TCC_ENABLE_LTO requested but IPO is not supported: ${_tcc_ipo_msg}")
+  endif()
+endif()
+
+# --- PGO --------------------------------------------------------------------
+
+set(_tcc_pgo_compile "")
+set(_tcc_pgo_link "")
+if(NOT _tcc_pgo STREQUAL "off")
+  file(TO_CMAKE_PATH "${TCC_PGO_DIR}" _tcc_pgo_dir)
+  if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+    if(_tcc_pgo STREQUAL "generate")
+      file(MAKE_DIRECTORY "${_tcc_pgo_dir}")
+      # Atomic counter updates keep profiles of multi-threaded runs consistent.
+      set(_tcc_pgo_compile -fprofile-generate=${_tcc_pgo_dir} -fprofile-update=atomic)
+      set(_tcc_pgo_link -fprofile-generate=${_tcc_pgo_dir})
+    else()
+      if(NOT EXISTS "${_tcc_pgo_dir}")
+        message(WARNING "TCC_PGO=use but ${_tcc_pgo_dir} does not exist; run the generate stage first")
+      endif()
+      set(_tcc_pgo_compile -fprofile-use=${_tcc_pgo_dir} -fprofile-correction -Wno-missing-profile)
+      set(_tcc_pgo_link -fprofile-use=${_tcc_pgo_dir})
+    endif()
+  elseif(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    if(_tcc_pgo STREQUAL "generate")
+      file(MAKE_DIRECTORY "${_tcc_pgo_dir}")
+      set(_tcc_pgo_compile -fprofile-generate=${_tcc_pgo_dir})
+      set(_tcc_pgo_link -fprofile-generate=${_tcc_pgo_dir})
+    else()
+      set(_tcc_profdata "${_tcc_pgo_dir}/default.profdata")
+      if(NOT EXISTS "${_tcc_profdata}")
+        message(FATAL_ERROR
+          "TCC_PGO=use needs ${_tcc_profdata}; merge the raw profiles with\n"
+          "  llvm-profdata merge -o ${_tcc_profdata} ${_tcc_pgo_dir}")
+      endif()
+      set(_tcc_pgo_compile -fprofile-use=${_tcc_profdata} -Wno-profile-instr-unprofiled)
+      set(_tcc_pgo_link -fprofile-use=${_tcc_profdata})
+    endif()
+  else()
+    message(WARNING "TCC_PGO is not implemented for ${CMAKE_CXX_COMPILER_ID}; ignoring")
+    set(_tcc_pgo "off")
+  endif()
+endif()
+
+# --- Sanitizers, native tuning, frame pointers ------------------------------
+
+set(_tcc_sanitize "")
+foreach(_san IN LISTS TCC_SANITIZE)
+  string(TOLOWER "${_san}" _san)
+  if(NOT _san MATCHES "^(address|thread|undefined|fuzzer)$")
+    message(FATAL_ERROR "TCC_SANITIZE entries must be address, thread, undefined or fuzzer (got '${_san}')")
+  endif()
+  list(APPEND _tcc_sanitize ${_san})
+endforeach()
+if("thread" IN_LIST _tcc_sanitize AND "address" IN_LIST _tcc_sanitize)
+  message(FATAL_ERROR "TCC_SANITIZE: thread and address cannot be combined")
+endif()
+
+set(_tcc_extra_compile "")
+set(_tcc_extra_link "")
+# fuzzer: libFuzzer coverage instrumentation for every target; the
+# tcc_fuzz_* binaries add the libFuzzer main (fuzz/CMakeLists.txt).
+if("fuzzer" IN_LIST _tcc_sanitize AND NOT CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+  message(FATAL_ERROR "TCC_SANITIZE=fuzzer needs Clang (libFuzzer)")
+endif()
+set(TCC_LIBFUZZER OFF)
+if("fuzzer" IN_LIST _tcc_sanitize)
+  set(TCC_LIBFUZZER ON)
+endif()
+
+if(_tcc_sanitize)
+  if(CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang")
+    string(REPLACE ";" "," _san_list "${_tcc_sanitize}")
+    string(REPLACE "fuzzer" "fuzzer-no-link" _san_list "${_san_list}")
+    # Sanitizer reports want full stacks; UB findings fail the run.
+    list(APPEND _tcc_extra_compile -fsanitize=${_san_list} -fno-omit-frame-pointer -fno-sanitize-recover=all)
+    list(APPEND _tcc_extra_link -fsanitize=${_san_list})
+  elseif(MSVC AND _tcc_sanitize STREQUAL "address")
+    list(APPEND _tcc_extra_compile /fsanitize=address)
+  else()
+    message(FATAL_ERROR "TCC_SANITIZE=${TCC_SANITIZE} is not supported with ${CMAKE_CXX_COMPILER_ID}")
+  endif()
+endif()
+
+if(TCC_NATIVE_ARCH)
+  if(CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang")
+    list(APPEND _tcc_extra_compile -march=native)
+  else()
+    message(WARNING "TCC_NATIVE_ARCH is not implemented for ${CMAKE_CXX_COMPILER_ID}; ignoring")
+  endif()
+endif()
+
+if(TCC_FRAME_POINTERS AND CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang")
+  list(APPEND _tcc_extra_compile -fno-omit-frame-pointer)
+  if(CMAKE_SYSTEM_PROCESSOR MATCHES "x86_64|AMD64|aarch64|arm64")
+    list(APPEND _tcc_extra_compile -mno-omit-leaf-frame-pointer)
+  endif()
+endif()
+
+# --- Per-target application -------------------------------------------------
+
+function(tcc_apply_build_profile target)
+  target_compile_options(${target} PRIVATE
+    $<$<CXX_COMPILER_ID:MSVC>:/W4 /permissive->
+    $<${_tcc_gnu_like}:-Wall -Wextra>
+    # CMake's RelWithDebInfo defaults to -O2; profile the code we ship.
+    $<$<AND:${_tcc_gnu_like},$<CONFIG:RelWithDebInfo>>:-O3>
+    $<$<AND:$<CXX_COMPILER_ID:MSVC>,$<CONFIG:Release,RelWithDebInfo>>:/O2 /Ob3>)
+
+  if(TCC_LTO_ACTIVE)
+    set_property(TARGET ${target} PROPERTY INTERPROCEDURAL_OPTIMIZATION ON)
+  endif()
+
+  if(_tcc_pgo_compile)
+    target_compile_options(${target} PRIVATE ${_tcc_pgo_compile})
+    target_link_options(${target} PRIVATE ${_tcc_pgo_link})
+  endif()
+
+  tcc_apply_section_gc(${target})
+  tcc_apply_compile_time(${target})
+
+  if(_tcc_extra_compile)
+    target_compile_options(${target} PRIVATE ${_tcc_extra_compile})
+  endif()
+  if(_tcc_extra_link)
+    target_link_options(${target} PRIVATE ${_tcc_extra_link})
+  endif()
+endfunction()
+
+function(tcc_print_build_profile)
+  if(CMAKE_CONFIGURATION_TYPES)
+    set(_config "multi-config")
+  else()
+    set(_config "${CMAKE_BUILD_TYPE}")
+  endif()
+  if(_tcc_sanitize)
+    string(REPLACE ";" "," _san "${_tcc_sanitize}")
+  else()
+    set(_san "none")
+  endif()
+  message(STATUS "tcc: build=${_config} lto=${TCC_LTO_ACTIVE} pgo=${_tcc_pgo} sanitize=${_san}"
+    " native=${TCC_NATIVE_ARCH} frame-pointers=${TCC_FRAME_POINTERS}")
+endfunction()
@@ -0,0 +1,115 @@
+# Build-throughput switches.
+#
+#   tcc_apply_compile_time(<target>)
+#       Unity build (TCC_UNITY_BUILD) and per-TU compile-time reports
+#       (TCC_TIME_TRACE). Applied by tcc_apply_build_profile.
+#
+#   tcc_precompile_headers(<target> [<header>...])
+#       Precompiles the heavy standard headers, plus the given ones, into
+#       <target> when TCC_PRECOMPILE_HEADERS is ON.
+#
+#   tcc_add_module_library()
+#       With TCC_USE_MODULES=ON, adds test_cmake_cpp_module (tcc::module),
+#       which exports the public headers as the named module `tcc`
+#       (src/module/tcc.cppm). Experimental: needs CMake 3.28, a Ninja or
+#       Visual Studio generator and GCC 14, Clang 16 or MSVC 19.34.
+#
+#   tcc_print_compile_time()
+#       Prints the active switches at configure time.
+#
+# Sources compiled with their own flags (the per-ISA tcc::simd kernels)
+# are kept out of both the unity batches and the precompiled header.
+#
+# TCC_TIME_TRACE writes a Chrome trace JSON next to each object file with
+# Clang (-ftime-trace; open in ui.perfetto.dev). GCC has no equivalent
+# and prints -ftime-report tables to the build log instead.
+
+include_guard(GLOBAL)
+
+option(TCC_UNITY_BUILD "Compile each target as a few batched unity sources" OFF)
+option(TCC_PRECOMPILE_HEADERS "Precompile the heavy standard headers" OFF)
+option(TCC_TIME_TRACE "Emit per-translation-unit compile-time reports" OFF)
+option(TCC_USE_MODULES "Experimental: also build the library as the C++20 named module 'tcc'" OFF)
+
+set(TCC_UNITY_BATCH_SIZE "8" CACHE STRING "Sources per unity batch when TCC_UNITY_BUILD is ON")
+
+set(_tcc_pch_headers
+  <algorithm>
+  <atomic>
+  <chrono>
+  <condition_variable>
+  <coroutine>
+  <cstddef>
+  <cstdint>
+  <cstring>
+  <filesystem>
+  <functional>
+  <memory>
+  <mutex>
+  <optional>
+  <span>
+  <string>
+  <string_view>
+  <thread>
+  <tuple>
+  <type_traits>
+  <utility>
+  <vector>)
+
+function(tcc_apply_compile_time target)
+  if(TCC_UNITY_BUILD)
+    set_target_properties(${target} PROPERTIES
+      UNITY_BUILD ON
+      UNITY_BUILD_BATCH_SIZE ${TCC_UNITY_BATCH_SIZE})
+  endif()
+  if(TCC_TIME_TRACE)
+    if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+      target_compile_options(${target} PRIVATE -ftime-trace)
+    elseif(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+      target_compile_options(${target} PRIVATE -ftime-report)
+    elseif(MSVC)
+      target_compile_options(${target} PRIVATE /Bt+)
+    endif()
+  endif()
+endfunction()
+
+function(tcc_precompile_headers target)
+  if(TCC_PRECOMPILE_HEADERS)
+    target_precompile_headers(${target} PRIVATE ${_tcc_pch_headers} ${ARGN})
+  endif()
+endfunction()
+
+function(tcc_add_module_library)
+  if(NOT TCC_USE_MODULES)
+    return()
+  endif()
+  if(CMAKE_VERSION VERSION_LESS 3.28)
+    message(FATAL_ERROR "TCC_USE_MODULES needs CMake 3.28 or newer (this is ${CMAKE_VERSION})")
+  endif()
+  if(NOT CMAKE_GENERATOR MATCHES "Ninja|Visual Studio")
+    message(FATAL_ERROR "TCC_USE_MODULES needs a Ninja or Visual Studio generator (got ${CMAKE_GENERATOR})")
+  endif()
+  if((CMAKE_CXX_COMPILER_ID STREQUAL "GNU" AND CMAKE_CXX_COMPILER_VERSION VERSION_LESS 14)
+     OR (CMAKE_CXX_COMPILER_ID STREQUAL "Clang" AND CMAKE_CXX_COMPILER_VERSION VERSION_LESS 16))
+    message(FATAL_ERROR
+      "TCC_USE_MODULES: ${CMAKE_CXX_COMPILER_ID} ${CMAKE_CXX_COMPILER_VERSION} cannot re-export "
+      "header declarations from a module; use GCC 14, Clang 16 or MSVC 19.34 or newer")
+  endif()
+
+  add_library(test_cmake_cpp_module)
+  add_library(tcc::module ALIAS test_cmake_cpp_module)
+  target_sources(test_cmake_cpp_module
+    PUBLIC FILE_SET CXX_MODULES BASE_DIRS "${PROJECT_SOURCE_DIR}/src/module"
+      FILES "${PROJECT_SOURCE_DIR}/src/module/tcc.cppm")
+  target_compile_features(test_cmake_cpp_module PUBLIC cxx_std_20)
+  target_link_libraries(test_cmake_cpp_module PUBLIC test_cmake_cpp)
+  target_compile_definitions(test_cmake_cpp_module PRIVATE
+    TCC_MODULE_HAVE_COMPRESSION=$<BOOL:${TCC_COMPRESSION_AVAILABLE}>
+    TCC_MODULE_HAVE_IO=$<BOOL:${TCC_IO_AVAILABLE}>)
+  tcc_apply_build_profile(test_cmake_cpp_module)
+endfunction()
+
+function(tcc_print_compile_time)
+  message(STATUS "tcc: unity=${TCC_UNITY_BUILD} pch=${TCC_PRECOMPILE_HEADERS} time-trace=${TCC_TIME_TRACE}"
+    " modules=${TCC_USE_MODULES}")
+endfunction()
@@ -0,0 +1,68 @@
+# Sources of tcc::CompressStream / DecompressStream / FrameReader.
+#
+#   tcc_add_compression_sources(<target>)
+#       Adds the frame streams and block codecs to <target> when
+#       TCC_WITH_COMPRESSION is ON. liblz4 and libzstd are linked when their
+#       headers and libraries are found; without liblz4 a built-in encoder of
+#       the LZ4 block format is used, without libzstd Codec::zstd is
+#       unavailable.
+
+include_guard(GLOBAL)
+
+option(TCC_WITH_COMPRESSION "Build the block-parallel compression streams (tcc/compression.hpp)" ON)
+
+set(TCC_COMPRESSION_AVAILABLE OFF)
+set(TCC_COMPRESSION_CODECS "")
+if(TCC_WITH_COMPRESSION)
+  set(TCC_COMPRESSION_AVAILABLE ON)
+  find_path(TCC_LZ4_INCLUDE_DIR lz4.h)
+  find_library(TCC_LZ4_LIBRARY lz4)
+  find_path(TCC_ZSTD_INCLUDE_DIR zstd.h)
+  find_library(TCC_ZSTD_LIBRARY zstd)
+  mark_as_advanced(TCC_LZ4_INCLUDE_DIR TCC_LZ4_LIBRARY TCC_ZSTD_INCLUDE_DIR TCC_ZSTD_LIBRARY)
+  if(TCC_LZ4_INCLUDE_DIR AND TCC_LZ4_LIBRARY)
+    list(APPEND TCC_COMPRESSION_CODECS "lz4(liblz4)")
+  else()
+    list(APPEND TCC_COMPRESSION_CODECS "lz4(built-in)")
+  endif()
+  if(TCC_ZSTD_INCLUDE_DIR AND TCC_ZSTD_LIBRARY)
+    list(APPEND TCC_COMPRESSION_CODECS "zstd")
+  endif()
+endif()
+
+set(_tcc_compression_dir "${PROJECT_SOURCE_DIR}/src/compression")
+
+function(tcc_add_compression_sources target)
+  if(NOT TCC_COMPRESSION_AVAILABLE)
+    return()
+  endif()
+  target_sources(${target} PRIVATE
+    "${_tcc_compression_dir}/codec.cpp"
+    "${_tcc_compression_dir}/lz4_block.cpp"
+    "${_tcc_compression_dir}/stream.cpp")
+  set(_defs "")
+  if(TCC_LZ4_INCLUDE_DIR AND TCC_LZ4_LIBRARY)
+    list(APPEND _defs TCC_COMPRESSION_HAVE_LZ4)
+    target_include_directories(${target} PRIVATE "${TCC_LZ4_INCLUDE_DIR}")
+    target_link_libraries(${target} PRIVATE "${TCC_LZ4_LIBRARY}")
+  endif()
+  if(TCC_ZSTD_INCLUDE_DIR AND TCC_ZSTD_LIBRARY)
+    list(APPEND _defs TCC_COMPRESSION_HAVE_ZSTD)
+    target_include_directories(${target} PRIVATE "${TCC_ZSTD_INCLUDE_DIR}")
+    target_link_libraries(${target} PRIVATE "${TCC_ZSTD_LIBRARY}")
+  endif()
+  if(_defs)
+    set_source_files_properties("${_tcc_compression_dir}/codec.cpp" PROPERTIES
+      COMPILE_DEFINITIONS "${_defs}"
+      SKIP_UNITY_BUILD_INCLUSION ON)
+  endif()
+endfunction()
+
+function(tcc_print_compression_codecs)
+  if(NOT TCC_COMPRESSION_AVAILABLE)
+    message(STATUS "tcc: compression=off")
+  else()
+    string(REPLACE ";" "," _codecs "${TCC_COMPRESSION_CODECS}")
+    message(STATUS "tcc: compression codecs=${_codecs}")
+  endif()
+endfunction()
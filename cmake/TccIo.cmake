@@ -0,0 +1,52 @@
+# Sources of tcc::io (Linux only).
+#
+#   tcc_add_io_sources(<target>)
+#       Adds the Ring front end and the epoll/thread-pool fallback backend to
+#       <target>, plus the io_uring backend when TCC_WITH_IO_URING is ON and
+#       <linux/io_uring.h> is available. The io_uring backend uses the kernel
+#       ABI directly, so liburing is not required.
+
+include_guard(GLOBAL)
+include(CheckIncludeFileCXX)
+
+option(TCC_WITH_IO_URING "Build the io_uring backend of tcc::io::Ring" ON)
+
+set(TCC_IO_AVAILABLE OFF)
+set(TCC_IO_URING_ACTIVE OFF)
+if(CMAKE_SYSTEM_NAME STREQUAL "Linux")
+  set(TCC_IO_AVAILABLE ON)
+  if(TCC_WITH_IO_URING)
+    check_include_file_cxx(linux/io_uring.h TCC_HAVE_LINUX_IO_URING_H)
+    if(TCC_HAVE_LINUX_IO_URING_H)
+      set(TCC_IO_URING_ACTIVE ON)
+    else()
+      message(STATUS "tcc: <linux/io_uring.h> not found; tcc::io uses the fallback backend only")
+    endif()
+  endif()
+endif()
+
+set(_tcc_io_dir "${PROJECT_SOURCE_DIR}/src/io")
+
+function(tcc_add_io_sources target)
+  if(NOT TCC_IO_AVAILABLE)
+    return()
+  endif()
+  target_sources(${target} PRIVATE
+    "${_tcc_io_dir}/ring.cpp"
+    "${_tcc_io_dir}/fallback_backend.cpp")
+  if(TCC_IO_URING_ACTIVE)
+    target_sources(${target} PRIVATE "${_tcc_io_dir}/uring_backend.cpp")
+    set_source_files_properties("${_tcc_io_dir}/ring.cpp" PROPERTIES
+      COMPILE_DEFINITIONS TCC_IO_HAVE_URING)
+  endif()
+endfunction()
+
+function(tcc_print_io_backends)
+  if(NOT TCC_IO_AVAILABLE)
+    message(STATUS "tcc: io=unavailable (Linux only)")
+  elseif(TCC_IO_URING_ACTIVE)
+    message(STATUS "tcc: io backends=io_uring,fallback")
+  else()
+    message(STATUS "tcc: io backends=fallback")
+  endif()
+endfunction()
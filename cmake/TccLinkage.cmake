@@ -0,0 +1,77 @@
+# Static/shared linkage of the core library and its exported-symbol set.
+#
+#   tcc_configure_linkage(<target>)
+#       Builds <target> with hidden visibility (-fvisibility=hidden
+#       -fvisibility-inlines-hidden) and generates
+#       <build>/include/tcc/export.hpp, whose TCC_API marks the public API.
+#       Shared builds (BUILD_SHARED_LIBS=ON) export only TCC_API symbols and
+#       link with -Wl,-O1,--hash-style=gnu; TCC_NO_SEMANTIC_INTERPOSITION
+#       adds -fno-semantic-interposition so calls inside the library bind
+#       locally and can be inlined.
+#
+#   tcc_apply_section_gc(<target>)
+#       Per-function/data sections and --gc-sections, so unreferenced code
+#       is dropped at link time. Applied by tcc_apply_build_profile.
+#
+#   tcc_print_linkage()
+#       Prints the active linkage at configure time.
+
+include_guard(GLOBAL)
+
+include(GenerateExportHeader)
+
+option(TCC_NO_SEMANTIC_INTERPOSITION
+  "Shared builds: compile with -fno-semantic-interposition (no LD_PRELOAD overriding of internal calls)" OFF)
+
+set(_tcc_elf_gnu_like OFF)
+if(CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang" AND NOT APPLE AND NOT WIN32)
+  set(_tcc_elf_gnu_like ON)
+endif()
+
+function(tcc_configure_linkage target)
+  set_target_properties(${target} PROPERTIES
+    CXX_VISIBILITY_PRESET hidden
+    VISIBILITY_INLINES_HIDDEN ON)
+
+  set(_export_dir "${PROJECT_BINARY_DIR}/include")
+  generate_export_header(${target}
+    BASE_NAME tcc
+    EXPORT_MACRO_NAME TCC_API
+    EXPORT_FILE_NAME "${_export_dir}/tcc/export.hpp")
+  target_include_directories(${target} PUBLIC $<BUILD_INTERFACE:${_export_dir}>)
+
+  get_target_property(_type ${target} TYPE)
+  if(_type STREQUAL "SHARED_LIBRARY")
+    set_target_properties(${target} PROPERTIES
+      VERSION ${PROJECT_VERSION}
+      SOVERSION ${PROJECT_VERSION_MAJOR})
+    if(_tcc_elf_gnu_like)
+      target_link_options(${target} PRIVATE LINKER:-O1 LINKER:--hash-style=gnu)
+      if(TCC_NO_SEMANTIC_INTERPOSITION)
+        target_compile_options(${target} PRIVATE -fno-semantic-interposition)
+      endif()
+    endif()
+  else()
+    # generate_export_header's macros assume a DLL unless told otherwise.
+    target_compile_definitions(${target} PUBLIC TCC_STATIC_DEFINE)
+  endif()
+endfunction()
+
+function(tcc_apply_section_gc target)
+  if(NOT _tcc_elf_gnu_like)
+    return()
+  endif()
+  target_compile_options(${target} PRIVATE -ffunction-sections -fdata-sections)
+  get_target_property(_type ${target} TYPE)
+  if(_type MATCHES "^(EXECUTABLE|SHARED_LIBRARY|MODULE_LIBRARY)$")
+    target_link_options(${target} PRIVATE LINKER:--gc-sections)
+  endif()
+endfunction()
+
+function(tcc_print_linkage)
+  if(BUILD_SHARED_LIBS)
+    message(STATUS "tcc: library=shared visibility=hidden no-semantic-interposition=${TCC_NO_SEMANTIC_INTERPOSITION}")
+  else()
+    message(STATUS "tcc: library=static visibility=hidden")
+  endif()
+endfunction()
@@ -0,0 +1,80 @@
+# The Rust half of tcc::rust (rust/, a Cargo staticlib).
+#
+#   tcc_add_rust_sources(<target>)
+#       When TCC_WITH_RUST is ON and cargo is found, builds rust/ with
+#       `cargo build --offline` (release profile, dev profile for Debug) into
+#       <build>/rust, adds the C++ wrappers in src/rust and links the static
+#       library into <target>. Shared builds keep the crate's symbols, Rust's
+#       std included, out of the dynamic symbol table.
+#
+#   tcc_print_rust()
+#       Prints whether the crate is linked.
+
+include_guard(GLOBAL)
+
+option(TCC_WITH_RUST "Build the Rust crate in rust/ and link it into test_cmake_cpp (needs cargo)" ON)
+
+set(TCC_RUST_AVAILABLE OFF)
+if(TCC_WITH_RUST)
+  find_program(TCC_CARGO cargo HINTS "$ENV{CARGO_HOME}/bin" "$ENV{HOME}/.cargo/bin")
+  mark_as_advanced(TCC_CARGO)
+  if(TCC_CARGO)
+    set(TCC_RUST_AVAILABLE ON)
+  else()
+    message(STATUS "tcc: cargo not found; tcc::rust is not built")
+  endif()
+endif()
+
+set(_tcc_rust_crate_dir "${PROJECT_SOURCE_DIR}/rust")
+set(_tcc_rust_src_dir "${PROJECT_SOURCE_DIR}/src/rust")
+
+function(tcc_add_rust_sources target)
+  if(NOT TCC_RUST_AVAILABLE)
+    return()
+  endif()
+  set(_target_dir "${PROJECT_BINARY_DIR}/rust")
+  set(_lib "${CMAKE_STATIC_LIBRARY_PREFIX}tcc_rs${CMAKE_STATIC_LIBRARY_SUFFIX}")
+
+  # Cargo tracks its own inputs, so the step always runs and is a no-op when
+  # nothing changed.
+  add_custom_target(tcc_rs_cargo
+    COMMAND "${TCC_CARGO}" build --offline --quiet
+            --manifest-path "${_tcc_rust_crate_dir}/Cargo.toml"
+            --target-dir "${_target_dir}"
+            $<$<NOT:$<CONFIG:Debug>>:--release>
+    BYPRODUCTS "${_target_dir}/$<IF:$<CONFIG:Debug>,debug,release>/${_lib}"
+    WORKING_DIRECTORY "${_tcc_rust_crate_dir}"
+    COMMENT "Building the tcc_rs crate with cargo"
+    VERBATIM)
+
+  # What `rustc --print native-static-libs` reports for a std staticlib.
+  if(WIN32)
+    set(_native ws2_32 userenv ntdll bcrypt advapi32)
+  elseif(APPLE)
+    set(_native "")
+  else()
+    set(_native Threads::Threads ${CMAKE_DL_LIBS} m rt util)
+  endif()
+
+  add_library(tcc_rs STATIC IMPORTED)
+  set_target_properties(tcc_rs PROPERTIES
+    IMPORTED_LOCATION "${_target_dir}/release/${_lib}"
+    IMPORTED_LOCATION_DEBUG "${_target_dir}/debug/${_lib}"
+    INTERFACE_LINK_LIBRARIES "${_native}")
+  add_dependencies(tcc_rs tcc_rs_cargo)
+
+  target_sources(${target} PRIVATE "${_tcc_rust_src_dir}/interop.cpp")
+  target_link_libraries(${target} PRIVATE tcc_rs)
+  get_target_property(_type ${target} TYPE)
+  if(_type STREQUAL "SHARED_LIBRARY" AND CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang" AND NOT APPLE AND NOT WIN32)
+    target_link_options(${target} PRIVATE "LINKER:--exclude-libs,${_lib}")
+  endif()
+endfunction()
+
+function(tcc_print_rust)
+  if(TCC_RUST_AVAILABLE)
+    message(STATUS "tcc: rust=${TCC_CARGO}")
+  else()
+    message(STATUS "tcc: rust=off")
+  endif()
+endfunction()
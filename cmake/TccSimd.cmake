@@ -0,0 +1,93 @@
+# Per-ISA kernel sources for tcc::simd.
+#
+#   tcc_add_simd_sources(<target>)
+#       Adds src/simd/*.cpp to <target>. Each ISA level lives in its own
+#       translation unit compiled with that level's flags only; the rest of
+#       the target keeps the baseline ISA, and src/simd/dispatch.cpp picks a
+#       level at startup. A level is skipped when the compiler rejects its
+#       flags, so the same sources build with old toolchains too.
+#
+# TCC_SIMD_ENABLE_AVX512 drops the AVX-512 level (e.g. for fleets where its
+# frequency licence costs more than it gains).
+
+include_guard(GLOBAL)
+include(CheckCXXCompilerFlag)
+
+option(TCC_SIMD_ENABLE_AVX512 "Compile the AVX-512 level of tcc::simd" ON)
+
+set(_tcc_simd_dir "${PROJECT_SOURCE_DIR}/src/simd")
+
+if(CMAKE_SYSTEM_PROCESSOR MATCHES "^(x86_64|AMD64|amd64|i[3-6]86|x86)$")
+  set(_tcc_simd_arch x86)
+elseif(CMAKE_SYSTEM_PROCESSOR MATCHES "^(aarch64|arm64|ARM64)$")
+  set(_tcc_simd_arch arm64)
+else()
+  set(_tcc_simd_arch none)
+endif()
+
+# Reductions must round the same way on every level: no FMA contraction.
+if(MSVC)
+  set(_tcc_simd_common_flags /fp:precise)
+else()
+  set(_tcc_simd_common_flags -ffp-contract=off)
+endif()
+
+# _tcc_simd_level(<define> <file> <gnu flags> <msvc flags>)
+macro(_tcc_simd_level define file gnu_flags msvc_flags)
+  if(MSVC)
+    set(_flags ${msvc_flags})
+  else()
+    set(_flags ${gnu_flags})
+  endif()
+  string(REPLACE ";" " " _flags_str "${_flags}")
+  string(MAKE_C_IDENTIFIER "TCC_SIMD_FLAGS_${define}" _check_var)
+  if(_flags_str STREQUAL "")
+    set(${_check_var} ON)
+  else()
+    check_cxx_compiler_flag("${_flags_str}" ${_check_var})
+  endif()
+  if(${_check_var})
+    list(APPEND _tcc_simd_sources "${_tcc_simd_dir}/${file}")
+    list(APPEND _tcc_simd_defines ${define})
+    set(_opts ${_flags} ${_tcc_simd_common_flags})
+    set_source_files_properties("${_tcc_simd_dir}/${file}" PROPERTIES
+      COMPILE_OPTIONS "${_opts}"
+      SKIP_UNITY_BUILD_INCLUSION ON
+      SKIP_PRECOMPILE_HEADERS ON)
+  endif()
+endmacro()
+
+set(_tcc_simd_sources "${_tcc_simd_dir}/scalar.cpp")
+set(_tcc_simd_defines "")
+set_source_files_properties("${_tcc_simd_dir}/scalar.cpp" PROPERTIES
+  COMPILE_OPTIONS "${_tcc_simd_common_flags}"
+  SKIP_UNITY_BUILD_INCLUSION ON
+  SKIP_PRECOMPILE_HEADERS ON)
+
+if(_tcc_simd_arch STREQUAL "x86")
+  # MSVC has no SSE4.2-only switch; its x64 baseline plus /arch:AVX is the
+  # closest match that still keeps the level distinct from AVX2.
+  _tcc_simd_level(TCC_SIMD_HAVE_SSE42 sse42.cpp "-msse4.2;-mpopcnt" "")
+  _tcc_simd_level(TCC_SIMD_HAVE_AVX2 avx2.cpp "-mavx2;-mbmi;-mbmi2" "/arch:AVX2")
+  if(TCC_SIMD_ENABLE_AVX512)
+    _tcc_simd_level(TCC_SIMD_HAVE_AVX512 avx512.cpp
+      "-mavx512f;-mavx512bw;-mavx512vl;-mpopcnt;-mbmi2" "/arch:AVX512")
+  endif()
+elseif(_tcc_simd_arch STREQUAL "arm64")
+  _tcc_simd_level(TCC_SIMD_HAVE_NEON neon.cpp "" "")
+endif()
+
+function(tcc_add_simd_sources target)
+  target_sources(${target} PRIVATE ${_tcc_simd_sources} "${_tcc_simd_dir}/dispatch.cpp")
+  set_source_files_properties("${_tcc_simd_dir}/dispatch.cpp" PROPERTIES
+    COMPILE_DEFINITIONS "${_tcc_simd_defines}"
+    SKIP_UNITY_BUILD_INCLUSION ON)
+endfunction()
+
+function(tcc_print_simd_levels)
+  string(REPLACE "TCC_SIMD_HAVE_" "" _levels "${_tcc_simd_defines}")
+  string(TOLOWER "${_levels}" _levels)
+  list(PREPEND _levels scalar)
+  string(REPLACE ";" "," _levels "${_levels}")
+  message(STATUS "tcc: simd levels=${_levels}")
+endfunction()
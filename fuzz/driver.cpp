@@ -0,0 +1,438 @@
+// Standalone driver for the fuzz targets: tcc_fuzz_<name>_replay.
+//
+//   tcc_fuzz_wire_replay fuzz/corpus/wire                     # replay, as CTest does
+//   tcc_fuzz_wire_replay --mutate=100000 fuzz/corpus/wire     # plus built-in mutations
+//   tcc_fuzz_wire_replay --bench --out=fuzz_wire.json fuzz/corpus/wire
+//
+// Arguments are corpus files or directories (every regular file in them).
+//
+//   --mutate=<n>       after the corpus, run n mutated copies of its inputs
+//                      (bit flips, interesting u32 values, truncation,
+//                      duplicated and spliced ranges). Deterministic for a
+//                      given --seed; a cheap stand-in for the coverage-guided
+//                      libFuzzer binary where Clang is not available
+//   --seed=<n>         mutator seed (default 1)
+//   --slow-ms=<ms>     fail when one input takes longer than this (0: off)
+//   --bench            time whole passes over the corpus instead, and list
+//                      the inputs that decode slowest per byte
+//   --repetitions=<n>  timed samples with --bench (default 5)
+//   --min-time=<s>     minimum duration of one sample (default 0.1)
+//   --out=<path>       with --bench, also write a report in tcc_bench's JSON
+//                      format, which tcc_bench_compare can gate on
+//   --write-seeds=<dir> write the target's seed inputs to <dir> and exit
+//
+// A crash, a failed TCC_FUZZ_CHECK or an exception escaping the target saves
+// the input to ./crash-<name> (./slow-<name> for --slow-ms) so it can be
+// replayed on its own or added to the corpus once fixed.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fuzz.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifndef TCC_FUZZ_TARGET
+#define TCC_FUZZ_TARGET "target"
+#endif
+
+namespace {
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+struct Input {
+  std::string name;
+  std::vector<std::byte> bytes;
+};
+
+struct Options {
+  std::vector<std::string> paths;
+  std::uint64_t mutations = 0;
+  std::uint64_t seed = 1;
+  double slow_ms = 0;
+  bool bench = false;
+  int repetitions = 5;
+  double min_time = 0.1;
+  std::string out;
+  std::string write_seeds;
+};
+
+// --- Crash capture ------------------------------------------------------------
+
+// The input being run, for the signal handler.
+const std::byte* g_current = nullptr;
+std::size_t g_current_size = 0;
+
+void save_input(const char* path, const std::byte* data, std::size_t size) noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+  // Async-signal-safe calls only: this runs in the handler.
+  const int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) return;
+  while (size > 0) {
+    const ssize_t n = ::write(fd, data, size);
+    if (n <= 0) break;
+    data += n;
+    size -= static_cast<std::size_t>(n);
+  }
+  ::close(fd);
+#else
+  if (std::FILE* f = std::fopen(path, "wb")) {
+    std::fwrite(data, 1, size, f);
+    std::fclose(f);
+  }
+#endif
+}
+
+extern "C" void on_crash(int sig) {
+  static constexpr char kPath[] = "crash-" TCC_FUZZ_TARGET;
+  static constexpr char kMessage[] = "tcc_fuzz: crashed, input saved to ./crash-" TCC_FUZZ_TARGET "\n";
+  save_input(kPath, g_current, g_current_size);
+#if defined(__unix__) || defined(__APPLE__)
+  [[maybe_unused]] const ssize_t n = ::write(2, kMessage, sizeof kMessage - 1);
+#endif
+  std::signal(sig, SIG_DFL);
+  std::raise(sig);
+}
+
+void install_crash_handlers() {
+  for (int sig : {SIGSEGV, SIGABRT, SIGFPE, SIGILL}) std::signal(sig, on_crash);
+#if defined(SIGBUS)
+  std::signal(SIGBUS, on_crash);
+#endif
+}
+
+void run_one(const std::vector<std::byte>& input) {
+  g_current = input.data();
+  g_current_size = input.size();
+  try {
+    LLVMFuzzerTestOneInput(reinterpret_cast<const std::uint8_t*>(input.data()), input.size());
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "tcc_fuzz: exception escaped the target: %s\n", e.what());
+    std::abort();
+  }
+}
+
+// --- Corpus -------------------------------------------------------------------
+
+std::vector<std::byte> read_file(const fs::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) throw std::runtime_error("cannot read " + path.string());
+  const std::vector<char> chars((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  std::vector<std::byte> bytes(chars.size());
+  std::transform(chars.begin(), chars.end(), bytes.begin(), [](char c) { return static_cast<std::byte>(c); });
+  return bytes;
+}
+
+std::vector<Input> load_corpus(const std::vector<std::string>& paths) {
+  std::vector<Input> corpus;
+  for (const std::string& p : paths) {
+    if (fs::is_directory(p)) {
+      std::vector<fs::path> files;
+      for (const auto& entry : fs::directory_iterator(p)) {
+        if (entry.is_regular_file()) files.push_back(entry.path());
+      }
+      std::sort(files.begin(), files.end());  // a deterministic order for --mutate
+      for (const fs::path& f : files) corpus.push_back({f.filename().string(), read_file(f)});
+    } else if (fs::is_regular_file(p)) {
+      corpus.push_back({fs::path(p).filename().string(), read_file(p)});
+    } else {
+      throw std::runtime_error("no such corpus file or directory: " + p);
+    }
+  }
+  return corpus;
+}
+
+void write_seeds(const fs::path& dir) {
+  fs::create_directories(dir);
+  const auto seeds = tcc::fuzz::seeds();
+  for (std::size_t i = 0; i < seeds.size(); ++i) {
+    const fs::path path = dir / ("seed-" + std::to_string(i));
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(seeds[i].data()), static_cast<std::streamsize>(seeds[i].size()));
+    if (!out) throw std::runtime_error("cannot write " + path.string());
+  }
+  std::printf("wrote %zu seeds to %s\n", seeds.size(), dir.string().c_str());
+}
+
+// --- Mutator ------------------------------------------------------------------
+
+/// A few structure-blind edits, weighted towards what breaks offset-based
+/// formats: 32-bit fields set to boundary values, and truncation.
+class Mutator {
+ public:
+  explicit Mutator(std::uint64_t seed) noexcept : state_(seed * 0x9e3779b97f4a7c15ull + 1) {}
+
+  void mutate(std::vector<std::byte>& v, const std::vector<std::byte>& other) {
+    const int edits = 1 + static_cast<int>(below(4));
+    for (int e = 0; e < edits; ++e) edit(v, other);
+  }
+
+ private:
+  std::uint64_t next() noexcept {  // xorshift64*
+    state_ ^= state_ >> 12;
+    state_ ^= state_ << 25;
+    state_ ^= state_ >> 27;
+    return state_ * 0x2545f4914f6cdd1dull;
+  }
+  std::size_t below(std::size_t n) noexcept { return n == 0 ? 0 : static_cast<std::size_t>(next() % n); }
+
+  void edit(std::vector<std::byte>& v, const std::vector<std::byte>& other) {
+    switch (below(7)) {
+      case 0:  // flip a bit
+        if (!v.empty()) v[below(v.size())] ^= static_cast<std::byte>(1u << below(8));
+        break;
+      case 1:  // set a byte
+        if (!v.empty()) v[below(v.size())] = static_cast<std::byte>(next());
+        break;
+      case 2:
+      case 3: {  // set an aligned u32, where offsets, sizes and counts live
+        if (v.size() < 4) break;
+        const std::size_t pos = below(v.size() - 3) & ~std::size_t{3};
+        const auto size = static_cast<std::uint32_t>(v.size());
+        const std::uint32_t values[] = {0,          1,           4,    8,        size,
+                                        size - 4,   size + 4,    0x7fffffffu, 0x80000000u, 0xffffffffu,
+                                        static_cast<std::uint32_t>(below(size))};
+        const std::uint32_t x = values[below(std::size(values))];
+        for (int b = 0; b < 4; ++b) v[pos + b] = static_cast<std::byte>(x >> (8 * b));
+        break;
+      }
+      case 4:  // truncate
+        v.resize(below(v.size() + 1));
+        break;
+      case 5: {  // duplicate a range in place
+        if (v.empty()) break;
+        const std::size_t from = below(v.size());
+        const std::size_t len = 1 + below(std::min<std::size_t>(v.size() - from, 64));
+        const std::vector<std::byte> copy(v.begin() + from, v.begin() + from + len);
+        v.insert(v.begin() + below(v.size() + 1), copy.begin(), copy.end());
+        break;
+      }
+      default: {  // splice in a range of another input
+        if (other.empty() || v.empty()) break;
+        const std::size_t from = below(other.size());
+        const std::size_t len = 1 + below(std::min<std::size_t>(other.size() - from, 256));
+        const std::size_t to = below(v.size());
+        v.resize(std::max(v.size(), to + len));
+        std::copy_n(other.begin() + from, len, v.begin() + to);
+        break;
+      }
+    }
+  }
+
+  std::uint64_t state_;
+};
+
+// --- Replay -------------------------------------------------------------------
+
+int replay(const std::vector<Input>& corpus, const Options& opts) {
+  std::size_t runs = 0;
+  std::uint64_t bytes = 0;
+  double slowest_ms = 0;
+  std::string slowest;
+  const auto start = Clock::now();
+
+  const auto run = [&](const std::vector<std::byte>& input, const std::string& name) {
+    const auto t0 = Clock::now();
+    run_one(input);
+    const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    ++runs;
+    bytes += input.size();
+    if (ms > slowest_ms) {
+      slowest_ms = ms;
+      slowest = name;
+    }
+    if (opts.slow_ms > 0 && ms > opts.slow_ms) {
+      save_input("slow-" TCC_FUZZ_TARGET, input.data(), input.size());
+      std::fprintf(stderr, "tcc_fuzz: %s took %.2f ms (limit %.2f ms), input saved to ./slow-" TCC_FUZZ_TARGET "\n",
+                   name.c_str(), ms, opts.slow_ms);
+      return false;
+    }
+    return true;
+  };
+
+  for (const Input& in : corpus) {
+    if (!run(in.bytes, in.name)) return 1;
+  }
+  Mutator mutator(opts.seed);
+  std::vector<std::byte> buf;
+  for (std::uint64_t i = 0; i < opts.mutations && !corpus.empty(); ++i) {
+    const Input& base = corpus[i % corpus.size()];
+    buf = base.bytes;
+    mutator.mutate(buf, corpus[(i * 7 + 3) % corpus.size()].bytes);
+    if (!run(buf, base.name + " mutation " + std::to_string(i))) return 1;
+  }
+
+  const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  std::printf("tcc_fuzz_%s: %zu runs (%zu corpus inputs), %.2f MB in %.3f s; slowest %s (%.3f ms)\n",
+              TCC_FUZZ_TARGET, runs, corpus.size(), static_cast<double>(bytes) / 1e6, seconds,
+              slowest.empty() ? "-" : slowest.c_str(), slowest_ms);
+  return 0;
+}
+
+// --- Throughput -----------------------------------------------------------------
+
+/// Seconds per call of `fn`, over enough calls to last `min_time`.
+template <class Fn>
+double time_per_call(Fn&& fn, double min_time) {
+  std::uint64_t calls = 1;
+  for (;;) {
+    const auto t0 = Clock::now();
+    for (std::uint64_t i = 0; i < calls; ++i) fn();
+    const double elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+    if (elapsed >= min_time || calls >= (1ull << 40)) return elapsed / static_cast<double>(calls);
+    calls *= elapsed > 0 ? std::clamp(static_cast<std::uint64_t>(min_time * 1.4 / elapsed), std::uint64_t{2},
+                                      std::uint64_t{10})
+                         : 10;
+  }
+}
+
+std::string json_string(std::string_view s) {
+  std::string out = "\"";
+  for (char c : s) {
+    if (c == '"' || c == '\\') out += '\\';
+    if (static_cast<unsigned char>(c) >= 0x20) out += c;
+  }
+  return out + "\"";
+}
+
+int bench(const std::vector<Input>& corpus, const Options& opts) {
+  if (corpus.empty()) throw std::runtime_error("--bench needs a non-empty corpus");
+  std::uint64_t bytes = 0;
+  for (const Input& in : corpus) bytes += in.bytes.size();
+  const auto pass = [&] {
+    for (const Input& in : corpus) run_one(in.bytes);
+  };
+
+  pass();  // warm up caches, lazily built tables and pools
+  std::vector<double> samples_ns;
+  for (int r = 0; r < opts.repetitions; ++r) samples_ns.push_back(time_per_call(pass, opts.min_time) * 1e9);
+  std::vector<double> sorted = samples_ns;
+  std::sort(sorted.begin(), sorted.end());
+  const double median_ns = sorted.size() % 2 ? sorted[sorted.size() / 2]
+                                             : (sorted[sorted.size() / 2 - 1] + sorted[sorted.size() / 2]) / 2;
+  const double mb_per_s = static_cast<double>(bytes) / (median_ns * 1e-9) / 1e6;
+  std::printf("tcc_fuzz_%s: %zu inputs, %llu bytes: %.0f ns per pass (min %.0f, max %.0f), %.2f MB/s\n",
+              TCC_FUZZ_TARGET, corpus.size(), static_cast<unsigned long long>(bytes), median_ns, sorted.front(),
+              sorted.back(), mb_per_s);
+
+  // Pathological inputs: cost per byte, each input timed on its own.
+  struct Cost {
+    const Input* input;
+    double ns_per_byte;
+  };
+  std::vector<Cost> costs;
+  const double per_input = std::max(opts.min_time / 20, 1e-3);
+  for (const Input& in : corpus) {
+    const double ns = time_per_call([&] { run_one(in.bytes); }, per_input) * 1e9;
+    costs.push_back({&in, ns / static_cast<double>(std::max<std::size_t>(in.bytes.size(), 1))});
+  }
+  std::sort(costs.begin(), costs.end(), [](const Cost& a, const Cost& b) { return a.ns_per_byte > b.ns_per_byte; });
+  std::printf("slowest inputs per byte:\n");
+  for (std::size_t i = 0; i < std::min<std::size_t>(costs.size(), 5); ++i) {
+    std::printf("  %-44s %10zu B %10.2f ns/B\n", costs[i].input->name.c_str(), costs[i].input->bytes.size(),
+                costs[i].ns_per_byte);
+  }
+
+  if (!opts.out.empty()) {
+    std::ofstream out(opts.out, std::ios::trunc);
+    if (!out) throw std::runtime_error("cannot open " + opts.out + " for writing");
+    double mean = 0;
+    for (double s : samples_ns) mean += s / static_cast<double>(samples_ns.size());
+    double var = 0;
+    for (double s : samples_ns) var += (s - mean) * (s - mean);
+    const double stddev = samples_ns.size() > 1 ? std::sqrt(var / static_cast<double>(samples_ns.size() - 1)) : 0;
+    out << "{\n  \"context\": {\"target\": " << json_string(TCC_FUZZ_TARGET) << ", \"inputs\": " << corpus.size()
+        << ", \"repetitions\": " << opts.repetitions << "},\n  \"benchmarks\": [\n    {\n"
+        << "      \"name\": " << json_string("fuzz_" TCC_FUZZ_TARGET "/corpus") << ",\n"
+        << "      \"iterations\": 1,\n"
+        << "      \"min_ns\": " << sorted.front() << ",\n"
+        << "      \"median_ns\": " << median_ns << ",\n"
+        << "      \"mean_ns\": " << mean << ",\n"
+        << "      \"p99_ns\": " << sorted.back() << ",\n"
+        << "      \"max_ns\": " << sorted.back() << ",\n"
+        << "      \"stddev_ns\": " << stddev << ",\n"
+        << "      \"bytes_per_iteration\": " << bytes << ",\n"
+        << "      \"bytes_per_second\": " << mb_per_s * 1e6 << ",\n"
+        << "      \"counters\": {\"inputs\": " << corpus.size()
+        << ", \"worst_ns_per_byte\": " << costs.front().ns_per_byte << "},\n"
+        << "      \"samples_ns\": [";
+    for (std::size_t i = 0; i < samples_ns.size(); ++i) out << (i ? ", " : "") << samples_ns[i];
+    out << "]\n    }\n  ]\n}\n";
+    if (!out) throw std::runtime_error("failed writing " + opts.out);
+  }
+  return 0;
+}
+
+// --- Command line ---------------------------------------------------------------
+
+bool parse_flag(std::string_view arg, std::string_view name, std::string& value) {
+  if (arg.substr(0, name.size()) != name || arg.size() <= name.size() || arg[name.size()] != '=') return false;
+  value = arg.substr(name.size() + 1);
+  return true;
+}
+
+Options parse_options(int argc, char** argv) {
+  Options opts;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    std::string value;
+    if (parse_flag(arg, "--mutate", value)) {
+      opts.mutations = std::strtoull(value.c_str(), nullptr, 10);
+    } else if (parse_flag(arg, "--seed", value)) {
+      opts.seed = std::strtoull(value.c_str(), nullptr, 10);
+    } else if (parse_flag(arg, "--slow-ms", value)) {
+      opts.slow_ms = std::atof(value.c_str());
+    } else if (parse_flag(arg, "--repetitions", value)) {
+      opts.repetitions = std::max(1, std::atoi(value.c_str()));
+    } else if (parse_flag(arg, "--min-time", value)) {
+      opts.min_time = std::atof(value.c_str());
+    } else if (parse_flag(arg, "--out", value)) {
+      opts.out = value;
+    } else if (parse_flag(arg, "--write-seeds", value)) {
+      opts.write_seeds = value;
+    } else if (arg == "--bench") {
+      opts.bench = true;
+    } else if (arg.substr(0, 2) == "--") {
+      throw std::invalid_argument("unknown option: " + std::string(arg));
+    } else {
+      opts.paths.emplace_back(arg);
+    }
+  }
+  return opts;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  try {
+    const Options opts = parse_options(argc, argv);
+    if (!opts.write_seeds.empty()) {
+      write_seeds(opts.write_seeds);
+      return 0;
+    }
+    const std::vector<Input> corpus = load_corpus(opts.paths);
+    install_crash_handlers();
+    return opts.bench ? bench(corpus, opts) : replay(corpus, opts);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "tcc_fuzz_%s: %s\n", TCC_FUZZ_TARGET, e.what());
+    return 2;
+  }
+}
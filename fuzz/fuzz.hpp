@@ -0,0 +1,61 @@
+#pragma once
+
+// Fuzz targets for the zero-copy parsers, and what they share.
+//
+//   extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+//     try {
+//       auto order = tcc::wire::root<Order>(tcc::fuzz::aligned(data, size));
+//       ...                                  // touch everything the view reaches
+//     } catch (const tcc::wire::Error&) {
+//     }
+//     return 0;
+//   }
+//   std::vector<std::vector<std::byte>> tcc::fuzz::seeds() { ... }
+//
+// Each fuzz_<name>.cpp is one libFuzzer target. It becomes
+//   tcc_fuzz_<name>          libFuzzer binary (Clang with TCC_SANITIZE=fuzzer)
+//   tcc_fuzz_<name>_replay   driver.cpp: replays a corpus, mutates it with a
+//                            simple built-in mutator, and times it (--bench)
+// so every compiler can run the corpus as a regression test and report how
+// fast the target decodes it, while Clang builds can grow the corpus.
+//
+// A target rejects malformed input through the parser's own exception and
+// calls TCC_FUZZ_CHECK for properties the sanitizers cannot see (a decoded
+// size that disagrees with the input, two kernels that disagree). Anything
+// else escaping it, a sanitizer report or a crash is a finding.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <span>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size);
+
+namespace tcc::fuzz {
+
+/// Well-formed inputs for a fresh corpus (tcc_fuzz_<name>_replay
+/// --write-seeds=<dir>); each should reach a different part of the format.
+std::vector<std::vector<std::byte>> seeds();
+
+[[noreturn]] inline void check_failed(const char* expr, const char* file, int line) {
+  std::fprintf(stderr, "%s:%d: fuzz check failed: %s\n", file, line, expr);
+  std::abort();
+}
+
+/// A copy of the input at 8-byte alignment. libFuzzer hands out buffers at
+/// arbitrary addresses, but the formats (like MappedFile and Builder
+/// buffers) guarantee alignment, so misaligned data is not a finding.
+inline std::span<const std::byte> aligned(const std::uint8_t* data, std::size_t size) {
+  static thread_local std::vector<std::uint64_t> buffer;
+  buffer.assign(size / 8 + 1, 0);
+  if (size != 0) std::memcpy(buffer.data(), data, size);
+  return {reinterpret_cast<const std::byte*>(buffer.data()), size};
+}
+
+}  // namespace tcc::fuzz
+
+/// Aborts (a finding) when `cond` is false, in every build type.
+#define TCC_FUZZ_CHECK(cond) ((cond) ? void() : ::tcc::fuzz::check_failed(#cond, __FILE__, __LINE__))
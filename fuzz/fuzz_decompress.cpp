@@ -0,0 +1,89 @@
+// The compression frame readers on arbitrary bytes: DecompressStream front
+// to back, and FrameReader from the footer.
+//
+// The two parse different parts of the frame (block headers in order vs.
+// footer and index), so when both accept an input they must agree on every
+// raw byte; the target checks that as well as running under the sanitizers.
+// Reads go through a buffer that is not a multiple of any block size, so
+// block boundaries fall inside reads.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "fuzz.hpp"
+#include "tcc/compression.hpp"
+#include "tcc/thread_pool.hpp"
+
+namespace {
+
+tcc::ThreadPool& pool() {
+  static tcc::ThreadPool p(2);
+  return p;
+}
+
+std::optional<std::vector<std::byte>> stream_decode(std::span<const std::byte> frame) {
+  try {
+    tcc::DecompressStream d(pool(), tcc::span_source(frame), 2);
+    std::vector<std::byte> out;
+    std::byte buf[3000];
+    while (std::size_t n = d.read(buf)) out.insert(out.end(), buf, buf + n);
+    return out;
+  } catch (const tcc::CompressionError&) {
+    return std::nullopt;
+  }
+}
+
+std::optional<std::vector<std::byte>> frame_decode(std::span<const std::byte> frame) {
+  try {
+    const tcc::FrameReader reader(frame);
+    std::vector<std::byte> out(static_cast<std::size_t>(reader.size()));
+    for (std::size_t at = 0; at < out.size(); at += 3000) {
+      const std::size_t n = std::min<std::size_t>(3000, out.size() - at);
+      TCC_FUZZ_CHECK(reader.read(at, std::span(out).subspan(at, n)) == n);
+    }
+    return out;
+  } catch (const tcc::CompressionError&) {
+    return std::nullopt;
+  }
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+  const std::span<const std::byte> frame(reinterpret_cast<const std::byte*>(data), size);
+  const auto streamed = stream_decode(frame);
+  const auto random_access = frame_decode(frame);
+  if (streamed && random_access) TCC_FUZZ_CHECK(*streamed == *random_access);
+  return 0;
+}
+
+std::vector<std::vector<std::byte>> tcc::fuzz::seeds() {
+  // Text that compresses, then bytes that do not, so frames mix lz4 and
+  // stored blocks; small blocks so a seed spans several.
+  std::vector<std::byte> raw(20'000);
+  const std::string_view words = "the quick brown fox jumps over the lazy dog ";
+  std::uint32_t x = 12345;
+  for (std::size_t i = 0; i < raw.size(); ++i) {
+    x = x * 1103515245u + 12345u;
+    raw[i] = static_cast<std::byte>(i < 14'000 ? words[i % words.size()] : x >> 24);
+  }
+
+  const auto frame = [&](tcc::Codec codec, std::size_t size) {
+    tcc::CompressStream z(pool(), tcc::span_source(std::span(raw).first(size)), {.codec = codec, .block_size = 4096});
+    std::vector<std::byte> out;
+    std::byte buf[4096];
+    while (std::size_t n = z.read(buf)) out.insert(out.end(), buf, buf + n);
+    return out;
+  };
+  std::vector<std::vector<std::byte>> out;
+  out.push_back(frame(tcc::Codec::lz4, raw.size()));
+  out.push_back(frame(tcc::Codec::store, 5000));
+  out.push_back(frame(tcc::Codec::lz4, 0));
+  if (tcc::codec_available(tcc::Codec::zstd)) out.push_back(frame(tcc::Codec::zstd, raw.size()));
+  return out;
+}
@@ -0,0 +1,98 @@
+// The MappedFile record iterators (RecordRange, LineRange) on arbitrary
+// bytes: the first byte picks the delimiter, the rest is the file.
+//
+// The records() / lines() a MappedFile hands out are these ranges over its
+// bytes(), so the span is iterated directly rather than through a file
+// write per input. Besides running under the sanitizers, the target checks
+// the records against a plain byte loop and every SIMD find_byte kernel the
+// CPU supports against the scalar one, on each suffix the iterator scans.
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "fuzz.hpp"
+#include "tcc/mapped_file.hpp"
+#include "tcc/simd.hpp"
+
+namespace {
+
+/// (offset, length) of each record, found one byte at a time.
+std::vector<std::pair<std::size_t, std::size_t>> reference_split(std::span<const std::byte> data, std::byte delim) {
+  std::vector<std::pair<std::size_t, std::size_t>> out;
+  std::size_t start = 0;
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    if (data[i] == delim) {
+      out.emplace_back(start, i - start);
+      start = i + 1;
+    }
+  }
+  if (start < data.size()) out.emplace_back(start, data.size() - start);
+  return out;
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+  if (size == 0) return 0;
+  const auto delim = static_cast<std::byte>(data[0]);
+  const std::span<const std::byte> body(reinterpret_cast<const std::byte*>(data) + 1, size - 1);
+
+  const auto expected = reference_split(body, delim);
+  std::size_t n = 0;
+  for (std::span<const std::byte> r : tcc::RecordRange(body, delim)) {
+    TCC_FUZZ_CHECK(n < expected.size());
+    TCC_FUZZ_CHECK(r.data() == body.data() + expected[n].first);
+    TCC_FUZZ_CHECK(r.size() == expected[n].second);
+    ++n;
+  }
+  TCC_FUZZ_CHECK(n == expected.size());
+
+  // Lines are the '\n' records with one trailing '\r' dropped.
+  const std::string_view text(reinterpret_cast<const char*>(body.data()), body.size());
+  const auto expected_lines = reference_split(body, std::byte{'\n'});
+  std::size_t lines = 0;
+  for (std::string_view line : tcc::lines(text)) {
+    TCC_FUZZ_CHECK(lines < expected_lines.size());
+    std::string_view want = text.substr(expected_lines[lines].first, expected_lines[lines].second);
+    if (!want.empty() && want.back() == '\r') want.remove_suffix(1);
+    TCC_FUZZ_CHECK(line.data() == want.data() && line.size() == want.size());
+    ++lines;
+  }
+  TCC_FUZZ_CHECK(lines == expected_lines.size());
+
+  // The kernels at every start position the iterator uses, short tails included.
+  const auto& scalar = tcc::simd::kernels(tcc::simd::Isa::scalar);
+  for (tcc::simd::Isa isa : tcc::simd::supported_isas()) {
+    const auto& k = tcc::simd::kernels(isa);
+    for (const auto& record : expected) {
+      const std::byte* p = body.data() + record.first;
+      const std::size_t rest = body.size() - record.first;
+      TCC_FUZZ_CHECK(k.find_byte(p, rest, delim) == scalar.find_byte(p, rest, delim));
+    }
+  }
+  return 0;
+}
+
+std::vector<std::vector<std::byte>> tcc::fuzz::seeds() {
+  const auto bytes = [](std::string_view s) {
+    std::vector<std::byte> v(s.size());
+    for (std::size_t i = 0; i < s.size(); ++i) v[i] = static_cast<std::byte>(s[i]);
+    return v;
+  };
+  std::vector<std::vector<std::byte>> out;
+  out.push_back(bytes("\nfirst line\r\nsecond line\n\nfourth, after an empty one\nno trailing newline"));
+  out.push_back(bytes(",a,b,,c,"));
+  std::string csv = ";";
+  for (int i = 0; i < 200; ++i) csv += "field" + std::to_string(i) + (i % 7 == 6 ? "\n" : ";");
+  out.push_back(bytes(csv));
+  std::string long_record = "|";  // longer than any vector width, delimiter near the end
+  long_record.append(300, 'x');
+  long_record += "|y";
+  out.push_back(bytes(long_record));
+  return out;
+}
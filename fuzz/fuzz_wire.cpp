@@ -0,0 +1,111 @@
+// tcc::wire::root() on arbitrary bytes, then every access the view allows.
+//
+// The schema uses each slot kind (scalars, String, scalar vectors of two
+// alignments, a nested table and a vector of tables) and refers to itself,
+// so verification depth, shared children and the old-schema path are all
+// reachable. Once root() accepts a buffer the walk reads every byte it
+// reaches; under ASan any read the verifier should have rejected reports.
+// root() checks a shared child once, but the walk follows every path, so
+// it gives up after kMaxVisits tables.
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "fuzz.hpp"
+#include "tcc/wire.hpp"
+
+namespace {
+
+namespace w = tcc::wire;
+
+struct Tree : w::Schema<w::Field<"id", std::uint64_t>,
+                        w::Field<"name", w::String>,
+                        w::Field<"levels", w::Vector<float>>,
+                        w::Field<"weights", w::Vector<double>>,
+                        w::Field<"left", w::Table<Tree>>,
+                        w::Field<"children", w::Vector<w::Table<Tree>>>> {};
+
+// The first two fields only: data from a writer that predates the rest.
+using TreeV1 = w::Schema<w::Field<"id", std::uint64_t>, w::Field<"name", w::String>>;
+
+constexpr std::size_t kMaxVisits = std::size_t{1} << 16;
+
+std::uint64_t walk(w::View<Tree> t, std::size_t& visits) {
+  if (!t || ++visits > kMaxVisits) return 0;
+  std::uint64_t h = t.get<"id">();
+  for (char c : t.get<"name">()) h = h * 31 + static_cast<unsigned char>(c);
+  for (float f : t.get<"levels">().span()) h += std::bit_cast<std::uint32_t>(f);
+  for (double d : t.get<"weights">()) h += std::bit_cast<std::uint64_t>(d);
+  h += walk(t.get<"left">(), visits);
+  const auto children = t.get<"children">();
+  for (std::size_t i = 0; i < children.size(); ++i) h += walk(children[i], visits);
+  return h;
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+  const std::span<const std::byte> buffer = tcc::fuzz::aligned(data, size);
+  try {
+    const w::View<Tree> tree = w::root<Tree>(buffer);
+    std::size_t visits = 0;
+    [[maybe_unused]] volatile std::uint64_t sink = walk(tree, visits);
+  } catch (const w::Error&) {
+  }
+  return 0;
+}
+
+std::vector<std::vector<std::byte>> tcc::fuzz::seeds() {
+  std::vector<std::vector<std::byte>> out;
+  const auto add = [&](w::Builder& b) { out.push_back(b.release()); };
+  const std::vector<float> levels = {1.5f, 2.5f, 3.5f};
+  const std::vector<double> weights = {0.25, 0.5};
+
+  {  // every field of one table
+    w::Builder b;
+    auto name = b.add_string("root");
+    auto lv = b.add_vector<float>(levels);
+    auto wt = b.add_vector<double>(weights);
+    b.finish(b.add_table<Tree>(std::uint64_t{1}, name, lv, wt, w::TableRef<Tree>{}, w::VectorRef<w::Table<Tree>>{}));
+    add(b);
+  }
+  {  // a chain through "left"
+    w::Builder b;
+    w::TableRef<Tree> left{};
+    for (std::uint64_t i = 0; i < 12; ++i) {
+      left = b.add_table<Tree>(i, b.add_string("n"), w::VectorRef<float>{}, w::VectorRef<double>{}, left,
+                               w::VectorRef<w::Table<Tree>>{});
+    }
+    b.finish(left);
+    add(b);
+  }
+  {  // one child shared by every slot of a vector, and absent entries
+    w::Builder b;
+    auto leaf = b.add_table<Tree>(std::uint64_t{7}, b.add_string("leaf"), b.add_vector<float>(levels),
+                                  w::VectorRef<double>{}, w::TableRef<Tree>{}, w::VectorRef<w::Table<Tree>>{});
+    auto kids = b.add_vector<Tree>({leaf, leaf, w::TableRef<Tree>{}, leaf});
+    b.finish(b.add_table<Tree>(std::uint64_t{8}, w::StringRef{}, w::VectorRef<float>{}, b.add_vector<double>(weights),
+                               leaf, kids));
+    add(b);
+  }
+  {  // written with the shorter schema
+    w::Builder b;
+    b.finish(b.add_table<TreeV1>(std::uint64_t{3}, b.add_string("old writer")));
+    add(b);
+  }
+  {  // a diamond chain: each level refers to the one below three times
+    w::Builder b;
+    w::TableRef<Tree> below{};
+    for (std::uint64_t i = 0; i < 10; ++i) {
+      const auto kids = b.add_vector<Tree>({below, below});
+      below = b.add_table<Tree>(i, w::StringRef{}, w::VectorRef<float>{}, w::VectorRef<double>{}, below, kids);
+    }
+    b.finish(below);
+    add(b);
+  }
+  return out;
+}
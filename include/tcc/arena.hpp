@@ -0,0 +1,219 @@
+#pragma once
+
+// Request-scoped bump-pointer allocation.
+//
+//   tcc::Arena arena;
+//   tcc::ArenaResource resource(arena);
+//   std::pmr::vector<std::pmr::string> names(&resource);
+//   ...                       // everything allocated from `arena`
+//   arena.reset();            // all of it dies at once; chunks are kept
+//
+// Arena is not thread-safe; use one per request or per thread. Objects made
+// with create() never have their destructors run, so only trivially
+// destructible types are accepted there. Types that own memory through a
+// polymorphic allocator (std::pmr containers) are fine when the destructor
+// is skipped, because deallocation is a no-op anyway.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "tcc/export.hpp"
+
+namespace tcc {
+
+/// An upstream memory_resource that hands out memory in fixed-size units
+/// (pages, huge pages). Arena sizes its chunks to whole units of such a
+/// resource, so the tail of the last unit is not wasted.
+class TCC_API GranularResource : public std::pmr::memory_resource {
+ public:
+  virtual std::size_t granularity() const noexcept = 0;
+
+  /// `n` rounded up to whole units. Granularities are page multiples but
+  /// need not be powers of two.
+  static constexpr std::size_t round_to_units(std::size_t n, std::size_t unit) noexcept {
+    return (n + unit - 1) / unit * unit;
+  }
+};
+
+class TCC_API Arena {
+ public:
+  static constexpr std::size_t kDefaultChunkSize = 64 * 1024;
+  static constexpr std::size_t kMaxChunkSize = 16 * 1024 * 1024;
+
+  /// `first_chunk` is the size of the first chunk; later chunks double up to
+  /// kMaxChunkSize. Chunks are obtained from `upstream`, rounded up to its
+  /// granularity when it is a GranularResource.
+  explicit Arena(std::size_t first_chunk = kDefaultChunkSize,
+                 std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept;
+  ~Arena();
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+  Arena(Arena&& other) noexcept;
+  Arena& operator=(Arena&& other) noexcept;
+
+  /// Returns `bytes` of storage aligned to `align` (a power of two). Never
+  /// returns nullptr; throws std::bad_alloc when upstream does.
+  void* allocate(std::size_t bytes, std::size_t align = alignof(std::max_align_t)) {
+    if (void* p = bump(bytes, align)) [[likely]] {
+      return p;
+    }
+    return allocate_slow(bytes, align);
+  }
+
+  /// Uninitialized storage for `n` objects of type T.
+  template <class T>
+  T* allocate_array(std::size_t n) {
+    if (n > SIZE_MAX / sizeof(T)) throw std::bad_array_new_length();
+    return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+  }
+
+  /// Constructs a T in the arena. The destructor will never run.
+  template <class T, class... Args>
+  T* create(Args&&... args) {
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "Arena::create skips destructors; use a pmr container or a trivially destructible type");
+    return ::new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  /// Makes every chunk available again without returning memory upstream.
+  /// All previously returned pointers become dangling.
+  void reset() noexcept;
+
+  /// Returns every chunk to upstream; the next allocation starts over.
+  void release() noexcept;
+
+  /// Bytes handed out since the last reset()/release(), including padding
+  /// inside retired chunks.
+  std::size_t bytes_used() const noexcept;
+  /// Total capacity of the chunks currently owned.
+  std::size_t bytes_reserved() const noexcept { return reserved_; }
+  std::size_t chunk_count() const noexcept { return chunks_; }
+
+  std::pmr::memory_resource* upstream() const noexcept { return upstream_; }
+
+ private:
+  struct Chunk {
+    Chunk* next;
+    std::size_t capacity;  // usable bytes following the header
+    std::byte* data() noexcept { return reinterpret_cast<std::byte*>(this + 1); }
+  };
+
+  void* bump(std::size_t bytes, std::size_t align) noexcept {
+    const auto cur = reinterpret_cast<std::uintptr_t>(cur_);
+    const auto end = reinterpret_cast<std::uintptr_t>(end_);
+    const std::uintptr_t aligned = (cur + align - 1) & ~(static_cast<std::uintptr_t>(align) - 1);
+    if (aligned > end || bytes > end - aligned) return nullptr;
+    cur_ = reinterpret_cast<std::byte*>(aligned + bytes);
+    return reinterpret_cast<void*>(aligned);
+  }
+
+  void* allocate_slow(std::size_t bytes, std::size_t align);
+  Chunk* new_chunk(std::size_t min_capacity);
+  void activate(Chunk* chunk) noexcept;
+
+  std::byte* cur_ = nullptr;
+  std::byte* end_ = nullptr;
+  Chunk* first_ = nullptr;
+  Chunk* current_ = nullptr;
+  std::size_t first_chunk_size_;
+  std::size_t next_chunk_size_;
+  std::size_t used_in_retired_ = 0;
+  std::size_t reserved_ = 0;
+  std::size_t chunks_ = 0;
+  std::size_t granularity_ = 1;  // of upstream_
+  std::pmr::memory_resource* upstream_;
+};
+
+/// std::pmr adapter: lets pmr containers allocate from an Arena. Deallocation
+/// is a no-op; memory comes back when the arena is reset or destroyed.
+class TCC_API ArenaResource final : public std::pmr::memory_resource {
+ public:
+  explicit ArenaResource(Arena& arena) noexcept : arena_(&arena) {}
+
+  Arena& arena() const noexcept { return *arena_; }
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t align) override { return arena_->allocate(bytes, align); }
+  void do_deallocate(void*, std::size_t, std::size_t) override {}
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    auto* o = dynamic_cast<const ArenaResource*>(&other);
+    return o != nullptr && o->arena_ == arena_;
+  }
+
+  Arena* arena_;
+};
+
+/// Free-list pool of fixed-size blocks carved out of an Arena. Freed blocks
+/// are reused LIFO, so a hot allocate/deallocate pair stays in cache. Not
+/// thread-safe; see thread_local_pool() for the per-thread variant.
+class TCC_API FixedPool {
+ public:
+  explicit FixedPool(std::size_t block_size, std::size_t block_align = alignof(std::max_align_t),
+                     std::size_t blocks_per_chunk = 256);
+
+  FixedPool(const FixedPool&) = delete;
+  FixedPool& operator=(const FixedPool&) = delete;
+
+  void* allocate() {
+    if (FreeBlock* block = free_) [[likely]] {
+      free_ = block->next;
+      return block;
+    }
+    return arena_.allocate(block_size_, block_align_);
+  }
+
+  /// `p` must have come from allocate() on this pool.
+  void deallocate(void* p) noexcept {
+    auto* block = static_cast<FreeBlock*>(p);
+    block->next = free_;
+    free_ = block;
+  }
+
+  std::size_t block_size() const noexcept { return block_size_; }
+  std::size_t bytes_reserved() const noexcept { return arena_.bytes_reserved(); }
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  std::size_t block_size_;
+  std::size_t block_align_;
+  FreeBlock* free_ = nullptr;
+  Arena arena_;
+};
+
+/// Per-thread pool sized for T. Blocks must be returned on the thread that
+/// allocated them, and before that thread exits.
+template <class T>
+FixedPool& thread_local_pool() {
+  thread_local FixedPool pool(sizeof(T), alignof(T));
+  return pool;
+}
+
+/// new/delete replacements backed by thread_local_pool<T>().
+template <class T, class... Args>
+T* pool_new(Args&&... args) {
+  FixedPool& pool = thread_local_pool<T>();
+  void* p = pool.allocate();
+  try {
+    return ::new (p) T(std::forward<Args>(args)...);
+  } catch (...) {
+    pool.deallocate(p);
+    throw;
+  }
+}
+
+template <class T>
+void pool_delete(T* p) noexcept {
+  if (p == nullptr) return;
+  p->~T();
+  thread_local_pool<T>().deallocate(p);
+}
+
+}  // namespace tcc
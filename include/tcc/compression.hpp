@@ -0,0 +1,190 @@
+#pragma once
+
+// Block-parallel, seekable compression frames (TCC_WITH_COMPRESSION).
+//
+//   tcc::ThreadPool pool;
+//   tcc::CompressStream z(pool, tcc::span_source(raw), {.codec = tcc::Codec::lz4});
+//   while (std::size_t n = z.read(buf)) out.write(buf, n);   // pull compressed bytes
+//
+//   tcc::DecompressStream d(pool, read_socket);               // sequential, any source
+//   while (std::size_t n = d.read(buf)) consume(buf, n);
+//
+//   tcc::FrameReader frame(file.bytes());                     // random access
+//   frame.read(offset, out);  // decodes only the blocks overlapping the range
+//
+// The input is cut into fixed-size blocks that are compressed independently,
+// up to `max_in_flight` at a time on the pool, and emitted in order; the
+// consumer only ever waits for the oldest block. Frame layout (integers
+// little-endian):
+//
+//   header   u32 magic "TCZ1" | u8 codec | u8 version | u16 0 | u32 block size | u32 0
+//   block    u32 stored size (bit 31: stored uncompressed) | u32 raw size | payload
+//   ...
+//   end      u32 0 | u32 0
+//   index    u64 frame offset of each block header
+//   footer   u64 raw size | u32 block count | u32 magic "TCZX"
+//
+// Every block but the last holds exactly `block size` raw bytes, so the
+// index maps a raw offset to its block with one division. Sequential
+// readers stop at the end marker and never need the index; seekable readers
+// start from the footer. Blocks that do not shrink are stored as is.
+//
+// Codecs: lz4 is always available (liblz4 when found at configure time,
+// otherwise a built-in encoder of the same block format); zstd needs libzstd
+// at configure time, see codec_available().
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "tcc/export.hpp"
+#include "tcc/thread_pool.hpp"
+
+namespace tcc {
+
+enum class Codec : std::uint8_t { store = 0, lz4 = 1, zstd = 2 };
+
+/// Whether this build can encode and decode `codec`.
+TCC_API bool codec_available(Codec codec) noexcept;
+
+/// Malformed or truncated frame, or a codec missing from this build.
+class TCC_API CompressionError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+/// Pull source: fills a prefix of the span and returns its length; 0 means
+/// end of input. May be called from the thread that calls read() only.
+using ByteSource = std::function<std::size_t(std::span<std::byte>)>;
+
+/// Source over bytes that outlive it.
+TCC_API ByteSource span_source(std::span<const std::byte> bytes);
+
+struct CompressOptions {
+  Codec codec = Codec::lz4;
+  /// zstd compression level; 0 means the library default. Ignored by lz4.
+  int level = 0;
+  /// Raw bytes per block, 4 KiB .. 1 GiB. Larger blocks compress better;
+  /// smaller ones parallelize and seek at a finer grain.
+  std::size_t block_size = 1 << 20;
+  /// Blocks compressed ahead of the reader; 0 means twice the pool size.
+  std::size_t max_in_flight = 0;
+};
+
+namespace detail {
+struct CompressionBlock;
+}
+
+/// Compressed frame of everything `source` yields, produced on demand.
+/// Not thread-safe; the pool does the parallel part.
+class TCC_API CompressStream {
+ public:
+  /// Throws std::invalid_argument for an unavailable codec or a block size
+  /// out of range.
+  CompressStream(ThreadPool& pool, ByteSource source, CompressOptions options = {});
+  /// Waits for blocks still being compressed.
+  ~CompressStream();
+
+  CompressStream(const CompressStream&) = delete;
+  CompressStream& operator=(const CompressStream&) = delete;
+
+  /// Fills `out` with the next compressed bytes; returns fewer than
+  /// out.size() only at the end of the frame, and 0 after it. Rethrows an
+  /// exception from the source or a block encoder.
+  std::size_t read(std::span<std::byte> out);
+
+  std::uint64_t raw_bytes() const noexcept { return raw_bytes_; }
+  std::uint64_t compressed_bytes() const noexcept { return emitted_; }
+
+ private:
+  bool advance();
+  void refill();
+
+  ThreadPool& pool_;
+  ByteSource source_;
+  CompressOptions options_;
+  std::deque<std::unique_ptr<detail::CompressionBlock>> in_flight_;
+  std::vector<std::unique_ptr<detail::CompressionBlock>> spare_;
+  std::vector<std::byte> pending_;  // bytes handed out by read(): [pos, end)
+  std::size_t pending_pos_ = 0;
+  std::size_t pending_end_ = 0;
+  std::vector<std::uint64_t> index_;
+  std::uint64_t raw_bytes_ = 0;
+  std::uint64_t emitted_ = 0;
+  bool header_done_ = false;
+  bool source_done_ = false;
+  bool trailer_done_ = false;
+};
+
+/// Raw bytes of a frame read front to back from any source; decodes up to
+/// `max_in_flight` blocks ahead (0: 2 x pool size).
+class TCC_API DecompressStream {
+ public:
+  DecompressStream(ThreadPool& pool, ByteSource source, std::size_t max_in_flight = 0);
+  ~DecompressStream();
+
+  DecompressStream(const DecompressStream&) = delete;
+  DecompressStream& operator=(const DecompressStream&) = delete;
+
+  /// Fills `out` with the next raw bytes; short only at the end. Throws
+  /// CompressionError on a malformed or truncated frame.
+  std::size_t read(std::span<std::byte> out);
+
+ private:
+  bool advance();
+  void refill();
+  bool read_exact(std::span<std::byte> out);
+
+  ThreadPool& pool_;
+  ByteSource source_;
+  std::size_t max_in_flight_;
+  Codec codec_ = Codec::store;
+  std::size_t block_size_ = 0;
+  std::deque<std::unique_ptr<detail::CompressionBlock>> in_flight_;
+  std::vector<std::unique_ptr<detail::CompressionBlock>> spare_;
+  std::vector<std::byte> pending_;
+  std::size_t pending_pos_ = 0;
+  std::size_t pending_end_ = 0;
+  bool header_done_ = false;
+  bool source_done_ = false;
+};
+
+/// Random access into a complete frame held in memory (a MappedFile, say).
+/// The constructor validates the footer, index and block headers; read()
+/// touches only the blocks it needs.
+class TCC_API FrameReader {
+ public:
+  explicit FrameReader(std::span<const std::byte> frame);
+
+  /// Total raw bytes in the frame.
+  std::uint64_t size() const noexcept { return raw_size_; }
+  std::size_t block_size() const noexcept { return block_size_; }
+  std::size_t block_count() const noexcept { return index_.size(); }
+  Codec codec() const noexcept { return codec_; }
+
+  /// Copies raw bytes [offset, offset + out.size()) into `out`; returns
+  /// the number copied, short when the range passes the end.
+  std::size_t read(std::uint64_t offset, std::span<std::byte> out) const;
+  /// Same, decoding the blocks in parallel on `pool`.
+  std::size_t read(ThreadPool& pool, std::uint64_t offset, std::span<std::byte> out) const;
+
+  /// Decodes block `i` into `out`, which must hold block_raw_size(i) bytes.
+  void decode_block(std::size_t i, std::span<std::byte> out) const;
+  std::size_t block_raw_size(std::size_t i) const noexcept;
+
+ private:
+  std::size_t read_block_range(std::size_t i, std::uint64_t offset, std::span<std::byte> out) const;
+
+  std::span<const std::byte> frame_;
+  Codec codec_ = Codec::store;
+  std::size_t block_size_ = 0;
+  std::uint64_t raw_size_ = 0;
+  std::vector<std::uint64_t> index_;
+};
+
+}  // namespace tcc
@@ -0,0 +1,338 @@
+#pragma once
+
+// Sharded, size-bounded cache for many concurrent readers.
+//
+//   tcc::ConcurrentCache<std::string, Profile> profiles({
+//       .capacity = 10'000, .ttl = std::chrono::minutes(5),
+//       .registry = &tcc::metrics::Registry::global(), .name = "profiles"});
+//
+//   if (auto p = profiles.get(user_id)) return *p;      // shared lock only
+//   profiles.put(user_id, load_profile(user_id));
+//
+// Keys hash to one of a power-of-two number of shards. Each shard holds a
+// FlatHashMap from key to a slot in a stable slot store, guarded by its own
+// std::shared_mutex. get() takes the lock shared: it looks the key up, sets
+// the slot's CLOCK reference bit with a relaxed atomic store (only when it
+// is not set yet, so hot entries do not dirty their cache line on every
+// hit) and copies the value out. Writers take the lock exclusively, but for
+// one shard only, and eviction runs inside that shard: there is no global
+// LRU list and no lock that every operation passes through.
+//
+// Eviction is CLOCK, a.k.a. second chance. A hand sweeps the shard's slots;
+// a referenced entry loses its bit and survives one more lap, an
+// unreferenced or expired one is evicted. Recently read entries therefore
+// survive like in an LRU, without moving anything on a hit.
+//
+// Capacity is in weight units: the Weigher gives each entry its weight
+// (1 by default, so capacity counts entries; return a byte size to bound
+// memory). Every shard gets an equal share. An entry heavier than a share
+// is not cached. TTLs are per entry, defaulting to CacheOptions::ttl.
+// Expired entries read as misses and are the first to go when the hand
+// passes them.
+//
+// Hits, misses, inserts, evictions and expirations are tcc::metrics
+// counters (tcc_cache_*_total{cache="<name>"}), plus entry and weight
+// gauges. Without a registry they live in one private to the cache.
+// V must be copyable: get() returns a copy, so use std::shared_ptr<const T>
+// for large values.
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "tcc/flat_hash_map.hpp"
+#include "tcc/metrics.hpp"
+#include "tcc/platform.hpp"
+
+namespace tcc {
+
+struct CacheOptions {
+  std::size_t capacity = std::size_t{1} << 16;  // total weight over all shards
+  std::size_t shards = 0;                       // rounded up to a power of two; 0: about 4 per hardware thread
+  std::chrono::nanoseconds ttl{0};              // default time to live; 0: entries do not expire
+  metrics::Registry* registry = nullptr;        // nullptr: counters private to the cache
+  std::string name = "default";                 // `cache` label of the exported series
+};
+
+/// Default Weigher: every entry weighs 1.
+struct UnitWeight {
+  template <class K, class V>
+  constexpr std::size_t operator()(const K&, const V&) const noexcept {
+    return 1;
+  }
+};
+
+template <class K, class V, class Hash = FlatHash<K>, class KeyEqual = std::equal_to<>, class Weigher = UnitWeight>
+class ConcurrentCache {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Stats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;       // including reads of expired entries
+    std::uint64_t inserts = 0;      // new keys; replacing a value is not an insert
+    std::uint64_t evictions = 0;    // pushed out by capacity
+    std::uint64_t expirations = 0;  // removed because their TTL passed
+    std::size_t entries = 0;
+    std::size_t weight = 0;
+  };
+
+  explicit ConcurrentCache(CacheOptions options = {}, Weigher weigher = {})
+      : options_(std::move(options)), weigher_(std::move(weigher)) {
+    std::size_t shards = options_.shards;
+    if (shards == 0) {
+      shards = std::bit_ceil(4 * std::max(1u, std::thread::hardware_concurrency()));
+      while (shards > 1 && options_.capacity / shards < 16) shards /= 2;  // keep small caches exact
+    }
+    shards = std::bit_ceil(std::max<std::size_t>(shards, 1));
+    shard_bits_ = static_cast<unsigned>(std::countr_zero(shards));
+    shards_ = std::make_unique<Shard[]>(shards);
+    shard_count_ = shards;
+    for (std::size_t i = 0; i < shards; ++i) {
+      shards_[i].capacity = options_.capacity / shards + (i < options_.capacity % shards ? 1 : 0);
+    }
+
+    metrics::Registry* registry = options_.registry;
+    if (registry == nullptr) {
+      own_registry_ = std::make_unique<metrics::Registry>();
+      registry = own_registry_.get();
+    }
+    const metrics::Labels labels = {{"cache", options_.name}};
+    hits_ = &registry->counter("tcc_cache_hits_total", "Cache lookups that found a live entry", labels);
+    misses_ = &registry->counter("tcc_cache_misses_total", "Cache lookups that found nothing or an expired entry",
+                                 labels);
+    inserts_ = &registry->counter("tcc_cache_inserts_total", "Keys added to the cache", labels);
+    evictions_ = &registry->counter("tcc_cache_evictions_total", "Entries evicted for capacity", labels);
+    expirations_ = &registry->counter("tcc_cache_expirations_total", "Entries removed after their TTL", labels);
+    entries_ = &registry->gauge("tcc_cache_entries", "Entries in the cache", labels);
+    weight_ = &registry->gauge("tcc_cache_weight", "Total weight of the entries in the cache", labels);
+  }
+
+  ConcurrentCache(const ConcurrentCache&) = delete;
+  ConcurrentCache& operator=(const ConcurrentCache&) = delete;
+
+  ~ConcurrentCache() {
+    // The gauges outlive the cache in a shared registry.
+    clear();
+  }
+
+  /// Copy of the live value under `key`, or nullopt.
+  std::optional<V> get(const K& key) const {
+    const Shard& s = shard_for(key);
+    std::shared_lock lock(s.mutex);
+    const auto it = s.index.find(key);
+    if (it == s.index.end()) {
+      misses_->inc();
+      return std::nullopt;
+    }
+    const Slot& slot = s.slots[it->second];
+    if (slot.expires != 0 && now() >= slot.expires) {
+      misses_->inc();
+      return std::nullopt;
+    }
+    if (slot.referenced.load(std::memory_order_relaxed) == 0) slot.referenced.store(1, std::memory_order_relaxed);
+    hits_->inc();
+    return slot.item->value;
+  }
+
+  /// Inserts or replaces `key`, evicting from its shard as needed. `ttl`
+  /// of zero means no expiry. Returns false, and drops any previous value,
+  /// when the entry alone outweighs the shard.
+  bool put(const K& key, V value, std::chrono::nanoseconds ttl) {
+    const std::size_t weight = weigher_(key, value);
+    const std::int64_t expires = ttl.count() > 0 ? now() + ttl.count() : 0;
+    Shard& s = shard_for(key);
+    std::unique_lock lock(s.mutex);
+    const auto it = s.index.find(key);
+    if (weight > s.capacity) {
+      if (it != s.index.end()) remove(s, it->second);
+      return false;
+    }
+    if (it != s.index.end()) {
+      const std::uint32_t index = it->second;
+      Slot& slot = s.slots[index];
+      adjust_weight(s, static_cast<std::ptrdiff_t>(weight) - static_cast<std::ptrdiff_t>(slot.weight));
+      slot.item->value = std::move(value);
+      slot.weight = weight;
+      slot.expires = expires;
+      slot.referenced.store(1, std::memory_order_relaxed);
+      while (s.weight > s.capacity) evict_one(s, index);
+      return true;
+    }
+    while (s.weight + weight > s.capacity) evict_one(s, kNoSlot);
+    std::uint32_t index;
+    if (!s.free.empty()) {
+      index = s.free.back();
+      s.free.pop_back();
+    } else {
+      index = static_cast<std::uint32_t>(s.slots.size());
+      s.slots.emplace_back();
+    }
+    Slot& slot = s.slots[index];
+    slot.item.emplace(Item{key, std::move(value)});
+    slot.weight = weight;
+    slot.expires = expires;
+    slot.referenced.store(0, std::memory_order_relaxed);
+    s.index.try_emplace(key, index);
+    adjust_weight(s, static_cast<std::ptrdiff_t>(weight));
+    entries_->add(1);
+    inserts_->inc();
+    return true;
+  }
+
+  bool put(const K& key, V value) { return put(key, std::move(value), options_.ttl); }
+
+  /// get(), or on a miss caches and returns `load()`. Concurrent misses on
+  /// one key may each call `load`; the last put wins.
+  template <class Load>
+  V get_or_load(const K& key, Load&& load) {
+    if (std::optional<V> hit = get(key)) return *std::move(hit);
+    V value = std::forward<Load>(load)();
+    put(key, value);
+    return value;
+  }
+
+  /// Removes `key`; returns whether it was present (expired or not).
+  bool erase(const K& key) {
+    Shard& s = shard_for(key);
+    std::unique_lock lock(s.mutex);
+    const auto it = s.index.find(key);
+    if (it == s.index.end()) return false;
+    remove(s, it->second);
+    return true;
+  }
+
+  void clear() {
+    for (std::size_t i = 0; i < shard_count_; ++i) {
+      Shard& s = shards_[i];
+      std::unique_lock lock(s.mutex);
+      entries_->sub(static_cast<double>(s.index.size()));
+      adjust_weight(s, -static_cast<std::ptrdiff_t>(s.weight));
+      s.index.clear();
+      s.slots.clear();
+      s.free.clear();
+      s.hand = 0;
+    }
+  }
+
+  std::size_t capacity() const noexcept { return options_.capacity; }
+  std::size_t shard_count() const noexcept { return shard_count_; }
+
+  /// Counters as of now; entries and weight are summed shard by shard.
+  Stats stats() const {
+    Stats out{hits_->value(), misses_->value(), inserts_->value(), evictions_->value(), expirations_->value()};
+    for (std::size_t i = 0; i < shard_count_; ++i) {
+      std::shared_lock lock(shards_[i].mutex);
+      out.entries += shards_[i].index.size();
+      out.weight += shards_[i].weight;
+    }
+    return out;
+  }
+
+ private:
+  static constexpr std::uint32_t kNoSlot = std::numeric_limits<std::uint32_t>::max();
+
+  struct Item {
+    K key;
+    V value;
+  };
+
+  // Slots never move (std::deque), so the atomic bit needs no copy and
+  // index entries stay valid while the map rehashes.
+  struct Slot {
+    std::optional<Item> item;  // empty on the free list
+    std::size_t weight = 0;
+    std::int64_t expires = 0;  // steady_clock nanoseconds; 0: never
+    mutable std::atomic<std::uint8_t> referenced{0};
+  };
+
+  struct alignas(kCacheLineSize) Shard {
+    mutable std::shared_mutex mutex;
+    FlatHashMap<K, std::uint32_t, Hash, KeyEqual> index;
+    std::deque<Slot> slots;
+    std::vector<std::uint32_t> free;
+    std::size_t hand = 0;
+    std::size_t weight = 0;
+    std::size_t capacity = 0;
+  };
+
+  static std::int64_t now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+  }
+
+  const Shard& shard_for(const K& key) const noexcept {
+    if (shard_bits_ == 0) return shards_[0];
+    // Remixed in case Hash is not a mixing hash; top bits, as the map
+    // inside the shard uses the low ones.
+    const auto h = static_cast<std::size_t>(detail::hash_mix(static_cast<std::uint64_t>(hash_(key))));
+    return shards_[h >> (std::numeric_limits<std::size_t>::digits - shard_bits_)];
+  }
+  Shard& shard_for(const K& key) noexcept { return const_cast<Shard&>(std::as_const(*this).shard_for(key)); }
+
+  void adjust_weight(Shard& s, std::ptrdiff_t delta) noexcept {
+    s.weight = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(s.weight) + delta);
+    if (delta != 0) weight_->add(static_cast<double>(delta));
+  }
+
+  void remove(Shard& s, std::uint32_t index) {
+    Slot& slot = s.slots[index];
+    s.index.erase(slot.item->key);
+    adjust_weight(s, -static_cast<std::ptrdiff_t>(slot.weight));
+    entries_->sub(1);
+    slot.item.reset();
+    slot.weight = 0;
+    s.free.push_back(index);
+  }
+
+  /// One CLOCK step to a victim, never `keep`. Caller holds the shard
+  /// exclusively and s.weight > 0 from entries other than `keep`.
+  void evict_one(Shard& s, std::uint32_t keep) {
+    const std::int64_t t = now();
+    for (;;) {
+      if (s.hand >= s.slots.size()) s.hand = 0;
+      const auto index = static_cast<std::uint32_t>(s.hand++);
+      Slot& slot = s.slots[index];
+      if (!slot.item || index == keep) continue;
+      if (slot.expires != 0 && t >= slot.expires) {
+        remove(s, index);
+        expirations_->inc();
+        return;
+      }
+      if (slot.referenced.exchange(0, std::memory_order_relaxed) != 0) continue;  // second chance
+      remove(s, index);
+      evictions_->inc();
+      return;
+    }
+  }
+
+  CacheOptions options_;
+  [[no_unique_address]] Weigher weigher_;
+  [[no_unique_address]] Hash hash_;
+  std::unique_ptr<Shard[]> shards_;
+  std::size_t shard_count_ = 0;
+  unsigned shard_bits_ = 0;
+  std::unique_ptr<metrics::Registry> own_registry_;
+  metrics::Counter* hits_ = nullptr;
+  metrics::Counter* misses_ = nullptr;
+  metrics::Counter* inserts_ = nullptr;
+  metrics::Counter* evictions_ = nullptr;
+  metrics::Counter* expirations_ = nullptr;
+  metrics::Gauge* entries_ = nullptr;
+  metrics::Gauge* weight_ = nullptr;
+};
+
+}  // namespace tcc
@@ -0,0 +1,388 @@
+#pragma once
+
+// C++20 coroutine types that run on tcc::ThreadPool.
+//
+//   tcc::Task<int> answer() { co_return 42; }
+//
+//   tcc::Task<int> sum(tcc::ThreadPool& pool) {
+//     co_await tcc::schedule(pool);       // continue on a pool worker
+//     int a = co_await answer();          // symmetric transfer, no stack growth
+//     co_return a + co_await answer();
+//   }
+//
+//   int total = tcc::sync_wait(sum(pool));  // block a non-pool thread on it
+//   tcc::spawn(pool, fire_and_forget());    // detached Task<void>
+//
+//   tcc::Generator<int> iota(int n) { for (int i = 0; i < n; ++i) co_yield i; }
+//
+// Task<T> is lazy: nothing runs until it is awaited (or passed to sync_wait
+// or spawn). Completing a task resumes its awaiter directly through
+// symmetric transfer, so chains of any depth neither grow the stack nor
+// touch the scheduler. I/O and timer awaitables live in tcc/io_await.hpp.
+//
+// Coroutine frames come from a per-thread recycling allocator with
+// size-classed free lists, so a steady-state co_await of a fresh Task costs
+// no call into malloc.
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "tcc/export.hpp"
+#include "tcc/thread_pool.hpp"
+
+namespace tcc {
+
+namespace detail {
+
+/// Frame storage. Sizes up to kMaxRecycledFrame are served from per-thread
+/// free lists (a frame freed on another thread joins that thread's list);
+/// larger frames go to ::operator new.
+TCC_API void* frame_allocate(std::size_t size);
+TCC_API void frame_deallocate(void* frame, std::size_t size) noexcept;
+
+inline constexpr std::size_t kMaxRecycledFrame = 1024;
+
+/// Gives every promise type in this header the recycling allocator.
+struct FramePromise {
+  static void* operator new(std::size_t size) { return frame_allocate(size); }
+  static void operator delete(void* frame, std::size_t size) noexcept { frame_deallocate(frame, size); }
+};
+
+}  // namespace detail
+
+// --- Task<T> ------------------------------------------------------------------
+
+template <class T = void>
+class Task;
+
+namespace detail {
+
+struct TaskPromiseBase : FramePromise {
+  struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+    template <class Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> self) noexcept {
+      return self.promise().continuation_;
+    }
+    void await_resume() const noexcept {}
+  };
+
+  std::suspend_always initial_suspend() const noexcept { return {}; }
+  FinalAwaiter final_suspend() const noexcept { return {}; }
+  void unhandled_exception() noexcept { error_ = std::current_exception(); }
+
+  std::coroutine_handle<> continuation_ = std::noop_coroutine();
+  std::exception_ptr error_;
+};
+
+template <class T>
+struct TaskPromise final : TaskPromiseBase {
+  Task<T> get_return_object() noexcept;
+
+  template <class U = T>
+    requires std::is_convertible_v<U&&, T>
+  void return_value(U&& value) noexcept(std::is_nothrow_constructible_v<T, U&&>) {
+    value_.emplace(std::forward<U>(value));
+  }
+
+  T take() {
+    if (error_) std::rethrow_exception(error_);
+    return std::move(*value_);
+  }
+
+  std::optional<T> value_;
+};
+
+template <>
+struct TaskPromise<void> final : TaskPromiseBase {
+  Task<void> get_return_object() noexcept;
+  void return_void() const noexcept {}
+  void take() {
+    if (error_) std::rethrow_exception(error_);
+  }
+};
+
+}  // namespace detail
+
+/// Lazily started coroutine producing a T (or an exception). Move-only;
+/// destroying an unfinished Task destroys its frame without running it.
+template <class T>
+class [[nodiscard]] Task {
+ public:
+  using promise_type = detail::TaskPromise<T>;
+  using value_type = T;
+
+  Task() noexcept = default;
+  Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+  Task& operator=(Task&& other) noexcept {
+    if (this != &other) {
+      if (handle_) handle_.destroy();
+      handle_ = std::exchange(other.handle_, {});
+    }
+    return *this;
+  }
+  ~Task() {
+    if (handle_) handle_.destroy();
+  }
+
+  bool valid() const noexcept { return static_cast<bool>(handle_); }
+  bool done() const noexcept { return handle_ && handle_.done(); }
+
+  /// Starts the task (if needed), suspends the awaiter until it finishes,
+  /// and yields its result or rethrows its exception. Awaiting a task
+  /// without a coroutine (default-constructed or moved-from) throws
+  /// std::logic_error.
+  auto operator co_await() && noexcept { return Awaiter<true>{handle_}; }
+  auto operator co_await() & noexcept { return Awaiter<true>{handle_}; }
+
+  /// Like co_await, but leaves the result in the task for result().
+  auto when_ready() noexcept { return Awaiter<false>{handle_}; }
+
+  /// Result of a finished task; rethrows its exception. Throws
+  /// std::logic_error for a task without a coroutine.
+  T result() {
+    if (!handle_) throw_invalid();
+    return handle_.promise().take();
+  }
+
+ private:
+  friend promise_type;
+  explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+  [[noreturn]] static void throw_invalid() {
+    throw std::logic_error("tcc::Task: the task has no coroutine (default-constructed or moved-from)");
+  }
+
+  template <bool TakeResult>
+  struct Awaiter {
+    std::coroutine_handle<promise_type> handle;
+
+    bool await_ready() const noexcept { return !handle || handle.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+      handle.promise().continuation_ = awaiting;
+      return handle;
+    }
+    decltype(auto) await_resume() {
+      if constexpr (TakeResult) {
+        if (!handle) throw_invalid();
+        return handle.promise().take();
+      }
+    }
+  };
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+template <class T>
+Task<T> detail::TaskPromise<T>::get_return_object() noexcept {
+  return Task<T>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+}
+
+inline Task<void> detail::TaskPromise<void>::get_return_object() noexcept {
+  return Task<void>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+}
+
+// --- Scheduling -------------------------------------------------------------------
+
+/// `co_await schedule(pool)` suspends and resumes on a worker of `pool`. The
+/// wake-up job lives in the awaiter (inside the frame), so hopping threads
+/// allocates nothing.
+class ScheduleAwaiter {
+ public:
+  explicit ScheduleAwaiter(ThreadPool& pool) noexcept : pool_(pool) {}
+
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> awaiting) {
+    job_.handle = awaiting;
+    pool_.submit(job_);
+  }
+  void await_resume() const noexcept {}
+
+ private:
+  struct ResumeJob final : Job {
+    void execute() override { handle.resume(); }
+    std::coroutine_handle<> handle;
+  };
+
+  ThreadPool& pool_;
+  ResumeJob job_;
+};
+
+inline ScheduleAwaiter schedule(ThreadPool& pool) noexcept { return ScheduleAwaiter(pool); }
+
+namespace detail {
+
+struct SyncWaitState {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done = false;
+};
+
+/// Wrapper coroutine for sync_wait: awaits the task, then wakes the blocked
+/// thread. The flag is set under the mutex so the waiter cannot return (and
+/// destroy the state) while the notifier still touches it.
+struct SyncWaiter {
+  struct promise_type : FramePromise {
+    SyncWaitState* state = nullptr;
+
+    SyncWaiter get_return_object() noexcept {
+      return {std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    auto final_suspend() const noexcept {
+      struct Notify {
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<promise_type> self) const noexcept {
+          SyncWaitState& s = *self.promise().state;
+          std::lock_guard lock(s.mutex);
+          s.done = true;
+          s.cv.notify_one();
+        }
+        void await_resume() const noexcept {}
+      };
+      return Notify{};
+    }
+    void return_void() const noexcept {}
+    void unhandled_exception() const noexcept { std::terminate(); }  // when_ready() does not throw
+  };
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+template <class T>
+SyncWaiter make_sync_waiter(Task<T>& task) {
+  co_await task.when_ready();
+}
+
+struct Detached {
+  struct promise_type : FramePromise {
+    Detached get_return_object() const noexcept { return {}; }
+    std::suspend_never initial_suspend() const noexcept { return {}; }
+    std::suspend_never final_suspend() const noexcept { return {}; }
+    void return_void() const noexcept {}
+    void unhandled_exception() const noexcept { std::terminate(); }
+  };
+};
+
+inline Detached run_detached(ThreadPool& pool, Task<void> task) {
+  co_await schedule(pool);
+  co_await std::move(task);
+}
+
+}  // namespace detail
+
+/// Runs `task` to completion on the calling thread (and wherever it hops to)
+/// and returns its result. Must not be called from a pool worker that the
+/// task needs in order to finish.
+template <class T>
+T sync_wait(Task<T> task) {
+  detail::SyncWaitState state;
+  detail::SyncWaiter waiter = detail::make_sync_waiter(task);
+  waiter.handle.promise().state = &state;
+  waiter.handle.resume();
+  {
+    std::unique_lock lock(state.mutex);
+    state.cv.wait(lock, [&] { return state.done; });
+  }
+  waiter.handle.destroy();
+  return task.result();
+}
+
+/// Starts `task` on `pool` without waiting for it. An exception escaping the
+/// task terminates the process, as with ThreadPool::post().
+inline void spawn(ThreadPool& pool, Task<void> task) { detail::run_detached(pool, std::move(task)); }
+
+// --- Generator<T> ---------------------------------------------------------------
+
+/// Synchronous lazy sequence: `for (const T& x : gen())`. Each yielded value
+/// is referenced in place, not copied, until the generator is resumed.
+template <class T>
+class [[nodiscard]] Generator {
+ public:
+  using value_type = std::remove_cvref_t<T>;
+
+  struct promise_type : detail::FramePromise {
+    const value_type* current = nullptr;
+    std::exception_ptr error;
+
+    Generator get_return_object() noexcept {
+      return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    std::suspend_always final_suspend() const noexcept { return {}; }
+    std::suspend_always yield_value(const value_type& value) noexcept {
+      current = std::addressof(value);
+      return {};
+    }
+    void return_void() const noexcept {}
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+    template <class U>
+    std::suspend_never await_transform(U&&) = delete;  // generators are synchronous
+  };
+
+  class iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Generator::value_type;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() noexcept = default;
+
+    const value_type& operator*() const noexcept { return *handle_.promise().current; }
+    const value_type* operator->() const noexcept { return handle_.promise().current; }
+
+    iterator& operator++() {
+      handle_.resume();
+      if (handle_.done() && handle_.promise().error) std::rethrow_exception(handle_.promise().error);
+      return *this;
+    }
+    void operator++(int) { ++*this; }
+
+    friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept {
+      return !it.handle_ || it.handle_.done();
+    }
+
+   private:
+    friend class Generator;
+    explicit iterator(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+  };
+
+  Generator(Generator&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+  Generator& operator=(Generator&& other) noexcept {
+    if (this != &other) {
+      if (handle_) handle_.destroy();
+      handle_ = std::exchange(other.handle_, {});
+    }
+    return *this;
+  }
+  ~Generator() {
+    if (handle_) handle_.destroy();
+  }
+
+  /// Runs to the first co_yield. Call once.
+  iterator begin() {
+    iterator it(handle_);
+    ++it;
+    return it;
+  }
+  std::default_sentinel_t end() const noexcept { return {}; }
+
+ private:
+  explicit Generator(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+}  // namespace tcc
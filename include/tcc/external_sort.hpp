@@ -0,0 +1,431 @@
+#pragma once
+
+// Sorting fixed-size records that do not fit in memory.
+//
+//   struct Row { std::uint64_t id; std::uint32_t shard; float score; };
+//   tcc::ExternalSortStats s = tcc::external_sort<Row>(
+//       "rows.bin", "rows.sorted.bin", {.run_bytes = 1 << 30},
+//       [](const Row& r) { return r.id; });
+//
+//   std::vector<std::uint32_t> keys = ...;
+//   tcc::radix_sort(std::span(keys));  // the in-memory stage on its own
+//
+// The input is cut into runs of `run_bytes`. Each run is sorted with a
+// parallel LSD radix sort on the ThreadPool. Runs are then spilled to temp
+// files and read back through MappedFile (sequential advice, so the kernel
+// reads ahead and drops pages behind the merge) for a k-way merge with a
+// loser tree. More than `fan_in` runs take several merge passes; within a
+// pass, independent groups merge in parallel. An input that fits in one run
+// is sorted in memory and never spilled.
+//
+// Keys are integers, returned by a projection from the record. The radix
+// sort does one pass per key byte and skips the bytes that are equal in
+// every record, so 64-bit keys with a small range cost little more than
+// 32-bit ones. Bucket offsets use simd::prefix_sum. The sort is stable:
+// records with equal keys keep their input order, across runs too.
+//
+// Peak memory is about 2 * run_bytes (the run and its scatter buffer) plus
+// a small output buffer per concurrent merge. Temp files live in a private
+// directory under `temp_dir` and are removed when the call returns or
+// throws.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tcc/export.hpp"
+#include "tcc/mapped_file.hpp"
+#include "tcc/simd.hpp"
+#include "tcc/thread_pool.hpp"
+
+namespace tcc {
+
+/// Default key projection: the record is its own key.
+struct IdentityKey {
+  template <class T>
+  constexpr const T& operator()(const T& value) const noexcept {
+    return value;
+  }
+};
+
+struct ExternalSortOptions {
+  std::size_t run_bytes = std::size_t{256} << 20;  // records sorted in memory at once
+  std::size_t fan_in = 64;                         // runs merged per pass, at least 2
+  std::filesystem::path temp_dir{};                // empty: std::filesystem::temp_directory_path()
+  ThreadPool* pool = nullptr;                      // nullptr: ThreadPool::global()
+};
+
+struct ExternalSortStats {
+  std::uint64_t records = 0;
+  std::uint64_t runs = 0;           // sorted runs cut from the input; 1 means nothing was spilled
+  std::uint64_t merge_passes = 0;   // including the final one into the output
+  std::uint64_t bytes_spilled = 0;  // written to temp files over all passes
+};
+
+namespace detail {
+
+template <class T, class Key>
+using radix_key_t = std::remove_cvref_t<std::invoke_result_t<Key&, const T&>>;
+
+/// Maps an integer key onto an unsigned one with the same order.
+template <class K>
+constexpr std::make_unsigned_t<K> radix_bits(K key) noexcept {
+  using U = std::make_unsigned_t<K>;
+  auto bits = static_cast<U>(key);
+  if constexpr (std::is_signed_v<K>) bits ^= static_cast<U>(U{1} << (8 * sizeof(K) - 1));
+  return bits;
+}
+
+using RadixCounts = std::array<std::uint32_t, 256>;
+
+// Slices smaller than this are not worth a task of their own.
+inline constexpr std::size_t kRadixMinSlice = std::size_t{1} << 16;
+
+/// Stable LSD radix sort of `data`, using `scratch` (same size or larger)
+/// as the scatter target. Sequential when `pool` is null.
+template <class T, class Key>
+void radix_sort(ThreadPool* pool, std::span<T> data, std::span<T> scratch, Key& key) {
+  using K = radix_key_t<T, Key>;
+  static_assert(std::is_integral_v<K> && !std::is_same_v<K, bool>, "radix_sort: the key must be an integer");
+  static_assert(std::is_trivially_copyable_v<T>, "radix_sort: records must be trivially copyable");
+  constexpr std::size_t kPasses = sizeof(K);
+  const std::size_t n = data.size();
+  if (n < 2) return;
+  if (scratch.size() < n) throw std::invalid_argument("radix_sort: scratch is smaller than the data");
+  if (n > std::numeric_limits<std::uint32_t>::max()) throw std::length_error("radix_sort: more than 2^32 records");
+
+  const std::size_t workers = pool != nullptr ? pool->size() : 1;
+  const std::size_t tasks = std::clamp<std::size_t>(n / kRadixMinSlice, 1, std::max<std::size_t>(workers, 1));
+  const auto slice = [&](std::size_t t) { return IndexRange{n * t / tasks, n * (t + 1) / tasks}; };
+  const auto for_each_task = [&](auto&& fn) {
+    if (tasks == 1) {
+      fn(std::size_t{0});
+      return;
+    }
+    parallel_for(*pool, {0, tasks}, 1, [&](IndexRange r) {
+      for (std::size_t t = r.begin; t < r.end; ++t) fn(t);
+    });
+  };
+  const auto digit = [&](const T& record, std::size_t pass) {
+    return static_cast<std::size_t>((radix_bits(key(record)) >> (8 * pass)) & 0xff);
+  };
+
+  // counts[t * kPasses + p]: histogram of byte p over slice t. Totals per
+  // byte do not depend on the order, so one read finds the passes to skip.
+  std::vector<RadixCounts> counts(tasks * kPasses);
+  for_each_task([&](std::size_t t) {
+    RadixCounts* c = &counts[t * kPasses];
+    for (std::size_t p = 0; p < kPasses; ++p) c[p].fill(0);
+    const IndexRange r = slice(t);
+    for (std::size_t i = r.begin; i < r.end; ++i) {
+      const auto bits = radix_bits(key(data[i]));
+      for (std::size_t p = 0; p < kPasses; ++p) ++c[p][static_cast<std::size_t>((bits >> (8 * p)) & 0xff)];
+    }
+  });
+
+  T* src = data.data();
+  T* dst = scratch.data();
+  bool permuted = false;
+  std::vector<RadixCounts> offsets(tasks);
+  for (std::size_t p = 0; p < kPasses; ++p) {
+    RadixCounts totals{};
+    for (std::size_t t = 0; t < tasks; ++t) {
+      for (std::size_t d = 0; d < 256; ++d) totals[d] += counts[t * kPasses + p][d];
+    }
+    if (*std::max_element(totals.begin(), totals.end()) == n) continue;  // every record has the same byte
+    if (permuted) {
+      // Records moved between slices in the previous pass.
+      for_each_task([&](std::size_t t) {
+        RadixCounts& c = counts[t * kPasses + p];
+        c.fill(0);
+        const IndexRange r = slice(t);
+        for (std::size_t i = r.begin; i < r.end; ++i) ++c[digit(src[i], p)];
+      });
+    }
+
+    RadixCounts starts;
+    simd::prefix_sum(totals, starts);
+    for (std::size_t d = 0; d < 256; ++d) {
+      std::uint32_t at = starts[d] - totals[d];
+      for (std::size_t t = 0; t < tasks; ++t) {
+        offsets[t][d] = at;
+        at += counts[t * kPasses + p][d];
+      }
+    }
+    for_each_task([&](std::size_t t) {
+      RadixCounts& at = offsets[t];
+      const IndexRange r = slice(t);
+      for (std::size_t i = r.begin; i < r.end; ++i) dst[at[digit(src[i], p)]++] = src[i];
+    });
+    std::swap(src, dst);
+    permuted = true;
+  }
+  if (src != data.data()) {
+    for_each_task([&](std::size_t t) {
+      const IndexRange r = slice(t);
+      std::memcpy(data.data() + r.begin, src + r.begin, r.size() * sizeof(T));
+    });
+  }
+}
+
+/// Tournament tree over k sorted sources: the winner is at the root, every
+/// inner node keeps the loser of its match, and replacing the winner
+/// replays only its leaf-to-root path (log2 k comparisons). Ties go to the
+/// lower source index, which keeps the merge stable.
+template <class K>
+class LoserTree {
+ public:
+  explicit LoserTree(std::size_t k) : k_(k), tree_(k), keys_(k), live_(k, 0) {}
+
+  /// Sets source `i` before build(); sources left unset start exhausted.
+  void set(std::size_t i, K key) noexcept {
+    keys_[i] = key;
+    live_[i] = 1;
+  }
+
+  void build() {
+    std::vector<std::size_t> winners(2 * k_);
+    for (std::size_t i = 0; i < k_; ++i) winners[k_ + i] = i;
+    for (std::size_t node = k_ - 1; node >= 1; --node) {
+      const std::size_t a = winners[2 * node], b = winners[2 * node + 1];
+      const bool a_wins = beats(a, b);
+      winners[node] = a_wins ? a : b;
+      tree_[node] = a_wins ? b : a;
+    }
+    tree_[0] = k_ > 1 ? winners[1] : 0;
+  }
+
+  bool empty() const noexcept { return live_[tree_[0]] == 0; }
+  std::size_t winner() const noexcept { return tree_[0]; }
+
+  /// The winner's source advanced to `key`.
+  void replace(K key) noexcept {
+    keys_[tree_[0]] = key;
+    replay();
+  }
+  /// The winner's source ran out.
+  void pop() noexcept {
+    live_[tree_[0]] = 0;
+    replay();
+  }
+
+ private:
+  bool beats(std::size_t a, std::size_t b) const noexcept {
+    if (live_[a] == 0) return false;
+    if (live_[b] == 0) return true;
+    return keys_[a] < keys_[b] || (keys_[a] == keys_[b] && a < b);
+  }
+
+  void replay() noexcept {
+    std::size_t w = tree_[0];
+    for (std::size_t node = (k_ + w) / 2; node >= 1; node /= 2) {
+      if (beats(tree_[node], w)) std::swap(tree_[node], w);
+    }
+    tree_[0] = w;
+  }
+
+  std::size_t k_;
+  std::vector<std::size_t> tree_;  // [0] winner, [1, k) losers; leaf of source i is node k + i
+  std::vector<K> keys_;
+  std::vector<unsigned char> live_;
+};
+
+/// Buffered binary output file. Throws std::system_error.
+class TCC_API FileWriter {
+ public:
+  explicit FileWriter(const std::filesystem::path& path);
+  ~FileWriter();
+  FileWriter(const FileWriter&) = delete;
+  FileWriter& operator=(const FileWriter&) = delete;
+
+  void write(const void* data, std::size_t bytes);
+  /// Flushes and closes, reporting write-back errors the destructor would swallow.
+  void finish();
+
+ private:
+  std::filesystem::path path_;
+  void* file_;  // std::FILE*
+};
+
+/// Private directory of spill files, removed with everything in it on
+/// destruction. Not thread-safe.
+class TCC_API SpillDir {
+ public:
+  explicit SpillDir(const std::filesystem::path& parent);
+  ~SpillDir();
+  SpillDir(const SpillDir&) = delete;
+  SpillDir& operator=(const SpillDir&) = delete;
+
+  /// A fresh file name in the directory; the file is not created.
+  std::filesystem::path next();
+
+ private:
+  std::filesystem::path dir_;
+  std::size_t files_ = 0;
+};
+
+/// Merges sorted run files into `output`, removing each run once merged.
+/// Returns the bytes written.
+template <class T, class Key>
+std::uint64_t merge_runs(std::span<const std::filesystem::path> runs, const std::filesystem::path& output,
+                         Key& key) {
+  using K = radix_key_t<T, Key>;
+  struct Source {
+    const T* pos;
+    const T* end;
+  };
+  std::vector<MappedFile> files;
+  std::vector<Source> sources;
+  files.reserve(runs.size());
+  LoserTree<K> tree(runs.size());
+  for (std::size_t i = 0; i < runs.size(); ++i) {
+    const MappedFile& file = files.emplace_back(runs[i], Advice::sequential);
+    const auto* first = reinterpret_cast<const T*>(file.data());
+    sources.push_back({first, first + file.size() / sizeof(T)});
+    if (first != sources.back().end) tree.set(i, key(*first));
+  }
+  tree.build();
+
+  constexpr std::size_t kBatch = std::max<std::size_t>(1, (std::size_t{1} << 20) / sizeof(T));
+  const auto batch = std::make_unique_for_overwrite<T[]>(kBatch);
+  FileWriter out(output);
+  std::uint64_t written = 0;
+  std::size_t fill = 0;
+  while (!tree.empty()) {
+    Source& s = sources[tree.winner()];
+    batch[fill++] = *s.pos;
+    if (++s.pos == s.end) {
+      tree.pop();
+    } else {
+      tree.replace(key(*s.pos));
+    }
+    if (fill == kBatch || tree.empty()) {
+      out.write(batch.get(), fill * sizeof(T));
+      written += fill * sizeof(T);
+      fill = 0;
+    }
+  }
+  out.finish();
+  files.clear();
+  for (const auto& run : runs) std::filesystem::remove(run);
+  return written;
+}
+
+}  // namespace detail
+
+// --- In memory --------------------------------------------------------------
+
+/// Stable radix sort of `data` by the integer `key(record)`, in parallel on
+/// `pool` for large inputs. `scratch` must hold at least data.size()
+/// records; its contents are unspecified afterwards. Throws
+/// std::invalid_argument for a short scratch and std::length_error beyond
+/// 2^32 records.
+template <class T, class Key = IdentityKey>
+void radix_sort(ThreadPool& pool, std::span<T> data, std::span<T> scratch, Key key = {}) {
+  detail::radix_sort(&pool, data, scratch, key);
+}
+
+/// Sequential radix_sort with its own scratch buffer.
+template <class T, class Key = IdentityKey>
+void radix_sort(std::span<T> data, Key key = {}) {
+  if (data.size() < 2) return;
+  const auto scratch = std::make_unique_for_overwrite<std::remove_const_t<T>[]>(data.size());
+  detail::radix_sort<T>(nullptr, data, {scratch.get(), data.size()}, key);
+}
+
+// --- External ---------------------------------------------------------------
+
+/// Writes the records of `input`, sorted by `key(record)`, to `output`.
+/// Throws std::system_error on I/O errors and std::invalid_argument for
+/// bad options. `output` is replaced.
+template <class T, class Key = IdentityKey>
+ExternalSortStats external_sort(std::span<const T> input, const std::filesystem::path& output,
+                                const ExternalSortOptions& options = {}, Key key = {}) {
+  static_assert(std::is_trivially_copyable_v<T>, "external_sort: records must be trivially copyable");
+  if (options.fan_in < 2) throw std::invalid_argument("external_sort: fan_in must be at least 2");
+  ThreadPool& pool = options.pool != nullptr ? *options.pool : ThreadPool::global();
+  const std::size_t n = input.size();
+  const std::size_t run_records = std::clamp<std::size_t>(options.run_bytes / sizeof(T), 1,
+                                                          std::numeric_limits<std::uint32_t>::max());
+  ExternalSortStats stats;
+  stats.records = n;
+  if (n <= run_records) {
+    // One run: sort in memory and write the output directly.
+    std::vector<T> run(input.begin(), input.end()), scratch(n);
+    detail::radix_sort<T>(&pool, run, scratch, key);
+    detail::FileWriter out(output);
+    out.write(run.data(), n * sizeof(T));
+    out.finish();
+    stats.runs = 1;
+    return stats;
+  }
+
+  detail::SpillDir spill(options.temp_dir.empty() ? std::filesystem::temp_directory_path() : options.temp_dir);
+  std::vector<std::filesystem::path> runs;
+  {
+    std::vector<T> run(run_records), scratch(run_records);
+    for (std::size_t begin = 0; begin < n; begin += run_records) {
+      const std::size_t count = std::min(run_records, n - begin);
+      std::memcpy(run.data(), input.data() + begin, count * sizeof(T));
+      detail::radix_sort<T>(&pool, {run.data(), count}, scratch, key);
+      runs.push_back(spill.next());
+      detail::FileWriter out(runs.back());
+      out.write(run.data(), count * sizeof(T));
+      out.finish();
+      stats.bytes_spilled += count * sizeof(T);
+    }
+  }
+  stats.runs = runs.size();
+
+  // Runs are consecutive slices of the input, and each group merges
+  // neighbouring runs in order, so ties keep their input order.
+  while (runs.size() > options.fan_in) {
+    const std::size_t groups = (runs.size() + options.fan_in - 1) / options.fan_in;
+    std::vector<std::filesystem::path> merged(groups);
+    for (auto& path : merged) path = spill.next();
+    std::vector<std::uint64_t> bytes(groups);
+    parallel_for(pool, {0, groups}, 1, [&](IndexRange r) {
+      for (std::size_t g = r.begin; g < r.end; ++g) {
+        const std::size_t first = g * options.fan_in;
+        const std::size_t count = std::min(options.fan_in, runs.size() - first);
+        bytes[g] = detail::merge_runs<T>(std::span(runs).subspan(first, count), merged[g], key);
+      }
+    });
+    for (std::uint64_t b : bytes) stats.bytes_spilled += b;
+    ++stats.merge_passes;
+    runs = std::move(merged);
+  }
+  detail::merge_runs<T>(std::span<const std::filesystem::path>(runs), output, key);
+  ++stats.merge_passes;
+  return stats;
+}
+
+/// external_sort over the records of the file at `input`, which must hold
+/// a whole number of records and must not be `output`.
+template <class T, class Key = IdentityKey>
+ExternalSortStats external_sort(const std::filesystem::path& input, const std::filesystem::path& output,
+                                const ExternalSortOptions& options = {}, Key key = {}) {
+  std::error_code ec;
+  if (std::filesystem::equivalent(input, output, ec)) {
+    throw std::invalid_argument("external_sort: " + input.string() + " cannot be sorted in place");
+  }
+  MappedFile file(input, Advice::sequential);
+  if (file.size() % sizeof(T) != 0) {
+    throw std::invalid_argument("external_sort: " + input.string() + " is not a whole number of records");
+  }
+  const std::span<const T> records(reinterpret_cast<const T*>(file.data()), file.size() / sizeof(T));
+  return external_sort<T>(records, output, options, std::move(key));
+}
+
+}  // namespace tcc
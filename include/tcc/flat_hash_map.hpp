@@ -0,0 +1,611 @@
+#pragma once
+
+// Open-addressing hash map in the SwissTable layout.
+//
+//   tcc::FlatHashMap<std::string, int> counts;
+//   counts.reserve(words.size());            // no rehash for the next inserts
+//   for (std::string_view w : words) ++counts[std::string(w)];
+//   auto it = counts.find("the");            // heterogeneous: no std::string built
+//
+// One control byte per slot lives in an array of its own, apart from the
+// slots: the top bit marks empty/deleted/sentinel, and for full slots the
+// low 7 bits hold 7 bits of the hash (H2). A lookup hashes once, loads the
+// 16 control bytes at the probe position and compares all of them against
+// H2 in one SIMD instruction (tcc/simd_group.hpp), so a typical hit reads
+// one control group and one slot, and a miss usually stops at the first
+// group containing an empty byte. The remaining hash bits (H1) choose the
+// start group; collisions probe further groups triangularly.
+//
+// Capacity is always 2^k - 1 slots. The control array holds one sentinel
+// after the last slot (where iteration stops) followed by a copy of the
+// first 15 control bytes, so a group load starting near the end reads the
+// wrapped-around bytes without a bounds check. The table grows when 7/8 of
+// the slots are full or deleted.
+//
+// Like std::unordered_map, value_type is std::pair<const K, V>. Unlike it,
+// slots move on rehash: any insertion that grows the table invalidates
+// iterators and references. Erasure leaves them valid for other elements.
+// Lookups are heterogeneous when both Hash and KeyEqual define
+// is_transparent, as FlatHash does for string keys.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "tcc/simd_group.hpp"
+
+namespace tcc {
+
+namespace detail {
+
+/// Folded 64x64->128 multiply, as in absl's hash mixing. std::hash on
+/// integers is the identity, which would leave H2 (the low 7 bits) with
+/// almost no entropy for keys that are multiples of a power of two.
+inline std::uint64_t hash_mix(std::uint64_t x) noexcept {
+  constexpr std::uint64_t kMul = 0x9e3779b97f4a7c15ull;
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 m = static_cast<unsigned __int128>(x) * kMul;
+  return static_cast<std::uint64_t>(m) ^ static_cast<std::uint64_t>(m >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  std::uint64_t high;
+  const std::uint64_t low = _umul128(x, kMul, &high);
+  return low ^ high;
+#else
+  // murmur3 finalizer.
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ull;
+  x ^= x >> 33;
+  return x;
+#endif
+}
+
+template <bool Transparent>
+struct KeyArg {
+  template <class Q, class K>
+  using type = Q;
+};
+
+template <>
+struct KeyArg<false> {
+  template <class Q, class K>
+  using type = K;
+};
+
+}  // namespace detail
+
+/// Default hasher: std::hash followed by a 64-bit mix. Transparent over
+/// std::string, std::string_view and const char*.
+template <class K>
+struct FlatHash {
+  std::size_t operator()(const K& key) const noexcept(noexcept(std::hash<K>{}(key))) {
+    return static_cast<std::size_t>(detail::hash_mix(static_cast<std::uint64_t>(std::hash<K>{}(key))));
+  }
+};
+
+template <>
+struct FlatHash<std::string> {
+  using is_transparent = void;
+  std::size_t operator()(std::string_view key) const noexcept {
+    return static_cast<std::size_t>(
+        detail::hash_mix(static_cast<std::uint64_t>(std::hash<std::string_view>{}(key))));
+  }
+};
+
+template <>
+struct FlatHash<std::string_view> : FlatHash<std::string> {};
+
+template <class K, class V, class Hash = FlatHash<K>, class KeyEqual = std::equal_to<>>
+class FlatHashMap {
+  static constexpr bool kTransparent = requires {
+    typename Hash::is_transparent;
+    typename KeyEqual::is_transparent;
+  };
+
+  // Heterogeneous overloads take `const key_arg<Q>&`: Q itself when both
+  // functors are transparent (deduced from the argument), K otherwise.
+  template <class Q>
+  using key_arg = typename detail::KeyArg<kTransparent>::template type<Q, K>;
+
+  using ctrl_t = std::int8_t;
+  using Group = simd::Group16;
+
+  static constexpr ctrl_t kEmpty = -128;
+  static constexpr ctrl_t kDeleted = -2;
+  static constexpr ctrl_t kSentinel = -1;
+  static constexpr std::size_t kWidth = Group::kWidth;
+  static constexpr std::size_t kMinCapacity = kWidth - 1;
+
+ public:
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<const K, V>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+
+  template <bool Const>
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = FlatHashMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<Const, const value_type&, value_type&>;
+    using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+    Iterator() noexcept = default;
+    /// iterator -> const_iterator.
+    template <bool C>
+      requires(Const && !C)
+    Iterator(const Iterator<C>& other) noexcept : ctrl_(other.ctrl_), slot_(other.slot_) {}
+
+    reference operator*() const noexcept { return *slot_; }
+    pointer operator->() const noexcept { return slot_; }
+
+    Iterator& operator++() noexcept {
+      ++ctrl_;
+      ++slot_;
+      skip_free();
+      return *this;
+    }
+    Iterator operator++(int) noexcept {
+      Iterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    friend bool operator==(const Iterator& a, const Iterator& b) noexcept { return a.ctrl_ == b.ctrl_; }
+
+   private:
+    friend class FlatHashMap;
+    template <bool>
+    friend class Iterator;
+
+    Iterator(const ctrl_t* ctrl, pointer slot) noexcept : ctrl_(ctrl), slot_(slot) {}
+
+    // Empty and deleted bytes are below kSentinel, so this stops at the
+    // first full slot or at the sentinel after the last one.
+    void skip_free() noexcept {
+      while (*ctrl_ < kSentinel) {
+        ++ctrl_;
+        ++slot_;
+      }
+    }
+
+    const ctrl_t* ctrl_ = nullptr;
+    pointer slot_ = nullptr;
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  FlatHashMap() noexcept(std::is_nothrow_default_constructible_v<Hash> &&
+                         std::is_nothrow_default_constructible_v<KeyEqual>) = default;
+
+  explicit FlatHashMap(size_type expected, const Hash& hash = Hash(), const KeyEqual& eq = KeyEqual())
+      : hash_(hash), eq_(eq) {
+    reserve(expected);
+  }
+
+  FlatHashMap(std::initializer_list<value_type> init) {
+    reserve(init.size());
+    for (const value_type& v : init) insert(v);
+  }
+
+  FlatHashMap(const FlatHashMap& other) : hash_(other.hash_), eq_(other.eq_) {
+    reserve(other.size_);
+    for (const value_type& v : other) insert_unique(hash_(v.first), v);
+  }
+
+  FlatHashMap(FlatHashMap&& other) noexcept
+      : ctrl_(std::exchange(other.ctrl_, nullptr)),
+        slots_(std::exchange(other.slots_, nullptr)),
+        capacity_(std::exchange(other.capacity_, 0)),
+        size_(std::exchange(other.size_, 0)),
+        growth_left_(std::exchange(other.growth_left_, 0)),
+        hash_(std::move(other.hash_)),
+        eq_(std::move(other.eq_)) {}
+
+  FlatHashMap& operator=(const FlatHashMap& other) {
+    if (this != &other) {
+      FlatHashMap copy(other);
+      swap(copy);
+    }
+    return *this;
+  }
+
+  FlatHashMap& operator=(FlatHashMap&& other) noexcept {
+    if (this != &other) {
+      FlatHashMap moved(std::move(other));
+      swap(moved);
+    }
+    return *this;
+  }
+
+  ~FlatHashMap() { destroy_table(); }
+
+  void swap(FlatHashMap& other) noexcept {
+    using std::swap;
+    swap(ctrl_, other.ctrl_);
+    swap(slots_, other.slots_);
+    swap(capacity_, other.capacity_);
+    swap(size_, other.size_);
+    swap(growth_left_, other.growth_left_);
+    swap(hash_, other.hash_);
+    swap(eq_, other.eq_);
+  }
+
+  // --- Iteration and size -------------------------------------------------------
+
+  iterator begin() noexcept {
+    if (size_ == 0) return end();
+    iterator it(ctrl_, slots_);
+    it.skip_free();
+    return it;
+  }
+  iterator end() noexcept { return iterator(ctrl_ + capacity_, slots_ + capacity_); }
+  const_iterator begin() const noexcept { return const_cast<FlatHashMap*>(this)->begin(); }
+  const_iterator end() const noexcept { return const_cast<FlatHashMap*>(this)->end(); }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+  /// Number of slots (2^k - 1, or 0 before the first insertion).
+  size_type capacity() const noexcept { return capacity_; }
+  float load_factor() const noexcept {
+    return capacity_ ? static_cast<float>(size_) / static_cast<float>(capacity_) : 0.0f;
+  }
+
+  hasher hash_function() const { return hash_; }
+  key_equal key_eq() const { return eq_; }
+
+  // --- Capacity --------------------------------------------------------------------
+
+  /// Makes room for `count` elements: until size() reaches `count`,
+  /// insertions do not rehash (and do not invalidate iterators).
+  void reserve(size_type count) {
+    if (count <= size_ + growth_left_) return;
+    rehash_to(capacity_for(count));
+  }
+
+  /// Rebuilds the table with room for at least max(count, size()) elements,
+  /// dropping deleted markers. rehash(0) shrinks to fit.
+  void rehash(size_type count) {
+    count = std::max(count, size_);
+    if (count == 0) {
+      destroy_table();
+      return;
+    }
+    rehash_to(capacity_for(count));
+  }
+
+  /// Destroys every element; keeps the allocation.
+  void clear() noexcept {
+    if (capacity_ == 0) return;
+    destroy_elements();
+    reset_ctrl();
+    size_ = 0;
+    growth_left_ = max_load(capacity_);
+  }
+
+  // --- Lookup ----------------------------------------------------------------------
+
+  template <class Q = K>
+  iterator find(const key_arg<Q>& key) {
+    const size_type i = find_index(key, hash_(key));
+    return i == npos ? end() : iterator_at(i);
+  }
+  template <class Q = K>
+  const_iterator find(const key_arg<Q>& key) const {
+    return const_cast<FlatHashMap*>(this)->find(key);
+  }
+
+  template <class Q = K>
+  bool contains(const key_arg<Q>& key) const {
+    return find_index(key, hash_(key)) != npos;
+  }
+
+  template <class Q = K>
+  size_type count(const key_arg<Q>& key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  /// Throws std::out_of_range when `key` is absent.
+  template <class Q = K>
+  V& at(const key_arg<Q>& key) {
+    const size_type i = find_index(key, hash_(key));
+    if (i == npos) throw std::out_of_range("FlatHashMap::at: key not found");
+    return slots_[i].second;
+  }
+  template <class Q = K>
+  const V& at(const key_arg<Q>& key) const {
+    return const_cast<FlatHashMap*>(this)->at(key);
+  }
+
+  // --- Modifiers -------------------------------------------------------------------
+
+  std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return try_emplace(std::move(const_cast<K&>(value.first)), std::move(value.second));
+  }
+
+  /// Constructs V from `args` only when `key` is absent.
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+    return emplace_key(key, std::forward<Args>(args)...);
+  }
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+    return emplace_key(std::move(key), std::forward<Args>(args)...);
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    value_type value(std::forward<Args>(args)...);
+    return insert(std::move(value));
+  }
+
+  template <class M>
+  std::pair<iterator, bool> insert_or_assign(const K& key, M&& mapped) {
+    auto [it, inserted] = try_emplace(key, std::forward<M>(mapped));
+    if (!inserted) it->second = std::forward<M>(mapped);
+    return {it, inserted};
+  }
+  template <class M>
+  std::pair<iterator, bool> insert_or_assign(K&& key, M&& mapped) {
+    auto [it, inserted] = try_emplace(std::move(key), std::forward<M>(mapped));
+    if (!inserted) it->second = std::forward<M>(mapped);
+    return {it, inserted};
+  }
+
+  V& operator[](const K& key) { return try_emplace(key).first->second; }
+  V& operator[](K&& key) { return try_emplace(std::move(key)).first->second; }
+
+  template <class Q = K>
+  size_type erase(const key_arg<Q>& key) {
+    const size_type i = find_index(key, hash_(key));
+    if (i == npos) return 0;
+    erase_at(i);
+    return 1;
+  }
+
+  /// Returns the iterator after `pos`.
+  iterator erase(const_iterator pos) {
+    const auto i = static_cast<size_type>(pos.ctrl_ - ctrl_);
+    erase_at(i);
+    iterator next = iterator_at(i);
+    next.skip_free();
+    return next;
+  }
+  iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+  friend bool operator==(const FlatHashMap& a, const FlatHashMap& b) {
+    if (a.size_ != b.size_) return false;
+    for (const value_type& v : a) {
+      auto it = b.find(v.first);
+      if (it == b.end() || !(it->second == v.second)) return false;
+    }
+    return true;
+  }
+
+ private:
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+  /// Start group and triangular step sequence over capacity + 1 positions.
+  class ProbeSeq {
+   public:
+    ProbeSeq(size_type h1, size_type mask) noexcept : mask_(mask), offset_(h1 & mask) {}
+    size_type offset() const noexcept { return offset_; }
+    size_type offset(size_type lane) const noexcept { return (offset_ + lane) & mask_; }
+    void next() noexcept {
+      index_ += kWidth;
+      offset_ = (offset_ + index_) & mask_;
+    }
+
+   private:
+    size_type mask_;
+    size_type offset_;
+    size_type index_ = 0;
+  };
+
+  static size_type h1(size_type hash) noexcept { return hash >> 7; }
+  static ctrl_t h2(size_type hash) noexcept { return static_cast<ctrl_t>(hash & 0x7f); }
+
+  static constexpr size_type max_load(size_type capacity) noexcept { return capacity - capacity / 8; }
+
+  static size_type capacity_for(size_type count) {
+    size_type capacity = kMinCapacity;
+    while (max_load(capacity) < count) {
+      if (capacity > (std::numeric_limits<size_type>::max() >> 2)) throw std::length_error("FlatHashMap too large");
+      capacity = capacity * 2 + 1;
+    }
+    return capacity;
+  }
+
+  iterator iterator_at(size_type i) noexcept { return iterator(ctrl_ + i, slots_ + i); }
+
+  template <class Q>
+  size_type find_index(const Q& key, size_type hash) const {
+    if (capacity_ == 0) return npos;
+    ProbeSeq seq(h1(hash), capacity_);
+    const ctrl_t tag = h2(hash);
+    for (;;) {
+      const Group g(ctrl_ + seq.offset());
+      for (unsigned lane : g.match(tag)) {
+        const size_type i = seq.offset(lane);
+        if (eq_(slots_[i].first, key)) return i;
+      }
+      if (g.match(kEmpty)) return npos;
+      seq.next();
+    }
+  }
+
+  /// First empty or deleted slot on the probe path of `hash`.
+  size_type find_free(size_type hash) const noexcept {
+    ProbeSeq seq(h1(hash), capacity_);
+    for (;;) {
+      const Group g(ctrl_ + seq.offset());
+      if (const auto free = g.below(kSentinel)) return seq.offset(free.lowest());
+      seq.next();
+    }
+  }
+
+  void set_ctrl(size_type i, ctrl_t c) noexcept {
+    ctrl_[i] = c;
+    // Mirror of the first kWidth - 1 bytes after the sentinel.
+    if (i < kWidth - 1) ctrl_[capacity_ + 1 + i] = c;
+  }
+
+  template <class KeyArg, class... Args>
+  std::pair<iterator, bool> emplace_key(KeyArg&& key, Args&&... args) {
+    const size_type hash = hash_(key);
+    if (const size_type i = find_index(key, hash); i != npos) return {iterator_at(i), false};
+    const size_type i = prepare_insert(hash);
+    ::new (static_cast<void*>(slots_ + i))
+        value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<KeyArg>(key)),
+                   std::forward_as_tuple(std::forward<Args>(args)...));
+    commit_insert(i, hash);
+    return {iterator_at(i), true};
+  }
+
+  /// Inserts a key known to be absent (copying, rehashing).
+  void insert_unique(size_type hash, const value_type& value) {
+    const size_type i = prepare_insert(hash);
+    ::new (static_cast<void*>(slots_ + i)) value_type(value);
+    commit_insert(i, hash);
+  }
+
+  /// Slot for a new element with `hash`, growing first if needed. A deleted
+  /// slot is reused without consuming growth.
+  size_type prepare_insert(size_type hash) {
+    if (capacity_ == 0) rehash_to(kMinCapacity);
+    size_type i = find_free(hash);
+    if (growth_left_ == 0 && ctrl_[i] != kDeleted) {
+      grow();
+      i = find_free(hash);
+    }
+    return i;
+  }
+
+  void commit_insert(size_type i, size_type hash) noexcept {
+    growth_left_ -= ctrl_[i] == kEmpty ? 1 : 0;
+    set_ctrl(i, h2(hash));
+    ++size_;
+  }
+
+  // Called with no growth left: double when mostly full, otherwise the
+  // table is clogged with deleted markers and a same-size rebuild clears
+  // them.
+  void grow() {
+    if (size_ > max_load(capacity_) / 2) {
+      rehash_to(capacity_ * 2 + 1);
+    } else {
+      rehash_to(capacity_);
+    }
+  }
+
+  void erase_at(size_type i) noexcept {
+    slots_[i].~value_type();
+    --size_;
+    // A slot can go back to empty only if no probe sequence ever passed
+    // over it while the group around it was full; otherwise a later lookup
+    // would stop early.
+    const Group after(ctrl_ + i);
+    const Group before(ctrl_ + ((i - kWidth) & capacity_));
+    const auto empty_after = after.match(kEmpty);
+    const auto empty_before = before.match(kEmpty);
+    const bool was_never_full =
+        empty_after && empty_before && empty_after.leading_clear() + empty_before.trailing_clear() < kWidth;
+    set_ctrl(i, was_never_full ? kEmpty : kDeleted);
+    growth_left_ += was_never_full ? 1 : 0;
+  }
+
+  static std::size_t ctrl_offset(size_type capacity) noexcept {
+    const std::size_t bytes = capacity * sizeof(value_type);
+    return (bytes + kWidth - 1) / kWidth * kWidth;
+  }
+  static std::size_t alloc_size(size_type capacity) noexcept { return ctrl_offset(capacity) + capacity + kWidth; }
+  static constexpr std::align_val_t kAlign{std::max(alignof(value_type), std::size_t{kWidth})};
+
+  void reset_ctrl() noexcept {
+    std::memset(ctrl_, static_cast<unsigned char>(kEmpty), capacity_ + kWidth);
+    ctrl_[capacity_] = kSentinel;
+  }
+
+  /// Moves every element into a fresh table of `new_capacity` slots.
+  void rehash_to(size_type new_capacity) {
+    void* block = ::operator new(alloc_size(new_capacity), kAlign);
+    value_type* old_slots = slots_;
+    ctrl_t* old_ctrl = ctrl_;
+    const size_type old_capacity = capacity_;
+
+    slots_ = static_cast<value_type*>(block);
+    ctrl_ = reinterpret_cast<ctrl_t*>(static_cast<std::byte*>(block) + ctrl_offset(new_capacity));
+    capacity_ = new_capacity;
+    reset_ctrl();
+    growth_left_ = max_load(new_capacity) - size_;
+
+    for (size_type j = 0; j < old_capacity; ++j) {
+      if (old_ctrl[j] < 0) continue;
+      value_type& src = old_slots[j];
+      const size_type hash = hash_(src.first);
+      const size_type i = find_free(hash);
+      relocate(slots_ + i, src);
+      set_ctrl(i, h2(hash));
+    }
+    if (old_capacity) ::operator delete(old_slots, alloc_size(old_capacity), kAlign);
+  }
+
+  // The source is destroyed right after, so moving out of its const key is
+  // safe in practice; this is how absl and folly relocate map slots too.
+  static void relocate(value_type* dst, value_type& src) noexcept {
+    static_assert(std::is_nothrow_move_constructible_v<K> && std::is_nothrow_move_constructible_v<V>,
+                  "FlatHashMap needs nothrow-movable keys and values");
+    ::new (static_cast<void*>(dst)) value_type(std::move(const_cast<K&>(src.first)), std::move(src.second));
+    src.~value_type();
+  }
+
+  void destroy_elements() noexcept {
+    if constexpr (!std::is_trivially_destructible_v<value_type>) {
+      for (size_type i = 0; i < capacity_; ++i) {
+        if (ctrl_[i] >= 0) slots_[i].~value_type();
+      }
+    }
+  }
+
+  void destroy_table() noexcept {
+    if (capacity_ == 0) return;
+    destroy_elements();
+    ::operator delete(slots_, alloc_size(capacity_), kAlign);
+    ctrl_ = nullptr;
+    slots_ = nullptr;
+    capacity_ = size_ = growth_left_ = 0;
+  }
+
+  ctrl_t* ctrl_ = nullptr;
+  value_type* slots_ = nullptr;
+  size_type capacity_ = 0;
+  size_type size_ = 0;
+  size_type growth_left_ = 0;
+  [[no_unique_address]] Hash hash_;
+  [[no_unique_address]] KeyEqual eq_;
+};
+
+}  // namespace tcc
@@ -0,0 +1,141 @@
+#pragma once
+
+// Huge-page backed memory for large, randomly accessed buffers.
+//
+//   tcc::HugePageResource huge({.policy = tcc::PagePolicy::hugetlb, .prefault = true});
+//   tcc::Arena arena(tcc::huge_page_size(), &huge);   // 2 MiB chunks, pre-faulted
+//   tcc::MappedFile index("keys.bin", tcc::Advice::random, {.policy = tcc::PagePolicy::transparent});
+//
+//   tcc::PageBacking b = tcc::page_backing(index.bytes());
+//   std::printf("%zu of %zu bytes on huge pages, ~%zu TLB entries\n", b.huge, b.bytes, b.tlb_entries());
+//
+// A 4 KiB page costs one TLB entry, so a random walk over a few hundred MiB
+// misses the dTLB on almost every access. A 2 MiB page covers 512 times as
+// much. Every policy falls back, one step at a time, instead of failing:
+// hugetlb -> transparent -> small pages.
+//
+//   hugetlb      MAP_HUGETLB from the reserved pool (vm.nr_hugepages). The
+//                pages are guaranteed once mapped, but the pool is usually
+//                empty unless an administrator filled it.
+//   transparent  a 2 MiB-aligned anonymous mapping with MADV_HUGEPAGE.
+//                Works with THP set to "always" or "madvise". The kernel
+//                may still hand out small pages when memory is fragmented,
+//                and khugepaged collapses them later.
+//   small        regular pages. Only `prefault` applies.
+//
+// `prefault` fills the mapping at allocation time (MAP_POPULATE, or
+// MADV_POPULATE_WRITE / touching each page for THP), so the first pass over
+// the buffer takes no page faults. page_backing() reports what the kernel
+// actually did, from /proc/self/smaps. Huge pages are a Linux feature:
+// elsewhere every policy degrades to operator new, and the reports are
+// empty.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include "tcc/arena.hpp"
+#include "tcc/export.hpp"
+
+namespace tcc {
+
+enum class PagePolicy {
+  small,
+  transparent,
+  hugetlb,
+};
+
+struct HugePageOptions {
+  PagePolicy policy = PagePolicy::transparent;
+  bool prefault = false;
+};
+
+/// Size of a transparent/hugetlb huge page (PMD size, 2 MiB on x86-64).
+TCC_API std::size_t huge_page_size() noexcept;
+
+/// memory_resource for large allocations, rounded up to whole huge pages
+/// (whole small pages for PagePolicy::small). Thread-safe. Pair it with an
+/// Arena, whose chunks it rounds to its granularity. Alignment up to the
+/// huge page size.
+class TCC_API HugePageResource final : public GranularResource {
+ public:
+  /// Cumulative counters since construction.
+  struct Stats {
+    std::uint64_t hugetlb_bytes = 0;      // mapped from the hugetlb pool
+    std::uint64_t transparent_bytes = 0;  // mapped with MADV_HUGEPAGE
+    std::uint64_t small_bytes = 0;        // mapped with regular pages
+    std::uint64_t fallbacks = 0;          // allocations served by a lower tier than asked for
+    std::uint64_t mapped_bytes = 0;       // currently mapped (allocated minus deallocated)
+  };
+
+  explicit HugePageResource(HugePageOptions options = {}) noexcept : options_(options) {}
+
+  const HugePageOptions& options() const noexcept { return options_; }
+  std::size_t granularity() const noexcept override;
+  Stats stats() const noexcept;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t align) override;
+  void do_deallocate(void* p, std::size_t bytes, std::size_t align) override;
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+  HugePageOptions options_;
+  std::atomic<std::uint64_t> hugetlb_bytes_{0};
+  std::atomic<std::uint64_t> transparent_bytes_{0};
+  std::atomic<std::uint64_t> small_bytes_{0};
+  std::atomic<std::uint64_t> fallbacks_{0};
+  std::atomic<std::uint64_t> mapped_bytes_{0};
+};
+
+/// How a range of this process's memory is backed, prorated from the
+/// /proc/self/smaps entries of the mappings it overlaps.
+struct PageBacking {
+  std::size_t bytes = 0;           // length of the range
+  std::size_t resident = 0;        // bytes currently in RAM
+  std::size_t huge = 0;            // resident bytes on huge pages (THP or hugetlb)
+  std::size_t small_page_size = 0;  // 0 when the report is unavailable
+
+  /// TLB entries needed to map the resident part: one per huge page plus
+  /// one per small page.
+  std::size_t tlb_entries() const noexcept {
+    if (small_page_size == 0) return 0;
+    const std::size_t huge_page = huge_page_size();
+    return (huge + huge_page - 1) / huge_page + (resident - huge + small_page_size - 1) / small_page_size;
+  }
+};
+
+TCC_API PageBacking page_backing(std::span<const std::byte> range);
+
+/// System-wide huge page state, from sysfs, /proc/meminfo and /proc/vmstat.
+struct SystemHugePages {
+  std::string thp_mode;                // "always", "madvise", "never", or empty when unknown
+  std::uint64_t hugetlb_total = 0;     // pages in the hugetlb pool
+  std::uint64_t hugetlb_free = 0;
+  std::uint64_t thp_fault_alloc = 0;   // page faults served with a THP
+  std::uint64_t thp_fault_fallback = 0;  // page faults that wanted a THP and got small pages
+  std::uint64_t thp_collapse_alloc = 0;  // small pages collapsed into a THP by khugepaged
+};
+
+TCC_API SystemHugePages system_huge_pages();
+
+namespace detail {
+
+/// One mapping made by map_pages. `length` is what unmap_pages needs.
+struct PageMapping {
+  void* data = nullptr;
+  std::size_t length = 0;
+  PagePolicy served = PagePolicy::small;
+};
+
+/// Maps at least `bytes` of anonymous read/write memory under `options`,
+/// falling back tier by tier. The length is a whole number of huge pages
+/// unless the policy is small, whichever tier served it. Throws
+/// std::bad_alloc when even small pages cannot be mapped.
+TCC_API PageMapping map_pages(std::size_t bytes, const HugePageOptions& options);
+TCC_API void unmap_pages(const PageMapping& mapping) noexcept;
+
+}  // namespace detail
+
+}  // namespace tcc
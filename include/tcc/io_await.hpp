@@ -0,0 +1,105 @@
+#pragma once
+
+// co_await adapters for tcc::io::Ring.
+//
+//   tcc::Task<> echo(tcc::io::Ring& ring, int socket) {
+//     std::array<std::byte, 4096> buf;
+//     for (;;) {
+//       int n = co_await tcc::io::async_recv(ring, socket, buf);
+//       if (n <= 0) co_return;
+//       co_await tcc::io::async_send(ring, socket, std::span(buf).first(n));
+//     }
+//   }
+//
+// Each awaitable prepares one operation, submits it, and resumes the
+// coroutine from the completion callback, i.e. on a worker of the ring's
+// ThreadPool. co_await yields the operation's result (bytes or -errno).
+// Awaiting costs one submit() per operation; code issuing many requests at
+// once can still use the callback interface to batch them.
+//
+// A coroutine resumed by a ring runs inside that ring's callback, so it must
+// not destroy the ring itself (the destructor would wait for the callback).
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include "tcc/io_ring.hpp"
+
+namespace tcc::io {
+
+namespace detail {
+
+/// `start(ring, callback)` issues the prepare call; the awaiter lives in the
+/// coroutine frame until resume, so the callback can refer to it.
+template <class Start>
+class OpAwaiter {
+ public:
+  OpAwaiter(Ring& ring, Start start) noexcept : ring_(ring), start_(std::move(start)) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  void await_suspend(std::coroutine_handle<> awaiting) {
+    handle_ = awaiting;
+    Ring& ring = ring_;
+    start_(ring, [this](int result) {
+      result_ = result;
+      handle_.resume();
+    });
+    // The callback may already have resumed (and freed) the coroutine by the
+    // time submit() returns; touch nothing of *this after it.
+    ring.submit();
+  }
+
+  int await_resume() const noexcept { return result_; }
+
+ private:
+  Ring& ring_;
+  Start start_;
+  std::coroutine_handle<> handle_;
+  int result_ = 0;
+};
+
+}  // namespace detail
+
+inline auto async_read(Ring& ring, FileRef file, std::span<std::byte> buffer, std::uint64_t offset) {
+  return detail::OpAwaiter(ring, [=](Ring& r, Callback cb) { r.read(file, buffer, offset, std::move(cb)); });
+}
+
+inline auto async_write(Ring& ring, FileRef file, std::span<const std::byte> buffer, std::uint64_t offset) {
+  return detail::OpAwaiter(ring, [=](Ring& r, Callback cb) { r.write(file, buffer, offset, std::move(cb)); });
+}
+
+inline auto async_read_fixed(Ring& ring, FileRef file, unsigned buffer_index, std::span<std::byte> buffer,
+                             std::uint64_t offset) {
+  return detail::OpAwaiter(
+      ring, [=](Ring& r, Callback cb) { r.read_fixed(file, buffer_index, buffer, offset, std::move(cb)); });
+}
+
+inline auto async_write_fixed(Ring& ring, FileRef file, unsigned buffer_index, std::span<const std::byte> buffer,
+                              std::uint64_t offset) {
+  return detail::OpAwaiter(
+      ring, [=](Ring& r, Callback cb) { r.write_fixed(file, buffer_index, buffer, offset, std::move(cb)); });
+}
+
+inline auto async_recv(Ring& ring, FileRef socket, std::span<std::byte> buffer) {
+  return detail::OpAwaiter(ring, [=](Ring& r, Callback cb) { r.recv(socket, buffer, std::move(cb)); });
+}
+
+inline auto async_send(Ring& ring, FileRef socket, std::span<const std::byte> buffer) {
+  return detail::OpAwaiter(ring, [=](Ring& r, Callback cb) { r.send(socket, buffer, std::move(cb)); });
+}
+
+inline auto async_fsync(Ring& ring, FileRef file) {
+  return detail::OpAwaiter(ring, [=](Ring& r, Callback cb) { r.fsync(file, std::move(cb)); });
+}
+
+/// Resumes on a pool worker after `delay`; yields 0.
+inline auto sleep_for(Ring& ring, std::chrono::nanoseconds delay) {
+  return detail::OpAwaiter(ring, [=](Ring& r, Callback cb) { r.timeout(delay, std::move(cb)); });
+}
+
+}  // namespace tcc::io
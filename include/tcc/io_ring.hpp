@@ -0,0 +1,152 @@
+#pragma once
+
+// Batched asynchronous file and socket I/O (Linux).
+//
+//   tcc::io::Ring ring;                               // completions run on ThreadPool::global()
+//   ring.read(fd, buffer, offset, [](int n) { ... });
+//   ring.send(socket, reply, [](int n) { ... });
+//   ring.submit();                                    // one system call for both
+//
+// Operations are queued locally by the prepare calls (read, write, recv, ...)
+// and handed to the kernel together by submit(), so N requests cost one
+// io_uring_enter instead of N syscalls. Each completion callback receives
+// the syscall-style result (bytes transferred, or -errno) and runs on a
+// worker of the ThreadPool; callbacks must not throw.
+//
+// Two backends implement the same interface:
+//   io_uring  - talks to the kernel ABI from <linux/io_uring.h> directly, with
+//               a reaper thread forwarding completions to the pool. Built when
+//               TCC_WITH_IO_URING is ON and the kernel header is available.
+//   fallback  - file operations run as blocking pread/pwrite on the pool;
+//               socket operations are tried non-blocking and park on an epoll
+//               reactor thread when they would block. Used when io_uring is
+//               not compiled in or io_uring_setup() fails at runtime (old
+//               kernel, seccomp profile), or when requested explicitly.
+//
+// Prepare calls and submit() may come from any thread; they are serialized
+// internally. Buffers must stay valid until the operation's callback runs.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string_view>
+
+#include "tcc/export.hpp"
+#include "tcc/thread_pool.hpp"
+
+namespace tcc::io {
+
+enum class BackendKind : std::uint8_t { io_uring, fallback };
+
+TCC_API std::string_view backend_name(BackendKind kind) noexcept;
+
+/// True when the io_uring backend is compiled in and the kernel accepts
+/// io_uring_setup(); probed once.
+TCC_API bool io_uring_supported() noexcept;
+
+/// Receives the operation's result: bytes transferred (or 0 for fsync,
+/// nop and expired timeouts) on success, -errno on failure.
+using Callback = std::function<void(int result)>;
+
+struct RingOptions {
+  /// Submission queue entries; preparing more than this between two
+  /// submit() calls flushes early.
+  unsigned queue_depth = 256;
+  /// Pool the callbacks run on; nullptr means ThreadPool::global().
+  ThreadPool* pool = nullptr;
+  /// Skip io_uring even when it is available.
+  bool force_fallback = false;
+};
+
+/// Slot in the table installed by Ring::register_files().
+struct FixedFile {
+  unsigned index;
+};
+
+/// A plain descriptor or a registered slot; converts implicitly from both.
+class FileRef {
+ public:
+  FileRef(int fd) noexcept : value_(fd), fixed_(false) {}
+  FileRef(FixedFile file) noexcept : value_(static_cast<int>(file.index)), fixed_(true) {}
+
+  int value() const noexcept { return value_; }
+  bool fixed() const noexcept { return fixed_; }
+
+ private:
+  int value_;
+  bool fixed_;
+};
+
+namespace detail {
+class Backend;
+struct Op;
+}
+
+class TCC_API Ring {
+ public:
+  /// Throws std::system_error when neither backend can be set up.
+  explicit Ring(RingOptions options = {});
+  /// Submits anything still queued and waits for every callback to finish.
+  ~Ring();
+
+  Ring(const Ring&) = delete;
+  Ring& operator=(const Ring&) = delete;
+
+  BackendKind backend() const noexcept;
+
+  // --- Prepare (queued until submit()) ---------------------------------------
+
+  void read(FileRef file, std::span<std::byte> buffer, std::uint64_t offset, Callback callback);
+  void write(FileRef file, std::span<const std::byte> buffer, std::uint64_t offset, Callback callback);
+
+  /// Like read()/write(), but `buffer` must lie inside registered buffer
+  /// `buffer_index`, which saves the kernel pinning the pages per request.
+  void read_fixed(FileRef file, unsigned buffer_index, std::span<std::byte> buffer, std::uint64_t offset,
+                  Callback callback);
+  void write_fixed(FileRef file, unsigned buffer_index, std::span<const std::byte> buffer,
+                   std::uint64_t offset, Callback callback);
+
+  void recv(FileRef socket, std::span<std::byte> buffer, Callback callback);
+  void send(FileRef socket, std::span<const std::byte> buffer, Callback callback);
+  void fsync(FileRef file, Callback callback);
+
+  /// Completes with 0 after `delay`.
+  void timeout(std::chrono::nanoseconds delay, Callback callback);
+
+  /// Completes with 0 as soon as it is submitted; useful to hop onto the pool.
+  void nop(Callback callback);
+
+  /// Hands every queued operation to the backend; returns how many.
+  std::size_t submit();
+
+  // --- Registration -----------------------------------------------------------
+
+  /// Replaces the registered buffer table. Must not race with in-flight
+  /// *_fixed operations. Throws std::system_error on failure.
+  void register_buffers(std::span<const std::span<std::byte>> buffers);
+
+  /// Replaces the registered file table used by FixedFile{index}. Must not
+  /// race with in-flight operations on fixed files. Throws std::system_error.
+  void register_files(std::span<const int> fds);
+
+  // --- Completion ---------------------------------------------------------------
+
+  /// Operations prepared or submitted whose callback has not returned yet.
+  std::size_t in_flight() const noexcept;
+
+  /// Submits queued operations and blocks until every callback has run.
+  /// Must not be called from a callback or another task on the same pool.
+  void drain();
+
+ private:
+  void enqueue(std::unique_ptr<detail::Op> op);
+
+  std::mutex mutex_;  // serializes prepare/submit/registration
+  std::unique_ptr<detail::Backend> backend_;
+};
+
+}  // namespace tcc::io
@@ -0,0 +1,220 @@
+#pragma once
+
+// Read-only, zero-copy view of a whole file.
+//
+//   tcc::MappedFile file("events.log", tcc::Advice::sequential | tcc::Advice::willneed);
+//   for (std::string_view line : tcc::lines(file)) handle(line);
+//
+// The file is mapped with mmap (CreateFileMapping/MapViewOfFile on Windows)
+// and exposed as std::span<const std::byte>; nothing is copied into user
+// space, and the page cache is the only buffer. Records returned by the
+// iterators point straight into the mapping and stay valid until the
+// MappedFile is closed or destroyed.
+//
+// Advice flags are hints. Unsupported ones (e.g. hugepage on file systems
+// without large-folio support, or anything but willneed on Windows) are
+// ignored and never turn into errors. Empty files are valid and map to an
+// empty span without a system mapping.
+//
+// Regular files cannot be mapped from the hugetlb pool, and page-cache THP
+// depends on the file system. For random lookups over a large, hot file,
+// the HugePageOptions constructor instead reads the file once into
+// anonymous huge-page memory (see tcc/huge_pages.hpp); the view is then a
+// private copy that no longer follows changes to the file.
+
+#include <cstddef>
+#include <filesystem>
+#include <iterator>
+#include <span>
+#include <string_view>
+
+#include "tcc/export.hpp"
+#include "tcc/simd.hpp"
+
+namespace tcc {
+
+struct HugePageOptions;
+
+/// Access-pattern hints, combinable with |.
+enum class Advice : unsigned {
+  normal = 0,
+  sequential = 1u << 0,  ///< MADV_SEQUENTIAL: aggressive read-ahead, early drop
+  random = 1u << 1,      ///< MADV_RANDOM: no read-ahead
+  willneed = 1u << 2,    ///< MADV_WILLNEED: start reading the range now
+  hugepage = 1u << 3,    ///< MADV_HUGEPAGE: back the mapping with huge pages when possible
+};
+
+constexpr Advice operator|(Advice a, Advice b) noexcept {
+  return static_cast<Advice>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
+}
+constexpr bool has_advice(Advice set, Advice flag) noexcept {
+  return (static_cast<unsigned>(set) & static_cast<unsigned>(flag)) != 0;
+}
+
+class TCC_API MappedFile {
+ public:
+  MappedFile() noexcept = default;
+
+  /// Maps `path` read-only. Throws std::system_error when the file cannot
+  /// be opened or mapped.
+  explicit MappedFile(const std::filesystem::path& path, Advice advice = Advice::sequential);
+
+  /// Reads `path` into memory mapped under `pages` (huge pages with
+  /// fallback) and makes it read-only. Off Linux this is the plain mapping
+  /// above. Throws std::system_error like it.
+  MappedFile(const std::filesystem::path& path, Advice advice, const HugePageOptions& pages);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  /// Applies `advice` to [offset, offset + length), clamped to the file and
+  /// widened to page boundaries. Returns false if the OS rejected every
+  /// requested hint.
+  bool advise(Advice advice, std::size_t offset = 0, std::size_t length = static_cast<std::size_t>(-1)) noexcept;
+
+  /// Unmaps the file; afterwards the object is empty.
+  void close() noexcept;
+
+  bool is_open() const noexcept { return open_; }
+  std::size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+  const std::byte* data() const noexcept { return data_; }
+  std::span<const std::byte> bytes() const noexcept { return {data_, size_}; }
+  std::string_view text() const noexcept { return {reinterpret_cast<const char*>(data_), size_}; }
+
+ private:
+  const std::byte* data_ = nullptr;
+  std::size_t size_ = 0;
+  std::size_t anonymous_length_ = 0;  // length of an anonymous copy; 0 for a file mapping
+  bool open_ = false;
+#if defined(_WIN32)
+  void* mapping_ = nullptr;  // HANDLE of the file-mapping object
+#endif
+};
+
+// --- Record iteration ---------------------------------------------------------
+
+/// Splits a byte range at every `delimiter`. Records exclude the delimiter;
+/// a trailing delimiter does not produce a final empty record (getline
+/// semantics), but empty records between two delimiters are kept.
+class RecordRange {
+ public:
+  class iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::span<const std::byte>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+
+    iterator() noexcept = default;
+
+    value_type operator*() const noexcept { return {pos_, record_end_}; }
+
+    iterator& operator++() noexcept {
+      pos_ = record_end_ == end_ ? end_ : record_end_ + 1;
+      find_end();
+      return *this;
+    }
+    iterator operator++(int) noexcept {
+      iterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    friend bool operator==(const iterator& a, const iterator& b) noexcept { return a.pos_ == b.pos_; }
+
+   private:
+    friend class RecordRange;
+
+    // The kernel is looked up once per iteration, not once per record.
+    iterator(const std::byte* pos, const std::byte* end, std::byte delimiter) noexcept
+        : pos_(pos), end_(end), delimiter_(delimiter), find_(simd::active_kernels().find_byte) {
+      find_end();
+    }
+
+    void find_end() noexcept {
+      const std::size_t hit = find_(pos_, static_cast<std::size_t>(end_ - pos_), delimiter_);
+      record_end_ = hit == simd::npos ? end_ : pos_ + hit;
+    }
+
+    const std::byte* pos_ = nullptr;
+    const std::byte* end_ = nullptr;
+    const std::byte* record_end_ = nullptr;
+    std::byte delimiter_{};
+    std::size_t (*find_)(const std::byte*, std::size_t, std::byte) = nullptr;
+  };
+
+  RecordRange(std::span<const std::byte> data, std::byte delimiter) noexcept
+      : data_(data), delimiter_(delimiter) {}
+
+  iterator begin() const noexcept { return {data_.data(), data_.data() + data_.size(), delimiter_}; }
+  iterator end() const noexcept {
+    const std::byte* last = data_.data() + data_.size();
+    return {last, last, delimiter_};
+  }
+
+ private:
+  std::span<const std::byte> data_;
+  std::byte delimiter_;
+};
+
+/// Text lines as string_views. A '\r' before the '\n' is stripped, so CRLF
+/// files read the same as LF files.
+class LineRange {
+ public:
+  class iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+
+    iterator() noexcept = default;
+
+    value_type operator*() const noexcept {
+      const std::span<const std::byte> r = *it_;
+      std::string_view line(reinterpret_cast<const char*>(r.data()), r.size());
+      if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+      return line;
+    }
+    iterator& operator++() noexcept {
+      ++it_;
+      return *this;
+    }
+    iterator operator++(int) noexcept {
+      iterator old = *this;
+      ++it_;
+      return old;
+    }
+
+    friend bool operator==(const iterator& a, const iterator& b) noexcept { return a.it_ == b.it_; }
+
+   private:
+    friend class LineRange;
+    explicit iterator(RecordRange::iterator it) noexcept : it_(it) {}
+
+    RecordRange::iterator it_;
+  };
+
+  explicit LineRange(std::string_view text) noexcept
+      : records_(std::as_bytes(std::span<const char>(text.data(), text.size())), std::byte{'\n'}) {}
+
+  iterator begin() const noexcept { return iterator(records_.begin()); }
+  iterator end() const noexcept { return iterator(records_.end()); }
+
+ private:
+  RecordRange records_;
+};
+
+inline RecordRange records(const MappedFile& file, std::byte delimiter) noexcept {
+  return {file.bytes(), delimiter};
+}
+inline LineRange lines(const MappedFile& file) noexcept { return LineRange(file.text()); }
+inline LineRange lines(std::string_view text) noexcept { return LineRange(text); }
+
+}  // namespace tcc
@@ -0,0 +1,233 @@
+#pragma once
+
+// Counters, gauges and latency histograms with a Prometheus text exporter.
+//
+//   auto& reg = tcc::metrics::Registry::global();
+//   auto& requests = reg.counter("http_requests_total", "Requests served", {{"method", "GET"}});
+//   auto& latency = reg.histogram("http_request_duration_seconds", "Request latency");
+//
+//   requests.inc();                                // no lock, no shared cache line
+//   { tcc::metrics::ScopedTimer t(latency); ... }  // records elapsed nanoseconds
+//
+//   std::string body = reg.prometheus_text();     // on scrape
+//
+// Registration takes a mutex and returns a reference that stays valid for
+// the registry's lifetime; keep it and update through it. Updates never lock.
+//
+// Counters and histograms are sharded: each thread is assigned one of
+// Registry::shard_count() cache-line-aligned slots on first use and only
+// increments that one, so concurrent writers do not bounce a line between
+// cores. Reads (value(), snapshot(), scrapes) sum the shards; they see each
+// shard atomically but not all shards at one instant.
+//
+// Histograms are log-linear (HDR style): exact below 8, then 8 buckets per
+// power of two, so any recorded value lands in a bucket within 12.5% of it,
+// over the full 64-bit range in 496 buckets. The exporter emits cumulative
+// `le` buckets at powers of two between HistogramOptions::min_exponent and
+// max_exponent, multiplied by `scale` (by default nanoseconds exported as
+// seconds, 1 us .. 34 s); a bucket counts the values below its bound.
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "tcc/export.hpp"
+#include "tcc/platform.hpp"
+
+namespace tcc::metrics {
+
+/// Label name/value pairs, e.g. {{"method", "GET"}, {"code", "200"}}.
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+namespace detail {
+
+inline constexpr std::size_t kNoSlot = ~std::size_t{0};
+TCC_API inline thread_local std::size_t tls_slot = kNoSlot;
+
+/// Assigns the calling thread the next round-robin slot.
+TCC_API std::size_t assign_slot() noexcept;
+
+/// Per-thread number, masked by the metric to pick its shard.
+inline std::size_t thread_slot() noexcept {
+  const std::size_t slot = tls_slot;
+  return slot != kNoSlot ? slot : assign_slot();
+}
+
+template <class T>
+struct alignas(kCacheLineSize) Padded {
+  std::atomic<T> value{0};
+};
+
+}  // namespace detail
+
+/// Monotonically increasing count.
+class TCC_API Counter {
+ public:
+  explicit Counter(std::size_t shards);
+
+  void inc(std::uint64_t n = 1) noexcept {
+    shards_[detail::thread_slot() & mask_].value.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  std::uint64_t value() const noexcept;
+
+ private:
+  std::unique_ptr<detail::Padded<std::uint64_t>[]> shards_;
+  std::size_t mask_;
+};
+
+/// Value that goes up and down. Not sharded: the last set() wins.
+class Gauge {
+ public:
+  void set(double v) noexcept { value_.store(v, std::memory_order_relaxed); }
+  void add(double v) noexcept { value_.fetch_add(v, std::memory_order_relaxed); }
+  void sub(double v) noexcept { value_.fetch_sub(v, std::memory_order_relaxed); }
+  double value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  alignas(kCacheLineSize) std::atomic<double> value_{0};
+};
+
+struct HistogramOptions {
+  /// Exported value of a recorded 1; the default turns nanoseconds into
+  /// Prometheus' base unit, seconds.
+  double scale = 1e-9;
+  /// Exported `le` bounds are 2^min_exponent .. 2^max_exponent (scaled).
+  unsigned min_exponent = 10;
+  unsigned max_exponent = 35;
+};
+
+class TCC_API Histogram {
+ public:
+  static constexpr unsigned kSubBucketBits = 3;
+  static constexpr std::size_t kBucketCount = std::size_t{64 - kSubBucketBits + 1} << kSubBucketBits;
+
+  /// Bucket holding `v`.
+  static constexpr std::size_t bucket_of(std::uint64_t v) noexcept {
+    constexpr std::uint64_t kSub = 1u << kSubBucketBits;
+    if (v < kSub) return static_cast<std::size_t>(v);
+    const unsigned e = 63u - static_cast<unsigned>(std::countl_zero(v));
+    const std::uint64_t mantissa = (v >> (e - kSubBucketBits)) & (kSub - 1);
+    return static_cast<std::size_t>(((e - kSubBucketBits + 1) << kSubBucketBits) + mantissa);
+  }
+  /// Smallest value in bucket `i`.
+  static constexpr std::uint64_t bucket_lower(std::size_t i) noexcept {
+    constexpr std::size_t kSub = std::size_t{1} << kSubBucketBits;
+    if (i < kSub) return i;
+    const unsigned e = static_cast<unsigned>(i >> kSubBucketBits) + kSubBucketBits - 1;
+    return (kSub + (i & (kSub - 1))) << (e - kSubBucketBits);
+  }
+
+  Histogram(std::size_t shards, HistogramOptions options);
+
+  void record(std::uint64_t v) noexcept {
+    Shard& s = shards_[detail::thread_slot() & mask_];
+    s.buckets[bucket_of(v)].fetch_add(1, std::memory_order_relaxed);
+    s.sum.fetch_add(v, std::memory_order_relaxed);
+  }
+
+  struct Snapshot {
+    std::array<std::uint64_t, kBucketCount> buckets{};
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;  ///< wraps after 2^64 (~585 years of nanoseconds)
+
+    /// Upper edge of the bucket holding the q-quantile (0 when empty).
+    std::uint64_t quantile(double q) const noexcept;
+  };
+
+  Snapshot snapshot() const noexcept;
+  const HistogramOptions& options() const noexcept { return options_; }
+
+ private:
+  struct alignas(kCacheLineSize) Shard {
+    std::array<std::atomic<std::uint64_t>, kBucketCount> buckets{};
+    std::atomic<std::uint64_t> sum{0};
+  };
+
+  std::unique_ptr<Shard[]> shards_;
+  std::size_t mask_;
+  HistogramOptions options_;
+};
+
+/// Records the lifetime of the object, in steady_clock nanoseconds.
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(Histogram& h) noexcept : h_(h), start_(std::chrono::steady_clock::now()) {}
+  ~ScopedTimer() {
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+    h_.record(static_cast<std::uint64_t>(ns.count()));
+  }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+  Histogram& h_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+class TCC_API Registry {
+ public:
+  /// `shards` per counter and histogram; 0 means one per hardware thread
+  /// (rounded up to a power of two, at most 64 for counters and 8 for
+  /// histograms, whose shards are 4 KiB each).
+  explicit Registry(std::size_t shards = 0);
+
+  Registry(const Registry&) = delete;
+  Registry& operator=(const Registry&) = delete;
+
+  /// Returns the metric registered under `name` and `labels`, creating it
+  /// on first use. Throws std::invalid_argument for a name or label that is
+  /// not a valid Prometheus identifier, or a name already used by a
+  /// different metric type. `help` is taken from the first registration.
+  Counter& counter(std::string_view name, std::string_view help, const Labels& labels = {});
+  Gauge& gauge(std::string_view name, std::string_view help, const Labels& labels = {});
+  Histogram& histogram(std::string_view name, std::string_view help, const Labels& labels = {},
+                       HistogramOptions options = {});
+
+  /// Prometheus text exposition format (version 0.0.4), families sorted by
+  /// name.
+  void write_prometheus(std::ostream& out) const;
+  std::string prometheus_text() const;
+
+  std::size_t shard_count() const noexcept { return shards_; }
+
+  /// Process-wide registry, created on first use.
+  static Registry& global();
+
+ private:
+  enum class Type { counter, gauge, histogram };
+
+  struct Series {
+    std::string labels;  // rendered: {a="b",c="d"}, or empty
+    std::unique_ptr<Counter> counter;
+    std::unique_ptr<Gauge> gauge;
+    std::unique_ptr<Histogram> histogram;
+  };
+
+  struct Family {
+    Type type;
+    std::string help;
+    std::vector<Series> series;
+  };
+
+  /// Finds or adds the series; caller holds mutex_.
+  Series& series(std::string_view name, std::string_view help, const Labels& labels, Type type);
+
+  mutable std::mutex mutex_;
+  std::map<std::string, Family, std::less<>> families_;
+  std::size_t shards_;
+};
+
+}  // namespace tcc::metrics
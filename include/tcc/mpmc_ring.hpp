@@ -0,0 +1,193 @@
+#pragma once
+
+// Bounded multi-producer/multi-consumer ring buffer (Dmitry Vyukov's design).
+//
+// Every cell carries a sequence number that tells producers and consumers
+// whose turn it is, so a push or pop costs one CAS on the shared index plus
+// one store to the cell; there is no lock and no per-element allocation.
+// Batch operations claim several consecutive cells with a single CAS.
+//
+// The buffer is allocated once at construction; capacity is rounded up to a
+// power of two.
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "tcc/platform.hpp"
+
+namespace tcc {
+
+template <class T>
+class MpmcRing {
+  static_assert(std::is_nothrow_move_constructible_v<T> || std::is_nothrow_copy_constructible_v<T>,
+                "MpmcRing elements must be nothrow move- or copy-constructible");
+
+ public:
+  using value_type = T;
+
+  explicit MpmcRing(std::size_t capacity)
+      : mask_(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1),
+        cells_(std::make_unique<Cell[]>(mask_ + 1)) {
+    for (std::size_t i = 0; i <= mask_; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+  }
+
+  MpmcRing(const MpmcRing&) = delete;
+  MpmcRing& operator=(const MpmcRing&) = delete;
+
+  ~MpmcRing() {
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    for (; head != tail; ++head) std::destroy_at(cells_[head & mask_].value());
+  }
+
+  std::size_t capacity() const noexcept { return mask_ + 1; }
+
+  template <class... Args>
+  bool try_emplace(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+    std::size_t pos = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& cell = cells_[pos & mask_];
+      const std::size_t seq = cell.seq.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          ::new (cell.raw()) T(std::forward<Args>(args)...);
+          cell.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;  // the consumer one lap behind has not freed this cell
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool try_push(const T& value) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+    return try_emplace(value);
+  }
+  bool try_push(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    return try_emplace(std::move(value));
+  }
+
+  bool try_pop(T& out) noexcept(std::is_nothrow_move_assignable_v<T>) {
+    return pop_with([&](T&& value) { out = std::move(value); });
+  }
+
+  std::optional<T> try_pop() {
+    std::optional<T> out;
+    pop_with([&](T&& value) { out.emplace(std::move(value)); });
+    return out;
+  }
+
+  /// Moves up to `count` elements from `first` into the ring, claiming the
+  /// cells with one CAS. Returns how many were pushed.
+  template <class It>
+  std::size_t try_push_batch(It first, std::size_t count) {
+    if (count == 0) return 0;
+    std::size_t pos = tail_.load(std::memory_order_relaxed);
+    std::size_t n = 0;
+    for (;;) {
+      // Count the consecutive free cells starting at pos. A free cell stays
+      // free until the index is advanced past it, so the count is still
+      // valid if the CAS below succeeds.
+      n = 0;
+      while (n < count && cells_[(pos + n) & mask_].seq.load(std::memory_order_acquire) == pos + n) ++n;
+      if (n == 0) {
+        const std::size_t seq = cells_[pos & mask_].seq.load(std::memory_order_acquire);
+        if (static_cast<std::ptrdiff_t>(seq - pos) < 0) return 0;
+        pos = tail_.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (tail_.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) break;
+    }
+    for (std::size_t i = 0; i < n; ++i, ++first) {
+      Cell& cell = cells_[(pos + i) & mask_];
+      ::new (cell.raw()) T(std::move(*first));
+      cell.seq.store(pos + i + 1, std::memory_order_release);
+    }
+    return n;
+  }
+
+  /// Moves up to `max` elements into `out`, claiming the cells with one CAS.
+  /// Returns how many were popped.
+  template <class OutIt>
+  std::size_t try_pop_batch(OutIt out, std::size_t max) {
+    if (max == 0) return 0;
+    std::size_t pos = head_.load(std::memory_order_relaxed);
+    std::size_t n = 0;
+    for (;;) {
+      n = 0;
+      while (n < max && cells_[(pos + n) & mask_].seq.load(std::memory_order_acquire) == pos + n + 1) ++n;
+      if (n == 0) {
+        const std::size_t seq = cells_[pos & mask_].seq.load(std::memory_order_acquire);
+        if (static_cast<std::ptrdiff_t>(seq - (pos + 1)) < 0) return 0;
+        pos = head_.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (head_.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) break;
+    }
+    for (std::size_t i = 0; i < n; ++i, ++out) {
+      Cell& cell = cells_[(pos + i) & mask_];
+      T* p = cell.value();
+      *out = std::move(*p);
+      std::destroy_at(p);
+      cell.seq.store(pos + i + mask_ + 1, std::memory_order_release);
+    }
+    return n;
+  }
+
+  /// Snapshot of the element count; exact only when all sides are idle.
+  std::size_t size_approx() const noexcept {
+    const std::size_t head = head_.load(std::memory_order_acquire);
+    const std::size_t tail = tail_.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+  }
+  bool empty_approx() const noexcept { return size_approx() == 0; }
+
+ private:
+  struct Cell {
+    std::atomic<std::size_t> seq;
+    alignas(T) std::byte storage[sizeof(T)];
+
+    void* raw() noexcept { return storage; }
+    T* value() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+  };
+
+  template <class Fn>
+  bool pop_with(Fn&& fn) {
+    std::size_t pos = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& cell = cells_[pos & mask_];
+      const std::size_t seq = cell.seq.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          T* p = cell.value();
+          fn(std::move(*p));
+          std::destroy_at(p);
+          cell.seq.store(pos + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;  // empty: the producer for this cell has not published
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  const std::size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+  alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0};  // next cell to produce
+  alignas(kCacheLineSize) std::atomic<std::size_t> head_{0};  // next cell to consume
+};
+
+}  // namespace tcc
@@ -0,0 +1,102 @@
+#pragma once
+
+// NUMA topology, thread pinning and node-local memory.
+//
+//   tcc::ThreadPool pool({.affinity = tcc::Affinity::node});  // workers pinned per node
+//   pool.post([] {
+//     tcc::Arena arena(1 << 20, tcc::numa::local_resource());  // chunks on this node
+//     ...
+//   });
+//
+//   const tcc::numa::Topology& topo = tcc::numa::topology();
+//   tcc::numa::NodeResource far(1, tcc::numa::Placement::bind);          // explicit node
+//
+// The topology is read from /sys/devices/system/node and limited to the
+// CPUs this process may run on (cgroups, taskset). Off Linux, or when sysfs
+// is unavailable, it is one node holding every CPU. Memory placement uses
+// mbind(2) directly, so libnuma is not required. NodeResource hands out
+// whole pages from mmap and is meant as an Arena upstream, not for small
+// objects.
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#include "tcc/arena.hpp"
+#include "tcc/export.hpp"
+
+namespace tcc::numa {
+
+struct Node {
+  int id = 0;             // kernel node number
+  std::vector<int> cpus;  // usable CPUs on this node, ascending
+};
+
+struct Topology {
+  std::vector<Node> nodes;  // nodes with at least one usable CPU, by id
+
+  std::size_t cpu_count() const noexcept {
+    std::size_t n = 0;
+    for (const Node& node : nodes) n += node.cpus.size();
+    return n;
+  }
+
+  /// Kernel node number of `cpu`, or -1 when the CPU is not usable.
+  int node_of_cpu(int cpu) const noexcept {
+    for (const Node& node : nodes) {
+      for (int c : node.cpus) {
+        if (c == cpu) return node.id;
+      }
+    }
+    return -1;
+  }
+};
+
+/// The machine's topology, detected on first use.
+TCC_API const Topology& topology();
+
+/// Node the calling thread is running on right now (0 when unknown).
+TCC_API int current_node() noexcept;
+
+/// Restricts the calling thread to `cpus`. Returns false when the
+/// platform cannot pin or the kernel refused (e.g. CPUs outside the
+/// process's allowed set); the thread then keeps its current affinity.
+TCC_API bool pin_current_thread(const std::vector<int>& cpus) noexcept;
+
+enum class Placement {
+  first_touch,  // no policy: pages land on the node of the thread that first writes them
+  preferred,    // MPOL_PREFERRED: on `node` while it has free memory, elsewhere otherwise
+  bind,         // MPOL_BIND: only on `node`; allocation fails when it is full
+};
+
+/// Page-granular memory_resource whose pages are placed on one NUMA node.
+/// Thread-safe; alignment up to the page size. Throws std::bad_alloc when
+/// mmap or, for Placement::bind, mbind fails. Off Linux it forwards to
+/// std::pmr::new_delete_resource().
+class TCC_API NodeResource final : public GranularResource {
+ public:
+  explicit NodeResource(int node, Placement placement = Placement::preferred) noexcept
+      : node_(node), placement_(placement) {}
+
+  int node() const noexcept { return node_; }
+  Placement placement() const noexcept { return placement_; }
+  std::size_t granularity() const noexcept override;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t align) override;
+  void do_deallocate(void* p, std::size_t bytes, std::size_t align) override;
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+  int node_;
+  Placement placement_;
+};
+
+/// Process-wide Placement::preferred resource for `node`; never destroyed.
+TCC_API NodeResource& node_resource(int node);
+
+/// node_resource(current_node()): an Arena upstream for the calling
+/// thread's node. Resolve it on the thread that will use the arena, after
+/// pinning, so the node does not change under it.
+TCC_API NodeResource& local_resource();
+
+}  // namespace tcc::numa
@@ -0,0 +1,688 @@
+#pragma once
+
+// Batched source -> transform -> sink pipelines on the ThreadPool.
+//
+//   template <template <class> class F = tcc::soa::Value>
+//   struct Event { F<std::uint64_t> user; F<float> amount; };
+//   template <template <class> class F = tcc::soa::Value>
+//   struct Scored { F<std::uint64_t> user; F<double> score; };
+//
+//   tcc::Pipeline pipeline({.batch_rows = 4096, .queue_batches = 8});
+//   pipeline
+//       .source<Event>([&](tcc::SoaVector<Event>& out) {
+//         return reader.append(out, pipeline.batch_rows());  // false once the input is exhausted
+//       })
+//       .transform<Scored>([](const tcc::SoaVector<Event>& in, tcc::SoaVector<Scored>& out) {
+//         for (std::size_t i = 0; i < in.size(); ++i) out.push_back({in[i].user, score(in[i].amount)});
+//       }, {.parallelism = 4})
+//       .sink([&](const tcc::SoaVector<Scored>& in) { writer.write(in.columns()); });
+//   pipeline.run();  // returns once every batch has reached the sink
+//
+// Data moves in batches of up to `batch_rows` rows, as SoaVector columns,
+// never item by item: a stage function is called once per batch and loops
+// over plain arrays, so the queue handoff and the call into the stage
+// (and any StaticDispatch visit inside it) cost once per few thousand rows.
+// Emptied batches go back to a free list and are refilled, so in steady
+// state no stage allocates.
+//
+// Adjacent stages are connected by a bounded channel: an SpscRing when
+// both sides have parallelism 1, an MpmcRing otherwise. A producer must
+// hold one of the channel's `queue_batches` credits before it starts a
+// batch, and the consumer returns the credit when it takes the batch. A
+// stage whose consumer falls behind therefore stops, and memory in flight
+// stays bounded by the queue sizes, however fast the source reads.
+//
+// Stages do not own threads. A stage runs as tasks on the pool, at most
+// `parallelism` at a time, and a task only exists while the stage has input
+// and downstream room: it processes batches until one of them runs out and
+// then ends, and pushing (or freeing room) schedules the neighbour. A pool
+// with fewer workers than stages still makes progress, and an idle stage
+// costs nothing. Batches keep their order only when every stage has
+// parallelism 1.
+//
+// If a stage function throws, the pipeline is cancelled: sources stop,
+// batches in flight are dropped, and run() rethrows the first exception
+// once everything has drained. cancel() does the same without an error.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tcc/mpmc_ring.hpp"
+#include "tcc/soa_vector.hpp"
+#include "tcc/spsc_ring.hpp"
+#include "tcc/thread_pool.hpp"
+
+namespace tcc {
+
+struct PipelineOptions {
+  std::size_t batch_rows = 4096;  // rows per batch; output batches come reserved to this
+  std::size_t queue_batches = 4;  // batches a channel holds before its producer stops
+  ThreadPool* pool = nullptr;     // nullptr: ThreadPool::global()
+};
+
+struct StageOptions {
+  std::size_t parallelism = 1;  // tasks of the stage running at once; the function must be thread-safe above 1
+  std::string name{};           // for Pipeline::stats(); empty: "source", "transform 1", ..., "sink"
+};
+
+struct StageStats {
+  std::string name;
+  std::uint64_t batches = 0;  // batches the stage function was called on
+  std::uint64_t rows = 0;     // rows it produced (for sinks: consumed)
+  std::uint64_t stalls = 0;   // times a task stopped because downstream was full
+};
+
+class Pipeline;
+
+namespace detail {
+
+template <template <template <class> class> class Record>
+class BatchPool {
+ public:
+  BatchPool(std::size_t free_batches, std::size_t rows) : free_(free_batches), rows_(rows) {}
+
+  /// An empty batch with room for `rows` rows, recycled when one is free.
+  SoaVector<Record> acquire() {
+    if (auto batch = free_.try_pop()) return std::move(*batch);
+    SoaVector<Record> batch;
+    batch.reserve(rows_);
+    return batch;
+  }
+
+  void release(SoaVector<Record>&& batch) noexcept {
+    batch.clear();
+    free_.try_push(std::move(batch));  // when the list is full, the batch is freed instead
+  }
+
+ private:
+  MpmcRing<SoaVector<Record>> free_;
+  std::size_t rows_;
+};
+
+/// The untyped half of a channel: credits for backpressure and the queued
+/// count that decides whether the consumer has work.
+class ChannelBase {
+ public:
+  explicit ChannelBase(std::size_t credits) : credits_(static_cast<std::ptrdiff_t>(credits)) {}
+  virtual ~ChannelBase() = default;
+
+  /// Claims room for one more batch; false when the channel is full.
+  bool acquire_credit() noexcept {
+    std::ptrdiff_t c = credits_.load();
+    while (c > 0) {
+      if (credits_.compare_exchange_weak(c, c - 1)) return true;
+    }
+    return false;
+  }
+  void return_credit() noexcept { credits_.fetch_add(1); }
+  bool has_credit() const noexcept { return credits_.load() > 0; }
+
+  /// Batches pushed and not popped yet. Can read -1 for a moment while a
+  /// pop overtakes the count of its push.
+  std::ptrdiff_t queued() const noexcept { return queued_.load(); }
+
+ protected:
+  // Sequentially consistent throughout. An exiting task decrements its
+  // stage's active count and then reads these; a neighbour updates these
+  // and then reads the active count. One of the two sees the other, so no
+  // wakeup is lost.
+  std::atomic<std::ptrdiff_t> credits_;
+  std::atomic<std::ptrdiff_t> queued_{0};
+};
+
+template <template <template <class> class> class Record>
+class Channel final : public ChannelBase {
+ public:
+  using Batch = SoaVector<Record>;
+  static constexpr std::size_t kSpscCapacity = 64;
+
+  Channel(std::size_t batches, bool single_ended, std::shared_ptr<BatchPool<Record>> pool)
+      : ChannelBase(batches), pool_(std::move(pool)) {
+    if (single_ended && batches <= kSpscCapacity) {
+      spsc_ = std::make_unique<SpscRing<Batch, kSpscCapacity>>();
+    } else {
+      mpmc_ = std::make_unique<MpmcRing<Batch>>(batches);
+    }
+  }
+
+  /// Never fails: the caller holds a credit, and the ring has a slot per
+  /// credit.
+  void push(Batch&& batch) noexcept {
+    if (spsc_) {
+      spsc_->try_push(std::move(batch));
+    } else {
+      mpmc_->try_push(std::move(batch));
+    }
+    queued_.fetch_add(1);
+  }
+
+  /// Takes the oldest batch and returns its credit to the producer.
+  bool pop(Batch& out) noexcept {
+    if (!(spsc_ ? spsc_->try_pop(out) : mpmc_->try_pop(out))) return false;
+    queued_.fetch_sub(1);
+    return_credit();
+    return true;
+  }
+
+  BatchPool<Record>& batches() noexcept { return *pool_; }
+  const std::shared_ptr<BatchPool<Record>>& batch_pool() const noexcept { return pool_; }
+
+ private:
+  std::shared_ptr<BatchPool<Record>> pool_;  // the producer's free list
+  std::unique_ptr<SpscRing<Batch, kSpscCapacity>> spsc_;
+  std::unique_ptr<MpmcRing<Batch>> mpmc_;
+};
+
+class StageBase;
+
+/// State shared by the stages of one pipeline.
+struct PipelineCore {
+  ThreadPool* pool = nullptr;
+  PipelineOptions options;
+  std::vector<StageBase*> stages;
+  std::atomic<bool> cancelled{false};
+  std::atomic<bool> done{false};
+  // Running tasks plus one for the unfinished sink. The pipeline may be
+  // destroyed once it drops to zero, so nothing touches the stages after
+  // releasing a hold.
+  std::atomic<std::size_t> holds{0};
+  std::mutex error_mutex;
+  std::exception_ptr error;
+
+  bool is_cancelled() const noexcept { return cancelled.load(std::memory_order_relaxed); }
+
+  void hold() noexcept { holds.fetch_add(1); }
+  void release() noexcept {
+    if (holds.fetch_sub(1) != 1) return;
+    ThreadPool& p = *pool;
+    done.store(true, std::memory_order_release);
+    p.notify_waiters();
+  }
+
+  void fail(std::exception_ptr e) {
+    {
+      std::lock_guard lock(error_mutex);
+      if (!error) error = std::move(e);
+    }
+    cancel();
+  }
+
+  /// Stops the sources and wakes every stage, so queued batches drain and
+  /// the end of the pipeline is detected. Called with a hold.
+  inline void cancel();
+};
+
+class StageBase {
+ public:
+  StageBase(PipelineCore& core, std::size_t parallelism, std::string name)
+      : core_(core), parallelism_(parallelism == 0 ? 1 : parallelism), name_(std::move(name)) {}
+  virtual ~StageBase() = default;
+
+  StageBase(const StageBase&) = delete;
+  StageBase& operator=(const StageBase&) = delete;
+
+  std::size_t parallelism() const noexcept { return parallelism_; }
+
+  /// Starts another task if the stage has work and is below its parallelism.
+  void schedule() {
+    std::size_t active = active_.load();
+    while (active < parallelism_) {
+      if (!ready()) return;
+      if (active_.compare_exchange_weak(active, active + 1)) {
+        core_.hold();
+        core_.pool->post([this] { run_task(); });
+        return;
+      }
+    }
+  }
+
+  /// Marks the stage finished once no input can arrive, none is queued and
+  /// no task runs, and then closes the next stage's input in turn.
+  void check_finished() {
+    if (!input_closed() || (input_ != nullptr && input_->queued() != 0) || active_.load() != 0) return;
+    if (finished_.exchange(true)) return;
+    if (downstream_ != nullptr) {
+      downstream_->upstream_closed_.store(true);
+      downstream_->check_finished();
+    } else {
+      core_.release();  // the sink's hold
+    }
+  }
+
+  StageStats stats() const {
+    return {name_, batches_.load(std::memory_order_relaxed), rows_.load(std::memory_order_relaxed),
+            stalls_.load(std::memory_order_relaxed)};
+  }
+
+  void link(StageBase& downstream, ChannelBase& channel) noexcept {
+    downstream_ = &downstream;
+    output_ = &channel;
+    downstream.upstream_ = this;
+    downstream.input_ = &channel;
+  }
+  bool has_downstream() const noexcept { return downstream_ != nullptr; }
+
+ protected:
+  /// Processes one batch. Returns false, without side effects, when there
+  /// was no input or no room downstream. Catches the stage function's
+  /// exceptions and reports them to the core.
+  virtual bool step() = 0;
+
+  bool input_closed() const noexcept {
+    return input_ != nullptr ? upstream_closed_.load() : exhausted_.load() || core_.is_cancelled();
+  }
+
+  bool ready() const noexcept {
+    if (input_ != nullptr ? input_->queued() <= 0 : input_closed()) return false;
+    return output_ == nullptr || core_.is_cancelled() || output_->has_credit();
+  }
+
+  /// After taking a batch: the producer may have been waiting for room,
+  /// and more input may be waiting for another task of this stage.
+  void took_input() {
+    upstream_->schedule();
+    if (input_->queued() > 0) schedule();
+  }
+
+  void count(std::size_t rows) noexcept {
+    batches_.fetch_add(1, std::memory_order_relaxed);
+    rows_.fetch_add(rows, std::memory_order_relaxed);
+  }
+  void stalled() noexcept { stalls_.fetch_add(1, std::memory_order_relaxed); }
+
+  PipelineCore& core_;
+  StageBase* upstream_ = nullptr;
+  StageBase* downstream_ = nullptr;
+  ChannelBase* input_ = nullptr;   // nullptr for the source
+  ChannelBase* output_ = nullptr;  // nullptr for the sink
+  std::atomic<bool> exhausted_{false};  // sources only
+
+ private:
+  void run_task() {
+    PipelineCore& core = core_;
+    while (step()) {
+    }
+    active_.fetch_sub(1);
+    if (ready()) schedule();
+    check_finished();
+    core.release();
+  }
+
+  const std::size_t parallelism_;
+  const std::string name_;
+  std::atomic<std::size_t> active_{0};
+  std::atomic<bool> upstream_closed_{false};
+  std::atomic<bool> finished_{false};
+  std::atomic<std::uint64_t> batches_{0};
+  std::atomic<std::uint64_t> rows_{0};
+  std::atomic<std::uint64_t> stalls_{0};
+};
+
+inline void PipelineCore::cancel() {
+  cancelled.store(true);
+  for (StageBase* stage : stages) {
+    stage->schedule();
+    stage->check_finished();
+  }
+}
+
+/// A stage with an output of Record batches.
+template <template <template <class> class> class Record>
+class Producer : public StageBase {
+ public:
+  Producer(PipelineCore& core, const StageOptions& options, std::string name,
+           std::shared_ptr<BatchPool<Record>> batches)
+      : StageBase(core, options.parallelism, std::move(name)), batches_(std::move(batches)) {}
+
+  void attach(Channel<Record>& channel, StageBase& downstream) noexcept {
+    out_ = &channel;
+    link(downstream, channel);
+  }
+  const std::shared_ptr<BatchPool<Record>>& batch_pool() const noexcept { return batches_; }
+
+ protected:
+  /// Sends a filled batch on, or recycles an empty one. Either way the
+  /// credit taken for it is used up.
+  void emit(SoaVector<Record>&& batch) {
+    if (batch.empty()) {
+      batches_->release(std::move(batch));
+      out_->return_credit();
+      return;
+    }
+    out_->push(std::move(batch));
+    downstream_->schedule();
+  }
+
+  std::shared_ptr<BatchPool<Record>> batches_;
+  Channel<Record>* out_ = nullptr;
+};
+
+template <template <template <class> class> class Out, class Fn>
+class SourceStage final : public Producer<Out> {
+ public:
+  SourceStage(PipelineCore& core, const StageOptions& options, std::string name, Fn fn)
+      : Producer<Out>(core, options, std::move(name),
+                      std::make_shared<BatchPool<Out>>(2 * (core.options.queue_batches + options.parallelism),
+                                                       core.options.batch_rows)),
+        fn_(std::move(fn)) {}
+
+ private:
+  bool step() override {
+    if (this->input_closed()) return false;
+    if (!this->out_->acquire_credit()) {
+      this->stalled();
+      return false;
+    }
+    SoaVector<Out> batch = this->batches_->acquire();
+    bool more = false;
+    try {
+      more = static_cast<bool>(fn_(batch));
+    } catch (...) {
+      batch.clear();
+      this->core_.fail(std::current_exception());
+    }
+    if (!more) this->exhausted_.store(true);
+    if (!batch.empty()) this->count(batch.size());
+    this->emit(std::move(batch));
+    return more;
+  }
+
+  Fn fn_;
+};
+
+template <template <template <class> class> class In, template <template <class> class> class Out, class Fn>
+class TransformStage final : public Producer<Out> {
+ public:
+  TransformStage(PipelineCore& core, const StageOptions& options, std::string name, Fn fn, Channel<In>& in)
+      : Producer<Out>(core, options, std::move(name),
+                      std::make_shared<BatchPool<Out>>(2 * (core.options.queue_batches + options.parallelism),
+                                                       core.options.batch_rows)),
+        fn_(std::move(fn)),
+        in_(in) {}
+
+ private:
+  bool step() override {
+    const bool cancelled = this->core_.is_cancelled();
+    if (!cancelled && !this->out_->acquire_credit()) {
+      this->stalled();
+      return false;
+    }
+    SoaVector<In> input;
+    if (!in_.pop(input)) {
+      if (!cancelled) this->out_->return_credit();
+      return false;
+    }
+    this->took_input();
+    if (cancelled) {
+      in_.batches().release(std::move(input));
+      return true;
+    }
+    SoaVector<Out> output = this->batches_->acquire();
+    try {
+      fn_(std::as_const(input), output);
+      this->count(output.size());
+    } catch (...) {
+      output.clear();
+      this->core_.fail(std::current_exception());
+    }
+    in_.batches().release(std::move(input));
+    this->emit(std::move(output));
+    return true;
+  }
+
+  Fn fn_;
+  Channel<In>& in_;
+};
+
+/// A transform that edits its input batch and passes it on: same record
+/// type, and it shares the free list of the stage before it.
+template <template <template <class> class> class Record, class Fn>
+class InPlaceStage final : public Producer<Record> {
+ public:
+  InPlaceStage(PipelineCore& core, const StageOptions& options, std::string name, Fn fn, Channel<Record>& in)
+      : Producer<Record>(core, options, std::move(name), in.batch_pool()), fn_(std::move(fn)), in_(in) {}
+
+ private:
+  bool step() override {
+    const bool cancelled = this->core_.is_cancelled();
+    if (!cancelled && !this->out_->acquire_credit()) {
+      this->stalled();
+      return false;
+    }
+    SoaVector<Record> batch;
+    if (!in_.pop(batch)) {
+      if (!cancelled) this->out_->return_credit();
+      return false;
+    }
+    this->took_input();
+    if (cancelled) {
+      in_.batches().release(std::move(batch));
+      return true;
+    }
+    try {
+      fn_(batch);
+      this->count(batch.size());
+    } catch (...) {
+      batch.clear();
+      this->core_.fail(std::current_exception());
+    }
+    this->emit(std::move(batch));
+    return true;
+  }
+
+  Fn fn_;
+  Channel<Record>& in_;
+};
+
+template <template <template <class> class> class In, class Fn>
+class SinkStage final : public StageBase {
+ public:
+  SinkStage(PipelineCore& core, const StageOptions& options, std::string name, Fn fn, Channel<In>& in)
+      : StageBase(core, options.parallelism, std::move(name)), fn_(std::move(fn)), in_(in) {}
+
+ private:
+  bool step() override {
+    SoaVector<In> batch;
+    if (!in_.pop(batch)) return false;
+    took_input();
+    if (!core_.is_cancelled()) {
+      try {
+        fn_(std::as_const(batch));
+        count(batch.size());
+      } catch (...) {
+        core_.fail(std::current_exception());
+      }
+    }
+    in_.batches().release(std::move(batch));
+    return true;
+  }
+
+  Fn fn_;
+  Channel<In>& in_;
+};
+
+}  // namespace detail
+
+/// The open end of a pipeline under construction: the last stage added,
+/// producing Record batches. Each handle takes exactly one next stage.
+template <template <template <class> class> class Record>
+class PipelineStage {
+ public:
+  using batch_type = SoaVector<Record>;
+
+  /// Adds `fn(const SoaVector<Record>& in, SoaVector<Out>& out)`. `out`
+  /// starts empty; an output left empty is dropped, so a transform can
+  /// filter.
+  template <template <template <class> class> class Out, class Fn>
+  PipelineStage<Out> transform(Fn&& fn, StageOptions options = {});
+
+  /// Adds `fn(SoaVector<Record>& batch)`, which edits the batch in place
+  /// (including removing rows) before it moves on.
+  template <class Fn>
+  PipelineStage<Record> transform_in_place(Fn&& fn, StageOptions options = {});
+
+  /// Ends the pipeline with `fn(const SoaVector<Record>& batch)`.
+  template <class Fn>
+  void sink(Fn&& fn, StageOptions options = {});
+
+ private:
+  friend class Pipeline;
+  template <template <template <class> class> class>
+  friend class PipelineStage;
+
+  PipelineStage(Pipeline& pipeline, detail::Producer<Record>& producer) noexcept
+      : pipeline_(&pipeline), producer_(&producer) {}
+
+  Pipeline* pipeline_;
+  detail::Producer<Record>* producer_;
+};
+
+class Pipeline {
+ public:
+  explicit Pipeline(PipelineOptions options = {}) {
+    if (options.batch_rows == 0) throw std::invalid_argument("Pipeline: batch_rows must be positive");
+    if (options.queue_batches == 0) throw std::invalid_argument("Pipeline: queue_batches must be positive");
+    core_.pool = options.pool != nullptr ? options.pool : &ThreadPool::global();
+    core_.options = options;
+  }
+
+  Pipeline(const Pipeline&) = delete;
+  Pipeline& operator=(const Pipeline&) = delete;
+
+  std::size_t batch_rows() const noexcept { return core_.options.batch_rows; }
+
+  /// Starts the pipeline with `fn(SoaVector<Record>& out) -> bool`, which
+  /// appends up to batch_rows() rows to the empty batch `out` and returns
+  /// false once the input is exhausted (rows appended by that last call
+  /// still go through). With parallelism above 1 the calls overlap, and
+  /// every call after the end must return false as well.
+  template <template <template <class> class> class Record, class Fn>
+  PipelineStage<Record> source(Fn&& fn, StageOptions options = {}) {
+    if (!stages_.empty()) throw std::logic_error("Pipeline::source: the pipeline already has a source");
+    auto stage = std::make_unique<detail::SourceStage<Record, std::decay_t<Fn>>>(
+        core_, options, stage_name(options, "source"), std::forward<Fn>(fn));
+    auto& ref = *stage;
+    add(std::move(stage));
+    return {*this, ref};
+  }
+
+  /// Runs every batch through to the sink and returns when the pipeline
+  /// has drained, rethrowing the first exception a stage function threw.
+  /// May be called once, from a worker of the pool or from any other
+  /// thread.
+  void run() {
+    if (!complete_) throw std::logic_error("Pipeline::run: the pipeline has no sink");
+    if (ran_.exchange(true)) throw std::logic_error("Pipeline::run: the pipeline has already run");
+    // The holds go in before started_ is published: a cancel() that sees
+    // started_ adds its hold on top of these instead of being overwritten.
+    core_.holds.store(2);  // the sink's, and this call's while it starts the source
+    started_.store(true);
+    core_.stages.front()->schedule();
+    core_.stages.front()->check_finished();  // a cancelled pipeline has nothing to start
+    core_.release();
+    core_.pool->wait(core_.done);
+    if (core_.error) std::rethrow_exception(core_.error);
+  }
+
+  /// Stops the sources and drops the batches in flight; run() then returns
+  /// normally. Safe from stage functions and from other threads at any
+  /// point before run() returns, including while it starts the source.
+  void cancel() {
+    core_.cancelled.store(true);
+    if (!started_.load()) return;  // run() has yet to start the source, and will see the flag
+    core_.hold();
+    core_.cancel();
+    core_.release();
+  }
+
+  /// Per-stage counters, source first.
+  std::vector<StageStats> stats() const {
+    std::vector<StageStats> out;
+    out.reserve(stages_.size());
+    for (const auto& stage : stages_) out.push_back(stage->stats());
+    return out;
+  }
+
+ private:
+  template <template <template <class> class> class>
+  friend class PipelineStage;
+
+  std::string stage_name(const StageOptions& options, const char* kind) const {
+    if (!options.name.empty()) return options.name;
+    if (std::string(kind) == "transform") return "transform " + std::to_string(stages_.size());
+    return kind;
+  }
+
+  void add(std::unique_ptr<detail::StageBase> stage) {
+    core_.stages.push_back(stage.get());
+    stages_.push_back(std::move(stage));
+  }
+
+  /// The channel from `producer` to a new consumer with `parallelism`.
+  template <template <template <class> class> class Record>
+  detail::Channel<Record>& open_channel(detail::Producer<Record>& producer, std::size_t parallelism) {
+    if (producer.has_downstream()) throw std::logic_error("Pipeline: this stage already has a consumer");
+    if (complete_) throw std::logic_error("Pipeline: the pipeline already has a sink");
+    const bool single_ended = producer.parallelism() == 1 && (parallelism == 0 ? 1 : parallelism) == 1;
+    auto channel = std::make_unique<detail::Channel<Record>>(core_.options.queue_batches, single_ended,
+                                                             producer.batch_pool());
+    auto& ref = *channel;
+    channels_.push_back(std::move(channel));
+    return ref;
+  }
+
+  detail::PipelineCore core_;
+  std::vector<std::unique_ptr<detail::StageBase>> stages_;
+  std::vector<std::unique_ptr<detail::ChannelBase>> channels_;
+  bool complete_ = false;
+  std::atomic<bool> ran_{false};
+  std::atomic<bool> started_{false};  // set once run() holds the core
+};
+
+// --- PipelineStage ------------------------------------------------------------
+
+template <template <template <class> class> class Record>
+template <template <template <class> class> class Out, class Fn>
+PipelineStage<Out> PipelineStage<Record>::transform(Fn&& fn, StageOptions options) {
+  auto& in = pipeline_->open_channel(*producer_, options.parallelism);
+  auto stage = std::make_unique<detail::TransformStage<Record, Out, std::decay_t<Fn>>>(
+      pipeline_->core_, options, pipeline_->stage_name(options, "transform"), std::forward<Fn>(fn), in);
+  auto& ref = *stage;
+  producer_->attach(in, ref);
+  pipeline_->add(std::move(stage));
+  return {*pipeline_, ref};
+}
+
+template <template <template <class> class> class Record>
+template <class Fn>
+PipelineStage<Record> PipelineStage<Record>::transform_in_place(Fn&& fn, StageOptions options) {
+  auto& in = pipeline_->open_channel(*producer_, options.parallelism);
+  auto stage = std::make_unique<detail::InPlaceStage<Record, std::decay_t<Fn>>>(
+      pipeline_->core_, options, pipeline_->stage_name(options, "transform"), std::forward<Fn>(fn), in);
+  auto& ref = *stage;
+  producer_->attach(in, ref);
+  pipeline_->add(std::move(stage));
+  return {*pipeline_, ref};
+}
+
+template <template <template <class> class> class Record>
+template <class Fn>
+void PipelineStage<Record>::sink(Fn&& fn, StageOptions options) {
+  auto& in = pipeline_->open_channel(*producer_, options.parallelism);
+  auto stage = std::make_unique<detail::SinkStage<Record, std::decay_t<Fn>>>(
+      pipeline_->core_, options, pipeline_->stage_name(options, "sink"), std::forward<Fn>(fn), in);
+  producer_->attach(in, *stage);
+  pipeline_->add(std::move(stage));
+  pipeline_->complete_ = true;
+}
+
+}  // namespace tcc
@@ -0,0 +1,41 @@
+#pragma once
+
+// Small platform shims shared by the concurrency components.
+
+#include <cstddef>
+#include <new>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace tcc {
+
+/// Distance that keeps two independently written atomics from sharing a
+/// cache line. GCC warns that the standard constant depends on -mtune; we
+/// want exactly that value, and every TU in the build sees the same flags.
+#if defined(__cpp_lib_hardware_interference_size)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+inline constexpr std::size_t kCacheLineSize = std::hardware_destructive_interference_size;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#else
+inline constexpr std::size_t kCacheLineSize = 64;
+#endif
+
+/// Hint to the CPU that we are in a spin-wait loop.
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#elif defined(_MSC_VER)
+  _mm_pause();
+#endif
+}
+
+}  // namespace tcc
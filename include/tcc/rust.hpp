@@ -0,0 +1,128 @@
+#pragma once
+
+// C++ side of the Rust crate in rust/ (TCC_WITH_RUST). Data crosses the
+// language boundary without being copied:
+//
+//   std::uint64_t h = tcc::rust::fnv1a(bytes);         // Rust reads the span in place
+//   tcc::rust::split(line, ',', [&](std::string_view field) {
+//     fields.push_back(field);                          // points into `line`
+//   });
+//   tcc::rust::Buffer up = tcc::rust::to_upper(text);  // a Rust Vec<u8>, now owned here
+//   up.append(suffix);                                  // handed to Rust and back, bytes stay put
+//
+// Spans and string views cross as borrowed {ptr, len} slices in both
+// directions, so no std::string or Vec is built for a call. Buffer owns a
+// Rust Vec<u8> taken apart into {ptr, len, cap}. Moving it into a Rust call
+// and back moves the pointer, not the bytes, and the allocation is only
+// ever freed by the Rust allocator. Fill a Buffer in place through spare()
+// and commit() (std::fread, read(2), a decoder) to hand data to Rust
+// without an intermediate copy.
+//
+// Rust panics abort the process (panic = "abort"), and so does a failed
+// Rust allocation.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "tcc/export.hpp"
+
+namespace tcc::rust {
+
+/// Owning handle to a Rust Vec<u8>. Move-only; empty when default
+/// constructed or moved from.
+class TCC_API Buffer {
+ public:
+  Buffer() noexcept = default;
+  ~Buffer();
+
+  Buffer(const Buffer&) = delete;
+  Buffer& operator=(const Buffer&) = delete;
+  Buffer(Buffer&& other) noexcept
+      : data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)),
+        capacity_(std::exchange(other.capacity_, 0)) {}
+  Buffer& operator=(Buffer&& other) noexcept {
+    Buffer(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /// An empty buffer that can take `capacity` bytes without reallocating.
+  static Buffer with_capacity(std::size_t capacity);
+
+  std::byte* data() noexcept { return data_; }
+  const std::byte* data() const noexcept { return data_; }
+  std::size_t size() const noexcept { return size_; }
+  std::size_t capacity() const noexcept { return capacity_; }
+  bool empty() const noexcept { return size_ == 0; }
+
+  std::span<const std::byte> bytes() const noexcept { return {data_, size_}; }
+  std::string_view text() const noexcept { return {reinterpret_cast<const char*>(data_), size_}; }
+
+  /// The uninitialized capacity past size(). Write into it, then commit().
+  std::span<std::byte> spare() noexcept { return {data_ + size_, capacity_ - size_}; }
+
+  /// Marks the first `n` bytes of spare() as written. Throws
+  /// std::length_error when n > spare().size().
+  void commit(std::size_t n);
+
+  /// Makes room for `additional` more bytes (Vec::reserve).
+  void reserve(std::size_t additional);
+
+  /// Appends `tail`, growing through Rust when the capacity is exhausted.
+  /// `tail` must not point into this buffer.
+  void append(std::span<const std::byte> tail);
+  void append(std::string_view tail) { append(std::as_bytes(std::span(tail.data(), tail.size()))); }
+
+  void swap(Buffer& other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+  }
+
+ private:
+  friend struct BufferAccess;
+
+  Buffer(std::byte* data, std::size_t size, std::size_t capacity) noexcept
+      : data_(data), size_(size), capacity_(capacity) {}
+
+  std::byte* data_ = nullptr;
+  std::size_t size_ = 0;
+  std::size_t capacity_ = 0;
+};
+
+/// Version of the linked Rust crate.
+TCC_API std::string_view crate_version() noexcept;
+
+/// 64-bit FNV-1a, computed by Rust on the caller's memory.
+TCC_API std::uint64_t fnv1a(std::span<const std::byte> bytes) noexcept;
+inline std::uint64_t fnv1a(std::string_view text) noexcept {
+  return fnv1a(std::as_bytes(std::span(text.data(), text.size())));
+}
+
+/// ASCII-uppercased copy of `bytes`, allocated once on the Rust side.
+TCC_API Buffer to_upper(std::span<const std::byte> bytes);
+inline Buffer to_upper(std::string_view text) { return to_upper(std::as_bytes(std::span(text.data(), text.size()))); }
+
+namespace detail {
+using FieldCallback = void (*)(void* ctx, std::string_view field);
+TCC_API std::size_t split(std::string_view text, char delimiter, FieldCallback on_field, void* ctx) noexcept;
+}  // namespace detail
+
+/// Calls `fn(field)` for each `delimiter`-separated field of `text`, as
+/// views into `text`, and returns the number of fields. `fn` must not
+/// throw: the call runs inside Rust frames, and unwinding through them
+/// terminates the process.
+template <class Fn>
+std::size_t split(std::string_view text, char delimiter, Fn&& fn) noexcept {
+  using F = std::remove_reference_t<Fn>;
+  return detail::split(
+      text, delimiter, [](void* ctx, std::string_view field) { (*static_cast<F*>(ctx))(field); },
+      const_cast<void*>(static_cast<const void*>(std::addressof(fn))));
+}
+
+}  // namespace tcc::rust
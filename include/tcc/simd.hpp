@@ -0,0 +1,94 @@
+#pragma once
+
+// Vectorized kernels with one-time runtime ISA selection.
+//
+// Every kernel is compiled once per ISA level, each in its own translation
+// unit with its own -m flags, and the best level the CPU supports is picked
+// once at startup. One binary therefore runs on any x86-64 machine (or any
+// AArch64 machine) and still uses AVX2/AVX-512/NEON where available.
+//
+// Results are bit-identical across ISA levels, including the scalar
+// fallback: floating-point reductions use a fixed 16-lane accumulation
+// order and a fixed pairwise horizontal fold, and no path uses FMA.
+// min/max follow the SSE minps/maxps convention: when a comparison is
+// unordered (NaN), the element being folded in wins.
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "tcc/export.hpp"
+
+namespace tcc::simd {
+
+enum class Isa : std::uint8_t { scalar, sse42, avx2, avx512, neon };
+
+TCC_API std::string_view isa_name(Isa isa) noexcept;
+
+/// Function table for one ISA level. All pointers are non-null.
+struct Kernels {
+  Isa isa;
+  float (*sum)(const float* data, std::size_t n);
+  float (*min)(const float* data, std::size_t n);
+  float (*max)(const float* data, std::size_t n);
+  float (*dot)(const float* a, const float* b, std::size_t n);
+  std::size_t (*find_byte)(const std::byte* data, std::size_t n, std::byte needle);
+  std::size_t (*count_byte)(const std::byte* data, std::size_t n, std::byte needle);
+  void (*prefix_sum)(const std::uint32_t* in, std::uint32_t* out, std::size_t n);
+};
+
+/// ISA levels compiled into this binary that the running CPU supports,
+/// from scalar up to the best one.
+TCC_API std::vector<Isa> supported_isas();
+
+/// Best supported level; what the free functions below use by default.
+TCC_API Isa detected_isa() noexcept;
+
+/// Level the free functions currently dispatch to.
+TCC_API Isa active_isa() noexcept;
+
+/// Forces a level, e.g. to compare levels in benchmarks. Throws
+/// std::invalid_argument when `isa` is not in supported_isas().
+TCC_API void set_active_isa(Isa isa);
+
+/// Table for a specific supported level; throws like set_active_isa().
+TCC_API const Kernels& kernels(Isa isa);
+
+/// Table for the active level.
+TCC_API const Kernels& active_kernels() noexcept;
+
+inline constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+/// Sum of all elements; 0 for an empty span.
+inline float sum(std::span<const float> v) noexcept { return active_kernels().sum(v.data(), v.size()); }
+
+/// Smallest element; +infinity for an empty span.
+inline float min(std::span<const float> v) noexcept { return active_kernels().min(v.data(), v.size()); }
+
+/// Largest element; -infinity for an empty span.
+inline float max(std::span<const float> v) noexcept { return active_kernels().max(v.data(), v.size()); }
+
+/// Sum of a[i] * b[i] over the shorter of the two spans.
+inline float dot(std::span<const float> a, std::span<const float> b) noexcept {
+  return active_kernels().dot(a.data(), b.data(), a.size() < b.size() ? a.size() : b.size());
+}
+
+/// Index of the first byte equal to `needle`, or npos.
+inline std::size_t find_byte(std::span<const std::byte> v, std::byte needle) noexcept {
+  return active_kernels().find_byte(v.data(), v.size(), needle);
+}
+
+/// Number of bytes equal to `needle`.
+inline std::size_t count_byte(std::span<const std::byte> v, std::byte needle) noexcept {
+  return active_kernels().count_byte(v.data(), v.size(), needle);
+}
+
+/// Inclusive prefix sum with unsigned wrap-around: out[i] = in[0] + ... +
+/// in[i]. `out` must hold in.size() elements and may alias `in`.
+inline void prefix_sum(std::span<const std::uint32_t> in, std::span<std::uint32_t> out) noexcept {
+  active_kernels().prefix_sum(in.data(), out.data(), in.size() < out.size() ? in.size() : out.size());
+}
+
+}  // namespace tcc::simd
@@ -0,0 +1,162 @@
+#pragma once
+
+// 16-byte group matching for open-addressing tables.
+//
+// Unlike the kernels in tcc/simd.hpp these are inline and compiled for the
+// baseline ISA only (SSE2 on x86-64, NEON on AArch64, a byte loop
+// elsewhere): a probe touches one group, so an indirect call through the
+// dispatch table would cost more than the comparison itself.
+//
+//   tcc::simd::Group16 g(ctrl + pos);
+//   for (unsigned i : g.match(h2)) check(pos + i);
+//   if (g.match(kEmpty)) return not_found;
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TCC_SIMD_GROUP_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#define TCC_SIMD_GROUP_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace tcc::simd {
+
+/// Set of lanes in a group, one bit per lane (SSE2, scalar) or one bit in
+/// each 4-bit nibble (NEON). Iterates the matching lane indices in order.
+template <unsigned Shift>
+class LaneMask {
+ public:
+  constexpr explicit LaneMask(std::uint64_t bits) noexcept : bits_(bits) {}
+
+  constexpr explicit operator bool() const noexcept { return bits_ != 0; }
+
+  /// Index of the first / last set lane; the mask must be non-empty.
+  unsigned lowest() const noexcept { return ctz(bits_) >> Shift; }
+  unsigned highest() const noexcept { return (63u - clz(bits_)) >> Shift; }
+
+  /// Clear lanes before the first set lane; 16 for an empty mask.
+  unsigned leading_clear() const noexcept { return bits_ ? lowest() : 16u; }
+  /// Clear lanes after the last set lane; 16 for an empty mask.
+  unsigned trailing_clear() const noexcept { return bits_ ? 15u - highest() : 16u; }
+
+  class iterator {
+   public:
+    constexpr explicit iterator(std::uint64_t bits) noexcept : bits_(bits) {}
+    unsigned operator*() const noexcept { return ctz(bits_) >> Shift; }
+    iterator& operator++() noexcept {
+      bits_ &= bits_ - 1;
+      return *this;
+    }
+    constexpr bool operator==(const iterator& other) const noexcept { return bits_ == other.bits_; }
+
+   private:
+    std::uint64_t bits_;
+  };
+
+  iterator begin() const noexcept { return iterator(bits_); }
+  iterator end() const noexcept { return iterator(0); }
+
+ private:
+  static unsigned ctz(std::uint64_t v) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long i;
+    _BitScanForward64(&i, v);
+    return static_cast<unsigned>(i);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(v));
+#endif
+  }
+  static unsigned clz(std::uint64_t v) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long i;
+    _BitScanReverse64(&i, v);
+    return 63u - static_cast<unsigned>(i);
+#else
+    return static_cast<unsigned>(__builtin_clzll(v));
+#endif
+  }
+
+  std::uint64_t bits_;
+};
+
+/// Sixteen control bytes loaded at once (unaligned), compared as signed
+/// values.
+class Group16 {
+ public:
+  static constexpr unsigned kWidth = 16;
+
+#if defined(TCC_SIMD_GROUP_SSE2)
+  using Mask = LaneMask<0>;
+
+  explicit Group16(const std::int8_t* p) noexcept : v_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+  /// Lanes equal to `byte`.
+  Mask match(std::int8_t byte) const noexcept { return to_mask(_mm_cmpeq_epi8(_mm_set1_epi8(byte), v_)); }
+  /// Lanes less than `limit`.
+  Mask below(std::int8_t limit) const noexcept { return to_mask(_mm_cmpgt_epi8(_mm_set1_epi8(limit), v_)); }
+  /// Lanes with the sign bit clear (byte >= 0).
+  Mask non_negative() const noexcept {
+    return Mask(static_cast<std::uint16_t>(~_mm_movemask_epi8(v_)));
+  }
+
+ private:
+  static Mask to_mask(__m128i m) noexcept {
+    return Mask(static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_movemask_epi8(m))));
+  }
+
+  __m128i v_;
+
+#elif defined(TCC_SIMD_GROUP_NEON)
+  using Mask = LaneMask<2>;
+
+  explicit Group16(const std::int8_t* p) noexcept : v_(vld1q_s8(p)) {}
+
+  Mask match(std::int8_t byte) const noexcept { return to_mask(vceqq_s8(v_, vdupq_n_s8(byte))); }
+  Mask below(std::int8_t limit) const noexcept { return to_mask(vcltq_s8(v_, vdupq_n_s8(limit))); }
+  Mask non_negative() const noexcept { return to_mask(vcgeq_s8(v_, vdupq_n_s8(0))); }
+
+ private:
+  // Narrowing shift packs each 0x00/0xFF lane into a nibble; keep one bit
+  // per nibble so that clearing the lowest bit advances one lane.
+  static Mask to_mask(uint8x16_t m) noexcept {
+    const uint8x8_t packed = vshrn_n_u16(vreinterpretq_u16_u8(m), 4);
+    return Mask(vget_lane_u64(vreinterpret_u64_u8(packed), 0) & 0x8888888888888888ull);
+  }
+
+  int8x16_t v_;
+
+#else
+  using Mask = LaneMask<0>;
+
+  explicit Group16(const std::int8_t* p) noexcept {
+    for (unsigned i = 0; i < kWidth; ++i) v_[i] = p[i];
+  }
+
+  Mask match(std::int8_t byte) const noexcept {
+    std::uint64_t m = 0;
+    for (unsigned i = 0; i < kWidth; ++i) m |= std::uint64_t{v_[i] == byte} << i;
+    return Mask(m);
+  }
+  Mask below(std::int8_t limit) const noexcept {
+    std::uint64_t m = 0;
+    for (unsigned i = 0; i < kWidth; ++i) m |= std::uint64_t{v_[i] < limit} << i;
+    return Mask(m);
+  }
+  Mask non_negative() const noexcept {
+    std::uint64_t m = 0;
+    for (unsigned i = 0; i < kWidth; ++i) m |= std::uint64_t{v_[i] >= 0} << i;
+    return Mask(m);
+  }
+
+ private:
+  std::int8_t v_[kWidth];
+#endif
+};
+
+}  // namespace tcc::simd
@@ -0,0 +1,509 @@
+#pragma once
+
+// Structure-of-arrays container for record types.
+//
+// A record is declared once, as an aggregate template over a "field kind":
+//
+//   template <template <class> class F = tcc::soa::Value>
+//   struct Quote {
+//     F<double> price;
+//     F<std::int64_t> volume;
+//     F<std::uint32_t> venue;
+//   };
+//
+// Quote<> is the ordinary struct (F<T> = T). tcc::SoaVector<Quote> keeps one
+// 64-byte-aligned array per field and renders the same template with other
+// kinds to give AoS-looking access without macros:
+//
+//   tcc::SoaVector<Quote> book;
+//   book.push_back({101.5, 300, 7});
+//   book[0].price *= 1.01;                           // Quote<Ref>: double& price
+//   std::span<double> prices = book.columns().price;  // Quote<Span>
+//   auto [price, volume, venue] = book[0];           // references, by position
+//
+// Fields are discovered by instantiating the record with a tag kind and
+// destructuring it with structured bindings (up to kMaxSoaFields fields),
+// so the field list is only ever written in the record itself. A scan that
+// reads one field streams exactly that field's array: no cache line is
+// spent on fields the loop never touches, and columns of float feed
+// tcc::simd kernels directly (`tcc::simd::sum(v.column<0>())`).
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace tcc {
+
+namespace soa {
+
+/// Field kinds. A record template instantiated with one of these is the
+/// plain value, a bundle of references, or a bundle of column spans.
+template <class T>
+using Value = T;
+template <class T>
+using Ref = T&;
+template <class T>
+using ConstRef = const T&;
+template <class T>
+using Span = std::span<T>;
+template <class T>
+using ConstSpan = std::span<const T>;
+
+/// Used only to discover field types: Record<Tag> has a Tag<T> per field.
+template <class T>
+using Tag = std::type_identity<T>;
+
+}  // namespace soa
+
+inline constexpr std::size_t kMaxSoaFields = 16;
+
+namespace detail {
+
+struct AnyField {
+  template <class T>
+  constexpr operator T() const noexcept;  // unevaluated only
+};
+
+template <class Aggregate, std::size_t... I>
+constexpr bool brace_constructible(std::index_sequence<I...>) {
+  return requires { Aggregate{(static_cast<void>(I), AnyField{})...}; };
+}
+
+/// Largest N such that Aggregate{a1..aN} is well-formed.
+template <class Aggregate, std::size_t N = kMaxSoaFields + 1>
+constexpr std::size_t count_fields() {
+  if constexpr (N == 0) {
+    return 0;
+  } else if constexpr (brace_constructible<Aggregate>(std::make_index_sequence<N>{})) {
+    return N;
+  } else {
+    return count_fields<Aggregate, N - 1>();
+  }
+}
+
+/// std::tie of an aggregate's fields, in declaration order.
+template <std::size_t N, class Aggregate>
+constexpr auto tie_fields(Aggregate& r) noexcept {
+  // clang-format off
+  if constexpr (N == 1) { auto& [a] = r; return std::tie(a); }
+  else if constexpr (N == 2) { auto& [a, b] = r; return std::tie(a, b); }
+  else if constexpr (N == 3) { auto& [a, b, c] = r; return std::tie(a, b, c); }
+  else if constexpr (N == 4) { auto& [a, b, c, d] = r; return std::tie(a, b, c, d); }
+  else if constexpr (N == 5) { auto& [a, b, c, d, e] = r; return std::tie(a, b, c, d, e); }
+  else if constexpr (N == 6) { auto& [a, b, c, d, e, f] = r; return std::tie(a, b, c, d, e, f); }
+  else if constexpr (N == 7) { auto& [a, b, c, d, e, f, g] = r; return std::tie(a, b, c, d, e, f, g); }
+  else if constexpr (N == 8) { auto& [a, b, c, d, e, f, g, h] = r; return std::tie(a, b, c, d, e, f, g, h); }
+  else if constexpr (N == 9) {
+    auto& [a, b, c, d, e, f, g, h, i] = r;
+    return std::tie(a, b, c, d, e, f, g, h, i);
+  } else if constexpr (N == 10) {
+    auto& [a, b, c, d, e, f, g, h, i, j] = r;
+    return std::tie(a, b, c, d, e, f, g, h, i, j);
+  } else if constexpr (N == 11) {
+    auto& [a, b, c, d, e, f, g, h, i, j, k] = r;
+    return std::tie(a, b, c, d, e, f, g, h, i, j, k);
+  } else if constexpr (N == 12) {
+    auto& [a, b, c, d, e, f, g, h, i, j, k, l] = r;
+    return std::tie(a, b, c, d, e, f, g, h, i, j, k, l);
+  } else if constexpr (N == 13) {
+    auto& [a, b, c, d, e, f, g, h, i, j, k, l, m] = r;
+    return std::tie(a, b, c, d, e, f, g, h, i, j, k, l, m);
+  } else if constexpr (N == 14) {
+    auto& [a, b, c, d, e, f, g, h, i, j, k, l, m, n] = r;
+    return std::tie(a, b, c, d, e, f, g, h, i, j, k, l, m, n);
+  } else if constexpr (N == 15) {
+    auto& [a, b, c, d, e, f, g, h, i, j, k, l, m, n, o] = r;
+    return std::tie(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o);
+  } else if constexpr (N == 16) {
+    auto& [a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p] = r;
+    return std::tie(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p);
+  } else {
+    static_assert(N <= kMaxSoaFields, "SoaVector records are limited to kMaxSoaFields fields");
+    return std::tuple<>();
+  }
+  // clang-format on
+}
+
+template <class TagTuple>
+struct UntagFields;
+
+template <class... Tags>
+struct UntagFields<std::tuple<Tags&...>> {
+  using type = std::tuple<typename Tags::type...>;
+};
+
+template <template <template <class> class> class Record>
+struct SoaTraits {
+  using Tagged = Record<soa::Tag>;
+  static_assert(std::is_aggregate_v<Tagged>, "SoaVector records must be aggregates");
+
+  static constexpr std::size_t kFields = count_fields<Tagged>();
+  static_assert(kFields > 0, "SoaVector records need at least one field");
+
+  /// std::tuple<T0, T1, ...> of the field types.
+  using Fields = typename UntagFields<decltype(tie_fields<kFields>(std::declval<Tagged&>()))>::type;
+};
+
+}  // namespace detail
+
+template <template <template <class> class> class Record>
+class SoaVector {
+  using Traits = detail::SoaTraits<Record>;
+  using Fields = typename Traits::Fields;
+
+ public:
+  static constexpr std::size_t kFields = Traits::kFields;
+  /// Alignment of every column (one cache line; enough for AVX-512 loads).
+  static constexpr std::size_t kAlignment = 64;
+
+  template <std::size_t I>
+  using field_type = std::tuple_element_t<I, Fields>;
+
+  using value_type = Record<soa::Value>;
+  using reference = Record<soa::Ref>;
+  using const_reference = Record<soa::ConstRef>;
+  using size_type = std::size_t;
+
+  /// Random-access iterator yielding reference bundles by value.
+  template <bool Const>
+  class Iterator {
+    using Owner = std::conditional_t<Const, const SoaVector, SoaVector>;
+
+   public:
+    // Like vector<bool>: random access by index, but a proxy reference.
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = SoaVector::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<Const, const_reference, SoaVector::reference>;
+
+    Iterator() noexcept = default;
+    Iterator(Owner* owner, size_type index) noexcept : owner_(owner), index_(index) {}
+
+    reference operator*() const noexcept { return (*owner_)[index_]; }
+    reference operator[](difference_type n) const noexcept { return (*owner_)[index_ + n]; }
+
+    Iterator& operator++() noexcept { return ++index_, *this; }
+    Iterator operator++(int) noexcept { return {owner_, index_++}; }
+    Iterator& operator--() noexcept { return --index_, *this; }
+    Iterator operator--(int) noexcept { return {owner_, index_--}; }
+    Iterator& operator+=(difference_type n) noexcept { return index_ += n, *this; }
+    Iterator& operator-=(difference_type n) noexcept { return index_ -= n, *this; }
+    friend Iterator operator+(Iterator it, difference_type n) noexcept { return it += n; }
+    friend Iterator operator+(difference_type n, Iterator it) noexcept { return it += n; }
+    friend Iterator operator-(Iterator it, difference_type n) noexcept { return it -= n; }
+    friend difference_type operator-(const Iterator& a, const Iterator& b) noexcept {
+      return static_cast<difference_type>(a.index_) - static_cast<difference_type>(b.index_);
+    }
+    friend bool operator==(const Iterator& a, const Iterator& b) noexcept { return a.index_ == b.index_; }
+    friend auto operator<=>(const Iterator& a, const Iterator& b) noexcept { return a.index_ <=> b.index_; }
+
+   private:
+    Owner* owner_ = nullptr;
+    size_type index_ = 0;
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  SoaVector() noexcept = default;
+  explicit SoaVector(size_type count) { resize(count); }
+
+  SoaVector(const SoaVector& other) {
+    reserve(other.size_);
+    for (size_type i = 0; i < other.size_; ++i) push_back(other.get(i));
+  }
+  SoaVector(SoaVector&& other) noexcept
+      : columns_(std::exchange(other.columns_, {})),
+        size_(std::exchange(other.size_, 0)),
+        capacity_(std::exchange(other.capacity_, 0)) {}
+
+  SoaVector& operator=(const SoaVector& other) {
+    if (this != &other) {
+      SoaVector copy(other);
+      swap(copy);
+    }
+    return *this;
+  }
+  SoaVector& operator=(SoaVector&& other) noexcept {
+    if (this != &other) {
+      SoaVector moved(std::move(other));
+      swap(moved);
+    }
+    return *this;
+  }
+
+  ~SoaVector() {
+    clear();
+    release(columns_, capacity_);
+  }
+
+  void swap(SoaVector& other) noexcept {
+    std::swap(columns_, other.columns_);
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+  }
+
+  // --- Size and capacity ----------------------------------------------------------
+
+  size_type size() const noexcept { return size_; }
+  size_type capacity() const noexcept { return capacity_; }
+  bool empty() const noexcept { return size_ == 0; }
+
+  void reserve(size_type count) {
+    if (count > capacity_) reallocate(count);
+  }
+
+  /// Value-initializes new elements; destroys surplus ones.
+  void resize(size_type count) {
+    if (count < size_) {
+      destroy_range(count, size_);
+      size_ = count;
+      return;
+    }
+    reserve(count);
+    while (size_ < count) emplace_default();
+  }
+
+  void clear() noexcept {
+    destroy_range(0, size_);
+    size_ = 0;
+  }
+
+  void shrink_to_fit() {
+    if (size_ < capacity_) reallocate(size_);
+  }
+
+  // --- Element access -------------------------------------------------------------
+
+  reference operator[](size_type i) noexcept { return make_ref<reference>(i, kIndices); }
+  const_reference operator[](size_type i) const noexcept { return make_ref<const_reference>(i, kIndices); }
+
+  /// Bounds-checked operator[]; throws std::out_of_range.
+  reference at(size_type i) {
+    check(i);
+    return (*this)[i];
+  }
+  const_reference at(size_type i) const {
+    check(i);
+    return (*this)[i];
+  }
+
+  /// Gathers element `i` into a plain record.
+  value_type get(size_type i) const { return make_value(i, kIndices); }
+  /// Scatters `value` into element `i`.
+  void set(size_type i, const value_type& value) { assign(i, value, kIndices); }
+
+  reference front() noexcept { return (*this)[0]; }
+  reference back() noexcept { return (*this)[size_ - 1]; }
+
+  iterator begin() noexcept { return {this, 0}; }
+  iterator end() noexcept { return {this, size_}; }
+  const_iterator begin() const noexcept { return {this, 0}; }
+  const_iterator end() const noexcept { return {this, size_}; }
+
+  // --- Columns --------------------------------------------------------------------
+
+  /// Field I of every element, contiguous and kAlignment-aligned.
+  template <std::size_t I>
+  std::span<field_type<I>> column() noexcept {
+    return {std::get<I>(columns_), size_};
+  }
+  template <std::size_t I>
+  std::span<const field_type<I>> column() const noexcept {
+    return {std::get<I>(columns_), size_};
+  }
+
+  /// All columns as a record of spans: `v.columns().price`.
+  Record<soa::Span> columns() noexcept { return make_spans<Record<soa::Span>>(kIndices); }
+  Record<soa::ConstSpan> columns() const noexcept { return make_spans<Record<soa::ConstSpan>>(kIndices); }
+
+  // --- Modifiers ------------------------------------------------------------------
+
+  void push_back(const value_type& value) {
+    grow_for_one();
+    construct_at_end(detail::tie_fields<kFields>(value), kIndices);
+  }
+  void push_back(value_type&& value) {
+    grow_for_one();
+    auto fields = detail::tie_fields<kFields>(value);
+    construct_at_end(move_all(fields, kIndices), kIndices);
+  }
+
+  /// Appends an element built from one argument per field, in order.
+  template <class... Args>
+    requires(sizeof...(Args) == kFields)
+  reference emplace_back(Args&&... args) {
+    grow_for_one();
+    construct_at_end(std::forward_as_tuple(std::forward<Args>(args)...), kIndices);
+    return back();
+  }
+
+  void pop_back() noexcept {
+    --size_;
+    destroy_range(size_, size_ + 1);
+  }
+
+  /// Removes element `i` by moving the last element into its place (O(1),
+  /// does not preserve order).
+  void swap_remove(size_type i) noexcept {
+    if (i + 1 != size_) move_element(size_ - 1, i, kIndices);
+    pop_back();
+  }
+
+ private:
+  template <class Tuple>
+  struct Pointers;
+  template <class... Ts>
+  struct Pointers<std::tuple<Ts...>> {
+    using type = std::tuple<Ts*...>;
+  };
+  using Columns = typename Pointers<Fields>::type;
+
+  static constexpr auto kIndices = std::make_index_sequence<kFields>{};
+
+  template <std::size_t... I>
+  static constexpr bool all_nothrow_movable(std::index_sequence<I...>) {
+    return (std::is_nothrow_move_constructible_v<field_type<I>> && ...);
+  }
+  static_assert(all_nothrow_movable(kIndices), "SoaVector fields must be nothrow move constructible");
+
+  void check(size_type i) const {
+    if (i >= size_) throw std::out_of_range("SoaVector::at: index out of range");
+  }
+
+  template <class Ref, std::size_t... I>
+  Ref make_ref(size_type i, std::index_sequence<I...>) const noexcept {
+    return Ref{std::get<I>(columns_)[i]...};
+  }
+
+  template <std::size_t... I>
+  value_type make_value(size_type i, std::index_sequence<I...>) const {
+    return value_type{std::get<I>(columns_)[i]...};
+  }
+
+  template <class Spans, std::size_t... I>
+  Spans make_spans(std::index_sequence<I...>) const noexcept {
+    return Spans{{std::get<I>(columns_), size_}...};
+  }
+
+  template <std::size_t... I>
+  void assign(size_type i, const value_type& value, std::index_sequence<I...>) {
+    const auto fields = detail::tie_fields<kFields>(value);
+    ((std::get<I>(columns_)[i] = std::get<I>(fields)), ...);
+  }
+
+  template <class Tuple, std::size_t... I>
+  static auto move_all(Tuple& fields, std::index_sequence<I...>) noexcept {
+    return std::forward_as_tuple(std::move(std::get<I>(fields))...);
+  }
+
+  template <std::size_t... I>
+  void move_element(size_type from, size_type to, std::index_sequence<I...>) noexcept {
+    ((std::get<I>(columns_)[to] = std::move(std::get<I>(columns_)[from])), ...);
+  }
+
+  // Constructs field by field; on an exception the fields already built are
+  // destroyed and size() is unchanged.
+  template <class Tuple, std::size_t... I>
+  void construct_at_end(Tuple&& args, std::index_sequence<I...>) {
+    std::size_t built = 0;
+    try {
+      ((::new (static_cast<void*>(std::get<I>(columns_) + size_))
+            field_type<I>(std::get<I>(std::forward<Tuple>(args))),
+        ++built),
+       ...);
+    } catch (...) {
+      ((I < built ? std::destroy_at(std::get<I>(columns_) + size_) : void()), ...);
+      throw;
+    }
+    ++size_;
+  }
+
+  void emplace_default() { construct_default(kIndices); }
+
+  template <std::size_t... I>
+  void construct_default(std::index_sequence<I...>) {
+    std::size_t built = 0;
+    try {
+      ((::new (static_cast<void*>(std::get<I>(columns_) + size_)) field_type<I>(), ++built), ...);
+    } catch (...) {
+      ((I < built ? std::destroy_at(std::get<I>(columns_) + size_) : void()), ...);
+      throw;
+    }
+    ++size_;
+  }
+
+  void destroy_range(size_type first, size_type last) noexcept { destroy_columns(first, last, kIndices); }
+
+  template <std::size_t... I>
+  void destroy_columns(size_type first, size_type last, std::index_sequence<I...>) noexcept {
+    (std::destroy(std::get<I>(columns_) + first, std::get<I>(columns_) + last), ...);
+  }
+
+  void grow_for_one() {
+    if (size_ == capacity_) reallocate(std::max<size_type>(capacity_ * 2, kAlignment));
+  }
+
+  // Allocates every new column before touching the old ones, so a failed
+  // allocation leaves the vector unchanged.
+  void reallocate(size_type new_capacity) {
+    Columns fresh{};
+    allocate_all(fresh, new_capacity, kIndices);
+    relocate_all(fresh, kIndices);
+    release(columns_, capacity_);
+    columns_ = fresh;
+    capacity_ = new_capacity;
+  }
+
+  template <std::size_t... I>
+  static void allocate_all(Columns& out, size_type capacity, std::index_sequence<I...>) {
+    if (capacity == 0) return;
+    try {
+      ((std::get<I>(out) = static_cast<field_type<I>*>(
+            ::operator new(capacity * sizeof(field_type<I>), std::align_val_t{column_alignment<I>()}))),
+       ...);
+    } catch (...) {
+      release(out, capacity);
+      throw;
+    }
+  }
+
+  template <std::size_t... I>
+  void relocate_all(Columns& to, std::index_sequence<I...>) noexcept {
+    ((std::uninitialized_move(std::get<I>(columns_), std::get<I>(columns_) + size_, std::get<I>(to)),
+      std::destroy(std::get<I>(columns_), std::get<I>(columns_) + size_)),
+     ...);
+  }
+
+  template <std::size_t I>
+  static constexpr std::size_t column_alignment() noexcept {
+    return std::max(kAlignment, alignof(field_type<I>));
+  }
+
+  static void release(Columns& columns, size_type capacity) noexcept { release_all(columns, capacity, kIndices); }
+
+  template <std::size_t... I>
+  static void release_all(Columns& columns, size_type capacity, std::index_sequence<I...>) noexcept {
+    (([&] {
+       if (auto*& p = std::get<I>(columns)) {
+         ::operator delete(p, capacity * sizeof(field_type<I>), std::align_val_t{column_alignment<I>()});
+         p = nullptr;
+       }
+     }()),
+     ...);
+  }
+
+  Columns columns_{};
+  size_type size_ = 0;
+  size_type capacity_ = 0;
+};
+
+}  // namespace tcc
@@ -0,0 +1,156 @@
+#pragma once
+
+// Bounded single-producer/single-consumer ring buffer.
+//
+// Exactly one thread may push and exactly one thread may pop. Elements live
+// inline in the ring, so pushing and popping never allocate and move-only
+// types are supported. Each side keeps a private copy of the other side's
+// index and only re-reads the shared one when the copy says the ring is
+// full (or empty), so in steady state the two cores do not ping-pong lines.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "tcc/platform.hpp"
+
+namespace tcc {
+
+template <class T, std::size_t N>
+class SpscRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+  static_assert(std::is_nothrow_move_constructible_v<T> || std::is_nothrow_copy_constructible_v<T>,
+                "SpscRing elements must be nothrow move- or copy-constructible");
+
+ public:
+  using value_type = T;
+
+  SpscRing() = default;
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  ~SpscRing() {
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    for (; head != tail; ++head) std::destroy_at(slot(head));
+  }
+
+  static constexpr std::size_t capacity() noexcept { return N; }
+
+  // --- Producer side --------------------------------------------------------
+
+  template <class... Args>
+  bool try_emplace(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_cache_ == N) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail - head_cache_ == N) return false;
+    }
+    ::new (static_cast<void*>(slot(tail))) T(std::forward<Args>(args)...);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_push(const T& value) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+    return try_emplace(value);
+  }
+  bool try_push(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    return try_emplace(std::move(value));
+  }
+
+  /// Moves up to `count` elements from `first` into the ring with a single
+  /// index publication. Returns how many were pushed.
+  template <class It>
+  std::size_t try_push_batch(It first, std::size_t count) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    std::size_t free = N - (tail - head_cache_);
+    if (free < count) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      free = N - (tail - head_cache_);
+    }
+    const std::size_t n = std::min(free, count);
+    for (std::size_t i = 0; i < n; ++i, ++first) {
+      ::new (static_cast<void*>(slot(tail + i))) T(std::move(*first));
+    }
+    if (n != 0) tail_.store(tail + n, std::memory_order_release);
+    return n;
+  }
+
+  // --- Consumer side --------------------------------------------------------
+
+  bool try_pop(T& out) noexcept(std::is_nothrow_move_assignable_v<T>) {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_cache_) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head == tail_cache_) return false;
+    }
+    T* p = slot(head);
+    out = std::move(*p);
+    std::destroy_at(p);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  std::optional<T> try_pop() {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_cache_) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head == tail_cache_) return std::nullopt;
+    }
+    T* p = slot(head);
+    std::optional<T> out(std::move(*p));
+    std::destroy_at(p);
+    head_.store(head + 1, std::memory_order_release);
+    return out;
+  }
+
+  /// Moves up to `max` elements into `out` with a single index publication.
+  /// Returns how many were popped.
+  template <class OutIt>
+  std::size_t try_pop_batch(OutIt out, std::size_t max) {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    std::size_t available = tail_cache_ - head;
+    if (available < max) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      available = tail_cache_ - head;
+    }
+    const std::size_t n = std::min(available, max);
+    for (std::size_t i = 0; i < n; ++i, ++out) {
+      T* p = slot(head + i);
+      *out = std::move(*p);
+      std::destroy_at(p);
+    }
+    if (n != 0) head_.store(head + n, std::memory_order_release);
+    return n;
+  }
+
+  // --- Either side ----------------------------------------------------------
+
+  /// Snapshot of the element count; exact only when both sides are idle.
+  std::size_t size_approx() const noexcept {
+    // Read head first: tail never falls behind a head observed earlier.
+    const std::size_t head = head_.load(std::memory_order_acquire);
+    return tail_.load(std::memory_order_acquire) - head;
+  }
+  bool empty_approx() const noexcept { return size_approx() == 0; }
+
+ private:
+  T* slot(std::size_t index) noexcept {
+    return std::launder(reinterpret_cast<T*>(storage_ + (index & (N - 1)) * sizeof(T)));
+  }
+
+  // Consumer-owned line: the read index and the consumer's view of tail.
+  alignas(kCacheLineSize) std::atomic<std::size_t> head_{0};
+  std::size_t tail_cache_ = 0;
+  // Producer-owned line: the write index and the producer's view of head.
+  alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0};
+  std::size_t head_cache_ = 0;
+  alignas(kCacheLineSize) alignas(T) std::byte storage_[N * sizeof(T)];
+};
+
+}  // namespace tcc
@@ -0,0 +1,99 @@
+#pragma once
+
+// Startup-time profiling.
+//
+//   $ TCC_STARTUP_PROFILE=1 ./test_cmake_cpp
+//   startup profile -> startup_trace.json
+//       0.612 ms  exec and dynamic loading
+//       0.004 ms  static constructors
+//       0.031 ms  simd: detect ISA
+//       ...
+//
+//   int main() {
+//     tcc::startup::main_entered();               // closes "static constructors"
+//     ...
+//     if (tcc::startup::enabled()) tcc::startup::write_trace("startup_trace.json");
+//   }
+//
+// With TCC_STARTUP_PROFILE=1 in the environment, the process records:
+//   - "exec and dynamic loading": the process CPU time spent before the
+//     library's first constructor ran. That covers execve, the dynamic
+//     linker's relocations and the constructors of the shared libraries
+//     loaded before this one. It is an estimate: it counts CPU time, not
+//     wall time, so page-fault waits on a cold cache do not show.
+//   - "static constructors": from that first constructor to main_entered().
+//   - one phase per library singleton initialized on first use (metrics
+//     registry, SIMD dispatch, global thread pool, NUMA topology), and any
+//     Phase of your own.
+// write_trace() emits them as complete events through tcc::trace, with
+// the trace clock starting at process start.
+//
+// Without the variable, a Phase is one load and a branch, and nothing else
+// runs at load time. Library singletons are built on first use, not by
+// static initializers, so a short-lived tool pays only for the components
+// it touches.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "tcc/export.hpp"
+
+namespace tcc::startup {
+
+namespace detail {
+
+TCC_API inline bool g_enabled = false;  // set once, before main()
+
+TCC_API void record(const char* name, std::int64_t begin_ns, std::int64_t end_ns) noexcept;
+
+inline std::int64_t now_ns() noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace detail
+
+/// True when the process started with TCC_STARTUP_PROFILE=1.
+inline bool enabled() noexcept { return detail::g_enabled; }
+
+/// Times the enclosing scope as a startup phase when profiling. `name`
+/// must have static storage duration. Phases past the first 64 are
+/// dropped.
+class Phase {
+ public:
+  explicit Phase(const char* name) noexcept : name_(name), begin_(enabled() ? detail::now_ns() : 0) {}
+  ~Phase() {
+    if (begin_ != 0) detail::record(name_, begin_, detail::now_ns());
+  }
+
+  Phase(const Phase&) = delete;
+  Phase& operator=(const Phase&) = delete;
+
+ private:
+  const char* name_;
+  std::int64_t begin_;
+};
+
+/// Call first thing in main(): ends the "static constructors" phase.
+TCC_API void main_entered() noexcept;
+
+struct PhaseTiming {
+  std::string name;
+  std::chrono::nanoseconds start{0};     // since the process started
+  std::chrono::nanoseconds duration{0};
+};
+
+/// Everything recorded so far, in start order. Empty when not profiling.
+TCC_API std::vector<PhaseTiming> phases();
+
+/// Writes phases() as a Chrome/Perfetto trace through tcc::trace. Throws
+/// std::logic_error if a trace is already being recorded, and whatever
+/// tcc::trace::start() throws. Writes nothing when TCC_TRACING is off.
+TCC_API void write_trace(const std::filesystem::path& path);
+
+}  // namespace tcc::startup
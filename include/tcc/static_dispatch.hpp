@@ -0,0 +1,216 @@
+#pragma once
+
+// Hoisting a runtime strategy choice out of per-record loops.
+//
+//   struct Scale : tcc::BatchPolicy<Scale> {
+//     float k;
+//     float apply(float x) const noexcept { return x * k; }
+//   };
+//   struct Clamp : tcc::BatchPolicy<Clamp> {
+//     float lo, hi;
+//     float apply(float x) const noexcept { return std::clamp(x, lo, hi); }
+//   };
+//
+//   using Op = tcc::StaticDispatch<Scale, Clamp>;
+//   Op op = config.clamp ? Op(Clamp{{}, 0.0f, 1.0f}) : Op(Scale{{}, config.gain});
+//   op.transform(std::span(in), std::span(out));  // one visit, then a plain loop
+//
+//   tcc::with_constant<1, 2, 4, 8>(stride, [&](auto s) { gather<s()>(...); });
+//   constexpr auto squares = tcc::make_table<256>([](std::size_t i) { return i * i; });
+//
+// A virtual call per element stops the compiler from inlining the element
+// operation, so the loop around it cannot be unrolled or vectorized. Here
+// the choice is made once per batch. std::visit on a variant of policy
+// types picks the concrete type, and the loop is a template instantiated
+// for each policy, with apply() inlined into it. BatchPolicy is the CRTP
+// base that supplies those loops: a policy only writes apply().
+//
+// with_constant does the same for integers and enums: it turns a runtime
+// value from a short list into a compile-time constant, e.g. a stride or
+// width the loop can unroll on. make_table evaluates a generator at
+// compile time into a std::array lookup table; crc32() below is built
+// this way.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace tcc {
+
+// --- Compile-time tables ------------------------------------------------------
+
+/// std::array {fn(0), fn(1), ..., fn(N - 1)}; constexpr when `fn` is.
+template <std::size_t N, class Fn>
+constexpr auto make_table(Fn fn) {
+  std::array<std::invoke_result_t<Fn&, std::size_t>, N> table{};
+  for (std::size_t i = 0; i < N; ++i) table[i] = fn(i);
+  return table;
+}
+
+namespace detail {
+
+// Reflected CRC-32 (IEEE 802.3, zlib, PNG). Table k advances the CRC by one
+// byte followed by k zero bytes, for slicing-by-8.
+inline constexpr auto kCrc32Tables = [] {
+  std::array<std::array<std::uint32_t, 256>, 8> t{};
+  t[0] = make_table<256>([](std::size_t i) {
+    auto c = static_cast<std::uint32_t>(i);
+    for (int bit = 0; bit < 8; ++bit) c = (c & 1) != 0 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+    return c;
+  });
+  for (std::size_t k = 1; k < 8; ++k) {
+    t[k] = make_table<256>([&](std::size_t i) { return (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xff]; });
+  }
+  return t;
+}();
+
+constexpr std::uint32_t load_le32(const std::byte* p) noexcept {
+  return static_cast<std::uint32_t>(p[0]) | static_cast<std::uint32_t>(p[1]) << 8 |
+         static_cast<std::uint32_t>(p[2]) << 16 | static_cast<std::uint32_t>(p[3]) << 24;
+}
+
+}  // namespace detail
+
+/// CRC-32 of `data`, continuing from `crc` (the result of the previous
+/// block), so crc32(b, crc32(a)) == crc32(a + b). Eight bytes per step.
+constexpr std::uint32_t crc32(std::span<const std::byte> data, std::uint32_t crc = 0) noexcept {
+  const auto& t = detail::kCrc32Tables;
+  crc = ~crc;
+  const std::byte* p = data.data();
+  std::size_t n = data.size();
+  for (; n >= 8; n -= 8, p += 8) {
+    const std::uint32_t lo = detail::load_le32(p) ^ crc;
+    const std::uint32_t hi = detail::load_le32(p + 4);
+    crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+          t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+  }
+  for (; n != 0; --n, ++p) crc = t[0][(crc ^ static_cast<std::uint32_t>(*p)) & 0xff] ^ (crc >> 8);
+  return ~crc;
+}
+
+// --- Runtime value to compile-time constant -----------------------------------
+
+namespace detail {
+
+template <auto V, auto... Rest, class Fn>
+decltype(auto) with_constant(decltype(V) value, Fn& fn) {
+  if (value == V) return fn(std::integral_constant<decltype(V), V>{});
+  if constexpr (sizeof...(Rest) == 0) {
+    throw std::invalid_argument("with_constant: value is not one of the listed constants");
+  } else {
+    return detail::with_constant<Rest...>(value, fn);
+  }
+}
+
+}  // namespace detail
+
+/// Calls `fn(std::integral_constant<T, V>{})` for the V among `Values`
+/// equal to `value`. Every instantiation of `fn` must return the same
+/// type. Throws std::invalid_argument when `value` is not listed.
+template <auto First, decltype(First)... Rest, class Fn>
+decltype(auto) with_constant(decltype(First) value, Fn&& fn) {
+  return detail::with_constant<First, Rest...>(value, fn);
+}
+
+/// Default-constructs alternative `index` of `Variant`, e.g. a policy
+/// picked by a number in a config file. Throws std::out_of_range.
+template <class Variant>
+Variant variant_from_index(std::size_t index) {
+  constexpr std::size_t kSize = std::variant_size_v<Variant>;
+  constexpr auto kMakers = []<std::size_t... I>(std::index_sequence<I...>) {
+    return std::array<Variant (*)(), kSize>{+[]() -> Variant { return Variant(std::in_place_index<I>); }...};
+  }(std::make_index_sequence<kSize>{});
+  if (index >= kSize) throw std::out_of_range("variant_from_index: no alternative " + std::to_string(index));
+  return kMakers[index]();
+}
+
+// --- Batch policies -----------------------------------------------------------
+
+/// CRTP base: Derived defines `apply(const In&) const`, returning the
+/// transformed element (or nothing, for visitors), and inherits the loops.
+/// The transforms run on a local copy of the policy: through a reference,
+/// every store to a float output might change a float parameter, and the
+/// compiler would reload it per element instead of vectorizing. Keep
+/// policies small and cheap to copy.
+template <class Derived>
+class BatchPolicy {
+ public:
+  /// out[i] = apply(in[i]) over the shorter of the two spans. `in` may be
+  /// a span of const or mutable elements (std::span(vector) is mutable);
+  /// it is only read.
+  template <class In, class Out>
+  void transform(std::span<In> in, std::span<Out> out) const {
+    const Derived self = derived();
+    const std::span<const In> src = in;
+    const std::size_t n = src.size() < out.size() ? src.size() : out.size();
+    for (std::size_t i = 0; i < n; ++i) out[i] = self.apply(src[i]);
+  }
+
+  /// x = apply(x) for every element.
+  template <class T>
+  void transform_in_place(std::span<T> data) const {
+    const Derived self = derived();
+    for (T& x : data) x = self.apply(x);
+  }
+
+  /// apply(x) for every element, discarding results.
+  template <class T>
+  void for_each(std::span<T> data) const {
+    const Derived& self = derived();
+    for (T& x : data) self.apply(x);
+  }
+
+ private:
+  const Derived& derived() const noexcept { return static_cast<const Derived&>(*this); }
+};
+
+/// A runtime choice among policy types, resolved once per batch.
+template <class... Policies>
+class StaticDispatch {
+ public:
+  using variant_type = std::variant<Policies...>;
+
+  // Implicit, so a policy value converts like it would to the variant.
+  StaticDispatch() = default;
+  StaticDispatch(variant_type policy) : policy_(std::move(policy)) {}
+  template <class P>
+    requires(std::is_same_v<std::remove_cvref_t<P>, Policies> || ...)
+  StaticDispatch(P&& policy) : policy_(std::forward<P>(policy)) {}
+
+  /// Default-constructed policy number `index` (see variant_from_index).
+  static StaticDispatch from_index(std::size_t index) { return variant_from_index<variant_type>(index); }
+
+  std::size_t index() const noexcept { return policy_.index(); }
+  const variant_type& policy() const noexcept { return policy_; }
+
+  /// Calls `fn(policy)` with the concrete policy type: put the loop inside
+  /// `fn` (a generic lambda) and it is instantiated per policy.
+  template <class Fn>
+  decltype(auto) visit(Fn&& fn) const {
+    return std::visit(std::forward<Fn>(fn), policy_);
+  }
+
+  template <class In, class Out>
+  void transform(std::span<In> in, std::span<Out> out) const {
+    visit([&](const auto& p) { p.transform(in, out); });
+  }
+  template <class T>
+  void transform_in_place(std::span<T> data) const {
+    visit([&](const auto& p) { p.transform_in_place(data); });
+  }
+  template <class T>
+  void for_each(std::span<T> data) const {
+    visit([&](const auto& p) { p.for_each(data); });
+  }
+
+ private:
+  variant_type policy_;
+};
+
+}  // namespace tcc
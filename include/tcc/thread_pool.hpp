@@ -0,0 +1,334 @@
+#pragma once
+
+// Work-stealing thread pool and fork-join loops built on it.
+//
+//   tcc::ThreadPool pool;                          // one worker per core
+//   tcc::parallel_for(pool, {0, n}, 4096, [&](tcc::IndexRange r) {
+//     for (std::size_t i = r.begin; i < r.end; ++i) out[i] = f(in[i]);
+//   });
+//   double total = tcc::parallel_reduce(pool, {0, n}, 4096, 0.0,
+//       [&](tcc::IndexRange r) { return sum(in + r.begin, in + r.end); },
+//       std::plus<>{});
+//
+// Each worker owns a Chase-Lev deque. New work from a worker goes to its own
+// deque (LIFO, cache-warm); idle workers steal the oldest work from a random
+// victim. Work submitted from outside the pool goes through a shared
+// injection queue. Workers that find nothing spin briefly and then park on a
+// futex, so an idle pool costs no CPU.
+//
+// parallel_for/parallel_reduce split the range in halves down to `grain`
+// indices and join with help-while-waiting, so nested parallel loops do not
+// deadlock or oversubscribe. The split tree depends only on the range and
+// grain, which makes parallel_reduce deterministic for a given input.
+//
+// On NUMA machines, ThreadPoolOptions::affinity pins workers to the CPUs of
+// one node each (Affinity::node) or to a single CPU (Affinity::core),
+// spreading them evenly over the nodes. A pinned worker that runs dry
+// steals from workers on its own node before crossing to another one, so
+// work (and the memory it touches) stays on its socket while there is any
+// local work left.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tcc/export.hpp"
+#include "tcc/numa.hpp"
+#include "tcc/platform.hpp"
+#include "tcc/work_stealing_deque.hpp"
+
+namespace tcc {
+
+/// Unit of work scheduled on a ThreadPool. Whoever submits a Job keeps it
+/// alive until execute() has returned.
+class TCC_API Job {
+ public:
+  virtual void execute() = 0;
+
+ protected:
+  ~Job() = default;
+};
+
+/// Half-open index interval [begin, end).
+struct IndexRange {
+  std::size_t begin = 0;
+  std::size_t end = 0;
+
+  std::size_t size() const noexcept { return end > begin ? end - begin : 0; }
+};
+
+/// Where ThreadPool workers may run.
+enum class Affinity {
+  none,  // wherever the OS schedules them
+  node,  // each worker pinned to all CPUs of one NUMA node
+  core,  // each worker pinned to one CPU
+};
+
+struct ThreadPoolOptions {
+  /// Worker count; 0 means one per core (per usable CPU of `topology` when
+  /// pinned).
+  std::size_t threads = 0;
+  Affinity affinity = Affinity::none;
+  /// Nodes and CPUs to place pinned workers on; nullptr means
+  /// numa::topology(). Pass a subset to confine the pool to some sockets.
+  const numa::Topology* topology = nullptr;
+};
+
+class TCC_API ThreadPool {
+ public:
+  /// Starts `threads` workers; 0 means std::thread::hardware_concurrency().
+  explicit ThreadPool(std::size_t threads = 0);
+  explicit ThreadPool(const ThreadPoolOptions& options);
+  /// Runs every job already submitted, then joins the workers.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  std::size_t size() const noexcept { return workers_.size(); }
+
+  /// Schedules `job`. From a worker of this pool the job goes to that
+  /// worker's deque; from anywhere else it goes to the injection queue.
+  void submit(Job& job);
+
+  /// Fire-and-forget: runs `fn()` on some worker. An exception escaping
+  /// `fn` terminates the process.
+  template <class Fn>
+  void post(Fn&& fn) {
+    submit(*new FunctionJob<std::decay_t<Fn>>(std::forward<Fn>(fn)));
+  }
+
+  /// Returns once `done` is true. A worker of this pool keeps executing
+  /// queued tasks meanwhile; any other thread blocks, and whoever sets
+  /// `done` for it must call notify_waiters() afterwards.
+  void wait(const std::atomic<bool>& done);
+
+  /// Wakes threads blocked in wait(). Touches only pool state, so it is safe
+  /// to call after the flag's owner may already have been destroyed.
+  void notify_waiters() noexcept;
+
+  /// Index of the calling worker in [0, size()), or -1 when the caller is
+  /// not a worker of this pool.
+  int current_worker() const noexcept;
+
+  /// NUMA node worker `index` is pinned to, or -1 for Affinity::none.
+  int worker_node(std::size_t index) const noexcept { return workers_[index]->node; }
+
+  /// Process-wide pool, created on first use with one worker per core.
+  static ThreadPool& global();
+
+ private:
+  template <class Fn>
+  class FunctionJob final : public Job {
+   public:
+    explicit FunctionJob(Fn fn) : fn_(std::move(fn)) {}
+    void execute() override {
+      std::unique_ptr<FunctionJob> self(this);
+      fn_();
+    }
+
+   private:
+    Fn fn_;
+  };
+
+  struct alignas(kCacheLineSize) Worker {
+    ChaseLevDeque<Job*> deque;
+    std::uint64_t rng;
+    int node = -1;
+    std::vector<int> cpus;              // pinned set; empty when unpinned
+    std::vector<Worker*> local_peers;   // other workers on `node`, when the pool spans nodes
+    std::thread thread;
+  };
+
+  void place_workers(Affinity affinity, const numa::Topology& topo);
+
+  void worker_loop(std::size_t index);
+  Job* find_job(Worker* self);
+  Job* steal_from_others(Worker* self);
+  Job* pop_injected();
+  void notify_work();
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  std::mutex inject_mutex_;
+  std::deque<Job*> injected_;
+  std::atomic<std::size_t> injected_count_{0};
+
+  // Parking: sleepers bump sleeping_, re-check for work and wait on epoch_.
+  // Submitters bump epoch_ and notify only when someone is asleep.
+  alignas(kCacheLineSize) std::atomic<std::uint32_t> epoch_{0};
+  std::atomic<std::uint32_t> sleeping_{0};
+  std::atomic<bool> stopping_{false};
+
+  // Bumped by notify_waiters(); non-worker threads in wait() block on it.
+  alignas(kCacheLineSize) std::atomic<std::uint32_t> completions_{0};
+};
+
+namespace detail {
+
+/// Shared state of one parallel_for/parallel_reduce call.
+template <class Body>
+struct ForkJoin {
+  ForkJoin(ThreadPool& p, std::size_t g, Body& b) : pool(p), grain(g), body(b) {}
+
+  ThreadPool& pool;
+  std::size_t grain;
+  Body& body;
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  void record(std::exception_ptr e) {
+    std::lock_guard lock(error_mutex);
+    if (!error) error = std::move(e);
+    failed.store(true, std::memory_order_relaxed);
+  }
+};
+
+/// Splits [range] in halves, hands the right half to the pool, recurses on
+/// the left, then joins. Returns the reduction of the whole range.
+template <class Result, class Body>
+Result fork_join(ForkJoin<Body>& ctx, IndexRange range);
+
+template <class Result, class Body>
+class SplitJob final : public Job {
+ public:
+  SplitJob(ForkJoin<Body>& ctx, IndexRange range, bool external_waiter = false)
+      : ctx_(ctx), range_(range), external_waiter_(external_waiter) {}
+
+  void execute() override {
+    try {
+      result_.emplace(fork_join<Result>(ctx_, range_));
+    } catch (...) {
+      ctx_.record(std::current_exception());
+    }
+    // The joining thread may destroy *this as soon as done_ flips, so read
+    // everything needed first.
+    ThreadPool& pool = ctx_.pool;
+    const bool notify = external_waiter_;
+    done_.store(true, std::memory_order_release);
+    if (notify) pool.notify_waiters();
+  }
+
+  std::atomic<bool>& done() noexcept { return done_; }
+  std::optional<Result>& result() noexcept { return result_; }
+
+ private:
+  ForkJoin<Body>& ctx_;
+  IndexRange range_;
+  bool external_waiter_;
+  std::optional<Result> result_;
+  std::atomic<bool> done_{false};
+};
+
+template <class Result, class Body>
+Result fork_join(ForkJoin<Body>& ctx, IndexRange range) {
+  if (range.size() <= ctx.grain) {
+    if (ctx.failed.load(std::memory_order_relaxed)) return Result{};
+    return ctx.body.leaf(range);
+  }
+  const std::size_t mid = range.begin + range.size() / 2;
+  if (ctx.pool.size() <= 1) {
+    // Same split tree as the parallel path, so reductions agree bit-for-bit.
+    Result left = fork_join<Result>(ctx, {range.begin, mid});
+    return ctx.body.combine(std::move(left), fork_join<Result>(ctx, {mid, range.end}));
+  }
+  SplitJob<Result, Body> right(ctx, {mid, range.end});
+  ctx.pool.submit(right);
+  std::optional<Result> left;
+  try {
+    left.emplace(fork_join<Result>(ctx, {range.begin, mid}));
+  } catch (...) {
+    // `right` lives in this frame: it must finish before we unwind.
+    ctx.pool.wait(right.done());
+    throw;
+  }
+  ctx.pool.wait(right.done());
+  if (!right.result()) return Result{};
+  return ctx.body.combine(std::move(*left), std::move(*right.result()));
+}
+
+template <class Body>
+typename Body::result_type run_root(ThreadPool& pool, IndexRange range, std::size_t grain, Body body) {
+  using Result = typename Body::result_type;
+  ForkJoin<Body> ctx{pool, grain == 0 ? 1 : grain, body};
+  if (pool.current_worker() >= 0 || pool.size() <= 1) {
+    Result result = fork_join<Result>(ctx, range);
+    if (ctx.error) std::rethrow_exception(ctx.error);
+    return result;
+  }
+  // Called from outside the pool: hand the whole tree to the workers and
+  // block until it is done.
+  SplitJob<Result, Body> root(ctx, range, /*external_waiter=*/true);
+  pool.submit(root);
+  pool.wait(root.done());
+  if (ctx.error) std::rethrow_exception(ctx.error);
+  return std::move(*root.result());
+}
+
+struct Unit {};
+
+template <class Fn>
+struct ForBody {
+  using result_type = Unit;
+  Fn& fn;
+  Unit leaf(IndexRange r) {
+    fn(r);
+    return {};
+  }
+  Unit combine(Unit, Unit) { return {}; }
+};
+
+template <class T, class Map, class Reduce>
+struct ReduceBody {
+  using result_type = T;
+  Map& map;
+  Reduce& reduce;
+  T leaf(IndexRange r) { return map(r); }
+  T combine(T a, T b) { return reduce(std::move(a), std::move(b)); }
+};
+
+}  // namespace detail
+
+/// Calls `fn(IndexRange)` on disjoint sub-ranges covering `range`, each at
+/// most `grain` long, in parallel on `pool`. Rethrows the first exception
+/// thrown by `fn` after all started chunks have finished.
+template <class Fn>
+void parallel_for(ThreadPool& pool, IndexRange range, std::size_t grain, Fn&& fn) {
+  if (range.size() == 0) return;
+  detail::run_root(pool, range, grain, detail::ForBody<std::remove_reference_t<Fn>>{fn});
+}
+
+template <class Fn>
+void parallel_for(IndexRange range, std::size_t grain, Fn&& fn) {
+  parallel_for(ThreadPool::global(), range, grain, std::forward<Fn>(fn));
+}
+
+/// Maps every chunk with `map(IndexRange) -> T` and folds the results with
+/// `reduce(T, T) -> T` in index order; an empty range yields `identity`.
+/// T must be default-constructible.
+template <class T, class Map, class Reduce>
+T parallel_reduce(ThreadPool& pool, IndexRange range, std::size_t grain, T identity, Map&& map,
+                  Reduce&& reduce) {
+  if (range.size() == 0) return identity;
+  using Body = detail::ReduceBody<T, std::remove_reference_t<Map>, std::remove_reference_t<Reduce>>;
+  T result = detail::run_root(pool, range, grain, Body{map, reduce});
+  return reduce(std::move(identity), std::move(result));
+}
+
+template <class T, class Map, class Reduce>
+T parallel_reduce(IndexRange range, std::size_t grain, T identity, Map&& map, Reduce&& reduce) {
+  return parallel_reduce(ThreadPool::global(), range, grain, std::move(identity), std::forward<Map>(map),
+                         std::forward<Reduce>(reduce));
+}
+
+}  // namespace tcc
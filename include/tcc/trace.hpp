@@ -0,0 +1,200 @@
+#pragma once
+
+// Hot-path tracing to Chrome/Perfetto trace JSON.
+//
+//   tcc::trace::start({.path = "trace.json"});   // begins recording
+//   void handle(Request& r) {
+//     TCC_TRACE_SCOPE("handle");                 // one complete ("X") event
+//     TCC_TRACE_COUNTER("queue_depth", depth);   // counter ("C") track
+//     ...
+//   }
+//   tcc::trace::stop();                          // drains and closes the file
+//
+// Open trace.json in ui.perfetto.dev or chrome://tracing.
+//
+// Each thread records into its own single-producer ring of fixed-size
+// events; a scope costs two cycle-counter reads (rdtsc, cntvct) and one
+// 32-byte store, with no locks and no allocation. A background thread
+// drains every ring each `flush_interval` and appends JSON to the file,
+// converting ticks to microseconds with a rate calibrated at start(). A
+// full ring drops new events (dropped_events() counts them) rather than
+// stall the caller. When tracing is not started, a scope is one relaxed
+// load and a branch.
+//
+// Names must have static storage duration (string literals): only the
+// pointer is recorded.
+//
+// Configuring with -DTCC_TRACING=OFF defines TCC_TRACING to 0: the macros
+// expand to nothing, the functions below become empty inlines, and the
+// recorder is not built.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+#include "tcc/export.hpp"
+
+#if !defined(TCC_TRACING)
+#define TCC_TRACING 1
+#endif
+
+#if TCC_TRACING
+#include <atomic>
+#include <bit>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace tcc::trace {
+
+struct Options {
+  std::filesystem::path path = "trace.json";
+  /// How often the background thread drains the per-thread rings.
+  std::chrono::milliseconds flush_interval{100};
+  /// Ring capacity per thread, in 32-byte events (rounded up to a power
+  /// of two). Fixed when a thread first records.
+  std::size_t buffer_events = std::size_t{1} << 16;
+  /// The instant shown as time 0; the default is the start() call. Set it
+  /// earlier to place events passed to complete() that predate start().
+  std::chrono::steady_clock::time_point origin{};
+};
+
+#if TCC_TRACING
+
+namespace detail {
+
+enum class Kind : std::uint32_t { complete, instant, counter };
+
+struct Event {
+  std::uint64_t begin;  // ticks
+  std::uint64_t value;  // end ticks (complete) or counter value (bit pattern of a double)
+  const char* name;
+  Kind kind;
+  std::uint32_t reserved;
+};
+
+/// One thread's ring. Only the owning thread writes `head`; only the
+/// flusher writes `tail`.
+struct ThreadBuffer {
+  Event* events;
+  std::uint64_t mask;
+  std::uint64_t tail_cache = 0;  // writer's last view of tail
+  alignas(64) std::atomic<std::uint64_t> head{0};
+  alignas(64) std::atomic<std::uint64_t> tail{0};
+  std::atomic<std::uint64_t> dropped{0};
+};
+
+TCC_API inline std::atomic<bool> g_enabled{false};
+TCC_API inline thread_local ThreadBuffer* tls_buffer = nullptr;
+
+/// Registers the calling thread's ring; nullptr once the thread is exiting.
+TCC_API ThreadBuffer* register_thread();
+
+inline std::uint64_t ticks() noexcept {
+#if defined(__x86_64__) || defined(__i386__) || defined(_MSC_VER)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  std::uint64_t v;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(v));
+  return v;
+#else
+  return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+inline void record(const Event& e) noexcept {
+  ThreadBuffer* b = tls_buffer;
+  if (b == nullptr && (b = register_thread()) == nullptr) return;
+  const std::uint64_t head = b->head.load(std::memory_order_relaxed);
+  if (head - b->tail_cache > b->mask) {
+    b->tail_cache = b->tail.load(std::memory_order_acquire);
+    if (head - b->tail_cache > b->mask) {
+      b->dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  }
+  b->events[head & b->mask] = e;
+  b->head.store(head + 1, std::memory_order_release);
+}
+
+}  // namespace detail
+
+/// Opens `options.path` and starts recording. Throws std::system_error if
+/// the file cannot be created, std::logic_error if already started.
+TCC_API void start(const Options& options = {});
+
+/// Stops recording, writes out every buffered event and closes the file.
+/// No-op when not started.
+TCC_API void stop();
+
+/// Drains all rings to the file now (the background thread does this
+/// periodically).
+TCC_API void flush();
+
+inline bool enabled() noexcept { return detail::g_enabled.load(std::memory_order_relaxed); }
+
+/// Names the calling thread's track in the trace viewer.
+TCC_API void set_thread_name(std::string_view name);
+
+/// Events lost to full rings since start().
+TCC_API std::uint64_t dropped_events() noexcept;
+
+/// RAII complete event from construction to destruction.
+class Scope {
+ public:
+  explicit Scope(const char* name) noexcept : name_(name), begin_(enabled() ? detail::ticks() : 0) {}
+  ~Scope() {
+    if (begin_ != 0) detail::record({begin_, detail::ticks(), name_, detail::Kind::complete, 0});
+  }
+
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+ private:
+  const char* name_;
+  std::uint64_t begin_;
+};
+
+/// Records a complete event measured elsewhere, e.g. before start().
+/// Ignored when not started.
+TCC_API void complete(const char* name, std::chrono::steady_clock::time_point begin,
+                      std::chrono::steady_clock::time_point end) noexcept;
+
+inline void instant(const char* name) noexcept {
+  if (enabled()) detail::record({detail::ticks(), 0, name, detail::Kind::instant, 0});
+}
+
+inline void counter(const char* name, double value) noexcept {
+  if (enabled()) {
+    detail::record({detail::ticks(), std::bit_cast<std::uint64_t>(value), name, detail::Kind::counter, 0});
+  }
+}
+
+#define TCC_TRACE_CONCAT_(a, b) a##b
+#define TCC_TRACE_CONCAT(a, b) TCC_TRACE_CONCAT_(a, b)
+#define TCC_TRACE_SCOPE(name) ::tcc::trace::Scope TCC_TRACE_CONCAT(tcc_trace_scope_, __LINE__)(name)
+#define TCC_TRACE_INSTANT(name) ::tcc::trace::instant(name)
+#define TCC_TRACE_COUNTER(name, value) ::tcc::trace::counter(name, static_cast<double>(value))
+
+#else  // !TCC_TRACING
+
+inline void start(const Options& = {}) {}
+inline void stop() {}
+inline void flush() {}
+constexpr bool enabled() noexcept { return false; }
+inline void set_thread_name(std::string_view) {}
+inline void complete(const char*, std::chrono::steady_clock::time_point, std::chrono::steady_clock::time_point) noexcept {}
+constexpr std::uint64_t dropped_events() noexcept { return 0; }
+
+#define TCC_TRACE_SCOPE(name) static_cast<void>(0)
+#define TCC_TRACE_INSTANT(name) static_cast<void>(0)
+#define TCC_TRACE_COUNTER(name, value) static_cast<void>(0)
+
+#endif  // TCC_TRACING
+
+}  // namespace tcc::trace
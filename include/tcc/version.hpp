@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string_view>
+
+#include "tcc/export.hpp"
+
+namespace tcc {
+
+/// Semantic version of the library, e.g. "0.1.0".
+TCC_API std::string_view version() noexcept;
+
+/// Short description of how the library was compiled: compiler and whether
+/// assertions are enabled.
+TCC_API std::string_view build_info() noexcept;
+
+}  // namespace tcc
@@ -0,0 +1,618 @@
+#pragma once
+
+// Zero-copy binary messages read in place, without a parse step.
+//
+//   namespace w = tcc::wire;
+//   using Fill = w::Schema<w::Field<"qty", std::int32_t>, w::Field<"price", double>>;
+//   using Order = w::Schema<w::Field<"id", std::uint64_t>,
+//                           w::Field<"symbol", w::String>,
+//                           w::Field<"levels", w::Vector<float>>,
+//                           w::Field<"fills", w::Vector<w::Table<Fill>>>>;
+//
+//   w::Builder b;
+//   auto sym = b.add_string("AAPL");                 // children first,
+//   auto lv = b.add_vector<float>(levels);
+//   auto f0 = b.add_table<Fill>(100, 187.25);        // positional, one per field
+//   auto fills = b.add_vector<Fill>({f0});
+//   b.finish(b.add_table<Order>(42, sym, lv, fills)); // then the parent
+//
+//   w::View<Order> order = w::root<Order>(file.bytes());  // verified, not parsed
+//   std::string_view s = order.get<"symbol">();          // points into the buffer
+//   std::span<const float> l = order.get<"levels">().span();
+//
+// Format (all integers little-endian, all offsets absolute u32 from the
+// start of the buffer):
+//
+//   header   u32 magic "TCW1" | u32 root table | u32 total size | u32 reserved
+//   table    u32 inline size, then the fields at offsets fixed by the schema:
+//              scalars      stored inline, naturally aligned (no bool:
+//                           store flags as std::uint8_t)
+//              String       u32 offset, u32 length (bytes, then a NUL)
+//              Vector<T>    u32 offset, u32 count (elements aligned to T)
+//              Table<S>     u32 offset (0: absent)
+//
+// Every object is written before the table that refers to it, so child
+// offsets are always below their parent's offset; the verifier relies on
+// that to reject cycles. A field whose inline slot lies beyond a table's
+// inline size reads as its default (0, empty, absent), so schemas may grow
+// by appending fields without breaking old readers or old data.
+//
+// root() checks the header and walks every reachable offset once (bounds,
+// alignment, NUL terminators): cost proportional to the number of objects,
+// not bytes. A table shared by many references is checked once, so any
+// message a Builder writes verifies; the only allocation is a bitmap of
+// one bit per 8 message bytes. Use root_unchecked() for buffers this
+// process wrote itself. Spans of multi-byte scalars need the buffer 8-byte
+// aligned (MappedFile and Builder buffers are) and a little-endian host.
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tcc/export.hpp"
+
+namespace tcc::wire {
+
+/// Bad magic, truncated buffer, out-of-bounds offset, and the like.
+class TCC_API Error : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+// --- Schema descriptors -----------------------------------------------------------
+
+/// String literal usable as a template argument: Field<"price", double>.
+template <std::size_t N>
+struct FixedString {
+  char chars[N] = {};
+
+  constexpr FixedString(const char (&s)[N]) noexcept {
+    for (std::size_t i = 0; i < N; ++i) chars[i] = s[i];
+  }
+  constexpr std::string_view view() const noexcept { return {chars, N - 1}; }
+};
+
+struct String {};
+template <class T>
+struct Vector {
+  using element = T;
+};
+template <class S>
+struct Table {
+  using schema = S;
+};
+
+template <FixedString Name, class T>
+struct Field {
+  static constexpr std::string_view name = Name.view();
+  using type = T;
+};
+
+/// A table type. May be used as a base (`struct Node : Schema<...> {}`) so
+/// a schema can refer to itself through Table<Node>.
+template <class... Fields>
+struct Schema {
+  using fields = std::tuple<Fields...>;
+};
+
+namespace detail {
+
+// Not bool: any byte but 0 and 1 loaded from an untrusted buffer would be
+// an invalid bool, and the verifier does not look at scalars.
+template <class T>
+concept Scalar = (std::is_arithmetic_v<T> || std::is_enum_v<T>) && !std::is_same_v<std::remove_cv_t<T>, bool> &&
+                 sizeof(T) <= 8;
+
+inline constexpr std::uint32_t kMagic = 0x31574354;  // "TCW1"
+inline constexpr std::size_t kHeaderSize = 16;
+inline constexpr std::size_t kTableAlign = 8;
+inline constexpr std::size_t kMaxDepth = 64;
+
+/// Inline slot of one field type.
+template <class T>
+struct Slot;
+
+template <Scalar T>
+struct Slot<T> {
+  static constexpr std::size_t size = sizeof(T);
+  static constexpr std::size_t align = sizeof(T);
+};
+template <>
+struct Slot<String> {
+  static constexpr std::size_t size = 8;
+  static constexpr std::size_t align = 4;
+};
+template <class T>
+struct Slot<Vector<T>> {
+  static constexpr std::size_t size = 8;
+  static constexpr std::size_t align = 4;
+};
+template <class S>
+struct Slot<Table<S>> {
+  static constexpr std::size_t size = 4;
+  static constexpr std::size_t align = 4;
+};
+
+constexpr std::size_t align_up(std::size_t n, std::size_t a) noexcept { return (n + a - 1) / a * a; }
+
+template <class S>
+struct Layout;
+
+template <class... Fs>
+struct Layout<std::tuple<Fs...>> {
+  static constexpr std::size_t kCount = sizeof...(Fs);
+
+  static constexpr std::array<std::size_t, kCount> offsets = [] {
+    std::array<std::size_t, kCount> out{};
+    constexpr std::size_t sizes[] = {Slot<typename Fs::type>::size...};
+    constexpr std::size_t aligns[] = {Slot<typename Fs::type>::align...};
+    std::size_t cursor = 4;  // after the inline-size word
+    for (std::size_t i = 0; i < kCount; ++i) {
+      cursor = align_up(cursor, aligns[i]);
+      out[i] = cursor;
+      cursor += sizes[i];
+    }
+    return out;
+  }();
+
+  static constexpr std::size_t inline_size = [] {
+    std::size_t end = 4;
+    constexpr std::size_t sizes[] = {Slot<typename Fs::type>::size...};
+    for (std::size_t i = 0; i < kCount; ++i) end = offsets[i] + sizes[i];
+    return align_up(end, 4);
+  }();
+
+  static constexpr std::array<std::string_view, kCount> names = {Fs::name...};
+
+  template <FixedString Name>
+  static constexpr std::size_t index_of() {
+    for (std::size_t i = 0; i < kCount; ++i) {
+      if (names[i] == Name.view()) return i;
+    }
+    return kCount;
+  }
+};
+
+template <class S>
+using LayoutOf = Layout<typename S::fields>;
+
+template <class S, std::size_t I>
+using FieldType = typename std::tuple_element_t<I, typename S::fields>::type;
+
+// Little-endian scalar access without alignment requirements.
+template <class U>
+constexpr U byteswap(U v) noexcept {
+  if constexpr (sizeof(U) == 1) {
+    return v;
+  } else {
+    U out = 0;
+    for (std::size_t i = 0; i < sizeof(U); ++i) out = static_cast<U>((out << 8) | ((v >> (8 * i)) & 0xff));
+    return out;
+  }
+}
+
+template <std::size_t N>
+using UintOf = std::conditional_t<
+    N == 1, std::uint8_t,
+    std::conditional_t<N == 2, std::uint16_t, std::conditional_t<N == 4, std::uint32_t, std::uint64_t>>>;
+
+template <Scalar T>
+T load(const std::byte* p) noexcept {
+  using U = UintOf<sizeof(T)>;
+  U bits;
+  std::memcpy(&bits, p, sizeof bits);
+  if constexpr (std::endian::native == std::endian::big) bits = byteswap(bits);
+  T value;
+  std::memcpy(&value, &bits, sizeof value);
+  return value;
+}
+
+template <Scalar T>
+void store(std::byte* p, T value) noexcept {
+  using U = UintOf<sizeof(T)>;
+  U bits;
+  std::memcpy(&bits, &value, sizeof bits);
+  if constexpr (std::endian::native == std::endian::big) bits = byteswap(bits);
+  std::memcpy(p, &bits, sizeof bits);
+}
+
+}  // namespace detail
+
+// --- Reading ----------------------------------------------------------------------
+
+template <class S>
+class View;
+
+/// Read-only sequence stored in the buffer; elements are decoded on access.
+template <class T>
+class VectorView {
+ public:
+  using value_type = T;
+
+  VectorView() noexcept = default;
+  VectorView(const std::byte* data, std::uint32_t count) noexcept : data_(data), count_(count) {}
+
+  std::size_t size() const noexcept { return count_; }
+  bool empty() const noexcept { return count_ == 0; }
+  T operator[](std::size_t i) const noexcept { return detail::load<T>(data_ + i * sizeof(T)); }
+
+  /// The elements in place, without copying. Little-endian hosts only.
+  std::span<const T> span() const noexcept
+    requires(std::endian::native == std::endian::little)
+  {
+    return {reinterpret_cast<const T*>(data_), count_};
+  }
+
+  class iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() noexcept = default;
+    explicit iterator(const std::byte* p) noexcept : p_(p) {}
+    T operator*() const noexcept { return detail::load<T>(p_); }
+    iterator& operator++() noexcept {
+      p_ += sizeof(T);
+      return *this;
+    }
+    iterator operator++(int) noexcept {
+      iterator old = *this;
+      ++*this;
+      return old;
+    }
+    bool operator==(const iterator&) const noexcept = default;
+
+   private:
+    const std::byte* p_ = nullptr;
+  };
+
+  iterator begin() const noexcept { return iterator(data_); }
+  iterator end() const noexcept { return iterator(data_ + std::size_t{count_} * sizeof(T)); }
+
+ private:
+  const std::byte* data_ = nullptr;
+  std::uint32_t count_ = 0;
+};
+
+/// Sequence of nested tables.
+template <class S>
+class TableVectorView {
+ public:
+  TableVectorView() noexcept = default;
+  TableVectorView(const std::byte* base, std::uint32_t offset, std::uint32_t count) noexcept
+      : base_(base), offset_(offset), count_(count) {}
+
+  std::size_t size() const noexcept { return count_; }
+  bool empty() const noexcept { return count_ == 0; }
+  View<S> operator[](std::size_t i) const noexcept {
+    return View<S>(base_, detail::load<std::uint32_t>(base_ + offset_ + 4 * i));
+  }
+
+ private:
+  const std::byte* base_ = nullptr;
+  std::uint32_t offset_ = 0;
+  std::uint32_t count_ = 0;
+};
+
+/// Accessor for one table. Cheap to copy (a pointer and two integers). A
+/// default-constructed or absent view reads every field as its default.
+template <class S>
+class View {
+  using Layout = detail::LayoutOf<S>;
+
+ public:
+  View() noexcept = default;
+  View(const std::byte* base, std::uint32_t offset) noexcept
+      : base_(base), offset_(offset), inline_size_(offset ? detail::load<std::uint32_t>(base + offset) : 0) {}
+
+  /// False for an absent nested table.
+  explicit operator bool() const noexcept { return inline_size_ != 0; }
+
+  /// Whether field I is stored (false for data written with an older,
+  /// shorter schema).
+  template <std::size_t I>
+  bool has() const noexcept {
+    return Layout::offsets[I] + detail::Slot<detail::FieldType<S, I>>::size <= inline_size_;
+  }
+
+  template <std::size_t I>
+  auto get() const noexcept {
+    using T = detail::FieldType<S, I>;
+    const bool present = has<I>();
+    const std::byte* slot = base_ + offset_ + Layout::offsets[I];
+    if constexpr (detail::Scalar<T>) {
+      return present ? detail::load<T>(slot) : T{};
+    } else if constexpr (std::is_same_v<T, String>) {
+      if (!present) return std::string_view();
+      const auto off = detail::load<std::uint32_t>(slot);
+      const auto len = detail::load<std::uint32_t>(slot + 4);
+      return std::string_view(reinterpret_cast<const char*>(base_ + off), len);
+    } else if constexpr (requires { typename T::element; }) {
+      using Elem = typename T::element;
+      const std::uint32_t off = present ? detail::load<std::uint32_t>(slot) : 0;
+      const std::uint32_t count = present ? detail::load<std::uint32_t>(slot + 4) : 0;
+      if constexpr (requires { typename Elem::schema; }) {
+        return TableVectorView<typename Elem::schema>(base_, off, count);
+      } else {
+        return VectorView<Elem>(base_ + off, count);
+      }
+    } else {
+      using Child = typename T::schema;
+      return present ? View<Child>(base_, detail::load<std::uint32_t>(slot)) : View<Child>();
+    }
+  }
+
+  /// Field by name: `view.get<"price">()`.
+  template <FixedString Name>
+  auto get() const noexcept {
+    constexpr std::size_t i = Layout::template index_of<Name>();
+    static_assert(i < Layout::kCount, "no field with this name in the schema");
+    return get<i>();
+  }
+
+  std::uint32_t offset() const noexcept { return offset_; }
+
+ private:
+  const std::byte* base_ = nullptr;
+  std::uint32_t offset_ = 0;
+  std::uint32_t inline_size_ = 0;
+};
+
+namespace detail {
+
+/// Header checks shared by all schemas; returns the root table offset and
+/// stores the message size in `size`.
+TCC_API std::uint32_t check_header(std::span<const std::byte> buffer, std::uint32_t& size);
+
+[[noreturn]] TCC_API void fail(const char* what);
+
+/// Identifies a schema in Verifier::seen.
+template <class S>
+inline constexpr char kSchemaTag = 0;
+
+/// Walk state. Each table's fields are checked once per schema it is read
+/// as, however many references share it, so fan-out cannot make
+/// verification exponential. `seen` holds a bitmap per schema met so far,
+/// one bit per 8-byte table offset.
+struct Verifier {
+  const std::byte* base;
+  std::uint32_t size;
+  std::vector<std::pair<const void*, std::vector<std::uint64_t>>> seen;
+
+  /// Marks the table at `offset` as checked for `schema`; false when it
+  /// already was.
+  bool first_visit(const void* schema, std::uint32_t offset) {
+    auto it = std::find_if(seen.begin(), seen.end(), [&](const auto& s) { return s.first == schema; });
+    if (it == seen.end()) {
+      it = seen.insert(seen.end(), {schema, std::vector<std::uint64_t>(size / kTableAlign / 64 + 1)});
+    }
+    const std::uint32_t slot = offset / kTableAlign;
+    std::uint64_t& word = it->second[slot / 64];
+    const std::uint64_t bit = std::uint64_t{1} << (slot % 64);
+    if ((word & bit) != 0) return false;
+    word |= bit;
+    return true;
+  }
+};
+
+/// Objects live in [kHeaderSize, limit): `limit` is the offset of the
+/// table or vector that refers to them.
+inline void check_range(std::uint64_t offset, std::uint64_t bytes, std::uint64_t limit, const char* what) {
+  if (offset < kHeaderSize || offset + bytes > limit) fail(what);
+}
+
+template <class S>
+void verify_table(Verifier& v, std::uint32_t offset, std::uint32_t limit, std::size_t depth);
+
+template <Scalar T>
+void verify_slot(Verifier&, const std::byte*, std::uint32_t, std::size_t, T*) {}
+
+inline void verify_slot(Verifier& v, const std::byte* slot, std::uint32_t limit, std::size_t, String*) {
+  const auto off = load<std::uint32_t>(slot);
+  const auto len = load<std::uint32_t>(slot + 4);
+  if (off == 0 && len == 0) return;
+  check_range(off, std::uint64_t{len} + 1, limit, "string out of bounds");
+  if (v.base[off + len] != std::byte{0}) fail("string not terminated");
+}
+
+template <class E>
+void verify_slot(Verifier& v, const std::byte* slot, std::uint32_t limit, std::size_t depth, Vector<E>*) {
+  const auto off = load<std::uint32_t>(slot);
+  const auto count = load<std::uint32_t>(slot + 4);
+  if (count == 0) return;
+  if constexpr (Scalar<E>) {
+    if (off % alignof(E) != 0) fail("misaligned vector");
+    check_range(off, std::uint64_t{count} * sizeof(E), limit, "vector out of bounds");
+  } else {
+    if (off % 4 != 0) fail("misaligned vector");
+    check_range(off, std::uint64_t{count} * 4, limit, "vector out of bounds");
+    using Child = typename E::schema;
+    for (std::uint32_t i = 0; i < count; ++i) {
+      const auto child = load<std::uint32_t>(v.base + off + 4 * i);
+      if (child != 0) verify_table<Child>(v, child, off, depth + 1);
+    }
+  }
+}
+
+template <class C>
+void verify_slot(Verifier& v, const std::byte* slot, std::uint32_t limit, std::size_t depth, Table<C>*) {
+  const auto child = load<std::uint32_t>(slot);
+  if (child != 0) verify_table<C>(v, child, limit, depth + 1);
+}
+
+template <class S, std::size_t... I>
+void verify_fields(Verifier& v, std::uint32_t offset, std::uint32_t inline_size, std::size_t depth,
+                   std::index_sequence<I...>) {
+  using L = LayoutOf<S>;
+  // Fields past inline_size were written by an older schema: nothing to check.
+  ((L::offsets[I] + Slot<FieldType<S, I>>::size <= inline_size
+        ? verify_slot(v, v.base + offset + L::offsets[I], offset, depth, static_cast<FieldType<S, I>*>(nullptr))
+        : void()),
+   ...);
+}
+
+template <class S>
+void verify_table(Verifier& v, std::uint32_t offset, std::uint32_t limit, std::size_t depth) {
+  if (depth > kMaxDepth) fail("tables nested too deeply");
+  if (offset % kTableAlign != 0) fail("misaligned table");
+  check_range(offset, 4, limit, "table out of bounds");
+  const auto inline_size = load<std::uint32_t>(v.base + offset);
+  if (inline_size < 4 || inline_size % 4 != 0) fail("bad table size");
+  // Bounds depend on the referring parent, so they are checked every time;
+  // the fields only depend on the table itself.
+  check_range(offset, inline_size, limit, "table out of bounds");
+  if (!v.first_visit(&kSchemaTag<S>, offset)) return;
+  verify_fields<S>(v, offset, inline_size, depth, std::make_index_sequence<LayoutOf<S>::kCount>{});
+}
+
+}  // namespace detail
+
+/// Verifies `buffer` and returns a view of its root table. Throws
+/// wire::Error on any malformed offset; after that, no access through the
+/// view can leave the buffer.
+template <class S>
+View<S> root(std::span<const std::byte> buffer) {
+  std::uint32_t size = 0;
+  const std::uint32_t offset = detail::check_header(buffer, size);
+  detail::Verifier v{buffer.data(), size, {}};
+  detail::verify_table<S>(v, offset, size, 0);
+  return View<S>(buffer.data(), offset);
+}
+
+/// root() without verification, for buffers from a trusted writer.
+template <class S>
+View<S> root_unchecked(std::span<const std::byte> buffer) noexcept {
+  return View<S>(buffer.data(), detail::load<std::uint32_t>(buffer.data() + 4));
+}
+
+// --- Writing ----------------------------------------------------------------------
+
+/// Handles to objects already written by a Builder.
+struct StringRef {
+  std::uint32_t offset = 0;
+  std::uint32_t length = 0;
+};
+template <class T>
+struct VectorRef {
+  std::uint32_t offset = 0;
+  std::uint32_t count = 0;
+};
+template <class S>
+struct TableRef {
+  std::uint32_t offset = 0;
+};
+
+/// Appends objects to one growing buffer. Children must be added before
+/// the table that refers to them; finish() writes the header. Not
+/// thread-safe. Buffers are limited to 4 GiB (std::length_error).
+class TCC_API Builder {
+ public:
+  explicit Builder(std::size_t initial_capacity = 1024);
+
+  StringRef add_string(std::string_view s);
+
+  template <detail::Scalar T>
+  VectorRef<T> add_vector(std::span<const T> values) {
+    const std::uint32_t off = allocate(values.size() * sizeof(T), alignof(T) < 4 ? 4 : alignof(T));
+    if constexpr (std::endian::native == std::endian::little) {
+      if (!values.empty()) std::memcpy(buffer_.data() + off, values.data(), values.size_bytes());
+    } else {
+      for (std::size_t i = 0; i < values.size(); ++i) detail::store(buffer_.data() + off + i * sizeof(T), values[i]);
+    }
+    return {off, static_cast<std::uint32_t>(values.size())};
+  }
+  template <detail::Scalar T>
+  VectorRef<T> add_vector(std::initializer_list<T> values) {
+    return add_vector(std::span<const T>(values.begin(), values.size()));
+  }
+
+  /// Vector of nested tables.
+  template <class S>
+  VectorRef<Table<S>> add_vector(std::span<const TableRef<S>> tables) {
+    const std::uint32_t off = allocate(tables.size() * 4, 4);
+    for (std::size_t i = 0; i < tables.size(); ++i) detail::store(buffer_.data() + off + 4 * i, tables[i].offset);
+    return {off, static_cast<std::uint32_t>(tables.size())};
+  }
+  template <class S>
+  VectorRef<Table<S>> add_vector(std::initializer_list<TableRef<S>> tables) {
+    return add_vector<S>(std::span<const TableRef<S>>(tables.begin(), tables.size()));
+  }
+
+  /// Writes a table with one value per schema field, in order: scalars by
+  /// value, StringRef/VectorRef/TableRef for the rest (a default-constructed
+  /// ref means empty or absent).
+  template <class S, class... Args>
+  TableRef<S> add_table(const Args&... values) {
+    using L = detail::LayoutOf<S>;
+    static_assert(sizeof...(Args) == L::kCount, "add_table needs one value per field");
+    const std::uint32_t off = allocate(L::inline_size, detail::kTableAlign);
+    std::byte* table = buffer_.data() + off;
+    detail::store(table, static_cast<std::uint32_t>(L::inline_size));
+    write_fields<S>(table, std::make_index_sequence<L::kCount>{}, values...);
+    return {off};
+  }
+
+  /// Completes the message around `root` and returns it. The span stays
+  /// valid until the next call that modifies the builder.
+  template <class S>
+  std::span<const std::byte> finish(TableRef<S> root) {
+    return finish_root(root.offset);
+  }
+
+  /// Finished bytes so far (the whole message after finish()).
+  std::span<const std::byte> data() const noexcept { return {buffer_.data(), size_}; }
+
+  /// Moves the buffer out; the builder is empty afterwards.
+  std::vector<std::byte> release();
+
+  /// Starts a new message, keeping the allocation.
+  void clear() noexcept;
+
+ private:
+  /// Reserves `bytes` (zero-filled) at a multiple of `align`.
+  std::uint32_t allocate(std::size_t bytes, std::size_t align);
+  std::span<const std::byte> finish_root(std::uint32_t root);
+
+  template <class S, std::size_t... I, class... Args>
+  void write_fields(std::byte* table, std::index_sequence<I...>, const Args&... values) {
+    (write_field<detail::FieldType<S, I>>(table + detail::LayoutOf<S>::offsets[I], values), ...);
+  }
+
+  template <class T, class Arg>
+  static void write_field(std::byte* slot, const Arg& value) {
+    if constexpr (detail::Scalar<T>) {
+      static_assert(std::is_convertible_v<Arg, T>, "scalar field needs a convertible value");
+      detail::store<T>(slot, static_cast<T>(value));
+    } else if constexpr (std::is_same_v<T, String>) {
+      static_assert(std::is_same_v<Arg, StringRef>, "String field needs a StringRef from add_string()");
+      detail::store(slot, value.offset);
+      detail::store(slot + 4, value.length);
+    } else if constexpr (requires { typename T::element; }) {
+      static_assert(std::is_same_v<Arg, VectorRef<typename T::element>>,
+                    "Vector field needs the matching VectorRef from add_vector()");
+      detail::store(slot, value.offset);
+      detail::store(slot + 4, value.count);
+    } else {
+      static_assert(std::is_same_v<Arg, TableRef<typename T::schema>>,
+                    "Table field needs the matching TableRef from add_table()");
+      detail::store(slot, value.offset);
+    }
+  }
+
+  std::vector<std::byte> buffer_;
+  std::size_t size_ = detail::kHeaderSize;
+};
+
+}  // namespace tcc::wire
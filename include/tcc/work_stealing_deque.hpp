@@ -0,0 +1,125 @@
+#pragma once
+
+// Chase-Lev work-stealing deque ("Dynamic Circular Work-Stealing Deque",
+// Chase & Lev 2005; memory orders after Le et al. 2013).
+//
+// The owning thread pushes and pops at the bottom; any thread may steal from
+// the top. T must be trivially copyable and small (a task pointer). The
+// buffer grows on demand; retired buffers are kept until the deque is
+// destroyed because a concurrent thief may still be reading one.
+//
+// The owner/thief race on the last element is resolved with seq_cst
+// operations on top and bottom rather than standalone fences, which keeps
+// the algorithm visible to ThreadSanitizer.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "tcc/platform.hpp"
+
+namespace tcc {
+
+template <class T>
+class ChaseLevDeque {
+  static_assert(std::is_trivially_copyable_v<T>, "ChaseLevDeque holds trivially copyable values");
+
+ public:
+  explicit ChaseLevDeque(std::size_t initial_capacity = 256) {
+    std::size_t cap = 2;
+    while (cap < initial_capacity) cap <<= 1;
+    auto array = std::make_unique<Array>(cap);
+    array_.store(array.get(), std::memory_order_relaxed);
+    buffers_.push_back(std::move(array));
+  }
+
+  ChaseLevDeque(const ChaseLevDeque&) = delete;
+  ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+  /// Owner only.
+  void push(T value) {
+    const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+    const std::int64_t t = top_.load(std::memory_order_acquire);
+    Array* a = array_.load(std::memory_order_relaxed);
+    if (b - t > static_cast<std::int64_t>(a->mask)) a = grow(a, t, b);
+    a->put(b, value);
+    // seq_cst rather than release: a thread pool checking for parked workers
+    // right after push() needs this store ordered before its next load.
+    bottom_.store(b + 1, std::memory_order_seq_cst);
+  }
+
+  /// Owner only. Takes the most recently pushed value.
+  std::optional<T> pop() {
+    const std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Array* a = array_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_seq_cst);
+    std::int64_t t = top_.load(std::memory_order_seq_cst);
+    if (t > b) {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+    T value = a->get(b);
+    if (t == b) {
+      // Last element: race the thieves for it.
+      const bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed);
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      if (!won) return std::nullopt;
+    }
+    return value;
+  }
+
+  /// Any thread. Takes the oldest value; returns nullopt when empty or when
+  /// it lost a race (callers just try elsewhere).
+  std::optional<T> steal() {
+    std::int64_t t = top_.load(std::memory_order_seq_cst);
+    const std::int64_t b = bottom_.load(std::memory_order_seq_cst);
+    if (t >= b) return std::nullopt;
+    Array* a = array_.load(std::memory_order_acquire);
+    T value = a->get(t);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return std::nullopt;
+    }
+    return value;
+  }
+
+  /// Snapshot; may be stale by the time it is used.
+  bool empty_approx() const noexcept {
+    return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Array {
+    explicit Array(std::size_t capacity) : mask(capacity - 1), slots(new std::atomic<T>[capacity]) {}
+
+    void put(std::int64_t i, T v) noexcept {
+      slots[static_cast<std::size_t>(i) & mask].store(v, std::memory_order_relaxed);
+    }
+    T get(std::int64_t i) const noexcept {
+      return slots[static_cast<std::size_t>(i) & mask].load(std::memory_order_relaxed);
+    }
+
+    std::size_t mask;
+    std::unique_ptr<std::atomic<T>[]> slots;
+  };
+
+  Array* grow(Array* old, std::int64_t t, std::int64_t b) {
+    auto bigger = std::make_unique<Array>((old->mask + 1) * 2);
+    for (std::int64_t i = t; i < b; ++i) bigger->put(i, old->get(i));
+    Array* raw = bigger.get();
+    buffers_.push_back(std::move(bigger));
+    array_.store(raw, std::memory_order_release);
+    return raw;
+  }
+
+  alignas(kCacheLineSize) std::atomic<std::int64_t> top_{0};
+  alignas(kCacheLineSize) std::atomic<std::int64_t> bottom_{0};
+  std::atomic<Array*> array_{nullptr};
+  std::vector<std::unique_ptr<Array>> buffers_;  // owner only
+};
+
+}  // namespace tcc
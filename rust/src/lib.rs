@@ -0,0 +1,152 @@
+//! C ABI of the `tcc_rs` static library, mirrored by `src/rust/ffi.hpp` and
+//! wrapped for C++ by `include/tcc/rust.hpp`.
+//!
+//! Nothing is copied at the boundary:
+//!
+//! * `TccSlice` is a borrowed `{ptr, len}` view. C++ passes spans and string
+//!   views in as slices, and Rust hands sub-slices of them back to C++.
+//! * `TccRustBuf` is a `Vec<u8>` taken apart into `{ptr, len, cap}`. Ownership
+//!   moves with the struct. A function that takes one by value consumes it,
+//!   and one that returns it hands it over. Only `tcc_rs_buf_free` (or
+//!   another consuming call) may release it, so the allocation never changes
+//!   allocator.
+
+use std::ffi::c_void;
+use std::mem::ManuallyDrop;
+use std::slice;
+
+#[repr(C)]
+#[derive(Clone, Copy)]
+pub struct TccSlice {
+    pub ptr: *const u8,
+    pub len: usize,
+}
+
+#[repr(C)]
+pub struct TccRustBuf {
+    pub ptr: *mut u8,
+    pub len: usize,
+    pub cap: usize,
+}
+
+impl TccSlice {
+    fn from_bytes(bytes: &[u8]) -> Self {
+        TccSlice { ptr: bytes.as_ptr(), len: bytes.len() }
+    }
+
+    /// # Safety
+    /// `ptr` must be valid for `len` bytes for the returned lifetime. A null
+    /// `ptr` is accepted when `len` is 0 (C++ empty spans may have one).
+    unsafe fn as_bytes<'a>(self) -> &'a [u8] {
+        if self.len == 0 {
+            &[]
+        } else {
+            slice::from_raw_parts(self.ptr, self.len)
+        }
+    }
+}
+
+impl TccRustBuf {
+    fn from_vec(v: Vec<u8>) -> Self {
+        let mut v = ManuallyDrop::new(v);
+        TccRustBuf { ptr: v.as_mut_ptr(), len: v.len(), cap: v.capacity() }
+    }
+
+    /// # Safety
+    /// `self` must come from `from_vec` (or be all-null, meaning empty) and
+    /// not have been released yet.
+    unsafe fn into_vec(self) -> Vec<u8> {
+        if self.ptr.is_null() {
+            Vec::new()
+        } else {
+            Vec::from_raw_parts(self.ptr, self.len, self.cap)
+        }
+    }
+}
+
+/// Version of the crate, as a static string.
+#[no_mangle]
+pub extern "C" fn tcc_rs_version() -> TccSlice {
+    TccSlice::from_bytes(env!("CARGO_PKG_VERSION").as_bytes())
+}
+
+/// 64-bit FNV-1a of a borrowed slice.
+///
+/// # Safety
+/// `bytes` must be a valid slice.
+#[no_mangle]
+pub unsafe extern "C" fn tcc_rs_fnv1a(bytes: TccSlice) -> u64 {
+    bytes.as_bytes().iter().fold(0xcbf2_9ce4_8422_2325u64, |h, &b| (h ^ u64::from(b)).wrapping_mul(0x100_0000_01b3))
+}
+
+/// Calls `on_field(ctx, field)` for every `delimiter`-separated field of
+/// `text`, in order. Each field is a sub-slice of `text`. Returns the
+/// number of fields (an empty input has one empty field).
+///
+/// # Safety
+/// `text` must be a valid slice that outlives the call. `on_field` must be
+/// callable with `ctx` and must not unwind.
+#[no_mangle]
+pub unsafe extern "C" fn tcc_rs_split(
+    text: TccSlice,
+    delimiter: u8,
+    on_field: extern "C" fn(*mut c_void, TccSlice),
+    ctx: *mut c_void,
+) -> usize {
+    let mut count = 0;
+    for field in text.as_bytes().split(|&b| b == delimiter) {
+        on_field(ctx, TccSlice::from_bytes(field));
+        count += 1;
+    }
+    count
+}
+
+/// ASCII-uppercased copy of `bytes` in a new Rust-owned buffer.
+///
+/// # Safety
+/// `bytes` must be a valid slice.
+#[no_mangle]
+pub unsafe extern "C" fn tcc_rs_to_upper(bytes: TccSlice) -> TccRustBuf {
+    TccRustBuf::from_vec(bytes.as_bytes().to_ascii_uppercase())
+}
+
+/// An empty buffer with room for at least `capacity` bytes.
+#[no_mangle]
+pub extern "C" fn tcc_rs_buf_with_capacity(capacity: usize) -> TccRustBuf {
+    TccRustBuf::from_vec(Vec::with_capacity(capacity))
+}
+
+/// Consumes `buf`, makes room for `additional` more bytes and returns it.
+/// The bytes stay in place unless the capacity has to grow.
+///
+/// # Safety
+/// `buf` must be a live buffer from this library.
+#[no_mangle]
+pub unsafe extern "C" fn tcc_rs_buf_reserve(buf: TccRustBuf, additional: usize) -> TccRustBuf {
+    let mut v = buf.into_vec();
+    v.reserve(additional);
+    TccRustBuf::from_vec(v)
+}
+
+/// Consumes `buf`, appends `tail` and returns it. The existing bytes are
+/// not copied unless the capacity has to grow.
+///
+/// # Safety
+/// `buf` must be a live buffer from this library. `tail` must be a valid
+/// slice that does not overlap it.
+#[no_mangle]
+pub unsafe extern "C" fn tcc_rs_buf_append(buf: TccRustBuf, tail: TccSlice) -> TccRustBuf {
+    let mut v = buf.into_vec();
+    v.extend_from_slice(tail.as_bytes());
+    TccRustBuf::from_vec(v)
+}
+
+/// Releases `buf`. An all-null buffer is ignored.
+///
+/// # Safety
+/// `buf` must be a live buffer from this library, or all-null.
+#[no_mangle]
+pub unsafe extern "C" fn tcc_rs_buf_free(buf: TccRustBuf) {
+    drop(buf.into_vec());
+}
+
@@ -0,0 +1,133 @@
+#include "tcc/arena.hpp"
+
+#include <algorithm>
+
+namespace tcc {
+
+namespace {
+
+constexpr std::size_t kMinChunkSize = 256;
+
+// Rounding blocks up once keeps consecutive blocks aligned without padding.
+constexpr std::size_t round_up(std::size_t n, std::size_t align) noexcept {
+  return (n + align - 1) & ~(align - 1);
+}
+
+}  // namespace
+
+// --- Arena ------------------------------------------------------------------
+
+Arena::Arena(std::size_t first_chunk, std::pmr::memory_resource* upstream) noexcept
+    : first_chunk_size_(std::clamp(first_chunk, kMinChunkSize, kMaxChunkSize)),
+      next_chunk_size_(first_chunk_size_),
+      upstream_(upstream) {
+  if (auto* granular = dynamic_cast<GranularResource*>(upstream)) {
+    granularity_ = std::max<std::size_t>(granular->granularity(), 1);
+  }
+}
+
+Arena::~Arena() { release(); }
+
+Arena::Arena(Arena&& other) noexcept
+    : cur_(std::exchange(other.cur_, nullptr)),
+      end_(std::exchange(other.end_, nullptr)),
+      first_(std::exchange(other.first_, nullptr)),
+      current_(std::exchange(other.current_, nullptr)),
+      first_chunk_size_(other.first_chunk_size_),
+      next_chunk_size_(std::exchange(other.next_chunk_size_, other.first_chunk_size_)),
+      used_in_retired_(std::exchange(other.used_in_retired_, 0)),
+      reserved_(std::exchange(other.reserved_, 0)),
+      chunks_(std::exchange(other.chunks_, 0)),
+      granularity_(other.granularity_),
+      upstream_(other.upstream_) {}
+
+Arena& Arena::operator=(Arena&& other) noexcept {
+  if (this != &other) {
+    release();
+    cur_ = std::exchange(other.cur_, nullptr);
+    end_ = std::exchange(other.end_, nullptr);
+    first_ = std::exchange(other.first_, nullptr);
+    current_ = std::exchange(other.current_, nullptr);
+    first_chunk_size_ = other.first_chunk_size_;
+    next_chunk_size_ = std::exchange(other.next_chunk_size_, other.first_chunk_size_);
+    used_in_retired_ = std::exchange(other.used_in_retired_, 0);
+    reserved_ = std::exchange(other.reserved_, 0);
+    chunks_ = std::exchange(other.chunks_, 0);
+    granularity_ = other.granularity_;
+    upstream_ = other.upstream_;
+  }
+  return *this;
+}
+
+void* Arena::allocate_slow(std::size_t bytes, std::size_t align) {
+  // After reset() the chunks past the current one are empty; use them before
+  // asking upstream for more. A chunk too small for this request is skipped
+  // until the next reset().
+  while (current_ != nullptr && current_->next != nullptr) {
+    used_in_retired_ += static_cast<std::size_t>(cur_ - current_->data());
+    activate(current_->next);
+    if (void* p = bump(bytes, align)) return p;
+  }
+
+  if (bytes > SIZE_MAX - align) throw std::bad_alloc();
+  Chunk* chunk = new_chunk(bytes + align);
+  if (current_ != nullptr) {
+    used_in_retired_ += static_cast<std::size_t>(cur_ - current_->data());
+    current_->next = chunk;
+  } else {
+    first_ = chunk;
+  }
+  activate(chunk);
+  return bump(bytes, align);
+}
+
+Arena::Chunk* Arena::new_chunk(std::size_t min_capacity) {
+  std::size_t capacity = std::max(next_chunk_size_, min_capacity);
+  if (granularity_ > 1) {
+    // Grow the chunk into the rest of the upstream's last unit.
+    capacity = GranularResource::round_to_units(sizeof(Chunk) + capacity, granularity_) - sizeof(Chunk);
+  }
+  void* raw = upstream_->allocate(sizeof(Chunk) + capacity, alignof(std::max_align_t));
+  auto* chunk = ::new (raw) Chunk{nullptr, capacity};
+  next_chunk_size_ = std::min(next_chunk_size_ * 2, kMaxChunkSize);
+  reserved_ += capacity;
+  ++chunks_;
+  return chunk;
+}
+
+void Arena::activate(Chunk* chunk) noexcept {
+  current_ = chunk;
+  cur_ = chunk->data();
+  end_ = cur_ + chunk->capacity;
+}
+
+void Arena::reset() noexcept {
+  used_in_retired_ = 0;
+  if (first_ != nullptr) activate(first_);
+}
+
+void Arena::release() noexcept {
+  for (Chunk* chunk = first_; chunk != nullptr;) {
+    Chunk* next = chunk->next;
+    upstream_->deallocate(chunk, sizeof(Chunk) + chunk->capacity, alignof(std::max_align_t));
+    chunk = next;
+  }
+  cur_ = end_ = nullptr;
+  first_ = current_ = nullptr;
+  next_chunk_size_ = first_chunk_size_;
+  used_in_retired_ = reserved_ = chunks_ = 0;
+}
+
+std::size_t Arena::bytes_used() const noexcept {
+  const std::size_t in_current = current_ != nullptr ? static_cast<std::size_t>(cur_ - current_->data()) : 0;
+  return used_in_retired_ + in_current;
+}
+
+// --- FixedPool --------------------------------------------------------------
+
+FixedPool::FixedPool(std::size_t block_size, std::size_t block_align, std::size_t blocks_per_chunk)
+    : block_size_(round_up(std::max(block_size, sizeof(FreeBlock)), std::max(block_align, alignof(FreeBlock)))),
+      block_align_(std::max(block_align, alignof(FreeBlock))),
+      arena_(block_size_ * std::max<std::size_t>(blocks_per_chunk, 1)) {}
+
+}  // namespace tcc
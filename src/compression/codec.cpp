@@ -0,0 +1,178 @@
+// Per-block encode/decode for each Codec. liblz4 and libzstd are used when
+// found at configure time (TCC_COMPRESSION_HAVE_LZ4 / _ZSTD); lz4 falls
+// back to the built-in block codec, zstd has no fallback.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "codec.hpp"
+
+#if defined(TCC_COMPRESSION_HAVE_LZ4)
+#include <lz4.h>
+#endif
+#if defined(TCC_COMPRESSION_HAVE_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace tcc {
+
+bool codec_available(Codec codec) noexcept {
+  switch (codec) {
+    case Codec::store:
+    case Codec::lz4:
+      return true;
+    case Codec::zstd:
+#if defined(TCC_COMPRESSION_HAVE_ZSTD)
+      return true;
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+namespace detail {
+
+namespace {
+
+[[noreturn]] void corrupt(const char* what) { throw CompressionError(std::string("tcc: corrupt frame: ") + what); }
+
+#if defined(TCC_COMPRESSION_HAVE_ZSTD)
+
+// One context per worker thread: ZSTD_compress() would allocate and free
+// several hundred KiB of state for every block.
+struct ZstdContexts {
+  std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> cctx{ZSTD_createCCtx(), &ZSTD_freeCCtx};
+  std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> dctx{ZSTD_createDCtx(), &ZSTD_freeDCtx};
+};
+
+ZstdContexts& zstd_contexts() {
+  thread_local ZstdContexts contexts;
+  return contexts;
+}
+
+#endif
+
+std::size_t max_payload(Codec codec, std::size_t n) noexcept {
+  switch (codec) {
+    case Codec::lz4:
+#if defined(TCC_COMPRESSION_HAVE_LZ4)
+      return static_cast<std::size_t>(LZ4_compressBound(static_cast<int>(n)));
+#else
+      return lz4_bound(n);
+#endif
+    case Codec::zstd:
+#if defined(TCC_COMPRESSION_HAVE_ZSTD)
+      return ZSTD_compressBound(n);
+#else
+      break;
+#endif
+    case Codec::store:
+      break;
+  }
+  return n;
+}
+
+/// Compressed size, or 0 when the codec cannot beat `raw.size()`.
+std::size_t compress_payload(Codec codec, int level, std::span<const std::byte> raw, std::byte* dst,
+                             std::size_t capacity) {
+  switch (codec) {
+    case Codec::lz4: {
+#if defined(TCC_COMPRESSION_HAVE_LZ4)
+      const int n = LZ4_compress_default(reinterpret_cast<const char*>(raw.data()), reinterpret_cast<char*>(dst),
+                                         static_cast<int>(raw.size()), static_cast<int>(capacity));
+      return n > 0 ? static_cast<std::size_t>(n) : 0;
+#else
+      (void)capacity;
+      return lz4_compress(raw.data(), raw.size(), dst);
+#endif
+    }
+    case Codec::zstd: {
+#if defined(TCC_COMPRESSION_HAVE_ZSTD)
+      const std::size_t n = ZSTD_compressCCtx(zstd_contexts().cctx.get(), dst, capacity, raw.data(), raw.size(),
+                                              level == 0 ? ZSTD_CLEVEL_DEFAULT : level);
+      if (ZSTD_isError(n)) throw CompressionError(std::string("tcc: zstd: ") + ZSTD_getErrorName(n));
+      return n;
+#else
+      (void)level;
+      (void)capacity;
+      throw CompressionError("tcc: zstd is not available in this build");
+#endif
+    }
+    case Codec::store:
+      break;
+  }
+  return 0;
+}
+
+}  // namespace
+
+std::size_t encode_block(Codec codec, int level, std::span<const std::byte> raw, std::vector<std::byte>& out) {
+  const std::size_t capacity = std::max(max_payload(codec, raw.size()), raw.size());
+  if (out.size() < kBlockHeaderSize + capacity) out.resize(kBlockHeaderSize + capacity);
+  std::byte* payload = out.data() + kBlockHeaderSize;
+  std::size_t stored = compress_payload(codec, level, raw, payload, capacity);
+  std::uint32_t word = static_cast<std::uint32_t>(stored);
+  if (stored == 0 || stored >= raw.size()) {
+    if (!raw.empty()) std::memcpy(payload, raw.data(), raw.size());
+    stored = raw.size();
+    word = static_cast<std::uint32_t>(stored) | kStoredFlag;
+  }
+  store_le(out.data(), word);
+  store_le(out.data() + 4, static_cast<std::uint32_t>(raw.size()));
+  return kBlockHeaderSize + stored;
+}
+
+std::uint64_t max_raw_size(Codec codec, std::uint32_t stored_word) noexcept {
+  const std::uint64_t stored = stored_word & ~kStoredFlag;
+  if ((stored_word & kStoredFlag) != 0) return stored;
+  switch (codec) {
+    case Codec::lz4:
+      return stored * 255;  // each LZ4 length byte adds at most 255 output bytes
+    case Codec::zstd:
+      return stored * 32768;  // an RLE block: 3-byte header + 1 byte -> 128 KiB
+    case Codec::store:
+      break;
+  }
+  return 0;  // compressed block in a stored frame
+}
+
+void decode_block(Codec codec, std::uint32_t stored_word, std::span<const std::byte> payload,
+                  std::span<std::byte> out) {
+  if ((stored_word & kStoredFlag) != 0) {
+    if (payload.size() != out.size()) corrupt("stored block size mismatch");
+    if (!out.empty()) std::memcpy(out.data(), payload.data(), out.size());
+    return;
+  }
+  switch (codec) {
+    case Codec::lz4: {
+#if defined(TCC_COMPRESSION_HAVE_LZ4)
+      const int n = LZ4_decompress_safe(reinterpret_cast<const char*>(payload.data()),
+                                        reinterpret_cast<char*>(out.data()), static_cast<int>(payload.size()),
+                                        static_cast<int>(out.size()));
+      if (n < 0 || static_cast<std::size_t>(n) != out.size()) corrupt("bad lz4 block");
+#else
+      if (!lz4_decompress(payload.data(), payload.size(), out.data(), out.size())) corrupt("bad lz4 block");
+#endif
+      return;
+    }
+    case Codec::zstd: {
+#if defined(TCC_COMPRESSION_HAVE_ZSTD)
+      const std::size_t n =
+          ZSTD_decompressDCtx(zstd_contexts().dctx.get(), out.data(), out.size(), payload.data(), payload.size());
+      if (ZSTD_isError(n) || n != out.size()) corrupt("bad zstd block");
+      return;
+#else
+      throw CompressionError("tcc: zstd is not available in this build");
+#endif
+    }
+    case Codec::store:
+      break;
+  }
+  corrupt("compressed block in a stored frame");
+}
+
+}  // namespace detail
+
+}  // namespace tcc
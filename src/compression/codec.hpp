@@ -0,0 +1,95 @@
+#pragma once
+
+// Frame constants and per-block codecs shared by the compression streams
+// and FrameReader. See tcc/compression.hpp for the frame layout.
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <span>
+#include <vector>
+
+#include "tcc/compression.hpp"
+#include "tcc/thread_pool.hpp"
+
+namespace tcc::detail {
+
+inline constexpr std::uint32_t kFrameMagic = 0x315a4354;   // "TCZ1"
+inline constexpr std::uint32_t kFooterMagic = 0x585a4354;  // "TCZX"
+inline constexpr std::uint8_t kFrameVersion = 1;
+inline constexpr std::size_t kFrameHeaderSize = 16;
+inline constexpr std::size_t kBlockHeaderSize = 8;
+inline constexpr std::size_t kFooterSize = 16;
+inline constexpr std::uint32_t kStoredFlag = 0x80000000u;
+inline constexpr std::size_t kMinBlockSize = std::size_t{4} << 10;
+inline constexpr std::size_t kMaxBlockSize = std::size_t{1} << 30;
+
+// Unsigned little-endian integers at any alignment.
+template <class T>
+constexpr T reverse_bytes(T v) noexcept {
+  T out = 0;
+  for (std::size_t i = 0; i < sizeof(T); ++i) out = static_cast<T>((out << 8) | ((v >> (8 * i)) & 0xff));
+  return out;
+}
+
+template <class T>
+T load_le(const std::byte* p) noexcept {
+  T v;
+  std::memcpy(&v, p, sizeof v);
+  if constexpr (std::endian::native == std::endian::big) v = reverse_bytes(v);
+  return v;
+}
+
+template <class T>
+void store_le(std::byte* p, T v) noexcept {
+  if constexpr (std::endian::native == std::endian::big) v = reverse_bytes(v);
+  std::memcpy(p, &v, sizeof v);
+}
+
+/// Writes block header and payload for `raw` to out[0, n) and returns n,
+/// growing `out` as needed (never shrinking, so recycled buffers are not
+/// re-zeroed). Falls back to a stored block when the codec does not shrink
+/// the input.
+std::size_t encode_block(Codec codec, int level, std::span<const std::byte> raw, std::vector<std::byte>& out);
+
+/// Decodes one payload, given its stored-size word, into exactly
+/// out.size() bytes. Throws CompressionError on corrupt input.
+void decode_block(Codec codec, std::uint32_t stored_word, std::span<const std::byte> payload,
+                  std::span<std::byte> out);
+
+/// Most raw bytes a payload with this stored-size word can decode to. A
+/// block header claiming more is corrupt; checking it first keeps a few
+/// bytes of input from making a reader allocate a whole maximum-size block.
+std::uint64_t max_raw_size(Codec codec, std::uint32_t stored_word) noexcept;
+
+// Built-in LZ4 block format codec (src/compression/lz4_block.cpp), used
+// when liblz4 was not found at configure time.
+std::size_t lz4_bound(std::size_t n) noexcept;
+/// Compresses src into dst, which holds lz4_bound(n) bytes; returns the
+/// compressed size.
+std::size_t lz4_compress(const std::byte* src, std::size_t n, std::byte* dst) noexcept;
+/// Returns false unless src decodes to exactly `raw` bytes.
+bool lz4_decompress(const std::byte* src, std::size_t n, std::byte* dst, std::size_t raw) noexcept;
+
+/// One block in flight on the pool, compressing or decompressing. Reused
+/// across blocks so its buffers keep their capacity.
+struct CompressionBlock final : Job {
+  void execute() override;
+
+  ThreadPool* pool = nullptr;
+  bool compress = true;
+  Codec codec = Codec::store;
+  int level = 0;
+  std::uint32_t stored_word = 0;  // decompression: the block header word
+  std::vector<std::byte> input;   // raw bytes, or the compressed payload
+  std::size_t input_size = 0;
+  std::vector<std::byte> output;  // encoded block with header, or raw bytes
+  std::size_t output_size = 0;
+  std::exception_ptr error;
+  std::atomic<bool> done{false};
+};
+
+}  // namespace tcc::detail
@@ -0,0 +1,253 @@
+// LZ4 block format (https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md)
+// without liblz4: a single-probe hash-table matcher with literal-run
+// acceleration, and a bounds-checked decoder. Output is readable by any
+// LZ4 block decoder and vice versa.
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "codec.hpp"
+
+namespace tcc::detail {
+
+namespace {
+
+using u8 = unsigned char;
+
+constexpr std::size_t kMinMatch = 4;
+constexpr std::size_t kLastLiterals = 5;  // the block ends with at least this many literals
+constexpr std::size_t kMatchSafety = 12;  // the last match starts at least this far from the end
+constexpr std::size_t kMaxOffset = 65535;
+constexpr int kHashLog = 13;              // 32 KiB table: stays in L1
+constexpr unsigned kSkipTrigger = 6;      // probe step grows every 2^6 missed positions
+constexpr std::size_t kWildCopy = 16;
+
+inline std::uint32_t read32(const u8* p) noexcept {
+  std::uint32_t v;
+  std::memcpy(&v, p, sizeof v);
+  return v;
+}
+
+inline std::uint64_t read64(const u8* p) noexcept {
+  std::uint64_t v;
+  std::memcpy(&v, p, sizeof v);
+  return v;
+}
+
+inline std::uint32_t hash4(std::uint32_t v) noexcept { return (v * 2654435761u) >> (32 - kHashLog); }
+
+/// Length of the common prefix of p and q, stopping at `limit`.
+inline std::size_t match_length(const u8* p, const u8* q, const u8* limit) noexcept {
+  const u8* start = p;
+  while (p + 8 <= limit) {
+    const std::uint64_t diff = read64(p) ^ read64(q);
+    if (diff != 0) {
+      const int bytes = std::endian::native == std::endian::little ? std::countr_zero(diff) / 8
+                                                                    : std::countl_zero(diff) / 8;
+      return static_cast<std::size_t>(p - start) + static_cast<std::size_t>(bytes);
+    }
+    p += 8;
+    q += 8;
+  }
+  while (p < limit && *p == *q) {
+    ++p;
+    ++q;
+  }
+  return static_cast<std::size_t>(p - start);
+}
+
+/// Copies at least n bytes in 16-byte chunks; both sides need n + 15
+/// bytes of room, and src must be at least 16 bytes behind dst if they
+/// overlap.
+inline void wild_copy(u8* dst, const u8* src, std::size_t n) noexcept {
+  for (std::size_t i = 0; i < n; i += kWildCopy) std::memcpy(dst + i, src + i, kWildCopy);
+}
+
+/// Adds a 255-continued length extension to `length`; false if truncated.
+inline bool read_length(const u8*& ip, const u8* iend, std::size_t& length) noexcept {
+  u8 b;
+  do {
+    if (ip >= iend) return false;
+    b = *ip++;
+    length += b;
+  } while (b == 255);
+  return true;
+}
+
+inline u8* write_length(u8* op, std::size_t rest) noexcept {
+  while (rest >= 255) {
+    *op++ = 255;
+    rest -= 255;
+  }
+  *op++ = static_cast<u8>(rest);
+  return op;
+}
+
+/// Writes the literal-length half of `token` and the literals themselves.
+/// `fast` means there are kWildCopy bytes of slack after both runs.
+inline u8* emit_literals(u8* op, u8* token, const u8* literals, std::size_t n, bool fast) noexcept {
+  if (n >= 15) {
+    *token = 15 << 4;
+    op = write_length(op, n - 15);
+  } else {
+    *token = static_cast<u8>(n << 4);
+  }
+  if (fast) {
+    wild_copy(op, literals, n);
+  } else {
+    std::memcpy(op, literals, n);
+  }
+  return op + n;
+}
+
+}  // namespace
+
+std::size_t lz4_bound(std::size_t n) noexcept { return n + n / 255 + 16; }
+
+std::size_t lz4_compress(const std::byte* source, std::size_t n, std::byte* dest) noexcept {
+  const u8* const src = reinterpret_cast<const u8*>(source);
+  u8* op = reinterpret_cast<u8*>(dest);
+  u8* const op_end = op + lz4_bound(n);
+  const u8* const end = src + n;
+  const u8* anchor = src;
+
+  if (n >= kMatchSafety + 1) {
+    const u8* const match_start_limit = end - kMatchSafety;
+    const u8* const match_end_limit = end - kLastLiterals;
+    // Positions relative to src; 0 doubles as "empty", which only costs a
+    // failed compare against the first bytes. Per thread, since blocks are
+    // compressed on pool workers concurrently.
+    thread_local std::uint32_t table[std::size_t{1} << kHashLog];
+    std::memset(table, 0, sizeof table);
+
+    const u8* ip = src + 1;
+    while (ip < match_start_limit) {
+      const std::uint32_t h = hash4(read32(ip));
+      const u8* candidate = src + table[h];
+      table[h] = static_cast<std::uint32_t>(ip - src);
+      if (candidate >= ip || static_cast<std::size_t>(ip - candidate) > kMaxOffset ||
+          read32(candidate) != read32(ip)) {
+        ip += 1 + (static_cast<std::size_t>(ip - anchor) >> kSkipTrigger);
+        continue;
+      }
+      while (ip > anchor && candidate > src && ip[-1] == candidate[-1]) {
+        --ip;
+        --candidate;
+      }
+      const std::size_t length = kMinMatch + match_length(ip + kMinMatch, candidate + kMinMatch, match_end_limit);
+
+      u8* token = op++;
+      const auto literals = static_cast<std::size_t>(ip - anchor);
+      const bool fast = static_cast<std::size_t>(end - anchor) >= literals + kWildCopy &&
+                        static_cast<std::size_t>(op_end - op) >= literals + kWildCopy + 5;
+      op = emit_literals(op, token, anchor, literals, fast);
+      const auto offset = static_cast<std::uint16_t>(ip - candidate);
+      *op++ = static_cast<u8>(offset);
+      *op++ = static_cast<u8>(offset >> 8);
+      const std::size_t extra = length - kMinMatch;
+      if (extra >= 15) {
+        *token |= 15;
+        op = write_length(op, extra - 15);
+      } else {
+        *token |= static_cast<u8>(extra);
+      }
+
+      ip += length;
+      anchor = ip;
+      // Seed the table inside the match so the next one is found sooner.
+      if (ip < match_start_limit) table[hash4(read32(ip - 2))] = static_cast<std::uint32_t>(ip - 2 - src);
+    }
+  }
+
+  u8* token = op++;
+  op = emit_literals(op, token, anchor, static_cast<std::size_t>(end - anchor), false);
+  return static_cast<std::size_t>(op - reinterpret_cast<u8*>(dest));
+}
+
+bool lz4_decompress(const std::byte* source, std::size_t n, std::byte* dest, std::size_t raw) noexcept {
+  const u8* ip = reinterpret_cast<const u8*>(source);
+  const u8* const iend = ip + n;
+  u8* const out = reinterpret_cast<u8*>(dest);
+  u8* op = out;
+  u8* const oend = out + raw;
+
+  while (ip < iend) {
+    const u8 token = *ip++;
+    std::size_t literals = token >> 4;
+
+    // Short literals and a short match with room to spare on both sides:
+    // fixed-size copies, no length loops. With 18 input bytes left the
+    // sequence cannot be the last one, so a match offset follows.
+    if (literals < 15 && (token & 15) < 15 && iend - ip >= 18 && oend - op >= 32) {
+      std::memcpy(op, ip, 16);
+      ip += literals;
+      op += literals;
+      const std::size_t offset = ip[0] | (std::size_t{ip[1]} << 8);
+      ip += 2;
+      const std::size_t length = (token & 15) + kMinMatch;
+      if (offset == 0 || offset > static_cast<std::size_t>(op - out)) return false;
+      const u8* match = op - offset;
+      if (offset >= 8) {
+        // Each 8-byte step reads only bytes at least 8 behind its target.
+        std::memcpy(op, match, 8);
+        std::memcpy(op + 8, match + 8, 8);
+        std::memcpy(op + 16, match + 16, 2);
+      } else {
+        for (std::size_t i = 0; i < length; ++i) op[i] = match[i];
+      }
+      op += length;
+      continue;
+    }
+
+    if (literals == 15 && !read_length(ip, iend, literals)) return false;
+    if (literals > static_cast<std::size_t>(iend - ip) || literals > static_cast<std::size_t>(oend - op)) {
+      return false;
+    }
+    if (static_cast<std::size_t>(iend - ip) >= literals + kWildCopy &&
+        static_cast<std::size_t>(oend - op) >= literals + kWildCopy) {
+      wild_copy(op, ip, literals);
+    } else {
+      std::memcpy(op, ip, literals);
+    }
+    ip += literals;
+    op += literals;
+    if (ip == iend) break;  // the last sequence has no match
+
+    if (iend - ip < 2) return false;
+    const std::size_t offset = ip[0] | (std::size_t{ip[1]} << 8);
+    ip += 2;
+    if (offset == 0 || offset > static_cast<std::size_t>(op - out)) return false;
+    std::size_t length = token & 15;
+    if (length == 15 && !read_length(ip, iend, length)) return false;
+    length += kMinMatch;
+    if (length > static_cast<std::size_t>(oend - op)) return false;
+
+    const u8* match = op - offset;
+    if (offset >= kWildCopy && static_cast<std::size_t>(oend - op) >= length + kWildCopy) {
+      // Chunks never overlap their own source, so over-copying is safe: the
+      // tail is rewritten by the next sequence.
+      wild_copy(op, match, length);
+      op += length;
+    } else if (offset >= length) {
+      std::memcpy(op, match, length);
+      op += length;
+    } else if (offset >= 8) {
+      // Overlapping, but each 8-byte chunk reads bytes already written.
+      u8* const stop = op + length;
+      while (stop - op >= 8) {
+        std::memcpy(op, match, 8);
+        op += 8;
+        match += 8;
+      }
+      while (op < stop) *op++ = *match++;
+    } else {
+      for (std::size_t i = 0; i < length; ++i) op[i] = match[i];
+      op += length;
+    }
+  }
+  return op == oend;
+}
+
+}  // namespace tcc::detail
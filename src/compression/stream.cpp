@@ -0,0 +1,379 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "codec.hpp"
+
+namespace tcc {
+
+namespace detail {
+
+void CompressionBlock::execute() {
+  // The owner may reuse or free *this as soon as done flips.
+  ThreadPool& p = *pool;
+  try {
+    if (compress) {
+      output_size = encode_block(codec, level, {input.data(), input_size}, output);
+    } else {
+      decode_block(codec, stored_word, {input.data(), input_size}, {output.data(), output_size});
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+  done.store(true, std::memory_order_release);
+  p.notify_waiters();
+}
+
+}  // namespace detail
+
+namespace {
+
+[[noreturn]] void corrupt(const char* what) { throw CompressionError(std::string("tcc: corrupt frame: ") + what); }
+
+std::size_t default_in_flight(const ThreadPool& pool, std::size_t requested) noexcept {
+  return requested != 0 ? requested : std::max<std::size_t>(2, 2 * pool.size());
+}
+
+std::unique_ptr<detail::CompressionBlock> take_block(std::vector<std::unique_ptr<detail::CompressionBlock>>& spare,
+                                                     ThreadPool& pool) {
+  std::unique_ptr<detail::CompressionBlock> block;
+  if (spare.empty()) {
+    block = std::make_unique<detail::CompressionBlock>();
+  } else {
+    block = std::move(spare.back());
+    spare.pop_back();
+  }
+  block->pool = &pool;
+  block->error = nullptr;
+  block->done.store(false, std::memory_order_relaxed);
+  return block;
+}
+
+void wait_all(ThreadPool& pool, const std::deque<std::unique_ptr<detail::CompressionBlock>>& blocks) {
+  for (const auto& block : blocks) pool.wait(block->done);
+}
+
+/// Copies from [data + pos, data + end) into out[written, ...).
+std::size_t drain(const std::vector<std::byte>& data, std::size_t& pos, std::size_t end, std::span<std::byte> out,
+                  std::size_t written) {
+  const std::size_t n = std::min(end - pos, out.size() - written);
+  std::memcpy(out.data() + written, data.data() + pos, n);
+  pos += n;
+  return n;
+}
+
+}  // namespace
+
+ByteSource span_source(std::span<const std::byte> bytes) {
+  return [bytes, pos = std::size_t{0}](std::span<std::byte> out) mutable {
+    const std::size_t n = std::min(out.size(), bytes.size() - pos);
+    if (n != 0) std::memcpy(out.data(), bytes.data() + pos, n);
+    pos += n;
+    return n;
+  };
+}
+
+// --- CompressStream ------------------------------------------------------------
+
+CompressStream::CompressStream(ThreadPool& pool, ByteSource source, CompressOptions options)
+    : pool_(pool), source_(std::move(source)), options_(options) {
+  if (!codec_available(options_.codec)) throw std::invalid_argument("tcc::CompressStream: codec not available");
+  if (options_.block_size < detail::kMinBlockSize || options_.block_size > detail::kMaxBlockSize) {
+    throw std::invalid_argument("tcc::CompressStream: block_size out of range");
+  }
+  options_.max_in_flight = default_in_flight(pool_, options_.max_in_flight);
+}
+
+CompressStream::~CompressStream() { wait_all(pool_, in_flight_); }
+
+std::size_t CompressStream::read(std::span<std::byte> out) {
+  std::size_t written = 0;
+  while (written < out.size()) {
+    if (pending_pos_ == pending_end_ && !advance()) break;
+    written += drain(pending_, pending_pos_, pending_end_, out, written);
+  }
+  return written;
+}
+
+void CompressStream::refill() {
+  const std::size_t block_size = options_.block_size;
+  while (!source_done_ && in_flight_.size() < options_.max_in_flight) {
+    auto block = take_block(spare_, pool_);
+    if (block->input.size() < block_size) block->input.resize(block_size);
+    // Only the last block may be short, so keep reading until it is full.
+    std::size_t got = 0;
+    while (got < block_size) {
+      const std::size_t n = source_({block->input.data() + got, block_size - got});
+      if (n == 0) {
+        source_done_ = true;
+        break;
+      }
+      got += n;
+    }
+    if (got == 0) {
+      spare_.push_back(std::move(block));
+      break;
+    }
+    raw_bytes_ += got;
+    block->compress = true;
+    block->codec = options_.codec;
+    block->level = options_.level;
+    block->input_size = got;
+    pool_.submit(*block);
+    in_flight_.push_back(std::move(block));
+  }
+}
+
+bool CompressStream::advance() {
+  pending_pos_ = 0;
+  if (!header_done_) {
+    pending_.resize(std::max(pending_.size(), detail::kFrameHeaderSize));
+    std::byte* h = pending_.data();
+    detail::store_le(h, detail::kFrameMagic);
+    h[4] = static_cast<std::byte>(options_.codec);
+    h[5] = static_cast<std::byte>(detail::kFrameVersion);
+    detail::store_le(h + 6, std::uint16_t{0});
+    detail::store_le(h + 8, static_cast<std::uint32_t>(options_.block_size));
+    detail::store_le(h + 12, std::uint32_t{0});
+    pending_end_ = detail::kFrameHeaderSize;
+    emitted_ += pending_end_;
+    header_done_ = true;
+    return true;
+  }
+
+  refill();
+  if (!in_flight_.empty()) {
+    std::unique_ptr<detail::CompressionBlock> block = std::move(in_flight_.front());
+    in_flight_.pop_front();
+    try {
+      refill();  // keep the workers busy while the caller drains this block
+    } catch (...) {
+      pool_.wait(block->done);  // a worker still owns it; don't free it under them
+      throw;
+    }
+    pool_.wait(block->done);
+    if (block->error) std::rethrow_exception(block->error);
+    index_.push_back(emitted_);
+    std::swap(pending_, block->output);
+    pending_end_ = block->output_size;
+    emitted_ += pending_end_;
+    spare_.push_back(std::move(block));
+    return true;
+  }
+
+  if (!trailer_done_) {
+    const std::size_t size = detail::kBlockHeaderSize + 8 * index_.size() + detail::kFooterSize;
+    pending_.resize(std::max(pending_.size(), size));
+    std::byte* p = pending_.data();
+    detail::store_le(p, std::uint64_t{0});  // end marker
+    p += detail::kBlockHeaderSize;
+    for (std::uint64_t offset : index_) {
+      detail::store_le(p, offset);
+      p += 8;
+    }
+    detail::store_le(p, raw_bytes_);
+    detail::store_le(p + 8, static_cast<std::uint32_t>(index_.size()));
+    detail::store_le(p + 12, detail::kFooterMagic);
+    pending_end_ = size;
+    emitted_ += size;
+    trailer_done_ = true;
+    return true;
+  }
+  pending_end_ = 0;
+  return false;
+}
+
+// --- DecompressStream ----------------------------------------------------------
+
+DecompressStream::DecompressStream(ThreadPool& pool, ByteSource source, std::size_t max_in_flight)
+    : pool_(pool), source_(std::move(source)), max_in_flight_(default_in_flight(pool, max_in_flight)) {}
+
+DecompressStream::~DecompressStream() { wait_all(pool_, in_flight_); }
+
+std::size_t DecompressStream::read(std::span<std::byte> out) {
+  std::size_t written = 0;
+  while (written < out.size()) {
+    if (pending_pos_ == pending_end_ && !advance()) break;
+    written += drain(pending_, pending_pos_, pending_end_, out, written);
+  }
+  return written;
+}
+
+bool DecompressStream::read_exact(std::span<std::byte> out) {
+  std::size_t got = 0;
+  while (got < out.size()) {
+    const std::size_t n = source_(out.subspan(got));
+    if (n == 0) {
+      if (got == 0) return false;
+      corrupt("truncated");
+    }
+    got += n;
+  }
+  return true;
+}
+
+void DecompressStream::refill() {
+  while (!source_done_ && in_flight_.size() < max_in_flight_) {
+    std::byte header[detail::kBlockHeaderSize];
+    if (!read_exact(header)) corrupt("missing end marker");
+    const auto word = detail::load_le<std::uint32_t>(header);
+    const auto raw = detail::load_le<std::uint32_t>(header + 4);
+    if (word == 0 && raw == 0) {
+      source_done_ = true;  // the index and footer that follow are for seeking
+      break;
+    }
+    const std::size_t stored = word & ~detail::kStoredFlag;
+    // Encoders only keep payloads that are smaller than the raw block, and
+    // no codec expands a payload past max_raw_size(): together these bound
+    // what a corrupt header can make us allocate.
+    if (raw == 0 || raw > block_size_ || stored > raw || raw > detail::max_raw_size(codec_, word)) {
+      corrupt("bad block header");
+    }
+
+    auto block = take_block(spare_, pool_);
+    if (block->input.size() < stored) block->input.resize(stored);
+    if (stored != 0 && !read_exact({block->input.data(), stored})) corrupt("truncated");
+    if (block->output.size() < raw) block->output.resize(raw);
+    block->compress = false;
+    block->codec = codec_;
+    block->stored_word = word;
+    block->input_size = stored;
+    block->output_size = raw;
+    pool_.submit(*block);
+    in_flight_.push_back(std::move(block));
+  }
+}
+
+bool DecompressStream::advance() {
+  pending_pos_ = 0;
+  pending_end_ = 0;
+  if (!header_done_) {
+    std::byte h[detail::kFrameHeaderSize];
+    if (!read_exact(h)) corrupt("empty input");
+    if (detail::load_le<std::uint32_t>(h) != detail::kFrameMagic) corrupt("bad magic");
+    if (static_cast<std::uint8_t>(h[5]) != detail::kFrameVersion) corrupt("unknown version");
+    if (static_cast<std::uint8_t>(h[4]) > static_cast<std::uint8_t>(Codec::zstd)) corrupt("unknown codec");
+    codec_ = static_cast<Codec>(h[4]);
+    if (!codec_available(codec_)) throw CompressionError("tcc: frame codec is not available in this build");
+    block_size_ = detail::load_le<std::uint32_t>(h + 8);
+    if (block_size_ < detail::kMinBlockSize || block_size_ > detail::kMaxBlockSize) corrupt("bad block size");
+    header_done_ = true;
+  }
+
+  refill();
+  if (in_flight_.empty()) return false;
+  std::unique_ptr<detail::CompressionBlock> block = std::move(in_flight_.front());
+  in_flight_.pop_front();
+  try {
+    refill();  // a corrupt header after this block throws here
+  } catch (...) {
+    pool_.wait(block->done);  // a worker still owns it; don't free it under them
+    throw;
+  }
+  pool_.wait(block->done);
+  if (block->error) std::rethrow_exception(block->error);
+  std::swap(pending_, block->output);
+  pending_end_ = block->output_size;
+  spare_.push_back(std::move(block));
+  return true;
+}
+
+// --- FrameReader ---------------------------------------------------------------
+
+FrameReader::FrameReader(std::span<const std::byte> frame) : frame_(frame) {
+  const std::uint64_t size = frame.size();
+  if (size < detail::kFrameHeaderSize + detail::kBlockHeaderSize + detail::kFooterSize) corrupt("too short");
+  const std::byte* h = frame.data();
+  if (detail::load_le<std::uint32_t>(h) != detail::kFrameMagic) corrupt("bad magic");
+  if (static_cast<std::uint8_t>(h[5]) != detail::kFrameVersion) corrupt("unknown version");
+  if (static_cast<std::uint8_t>(h[4]) > static_cast<std::uint8_t>(Codec::zstd)) corrupt("unknown codec");
+  codec_ = static_cast<Codec>(h[4]);
+  block_size_ = detail::load_le<std::uint32_t>(h + 8);
+  if (block_size_ < detail::kMinBlockSize || block_size_ > detail::kMaxBlockSize) corrupt("bad block size");
+
+  const std::byte* footer = h + size - detail::kFooterSize;
+  if (detail::load_le<std::uint32_t>(footer + 12) != detail::kFooterMagic) corrupt("bad footer");
+  raw_size_ = detail::load_le<std::uint64_t>(footer);
+  const std::uint64_t count = detail::load_le<std::uint32_t>(footer + 8);
+  // Not (raw + block - 1) / block, which wraps for sizes near 2^64. With the
+  // count matching, every offset below raw_size_ lies in an indexed block.
+  if (count != raw_size_ / block_size_ + (raw_size_ % block_size_ != 0)) corrupt("block count does not match size");
+  const std::uint64_t reserved = detail::kFrameHeaderSize + detail::kBlockHeaderSize + detail::kFooterSize;
+  if (count > (size - reserved) / (8 + detail::kBlockHeaderSize)) corrupt("index out of bounds");
+  const std::uint64_t index_start = size - detail::kFooterSize - 8 * count;
+  const std::uint64_t end_marker = index_start - detail::kBlockHeaderSize;
+  if (detail::load_le<std::uint64_t>(h + end_marker) != 0) corrupt("missing end marker");
+
+  index_.resize(count);
+  std::uint64_t next = detail::kFrameHeaderSize;
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto offset = detail::load_le<std::uint64_t>(h + index_start + 8 * i);
+    if (offset != next || offset + detail::kBlockHeaderSize > end_marker) corrupt("bad index entry");
+    const auto word = detail::load_le<std::uint32_t>(h + offset);
+    const auto raw = detail::load_le<std::uint32_t>(h + offset + 4);
+    const std::uint64_t stored = word & ~detail::kStoredFlag;
+    if (raw != block_raw_size(i) || stored > raw || raw > detail::max_raw_size(codec_, word)) {
+      corrupt("bad block header");
+    }
+    next = offset + detail::kBlockHeaderSize + stored;
+    if (next > end_marker) corrupt("block out of bounds");
+    index_[i] = offset;
+  }
+  if (next != end_marker) corrupt("bytes between the last block and the end marker");
+}
+
+std::size_t FrameReader::block_raw_size(std::size_t i) const noexcept {
+  const std::uint64_t start = std::uint64_t{i} * block_size_;
+  return static_cast<std::size_t>(std::min<std::uint64_t>(block_size_, raw_size_ - start));
+}
+
+void FrameReader::decode_block(std::size_t i, std::span<std::byte> out) const {
+  if (i >= index_.size()) throw std::out_of_range("tcc::FrameReader: block index out of range");
+  if (out.size() != block_raw_size(i)) throw std::invalid_argument("tcc::FrameReader: output is not one block");
+  const std::byte* header = frame_.data() + index_[i];
+  const auto word = detail::load_le<std::uint32_t>(header);
+  detail::decode_block(codec_, word, {header + detail::kBlockHeaderSize, word & ~detail::kStoredFlag}, out);
+}
+
+std::size_t FrameReader::read_block_range(std::size_t i, std::uint64_t offset, std::span<std::byte> out) const {
+  const std::size_t raw = block_raw_size(i);
+  const std::size_t within = static_cast<std::size_t>(offset - std::uint64_t{i} * block_size_);
+  if (within == 0 && out.size() == raw) {
+    decode_block(i, out);  // the whole block: decode in place
+  } else {
+    thread_local std::vector<std::byte> scratch;
+    if (scratch.size() < raw) scratch.resize(raw);
+    decode_block(i, {scratch.data(), raw});
+    std::memcpy(out.data(), scratch.data() + within, out.size());
+  }
+  return out.size();
+}
+
+std::size_t FrameReader::read(std::uint64_t offset, std::span<std::byte> out) const {
+  if (offset >= raw_size_ || out.empty()) return 0;
+  const std::uint64_t end = std::min<std::uint64_t>(raw_size_, offset + out.size());
+  for (std::uint64_t i = offset / block_size_; i * block_size_ < end; ++i) {
+    const std::uint64_t lo = std::max(offset, i * block_size_);
+    const std::uint64_t hi = std::min(end, (i + 1) * block_size_);
+    read_block_range(static_cast<std::size_t>(i), lo, out.subspan(lo - offset, hi - lo));
+  }
+  return static_cast<std::size_t>(end - offset);
+}
+
+std::size_t FrameReader::read(ThreadPool& pool, std::uint64_t offset, std::span<std::byte> out) const {
+  if (offset >= raw_size_ || out.empty()) return 0;
+  const std::uint64_t end = std::min<std::uint64_t>(raw_size_, offset + out.size());
+  const auto first = static_cast<std::size_t>(offset / block_size_);
+  const auto last = static_cast<std::size_t>((end - 1) / block_size_);
+  parallel_for(pool, {first, last + 1}, 1, [&](IndexRange r) {
+    for (std::size_t i = r.begin; i < r.end; ++i) {
+      const std::uint64_t lo = std::max(offset, std::uint64_t{i} * block_size_);
+      const std::uint64_t hi = std::min(end, (std::uint64_t{i} + 1) * block_size_);
+      read_block_range(i, lo, out.subspan(lo - offset, hi - lo));
+    }
+  });
+  return static_cast<std::size_t>(end - offset);
+}
+
+}  // namespace tcc
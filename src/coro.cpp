@@ -0,0 +1,79 @@
+#include "tcc/coro.hpp"
+
+#include <new>
+
+namespace tcc::detail {
+
+namespace {
+
+// Frames are rounded up to 64 bytes; one free list per multiple of 64 up to
+// kMaxRecycledFrame. A list keeps at most kMaxCached blocks so a thread that
+// only frees (frames created elsewhere) cannot hoard memory.
+constexpr std::size_t kGranule = 64;
+constexpr std::size_t kClasses = kMaxRecycledFrame / kGranule;
+constexpr std::size_t kMaxCached = 256;
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+class FrameCache {
+ public:
+  FrameCache() noexcept = default;
+  FrameCache(const FrameCache&) = delete;
+  FrameCache& operator=(const FrameCache&) = delete;
+
+  ~FrameCache() {
+    for (std::size_t c = 0; c < kClasses; ++c) {
+      while (FreeBlock* block = heads_[c]) {
+        heads_[c] = block->next;
+        ::operator delete(block);
+      }
+    }
+  }
+
+  void* allocate(std::size_t cls) {
+    if (FreeBlock* block = heads_[cls]) {
+      heads_[cls] = block->next;
+      --counts_[cls];
+      return block;
+    }
+    return ::operator new((cls + 1) * kGranule);
+  }
+
+  void deallocate(void* frame, std::size_t cls) noexcept {
+    if (counts_[cls] >= kMaxCached) {
+      ::operator delete(frame);
+      return;
+    }
+    auto* block = static_cast<FreeBlock*>(frame);
+    block->next = heads_[cls];
+    heads_[cls] = block;
+    ++counts_[cls];
+  }
+
+ private:
+  FreeBlock* heads_[kClasses] = {};
+  std::size_t counts_[kClasses] = {};
+};
+
+thread_local FrameCache tls_frames;
+
+constexpr std::size_t size_class(std::size_t size) noexcept { return (size - 1) / kGranule; }
+
+}  // namespace
+
+void* frame_allocate(std::size_t size) {
+  if (size == 0 || size > kMaxRecycledFrame) return ::operator new(size);
+  return tls_frames.allocate(size_class(size));
+}
+
+void frame_deallocate(void* frame, std::size_t size) noexcept {
+  if (size == 0 || size > kMaxRecycledFrame) {
+    ::operator delete(frame);
+    return;
+  }
+  tls_frames.deallocate(frame, size_class(size));
+}
+
+}  // namespace tcc::detail
@@ -0,0 +1,81 @@
+#include "tcc/external_sort.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <random>
+#include <system_error>
+
+namespace tcc::detail {
+
+namespace {
+
+constexpr std::size_t kWriteBuffer = std::size_t{1} << 20;
+
+[[noreturn]] void throw_errno(const char* what, const std::filesystem::path& path) {
+  throw std::system_error(errno, std::generic_category(), std::string(what) + " " + path.string());
+}
+
+}  // namespace
+
+// --- FileWriter -------------------------------------------------------------
+
+FileWriter::FileWriter(const std::filesystem::path& path) : path_(path) {
+#if defined(_WIN32)
+  std::FILE* file = ::_wfopen(path.c_str(), L"wb");
+#else
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+#endif
+  if (file == nullptr) throw_errno("open", path);
+  // Large enough that writes reach the kernel in big sequential blocks.
+  std::setvbuf(file, nullptr, _IOFBF, kWriteBuffer);
+  file_ = file;
+}
+
+FileWriter::~FileWriter() {
+  if (file_ != nullptr) std::fclose(static_cast<std::FILE*>(file_));
+}
+
+void FileWriter::write(const void* data, std::size_t bytes) {
+  if (bytes != 0 && std::fwrite(data, 1, bytes, static_cast<std::FILE*>(file_)) != bytes) {
+    throw_errno("write", path_);
+  }
+}
+
+void FileWriter::finish() {
+  auto* file = static_cast<std::FILE*>(std::exchange(file_, nullptr));
+  if (file == nullptr) return;
+  const bool flushed = std::fflush(file) == 0;
+  const int flush_errno = errno;
+  if (std::fclose(file) != 0 || !flushed) {
+    if (!flushed) errno = flush_errno;
+    throw_errno("write", path_);
+  }
+}
+
+// --- SpillDir ---------------------------------------------------------------
+
+SpillDir::SpillDir(const std::filesystem::path& parent) {
+  std::random_device seed;
+  std::mt19937_64 rng((static_cast<std::uint64_t>(seed()) << 32) ^ seed());
+  for (int attempt = 0; attempt < 16; ++attempt) {
+    char name[32];
+    std::snprintf(name, sizeof name, "tcc_sort_%016llx", static_cast<unsigned long long>(rng()));
+    std::error_code ec;
+    if (std::filesystem::create_directory(parent / name, ec)) {
+      dir_ = parent / name;
+      return;
+    }
+    if (ec) throw std::system_error(ec, "create spill directory in " + parent.string());
+  }
+  throw std::system_error(std::make_error_code(std::errc::file_exists),
+                          "create spill directory in " + parent.string());
+}
+
+SpillDir::~SpillDir() {
+  std::error_code ec;
+  std::filesystem::remove_all(dir_, ec);
+}
+
+std::filesystem::path SpillDir::next() { return dir_ / ("run_" + std::to_string(files_++) + ".bin"); }
+
+}  // namespace tcc::detail
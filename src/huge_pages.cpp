@@ -0,0 +1,229 @@
+#include "tcc/huge_pages.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace tcc {
+
+namespace {
+
+constexpr std::size_t kDefaultHugePage = std::size_t{2} << 20;
+
+#if defined(__linux__)
+
+std::size_t small_page_size() noexcept {
+  static const auto size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  return size;
+}
+
+/// Faults every page of [p, p + n) in for writing.
+void prefault(void* p, std::size_t n) noexcept {
+#if defined(MADV_POPULATE_WRITE)
+  if (::madvise(p, n, MADV_POPULATE_WRITE) == 0) return;  // Linux 5.14+
+#endif
+  // Zero pages are already zero; a volatile store of 0 still faults them in.
+  auto* bytes = static_cast<volatile unsigned char*>(p);
+  for (std::size_t i = 0; i < n; i += small_page_size()) bytes[i] = 0;
+}
+
+void* map_anonymous(std::size_t length, int extra_flags) noexcept {
+  void* p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extra_flags, -1, 0);
+  return p == MAP_FAILED ? nullptr : p;
+}
+
+/// `length` bytes aligned to `align`: over-map, then trim both ends.
+void* map_aligned(std::size_t length, std::size_t align) noexcept {
+  void* raw = map_anonymous(length + align, 0);
+  if (raw == nullptr) return nullptr;
+  const auto start = reinterpret_cast<std::uintptr_t>(raw);
+  const std::uintptr_t aligned = (start + align - 1) & ~(static_cast<std::uintptr_t>(align) - 1);
+  if (aligned > start) ::munmap(raw, aligned - start);
+  const std::size_t tail = start + length + align - (aligned + length);
+  if (tail != 0) ::munmap(reinterpret_cast<void*>(aligned + length), tail);
+  return reinterpret_cast<void*>(aligned);
+}
+
+/// First "key: value" number from a /proc style file.
+std::uint64_t read_key(const char* path, const std::string& key) {
+  std::ifstream in(path);
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.compare(0, key.size(), key) == 0 && line.size() > key.size() &&
+        (line[key.size()] == ':' || line[key.size()] == ' ')) {
+      return std::strtoull(line.c_str() + key.size() + 1, nullptr, 10);
+    }
+  }
+  return 0;
+}
+
+#endif
+
+}  // namespace
+
+std::size_t huge_page_size() noexcept {
+#if defined(__linux__)
+  static const std::size_t size = [] {
+    std::ifstream in("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size");
+    std::size_t n = 0;
+    return in >> n && n != 0 ? n : kDefaultHugePage;
+  }();
+  return size;
+#else
+  return kDefaultHugePage;
+#endif
+}
+
+// --- Mapping ----------------------------------------------------------------
+
+detail::PageMapping detail::map_pages(std::size_t bytes, const HugePageOptions& options) {
+#if defined(__linux__)
+  const std::size_t huge = huge_page_size();
+  PageMapping m;
+  if (options.policy == PagePolicy::hugetlb) {
+    m.length = GranularResource::round_to_units(std::max<std::size_t>(bytes, 1), huge);
+    m.data = map_anonymous(m.length, MAP_HUGETLB | (options.prefault ? MAP_POPULATE : 0));
+    if (m.data != nullptr) {
+      m.served = PagePolicy::hugetlb;
+      return m;
+    }
+  }
+  if (options.policy != PagePolicy::small) {
+    m.length = GranularResource::round_to_units(std::max<std::size_t>(bytes, 1), huge);
+    m.data = map_aligned(m.length, huge);
+    if (m.data != nullptr) {
+      // EINVAL means no THP support at all: the pages are small then.
+      m.served = ::madvise(m.data, m.length, MADV_HUGEPAGE) == 0 ? PagePolicy::transparent : PagePolicy::small;
+      if (options.prefault) prefault(m.data, m.length);
+      return m;
+    }
+  }
+  // Still whole huge pages when they were asked for: HugePageResource
+  // unmaps by its granularity, which only knows the policy.
+  const std::size_t unit = options.policy == PagePolicy::small ? small_page_size() : huge;
+  m.length = GranularResource::round_to_units(std::max<std::size_t>(bytes, 1), unit);
+  m.data = map_anonymous(m.length, options.prefault ? MAP_POPULATE : 0);
+  if (m.data == nullptr) throw std::bad_alloc();
+  m.served = PagePolicy::small;
+  return m;
+#else
+  (void)options;
+  return {::operator new(bytes, std::align_val_t{kDefaultHugePage}), bytes, PagePolicy::small};
+#endif
+}
+
+void detail::unmap_pages(const PageMapping& mapping) noexcept {
+  if (mapping.data == nullptr) return;
+#if defined(__linux__)
+  ::munmap(mapping.data, mapping.length);
+#else
+  ::operator delete(mapping.data, std::align_val_t{kDefaultHugePage});
+#endif
+}
+
+// --- HugePageResource -------------------------------------------------------
+
+std::size_t HugePageResource::granularity() const noexcept {
+#if defined(__linux__)
+  return options_.policy == PagePolicy::small ? small_page_size() : huge_page_size();
+#else
+  return 1;
+#endif
+}
+
+void* HugePageResource::do_allocate(std::size_t bytes, std::size_t align) {
+  if (align > huge_page_size()) throw std::bad_alloc();
+  const detail::PageMapping m = detail::map_pages(bytes, options_);
+  std::atomic<std::uint64_t>& tier = m.served == PagePolicy::hugetlb       ? hugetlb_bytes_
+                                     : m.served == PagePolicy::transparent ? transparent_bytes_
+                                                                           : small_bytes_;
+  tier.fetch_add(m.length, std::memory_order_relaxed);
+  mapped_bytes_.fetch_add(m.length, std::memory_order_relaxed);
+  if (m.served != options_.policy) fallbacks_.fetch_add(1, std::memory_order_relaxed);
+  return m.data;
+}
+
+void HugePageResource::do_deallocate(void* p, std::size_t bytes, std::size_t align) {
+  (void)align;
+  // The tier does not matter for munmap, only the rounded length: hugetlb
+  // and THP mappings are both whole huge pages.
+  const std::size_t length = round_to_units(std::max<std::size_t>(bytes, 1), granularity());
+  detail::unmap_pages({p, length, options_.policy});
+  mapped_bytes_.fetch_sub(length, std::memory_order_relaxed);
+}
+
+HugePageResource::Stats HugePageResource::stats() const noexcept {
+  return {hugetlb_bytes_.load(std::memory_order_relaxed), transparent_bytes_.load(std::memory_order_relaxed),
+          small_bytes_.load(std::memory_order_relaxed), fallbacks_.load(std::memory_order_relaxed),
+          mapped_bytes_.load(std::memory_order_relaxed)};
+}
+
+// --- Reports ----------------------------------------------------------------
+
+PageBacking page_backing(std::span<const std::byte> range) {
+  PageBacking out;
+  out.bytes = range.size();
+#if defined(__linux__)
+  if (range.empty()) return out;
+  const auto begin = reinterpret_cast<std::uintptr_t>(range.data());
+  const std::uintptr_t end = begin + range.size();
+  std::ifstream in("/proc/self/smaps");
+  if (!in) return out;
+  out.small_page_size = small_page_size();
+
+  // Header lines ("start-end perms ...") open a mapping; "Key: N kB" lines follow.
+  double overlap = 0;  // fraction of the current mapping inside the range
+  double resident = 0, huge = 0;
+  std::string line;
+  while (std::getline(in, line)) {
+    const std::size_t dash = line.find('-');
+    const std::size_t colon = line.find(':');
+    if (dash != std::string::npos && (colon == std::string::npos || dash < colon) &&
+        line.find(' ') > dash) {
+      char* rest = nullptr;
+      const std::uintptr_t lo = std::strtoull(line.c_str(), &rest, 16);
+      const std::uintptr_t hi = std::strtoull(rest + 1, nullptr, 16);
+      const std::uintptr_t a = std::max(lo, begin), b = std::min(hi, end);
+      overlap = b > a && hi > lo ? static_cast<double>(b - a) / static_cast<double>(hi - lo) : 0.0;
+      continue;
+    }
+    if (overlap == 0 || colon == std::string::npos) continue;
+    const std::string key = line.substr(0, colon);
+    const double kib = std::strtod(line.c_str() + colon + 1, nullptr) * 1024.0 * overlap;
+    if (key == "Rss" || key == "Private_Hugetlb" || key == "Shared_Hugetlb") resident += kib;
+    if (key == "AnonHugePages" || key == "FilePmdMapped" || key == "ShmemPmdMapped" || key == "Private_Hugetlb" ||
+        key == "Shared_Hugetlb") {
+      huge += kib;
+    }
+  }
+  out.resident = std::min(static_cast<std::size_t>(resident), out.bytes);
+  out.huge = std::min(static_cast<std::size_t>(huge), out.resident);
+#endif
+  return out;
+}
+
+SystemHugePages system_huge_pages() {
+  SystemHugePages out;
+#if defined(__linux__)
+  std::ifstream enabled("/sys/kernel/mm/transparent_hugepage/enabled");
+  std::string modes;
+  std::getline(enabled, modes);
+  if (const auto open = modes.find('['), close = modes.find(']'); open != std::string::npos && close > open) {
+    out.thp_mode = modes.substr(open + 1, close - open - 1);
+  }
+  out.hugetlb_total = read_key("/proc/meminfo", "HugePages_Total");
+  out.hugetlb_free = read_key("/proc/meminfo", "HugePages_Free");
+  out.thp_fault_alloc = read_key("/proc/vmstat", "thp_fault_alloc");
+  out.thp_fault_fallback = read_key("/proc/vmstat", "thp_fault_fallback");
+  out.thp_collapse_alloc = read_key("/proc/vmstat", "thp_collapse_alloc");
+#endif
+  return out;
+}
+
+}  // namespace tcc
@@ -0,0 +1,99 @@
+#pragma once
+
+// Interface between tcc::io::Ring and its two backends. Ring serializes
+// every call except run(), which backends reach through Op::execute() on
+// pool workers.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include "tcc/io_ring.hpp"
+#include "tcc/thread_pool.hpp"
+
+namespace tcc::io::detail {
+
+enum class OpCode : std::uint8_t { nop, read, write, read_fixed, write_fixed, recv, send, fsync, timeout };
+
+class Backend;
+
+/// One operation from prepare to callback. Scheduled on the pool directly,
+/// so a completion costs no allocation beyond the op itself.
+struct Op final : Job {
+  void execute() override;
+
+  Backend* backend = nullptr;
+  Callback callback;
+  OpCode code = OpCode::nop;
+  bool fixed_file = false;
+  bool ready = false;  // `result` is final; only the callback is left
+  int fd = -1;
+  unsigned buffer_index = 0;
+  void* addr = nullptr;
+  std::size_t len = 0;
+  std::uint64_t offset = 0;
+  std::int64_t timeout_ns = 0;
+  std::int64_t timespec[2] = {};  // __kernel_timespec for io_uring timeouts
+  int result = 0;
+};
+
+class Backend {
+ public:
+  explicit Backend(ThreadPool& pool) noexcept : pool_(pool) {}
+  virtual ~Backend() = default;
+
+  Backend(const Backend&) = delete;
+  Backend& operator=(const Backend&) = delete;
+
+  virtual BackendKind kind() const noexcept = 0;
+
+  /// Queues `op`; the backend owns it from here on.
+  virtual void prepare(Op* op) = 0;
+  virtual std::size_t submit() = 0;
+  virtual void register_buffers(std::span<const std::span<std::byte>> buffers) = 0;
+  virtual void register_files(std::span<const int> fds) = 0;
+
+  /// Called on a pool worker for every scheduled op.
+  virtual void run(Op& op) = 0;
+
+  /// Ops prepared but whose callback has not returned.
+  std::size_t in_flight() const noexcept { return pending_.load(std::memory_order_acquire); }
+
+  void begin_op() noexcept { pending_.fetch_add(1, std::memory_order_relaxed); }
+
+  /// Blocks until in_flight() is 0 (caller must have submitted everything).
+  void wait_idle() noexcept {
+    for (std::size_t n = pending_.load(std::memory_order_acquire); n != 0;
+         n = pending_.load(std::memory_order_acquire)) {
+      pending_.wait(n, std::memory_order_acquire);
+    }
+  }
+
+ protected:
+  /// Runs the callback and retires `op`.
+  void finish(Op* op) noexcept {
+    std::unique_ptr<Op> owned(op);
+    if (owned->callback) owned->callback(owned->result);
+    owned.reset();
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) pending_.notify_all();
+  }
+
+  ThreadPool& pool_;
+
+ private:
+  std::atomic<std::size_t> pending_{0};
+};
+
+inline void Op::execute() { backend->run(*this); }
+
+/// Whether io_uring_setup() succeeds on this kernel.
+bool probe_uring() noexcept;
+
+/// nullptr when io_uring is not compiled in or the kernel refuses it.
+std::unique_ptr<Backend> make_uring_backend(ThreadPool& pool, unsigned queue_depth);
+
+std::unique_ptr<Backend> make_fallback_backend(ThreadPool& pool);
+
+}  // namespace tcc::io::detail
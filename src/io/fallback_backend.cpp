@@ -0,0 +1,290 @@
+// Portable backend for kernels or sandboxes without io_uring.
+//
+// File operations cannot be made non-blocking on Linux, so they run as
+// plain pread/pwrite/fsync on a pool worker. Socket operations are tried
+// with MSG_DONTWAIT first; when they would block they park on an epoll
+// reactor thread (EPOLLONESHOT per descriptor) and go back to the pool once
+// the socket is ready. The reactor also owns the timers.
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "backend.hpp"
+
+namespace tcc::io::detail {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// epoll data tag of the wake-up eventfd.
+constexpr std::uint64_t kWakeTag = ~std::uint64_t{0};
+
+class FallbackBackend final : public Backend {
+ public:
+  explicit FallbackBackend(ThreadPool& pool) : Backend(pool) {
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) throw std::system_error(errno, std::generic_category(), "epoll_create1");
+    wake_fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wake_fd_ < 0) {
+      const int err = errno;
+      ::close(epoll_fd_);
+      throw std::system_error(err, std::generic_category(), "eventfd");
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = kWakeTag;
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+    reactor_ = std::thread([this] { react(); });
+  }
+
+  ~FallbackBackend() override {
+    {
+      std::lock_guard lock(mutex_);
+      stopping_ = true;
+    }
+    wake();
+    reactor_.join();
+    ::close(wake_fd_);
+    ::close(epoll_fd_);
+  }
+
+  BackendKind kind() const noexcept override { return BackendKind::fallback; }
+
+  void prepare(Op* op) override { batch_.push_back(op); }
+
+  std::size_t submit() override {
+    const std::size_t n = batch_.size();
+    for (Op* op : batch_) {
+      if (op->code == OpCode::timeout) {
+        add_timer(op);
+      } else {
+        pool_.submit(*op);
+      }
+    }
+    batch_.clear();
+    return n;
+  }
+
+  void register_buffers(std::span<const std::span<std::byte>> buffers) override {
+    buffers_.assign(buffers.begin(), buffers.end());
+  }
+
+  void register_files(std::span<const int> fds) override { files_.assign(fds.begin(), fds.end()); }
+
+  void run(Op& op) override {
+    if (!op.ready && !perform(op)) return;  // parked on the reactor
+    finish(&op);
+  }
+
+ private:
+  struct Waiters {
+    std::deque<Op*> readers;
+    std::deque<Op*> writers;
+    bool added = false;  // fd is in the epoll set, possibly disarmed
+  };
+
+  struct Timer {
+    Clock::time_point deadline;
+    Op* op;
+    bool operator>(const Timer& other) const noexcept { return deadline > other.deadline; }
+  };
+
+  /// Executes the syscall. Returns false when the op was parked instead.
+  bool perform(Op& op) {
+    const int fd = resolve_fd(op);
+    if (fd < 0) {
+      op.result = -EBADF;
+      return true;
+    }
+    if ((op.code == OpCode::read_fixed || op.code == OpCode::write_fixed) && !in_registered_buffer(op)) {
+      op.result = -EFAULT;
+      return true;
+    }
+    ssize_t r = 0;
+    do {
+      switch (op.code) {
+        case OpCode::nop:
+        case OpCode::timeout:
+          r = 0;
+          break;
+        case OpCode::read:
+        case OpCode::read_fixed:
+          r = ::pread(fd, op.addr, op.len, static_cast<off_t>(op.offset));
+          break;
+        case OpCode::write:
+        case OpCode::write_fixed:
+          r = ::pwrite(fd, op.addr, op.len, static_cast<off_t>(op.offset));
+          break;
+        case OpCode::recv:
+          r = ::recv(fd, op.addr, op.len, MSG_DONTWAIT);
+          break;
+        case OpCode::send:
+          r = ::send(fd, op.addr, op.len, MSG_DONTWAIT | MSG_NOSIGNAL);
+          break;
+        case OpCode::fsync:
+          r = ::fsync(fd);
+          break;
+      }
+    } while (r < 0 && errno == EINTR);
+
+    if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) &&
+        (op.code == OpCode::recv || op.code == OpCode::send)) {
+      park(op, fd);
+      return false;
+    }
+    op.result = r < 0 ? -errno : static_cast<int>(r);
+    return true;
+  }
+
+  int resolve_fd(const Op& op) const noexcept {
+    if (op.code == OpCode::nop || op.code == OpCode::timeout) return 0;
+    if (!op.fixed_file) return op.fd;
+    const auto index = static_cast<std::size_t>(op.fd);
+    return index < files_.size() ? files_[index] : -1;
+  }
+
+  bool in_registered_buffer(const Op& op) const noexcept {
+    if (op.buffer_index >= buffers_.size()) return false;
+    const auto& b = buffers_[op.buffer_index];
+    const auto* p = static_cast<const std::byte*>(op.addr);
+    return p >= b.data() && p + op.len <= b.data() + b.size();
+  }
+
+  // --- Reactor ------------------------------------------------------------------
+
+  void park(Op& op, int fd) {
+    std::lock_guard lock(mutex_);
+    Waiters& w = waiters_[fd];
+    (op.code == OpCode::recv ? w.readers : w.writers).push_back(&op);
+    arm(fd, w);
+  }
+
+  /// Re-arms the one-shot registration for whatever `w` still waits on.
+  /// Caller holds mutex_.
+  void arm(int fd, Waiters& w) {
+    epoll_event ev{};
+    ev.events = EPOLLONESHOT | (w.readers.empty() ? 0u : EPOLLIN) | (w.writers.empty() ? 0u : EPOLLOUT);
+    ev.data.u64 = static_cast<std::uint32_t>(fd);
+    int rc = ::epoll_ctl(epoll_fd_, w.added ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &ev);
+    // The descriptor may have been closed and reused since we last saw it.
+    if (rc < 0 && errno == ENOENT) rc = ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+    if (rc < 0 && errno == EEXIST) rc = ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev);
+    if (rc < 0) {
+      // Not pollable: fail the waiters rather than hang them.
+      const int err = -errno;
+      for (auto* q : {&w.readers, &w.writers}) {
+        for (Op* op : *q) {
+          op->result = err;
+          op->ready = true;
+          pool_.submit(*op);
+        }
+        q->clear();
+      }
+      w.added = false;
+      return;
+    }
+    w.added = true;
+  }
+
+  void add_timer(Op* op) {
+    {
+      std::lock_guard lock(mutex_);
+      timers_.push({Clock::now() + std::chrono::nanoseconds(op->timeout_ns), op});
+    }
+    wake();
+  }
+
+  void wake() noexcept {
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const ssize_t n = ::write(wake_fd_, &one, sizeof one);
+  }
+
+  void react() {
+    std::vector<epoll_event> events(64);
+    std::vector<Op*> ready;
+    for (;;) {
+      int timeout_ms = -1;
+      {
+        std::lock_guard lock(mutex_);
+        if (stopping_) return;
+        if (!timers_.empty()) {
+          const auto wait = timers_.top().deadline - Clock::now();
+          // Round up so a timer never fires early.
+          const auto ms = std::chrono::ceil<std::chrono::milliseconds>(wait).count();
+          timeout_ms = ms < 0 ? 0 : static_cast<int>(ms);
+        }
+      }
+      const int n = ::epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), timeout_ms);
+
+      std::unique_lock lock(mutex_);
+      for (int i = 0; i < n; ++i) {
+        const epoll_event& ev = events[static_cast<std::size_t>(i)];
+        if (ev.data.u64 == kWakeTag) {
+          std::uint64_t drained;
+          [[maybe_unused]] const ssize_t r = ::read(wake_fd_, &drained, sizeof drained);
+          continue;
+        }
+        const int fd = static_cast<int>(ev.data.u64);
+        auto it = waiters_.find(fd);
+        if (it == waiters_.end()) continue;
+        Waiters& w = it->second;
+        const bool failed = (ev.events & (EPOLLERR | EPOLLHUP)) != 0;
+        if (failed || (ev.events & EPOLLIN) != 0) {
+          ready.insert(ready.end(), w.readers.begin(), w.readers.end());
+          w.readers.clear();
+        }
+        if (failed || (ev.events & EPOLLOUT) != 0) {
+          ready.insert(ready.end(), w.writers.begin(), w.writers.end());
+          w.writers.clear();
+        }
+        if (!w.readers.empty() || !w.writers.empty()) arm(fd, w);
+      }
+      const auto now = Clock::now();
+      while (!timers_.empty() && timers_.top().deadline <= now) {
+        Op* op = timers_.top().op;
+        timers_.pop();
+        op->result = 0;
+        op->ready = true;
+        ready.push_back(op);
+      }
+      lock.unlock();
+
+      // Parked socket ops retry their syscall on the pool.
+      for (Op* op : ready) pool_.submit(*op);
+      ready.clear();
+    }
+  }
+
+  std::vector<Op*> batch_;  // prepared, not yet submitted (Ring's mutex)
+  std::vector<std::span<std::byte>> buffers_;
+  std::vector<int> files_;
+
+  int epoll_fd_ = -1;
+  int wake_fd_ = -1;
+  std::mutex mutex_;  // reactor state below
+  std::unordered_map<int, Waiters> waiters_;
+  std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers_;
+  bool stopping_ = false;
+  std::thread reactor_;
+};
+
+}  // namespace
+
+std::unique_ptr<Backend> make_fallback_backend(ThreadPool& pool) { return std::make_unique<FallbackBackend>(pool); }
+
+}  // namespace tcc::io::detail
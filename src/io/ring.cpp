@@ -0,0 +1,150 @@
+#include "tcc/io_ring.hpp"
+
+#include <utility>
+
+#include "backend.hpp"
+
+namespace tcc::io {
+
+namespace {
+
+std::unique_ptr<detail::Op> make_op(detail::OpCode code, FileRef file, Callback callback) {
+  auto op = std::make_unique<detail::Op>();
+  op->code = code;
+  op->fd = file.value();
+  op->fixed_file = file.fixed();
+  op->callback = std::move(callback);
+  return op;
+}
+
+}  // namespace
+
+std::string_view backend_name(BackendKind kind) noexcept {
+  switch (kind) {
+    case BackendKind::io_uring:
+      return "io_uring";
+    case BackendKind::fallback:
+      return "fallback";
+  }
+  return "unknown";
+}
+
+bool io_uring_supported() noexcept {
+  static const bool supported = detail::probe_uring();
+  return supported;
+}
+
+Ring::Ring(RingOptions options) {
+  ThreadPool& pool = options.pool != nullptr ? *options.pool : ThreadPool::global();
+  if (!options.force_fallback) backend_ = detail::make_uring_backend(pool, options.queue_depth);
+  if (!backend_) backend_ = detail::make_fallback_backend(pool);
+}
+
+Ring::~Ring() {
+  drain();
+  backend_.reset();
+}
+
+BackendKind Ring::backend() const noexcept { return backend_->kind(); }
+
+void Ring::read(FileRef file, std::span<std::byte> buffer, std::uint64_t offset, Callback callback) {
+  auto op = make_op(detail::OpCode::read, file, std::move(callback));
+  op->addr = buffer.data();
+  op->len = buffer.size();
+  op->offset = offset;
+  enqueue(std::move(op));
+}
+
+void Ring::write(FileRef file, std::span<const std::byte> buffer, std::uint64_t offset, Callback callback) {
+  auto op = make_op(detail::OpCode::write, file, std::move(callback));
+  op->addr = const_cast<std::byte*>(buffer.data());
+  op->len = buffer.size();
+  op->offset = offset;
+  enqueue(std::move(op));
+}
+
+void Ring::read_fixed(FileRef file, unsigned buffer_index, std::span<std::byte> buffer, std::uint64_t offset,
+                      Callback callback) {
+  auto op = make_op(detail::OpCode::read_fixed, file, std::move(callback));
+  op->buffer_index = buffer_index;
+  op->addr = buffer.data();
+  op->len = buffer.size();
+  op->offset = offset;
+  enqueue(std::move(op));
+}
+
+void Ring::write_fixed(FileRef file, unsigned buffer_index, std::span<const std::byte> buffer,
+                       std::uint64_t offset, Callback callback) {
+  auto op = make_op(detail::OpCode::write_fixed, file, std::move(callback));
+  op->buffer_index = buffer_index;
+  op->addr = const_cast<std::byte*>(buffer.data());
+  op->len = buffer.size();
+  op->offset = offset;
+  enqueue(std::move(op));
+}
+
+void Ring::recv(FileRef socket, std::span<std::byte> buffer, Callback callback) {
+  auto op = make_op(detail::OpCode::recv, socket, std::move(callback));
+  op->addr = buffer.data();
+  op->len = buffer.size();
+  enqueue(std::move(op));
+}
+
+void Ring::send(FileRef socket, std::span<const std::byte> buffer, Callback callback) {
+  auto op = make_op(detail::OpCode::send, socket, std::move(callback));
+  op->addr = const_cast<std::byte*>(buffer.data());
+  op->len = buffer.size();
+  enqueue(std::move(op));
+}
+
+void Ring::fsync(FileRef file, Callback callback) {
+  auto op = make_op(detail::OpCode::fsync, file, std::move(callback));
+  enqueue(std::move(op));
+}
+
+void Ring::timeout(std::chrono::nanoseconds delay, Callback callback) {
+  auto op = make_op(detail::OpCode::timeout, -1, std::move(callback));
+  op->timeout_ns = delay.count() < 0 ? 0 : delay.count();
+  enqueue(std::move(op));
+}
+
+void Ring::nop(Callback callback) {
+  auto op = make_op(detail::OpCode::nop, -1, std::move(callback));
+  enqueue(std::move(op));
+}
+
+void Ring::enqueue(std::unique_ptr<detail::Op> op) {
+  std::lock_guard lock(mutex_);
+  op->backend = backend_.get();
+  backend_->begin_op();
+  backend_->prepare(op.release());
+}
+
+std::size_t Ring::submit() {
+  std::lock_guard lock(mutex_);
+  return backend_->submit();
+}
+
+void Ring::register_buffers(std::span<const std::span<std::byte>> buffers) {
+  std::lock_guard lock(mutex_);
+  backend_->register_buffers(buffers);
+}
+
+void Ring::register_files(std::span<const int> fds) {
+  std::lock_guard lock(mutex_);
+  backend_->register_files(fds);
+}
+
+std::size_t Ring::in_flight() const noexcept { return backend_->in_flight(); }
+
+void Ring::drain() {
+  submit();
+  backend_->wait_idle();
+}
+
+#if !defined(TCC_IO_HAVE_URING)
+bool detail::probe_uring() noexcept { return false; }
+std::unique_ptr<detail::Backend> detail::make_uring_backend(ThreadPool&, unsigned) { return nullptr; }
+#endif
+
+}  // namespace tcc::io
@@ -0,0 +1,351 @@
+// io_uring backend, written against the kernel ABI in <linux/io_uring.h>
+// (no liburing). The submitting side writes SQEs under Ring's mutex; a reaper
+// thread blocks in io_uring_enter(GETEVENTS), turns CQEs back into Ops and
+// schedules them on the pool, where the callback runs.
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "backend.hpp"
+
+namespace tcc::io::detail {
+
+namespace {
+
+int sys_setup(unsigned entries, io_uring_params* params) noexcept {
+  return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int sys_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) noexcept {
+  return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int sys_register(int fd, unsigned opcode, const void* arg, unsigned nr_args) noexcept {
+  return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+// Ring indices are shared with the kernel.
+unsigned load_acquire(unsigned* p) noexcept { return std::atomic_ref<unsigned>(*p).load(std::memory_order_acquire); }
+void store_release(unsigned* p, unsigned v) noexcept {
+  std::atomic_ref<unsigned>(*p).store(v, std::memory_order_release);
+}
+
+// The kernel orders an SQE before its CQE, but ThreadSanitizer cannot see
+// that; under TSan an extra release/acquire pair makes the handoff visible.
+#if defined(__SANITIZE_THREAD__)
+#define TCC_IO_TSAN 1
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define TCC_IO_TSAN 1
+#endif
+#endif
+
+// user_data of the NOP that tells the reaper to exit.
+constexpr std::uint64_t kStopTag = ~std::uint64_t{0};
+
+struct Mapping {
+  void* addr = MAP_FAILED;
+  std::size_t len = 0;
+
+  ~Mapping() {
+    if (addr != MAP_FAILED) ::munmap(addr, len);
+  }
+  bool map(int fd, std::size_t length, off_t offset) noexcept {
+    len = length;
+    addr = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    return addr != MAP_FAILED;
+  }
+  template <class T>
+  T* at(std::uint32_t offset) const noexcept {
+    return reinterpret_cast<T*>(static_cast<char*>(addr) + offset);
+  }
+};
+
+class UringBackend final : public Backend {
+ public:
+  UringBackend(ThreadPool& pool, int ring_fd) noexcept : Backend(pool), ring_fd_(ring_fd) {}
+
+  ~UringBackend() override {
+    if (reaper_.joinable()) {
+      // Ring has drained every op; the stop NOP is the last CQE.
+      while (!push_stop()) std::this_thread::yield();
+      reaper_.join();
+    }
+    ::close(ring_fd_);
+  }
+
+  bool init(const io_uring_params& p) noexcept {
+    std::size_t sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    std::size_t cq_len = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    const bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single) sq_len = cq_len = std::max(sq_len, cq_len);
+    if (!sq_map_.map(ring_fd_, sq_len, IORING_OFF_SQ_RING)) return false;
+    const Mapping* cq = &sq_map_;
+    if (!single) {
+      if (!cq_map_.map(ring_fd_, cq_len, IORING_OFF_CQ_RING)) return false;
+      cq = &cq_map_;
+    }
+    if (!sqe_map_.map(ring_fd_, p.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES)) return false;
+
+    sq_head_ = sq_map_.at<unsigned>(p.sq_off.head);
+    sq_tail_ = sq_map_.at<unsigned>(p.sq_off.tail);
+    sq_mask_ = *sq_map_.at<unsigned>(p.sq_off.ring_mask);
+    sq_entries_ = p.sq_entries;
+    sq_array_ = sq_map_.at<unsigned>(p.sq_off.array);
+    sqes_ = static_cast<io_uring_sqe*>(sqe_map_.addr);
+    local_tail_ = *sq_tail_;
+
+    cq_head_ = cq->at<unsigned>(p.cq_off.head);
+    cq_tail_ = cq->at<unsigned>(p.cq_off.tail);
+    cq_mask_ = *cq->at<unsigned>(p.cq_off.ring_mask);
+    cqes_ = cq->at<io_uring_cqe>(p.cq_off.cqes);
+
+    reaper_ = std::thread([this] { reap(); });
+    return true;
+  }
+
+  BackendKind kind() const noexcept override { return BackendKind::io_uring; }
+
+  void prepare(Op* op) override {
+    ++prepared_;
+    io_uring_sqe* sqe = next_sqe();
+    if (sqe == nullptr) {
+      // The ring is wedged; fail the op instead of losing it.
+      op->result = -errno;
+      op->ready = true;
+      pool_.submit(*op);
+      return;
+    }
+    std::memset(sqe, 0, sizeof *sqe);
+    sqe->user_data = reinterpret_cast<std::uintptr_t>(op);
+    sqe->fd = op->fd;
+    if (op->fixed_file) sqe->flags |= IOSQE_FIXED_FILE;
+    sqe->addr = reinterpret_cast<std::uintptr_t>(op->addr);
+    sqe->len = static_cast<std::uint32_t>(op->len);
+    sqe->off = op->offset;
+    switch (op->code) {
+      case OpCode::nop:
+        sqe->opcode = IORING_OP_NOP;
+        sqe->fd = -1;
+        break;
+      case OpCode::read:
+        sqe->opcode = IORING_OP_READ;
+        break;
+      case OpCode::write:
+        sqe->opcode = IORING_OP_WRITE;
+        break;
+      case OpCode::read_fixed:
+        sqe->opcode = IORING_OP_READ_FIXED;
+        sqe->buf_index = static_cast<std::uint16_t>(op->buffer_index);
+        break;
+      case OpCode::write_fixed:
+        sqe->opcode = IORING_OP_WRITE_FIXED;
+        sqe->buf_index = static_cast<std::uint16_t>(op->buffer_index);
+        break;
+      case OpCode::recv:
+        sqe->opcode = IORING_OP_RECV;
+        break;
+      case OpCode::send:
+        sqe->opcode = IORING_OP_SEND;
+        sqe->msg_flags = MSG_NOSIGNAL;
+        break;
+      case OpCode::fsync:
+        sqe->opcode = IORING_OP_FSYNC;
+        break;
+      case OpCode::timeout:
+        op->timespec[0] = op->timeout_ns / 1'000'000'000;
+        op->timespec[1] = op->timeout_ns % 1'000'000'000;
+        sqe->opcode = IORING_OP_TIMEOUT;
+        sqe->fd = -1;
+        sqe->addr = reinterpret_cast<std::uintptr_t>(op->timespec);
+        sqe->len = 1;
+        sqe->off = 0;  // pure timer: do not count other completions
+        break;
+    }
+  }
+
+  std::size_t submit() override {
+    const std::size_t n = std::exchange(prepared_, 0);
+    if (flush() < 0) {
+      throw std::system_error(errno, std::generic_category(), "io_uring_enter");
+    }
+    return n;
+  }
+
+  void register_buffers(std::span<const std::span<std::byte>> buffers) override {
+    if (buffers_registered_) {
+      sys_register(ring_fd_, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+      buffers_registered_ = false;
+    }
+    if (buffers.empty()) return;
+    std::vector<iovec> iovecs;
+    iovecs.reserve(buffers.size());
+    for (const auto& b : buffers) iovecs.push_back({b.data(), b.size()});
+    if (sys_register(ring_fd_, IORING_REGISTER_BUFFERS, iovecs.data(), static_cast<unsigned>(iovecs.size())) < 0) {
+      throw std::system_error(errno, std::generic_category(), "io_uring_register(buffers)");
+    }
+    buffers_registered_ = true;
+  }
+
+  void register_files(std::span<const int> fds) override {
+    if (files_registered_) {
+      sys_register(ring_fd_, IORING_UNREGISTER_FILES, nullptr, 0);
+      files_registered_ = false;
+    }
+    if (fds.empty()) return;
+    if (sys_register(ring_fd_, IORING_REGISTER_FILES, fds.data(), static_cast<unsigned>(fds.size())) < 0) {
+      throw std::system_error(errno, std::generic_category(), "io_uring_register(files)");
+    }
+    files_registered_ = true;
+  }
+
+  void run(Op& op) override {
+    // A pure timer reports expiry as -ETIME; the public contract says 0.
+    if (op.code == OpCode::timeout && op.result == -ETIME) op.result = 0;
+    finish(&op);
+  }
+
+ private:
+  /// Free SQE, submitting what is queued when the ring is full; nullptr
+  /// (with errno set) when the kernel refuses to take anything.
+  io_uring_sqe* next_sqe() noexcept {
+    while (local_tail_ - load_acquire(sq_head_) >= sq_entries_) {
+      if (flush() < 0) return nullptr;
+    }
+    const unsigned index = local_tail_ & sq_mask_;
+    sq_array_[index] = index;
+    ++local_tail_;
+    ++queued_;
+    return &sqes_[index];
+  }
+
+  /// Publishes queued SQEs and submits them with as few enters as possible.
+  int flush() noexcept {
+    if (queued_ == 0) return 0;
+#if defined(TCC_IO_TSAN)
+    tsan_handoff_.fetch_add(1, std::memory_order_release);
+#endif
+    store_release(sq_tail_, local_tail_);
+    while (queued_ > 0) {
+      const int n = sys_enter(ring_fd_, queued_, 0, 0);
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        // CQ overflow backlog: give the reaper a moment to drain it.
+        if (errno == EAGAIN || errno == EBUSY) {
+          std::this_thread::yield();
+          continue;
+        }
+        return -1;
+      }
+      queued_ -= static_cast<unsigned>(n);
+    }
+    return 0;
+  }
+
+  bool push_stop() noexcept {
+    if (local_tail_ - load_acquire(sq_head_) >= sq_entries_) return false;
+    const unsigned index = local_tail_ & sq_mask_;
+    io_uring_sqe* sqe = &sqes_[index];
+    std::memset(sqe, 0, sizeof *sqe);
+    sqe->opcode = IORING_OP_NOP;
+    sqe->fd = -1;
+    sqe->user_data = kStopTag;
+    sq_array_[index] = index;
+    ++local_tail_;
+    ++queued_;
+    return flush() == 0;
+  }
+
+  void reap() {
+    for (;;) {
+      if (sys_enter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR && errno != EBUSY) {
+        // Nothing sensible to do without the ring; keep waiting rather than
+        // dropping completions.
+        std::this_thread::yield();
+        continue;
+      }
+      unsigned head = *cq_head_;
+      const unsigned tail = load_acquire(cq_tail_);
+#if defined(TCC_IO_TSAN)
+      (void)tsan_handoff_.load(std::memory_order_acquire);
+#endif
+      bool stop = false;
+      for (; head != tail; ++head) {
+        const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+        if (cqe.user_data == kStopTag) {
+          stop = true;
+          continue;
+        }
+        Op* op = reinterpret_cast<Op*>(static_cast<std::uintptr_t>(cqe.user_data));
+        op->result = cqe.res;
+        op->ready = true;
+        pool_.submit(*op);
+      }
+      store_release(cq_head_, head);
+      if (stop) return;
+    }
+  }
+
+  int ring_fd_;
+  Mapping sq_map_;
+  Mapping cq_map_;
+  Mapping sqe_map_;
+
+  unsigned* sq_head_ = nullptr;
+  unsigned* sq_tail_ = nullptr;
+  unsigned* sq_array_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned sq_entries_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  unsigned local_tail_ = 0;
+  unsigned queued_ = 0;  // SQEs written but not yet accepted by the kernel
+  std::size_t prepared_ = 0;  // ops prepared since the last submit()
+
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+
+  bool buffers_registered_ = false;
+  bool files_registered_ = false;
+  std::thread reaper_;
+#if defined(TCC_IO_TSAN)
+  std::atomic<std::uint64_t> tsan_handoff_{0};
+#endif
+};
+
+}  // namespace
+
+bool probe_uring() noexcept {
+  io_uring_params params;
+  std::memset(&params, 0, sizeof params);
+  const int fd = sys_setup(1, &params);
+  if (fd < 0) return false;
+  ::close(fd);
+  return true;
+}
+
+std::unique_ptr<Backend> make_uring_backend(ThreadPool& pool, unsigned queue_depth) {
+  io_uring_params params;
+  std::memset(&params, 0, sizeof params);
+  const int fd = sys_setup(queue_depth == 0 ? 1 : queue_depth, &params);
+  if (fd < 0) return nullptr;
+  auto backend = std::make_unique<UringBackend>(pool, fd);
+  if (!backend->init(params)) return nullptr;
+  return backend;
+}
+
+}  // namespace tcc::io::detail
@@ -0,0 +1,229 @@
+#include "tcc/mapped_file.hpp"
+
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "tcc/huge_pages.hpp"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+namespace tcc {
+
+namespace {
+
+#if defined(_WIN32)
+
+[[noreturn]] void throw_last_error(const char* what, const std::filesystem::path& path) {
+  throw std::system_error(static_cast<int>(GetLastError()), std::system_category(),
+                          std::string(what) + " " + path.string());
+}
+
+#else
+
+[[noreturn]] void throw_errno(const char* what, const std::filesystem::path& path) {
+  throw std::system_error(errno, std::generic_category(), std::string(what) + " " + path.string());
+}
+
+// Closes the descriptor on every path out of the constructor; the mapping
+// keeps its own reference to the file.
+struct FdGuard {
+  int fd;
+  ~FdGuard() {
+    if (fd >= 0) ::close(fd);
+  }
+};
+
+#endif
+
+std::size_t page_size() noexcept {
+#if defined(_WIN32)
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwPageSize;
+#else
+  static const auto size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  return size;
+#endif
+}
+
+}  // namespace
+
+MappedFile::MappedFile(const std::filesystem::path& path, Advice advice) {
+#if defined(_WIN32)
+  HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) throw_last_error("open", path);
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size)) {
+    CloseHandle(file);
+    throw_last_error("stat", path);
+  }
+  if (size.QuadPart > 0) {
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+      CloseHandle(file);
+      throw_last_error("map", path);
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+      CloseHandle(mapping);
+      CloseHandle(file);
+      throw_last_error("map", path);
+    }
+    mapping_ = mapping;
+    data_ = static_cast<const std::byte*>(view);
+    size_ = static_cast<std::size_t>(size.QuadPart);
+  }
+  CloseHandle(file);
+#else
+  FdGuard fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+  if (fd.fd < 0) throw_errno("open", path);
+  struct stat st;
+  if (::fstat(fd.fd, &st) != 0) throw_errno("stat", path);
+  const auto size = static_cast<std::size_t>(st.st_size);
+  if (size > 0) {
+    int flags = MAP_PRIVATE;
+#if defined(MAP_POPULATE)
+    // Faulting the whole file in with one call is far cheaper than taking a
+    // page fault every 4 KiB during the scan.
+    if (has_advice(advice, Advice::willneed)) flags |= MAP_POPULATE;
+#endif
+    void* addr = ::mmap(nullptr, size, PROT_READ, flags, fd.fd, 0);
+    if (addr == MAP_FAILED) throw_errno("mmap", path);
+    data_ = static_cast<const std::byte*>(addr);
+    size_ = size;
+  }
+#endif
+  open_ = true;
+  if (advice != Advice::normal) advise(advice);
+}
+
+#if defined(__linux__)
+
+MappedFile::MappedFile(const std::filesystem::path& path, Advice advice, const HugePageOptions& pages) {
+  FdGuard fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+  if (fd.fd < 0) throw_errno("open", path);
+  struct stat st;
+  if (::fstat(fd.fd, &st) != 0) throw_errno("stat", path);
+  const auto size = static_cast<std::size_t>(st.st_size);
+  if (size > 0) {
+    const detail::PageMapping mapping = detail::map_pages(size, pages);
+    auto* dst = static_cast<char*>(mapping.data);
+    for (std::size_t done = 0; done < size;) {
+      const ::ssize_t n = ::pread(fd.fd, dst + done, size - done, static_cast<::off_t>(done));
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) {
+        const int err = n == 0 ? EIO : errno;  // the file shrank under us
+        detail::unmap_pages(mapping);
+        throw std::system_error(err, std::generic_category(), "read " + path.string());
+      }
+      done += static_cast<std::size_t>(n);
+    }
+    ::mprotect(mapping.data, mapping.length, PROT_READ);
+    data_ = static_cast<const std::byte*>(mapping.data);
+    size_ = size;
+    anonymous_length_ = mapping.length;
+  }
+  open_ = true;
+  if (advice != Advice::normal) advise(advice);
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path& path, Advice advice, const HugePageOptions&)
+    : MappedFile(path, advice) {}
+
+#endif
+
+MappedFile::~MappedFile() { close(); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      anonymous_length_(std::exchange(other.anonymous_length_, 0)),
+      open_(std::exchange(other.open_, false))
+#if defined(_WIN32)
+      ,
+      mapping_(std::exchange(other.mapping_, nullptr))
+#endif
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    close();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    anonymous_length_ = std::exchange(other.anonymous_length_, 0);
+    open_ = std::exchange(other.open_, false);
+#if defined(_WIN32)
+    mapping_ = std::exchange(other.mapping_, nullptr);
+#endif
+  }
+  return *this;
+}
+
+bool MappedFile::advise(Advice advice, std::size_t offset, std::size_t length) noexcept {
+  if (data_ == nullptr || offset >= size_) return advice == Advice::normal;
+  if (length > size_ - offset) length = size_ - offset;
+  // The mapping itself is page-aligned; only the offset needs rounding down.
+  const std::size_t page = page_size();
+  const std::size_t begin = offset & ~(page - 1);
+  length += offset - begin;
+  auto* addr = const_cast<std::byte*>(data_) + begin;
+
+#if defined(_WIN32)
+  if (!has_advice(advice, Advice::willneed)) return true;
+  WIN32_MEMORY_RANGE_ENTRY range{addr, length};
+  return PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0) != 0;
+#else
+  if (advice == Advice::normal) return ::madvise(addr, length, MADV_NORMAL) == 0;
+  bool any_ok = false;
+  const auto apply = [&](Advice flag, int native) {
+    if (has_advice(advice, flag)) any_ok |= ::madvise(addr, length, native) == 0;
+  };
+  apply(Advice::sequential, MADV_SEQUENTIAL);
+  apply(Advice::random, MADV_RANDOM);
+  apply(Advice::willneed, MADV_WILLNEED);
+#if defined(MADV_HUGEPAGE)
+  apply(Advice::hugepage, MADV_HUGEPAGE);
+#endif
+  return any_ok;
+#endif
+}
+
+void MappedFile::close() noexcept {
+#if defined(_WIN32)
+  if (data_ != nullptr) UnmapViewOfFile(data_);
+  if (mapping_ != nullptr) CloseHandle(mapping_);
+  mapping_ = nullptr;
+#else
+  if (anonymous_length_ != 0) {
+    detail::unmap_pages({const_cast<std::byte*>(data_), anonymous_length_});
+  } else if (data_ != nullptr) {
+    ::munmap(const_cast<std::byte*>(data_), size_);
+  }
+#endif
+  data_ = nullptr;
+  size_ = 0;
+  anonymous_length_ = 0;
+  open_ = false;
+}
+
+}  // namespace tcc
@@ -0,0 +1,252 @@
+#include "tcc/metrics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "tcc/startup.hpp"
+
+namespace tcc::metrics {
+
+namespace detail {
+
+std::size_t assign_slot() noexcept {
+  static std::atomic<std::size_t> next{0};
+  tls_slot = next.fetch_add(1, std::memory_order_relaxed) & (kNoSlot >> 1);
+  return tls_slot;
+}
+
+}  // namespace detail
+
+namespace {
+
+constexpr std::size_t kMaxCounterShards = 64;
+constexpr std::size_t kMaxHistogramShards = 8;
+
+bool valid_name(std::string_view name, bool allow_colon) {
+  if (name.empty()) return false;
+  for (std::size_t i = 0; i < name.size(); ++i) {
+    const char c = name[i];
+    const bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || (allow_colon && c == ':');
+    if (!alpha && !(i > 0 && c >= '0' && c <= '9')) return false;
+  }
+  return true;
+}
+
+void append_escaped(std::string& out, std::string_view s, bool quote) {
+  for (const char c : s) {
+    if (c == '\\') {
+      out.append("\\\\");
+    } else if (c == '\n') {
+      out.append("\\n");
+    } else if (quote && c == '"') {
+      out.append("\\\"");
+    } else {
+      out.push_back(c);
+    }
+  }
+}
+
+std::string render_labels(const Labels& labels) {
+  if (labels.empty()) return {};
+  std::string out = "{";
+  for (const auto& [name, value] : labels) {
+    if (!valid_name(name, false) || name.starts_with("__")) {
+      throw std::invalid_argument("tcc::metrics: invalid label name '" + name + "'");
+    }
+    if (name == "le") throw std::invalid_argument("tcc::metrics: label 'le' is reserved");
+    if (out.size() > 1) out.push_back(',');
+    out.append(name);
+    out.append("=\"");
+    append_escaped(out, value, true);
+    out.push_back('"');
+  }
+  out.push_back('}');
+  return out;
+}
+
+/// `labels` ({a="b"} or empty) with one more label appended.
+std::string with_label(const std::string& labels, const char* name, const std::string& value) {
+  std::string out = labels.empty() ? std::string("{") : labels.substr(0, labels.size() - 1) + ",";
+  out.append(name);
+  out.append("=\"");
+  out.append(value);
+  out.append("\"}");
+  return out;
+}
+
+std::string format_double(double v) {
+  if (std::isnan(v)) return "NaN";
+  if (std::isinf(v)) return v > 0 ? "+Inf" : "-Inf";
+  char buf[32];
+  const auto result = std::to_chars(buf, buf + sizeof buf, v);  // shortest round-trip form
+  return std::string(buf, result.ptr);
+}
+
+void check_options(const HistogramOptions& o) {
+  if (o.min_exponent > o.max_exponent || o.max_exponent > 63) {
+    throw std::invalid_argument("tcc::metrics: histogram exponents must satisfy min <= max <= 63");
+  }
+}
+
+std::size_t round_shards(std::size_t n, std::size_t limit) {
+  return std::bit_ceil(std::clamp<std::size_t>(n, 1, limit));
+}
+
+}  // namespace
+
+// --- Counter ----------------------------------------------------------------
+
+Counter::Counter(std::size_t shards)
+    : shards_(std::make_unique<detail::Padded<std::uint64_t>[]>(round_shards(shards, kMaxCounterShards))),
+      mask_(round_shards(shards, kMaxCounterShards) - 1) {}
+
+std::uint64_t Counter::value() const noexcept {
+  std::uint64_t total = 0;
+  for (std::size_t i = 0; i <= mask_; ++i) total += shards_[i].value.load(std::memory_order_relaxed);
+  return total;
+}
+
+// --- Histogram --------------------------------------------------------------
+
+Histogram::Histogram(std::size_t shards, HistogramOptions options)
+    : shards_(std::make_unique<Shard[]>(round_shards(shards, kMaxHistogramShards))),
+      mask_(round_shards(shards, kMaxHistogramShards) - 1),
+      options_(options) {
+  check_options(options_);
+}
+
+Histogram::Snapshot Histogram::snapshot() const noexcept {
+  Snapshot s;
+  for (std::size_t shard = 0; shard <= mask_; ++shard) {
+    const Shard& src = shards_[shard];
+    for (std::size_t i = 0; i < kBucketCount; ++i) s.buckets[i] += src.buckets[i].load(std::memory_order_relaxed);
+    s.sum += src.sum.load(std::memory_order_relaxed);
+  }
+  for (const std::uint64_t n : s.buckets) s.count += n;
+  return s;
+}
+
+std::uint64_t Histogram::Snapshot::quantile(double q) const noexcept {
+  if (count == 0) return 0;
+  const double clamped = std::clamp(q, 0.0, 1.0);
+  const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(clamped * static_cast<double>(count))));
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < kBucketCount; ++i) {
+    seen += buckets[i];
+    if (seen >= rank) return i + 1 < kBucketCount ? bucket_lower(i + 1) - 1 : UINT64_MAX;
+  }
+  return UINT64_MAX;
+}
+
+// --- Registry ---------------------------------------------------------------
+
+Registry::Registry(std::size_t shards)
+    : shards_(shards != 0 ? shards : std::max<std::size_t>(1, std::thread::hardware_concurrency())) {}
+
+Registry& Registry::global() {
+  static Registry registry = [] {
+    startup::Phase phase("metrics: global registry");
+    return Registry();
+  }();
+  return registry;
+}
+
+Registry::Series& Registry::series(std::string_view name, std::string_view help, const Labels& labels, Type type) {
+  if (!valid_name(name, true)) {
+    throw std::invalid_argument("tcc::metrics: invalid metric name '" + std::string(name) + "'");
+  }
+  std::string rendered = render_labels(labels);
+  auto it = families_.find(name);
+  if (it == families_.end()) it = families_.emplace(std::string(name), Family{type, std::string(help), {}}).first;
+  Family& family = it->second;
+  if (family.type != type) {
+    throw std::invalid_argument("tcc::metrics: '" + std::string(name) + "' is registered with another type");
+  }
+  for (Series& s : family.series) {
+    if (s.labels == rendered) return s;
+  }
+  Series& s = family.series.emplace_back();
+  s.labels = std::move(rendered);
+  return s;
+}
+
+Counter& Registry::counter(std::string_view name, std::string_view help, const Labels& labels) {
+  std::lock_guard lock(mutex_);
+  Series& s = series(name, help, labels, Type::counter);
+  if (!s.counter) s.counter = std::make_unique<Counter>(shards_);
+  return *s.counter;
+}
+
+Gauge& Registry::gauge(std::string_view name, std::string_view help, const Labels& labels) {
+  std::lock_guard lock(mutex_);
+  Series& s = series(name, help, labels, Type::gauge);
+  if (!s.gauge) s.gauge = std::make_unique<Gauge>();
+  return *s.gauge;
+}
+
+Histogram& Registry::histogram(std::string_view name, std::string_view help, const Labels& labels,
+                               HistogramOptions options) {
+  check_options(options);
+  std::lock_guard lock(mutex_);
+  Series& s = series(name, help, labels, Type::histogram);
+  if (!s.histogram) s.histogram = std::make_unique<Histogram>(shards_, options);
+  return *s.histogram;
+}
+
+void Registry::write_prometheus(std::ostream& out) const {
+  std::string text;
+  std::unique_lock lock(mutex_);
+  for (const auto& [name, family] : families_) {
+    text.append("# HELP ").append(name).push_back(' ');
+    append_escaped(text, family.help, false);
+    text.append("\n# TYPE ").append(name);
+    text.append(family.type == Type::counter ? " counter\n" : family.type == Type::gauge ? " gauge\n" : " histogram\n");
+    for (const Series& s : family.series) {
+      switch (family.type) {
+        case Type::counter:
+          text.append(name).append(s.labels).append(" ").append(std::to_string(s.counter->value())).push_back('\n');
+          break;
+        case Type::gauge:
+          text.append(name).append(s.labels).append(" ").append(format_double(s.gauge->value())).push_back('\n');
+          break;
+        case Type::histogram: {
+          const HistogramOptions& o = s.histogram->options();
+          const Histogram::Snapshot snap = s.histogram->snapshot();
+          // Buckets are log-linear, so every power of two is a bucket edge
+          // and the cumulative count below it is exact.
+          std::size_t next = 0;
+          std::uint64_t cumulative = 0;
+          for (unsigned e = o.min_exponent; e <= o.max_exponent; ++e) {
+            const std::size_t edge = Histogram::bucket_of(std::uint64_t{1} << e);
+            for (; next < edge; ++next) cumulative += snap.buckets[next];
+            const double bound = std::ldexp(1.0, static_cast<int>(e)) * o.scale;
+            text.append(name).append("_bucket").append(with_label(s.labels, "le", format_double(bound)));
+            text.append(" ").append(std::to_string(cumulative)).push_back('\n');
+          }
+          text.append(name).append("_bucket").append(with_label(s.labels, "le", "+Inf"));
+          text.append(" ").append(std::to_string(snap.count)).push_back('\n');
+          text.append(name).append("_sum").append(s.labels).append(" ");
+          text.append(format_double(static_cast<double>(snap.sum) * o.scale)).push_back('\n');
+          text.append(name).append("_count").append(s.labels).append(" ");
+          text.append(std::to_string(snap.count)).push_back('\n');
+          break;
+        }
+      }
+    }
+  }
+  lock.unlock();
+  out << text;
+}
+
+std::string Registry::prometheus_text() const {
+  std::ostringstream out;
+  write_prometheus(out);
+  return std::move(out).str();
+}
+
+}  // namespace tcc::metrics
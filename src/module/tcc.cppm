@@ -0,0 +1,267 @@
+// Named module `tcc` over the public headers (TCC_USE_MODULES=ON).
+//
+//   import tcc;
+//   tcc::ThreadPool pool;
+//   tcc::FlatHashMap<std::string, int> counts;
+//
+// The headers stay the source of truth: they are included in the global
+// module fragment and their public names are re-exported here, so the
+// module and #include users see the same entities and can be mixed in one
+// program. Macros cannot cross a module boundary; include tcc/trace.hpp
+// for TCC_TRACE_SCOPE and friends. Names in `detail` namespaces are not
+// exported.
+
+module;
+
+#include "tcc/arena.hpp"
+#include "tcc/concurrent_cache.hpp"
+#include "tcc/coro.hpp"
+#include "tcc/external_sort.hpp"
+#include "tcc/flat_hash_map.hpp"
+#include "tcc/huge_pages.hpp"
+#include "tcc/mapped_file.hpp"
+#include "tcc/metrics.hpp"
+#include "tcc/mpmc_ring.hpp"
+#include "tcc/numa.hpp"
+#include "tcc/pipeline.hpp"
+#include "tcc/platform.hpp"
+#include "tcc/simd.hpp"
+#include "tcc/soa_vector.hpp"
+#include "tcc/spsc_ring.hpp"
+#include "tcc/startup.hpp"
+#include "tcc/static_dispatch.hpp"
+#include "tcc/thread_pool.hpp"
+#include "tcc/trace.hpp"
+#include "tcc/version.hpp"
+#include "tcc/wire.hpp"
+#include "tcc/work_stealing_deque.hpp"
+#if TCC_MODULE_HAVE_COMPRESSION
+#include "tcc/compression.hpp"
+#endif
+#if TCC_MODULE_HAVE_IO
+#include "tcc/io_await.hpp"
+#include "tcc/io_ring.hpp"
+#endif
+
+export module tcc;
+
+export namespace tcc {
+
+// --- Core -------------------------------------------------------------------
+
+using tcc::build_info;
+using tcc::cpu_relax;
+using tcc::kCacheLineSize;
+using tcc::version;
+
+// --- Memory -----------------------------------------------------------------
+
+using tcc::Arena;
+using tcc::ArenaResource;
+using tcc::FixedPool;
+using tcc::GranularResource;
+using tcc::huge_page_size;
+using tcc::HugePageOptions;
+using tcc::HugePageResource;
+using tcc::page_backing;
+using tcc::PageBacking;
+using tcc::PagePolicy;
+using tcc::pool_delete;
+using tcc::pool_new;
+using tcc::system_huge_pages;
+using tcc::SystemHugePages;
+using tcc::thread_local_pool;
+
+// --- Containers -------------------------------------------------------------
+
+using tcc::CacheOptions;
+using tcc::ChaseLevDeque;
+using tcc::ConcurrentCache;
+using tcc::FlatHash;
+using tcc::FlatHashMap;
+using tcc::MpmcRing;
+using tcc::SoaVector;
+using tcc::SpscRing;
+using tcc::UnitWeight;
+
+// --- Static dispatch --------------------------------------------------------
+
+using tcc::BatchPolicy;
+using tcc::crc32;
+using tcc::make_table;
+using tcc::StaticDispatch;
+using tcc::variant_from_index;
+using tcc::with_constant;
+
+// --- Sorting ----------------------------------------------------------------
+
+using tcc::external_sort;
+using tcc::ExternalSortOptions;
+using tcc::ExternalSortStats;
+using tcc::IdentityKey;
+using tcc::radix_sort;
+
+// --- Concurrency ------------------------------------------------------------
+
+using tcc::Affinity;
+using tcc::Generator;
+using tcc::IndexRange;
+using tcc::Job;
+using tcc::parallel_for;
+using tcc::parallel_reduce;
+using tcc::schedule;
+using tcc::ScheduleAwaiter;
+using tcc::spawn;
+using tcc::sync_wait;
+using tcc::Task;
+using tcc::ThreadPool;
+using tcc::ThreadPoolOptions;
+
+// --- Pipelines --------------------------------------------------------------
+
+using tcc::Pipeline;
+using tcc::PipelineOptions;
+using tcc::PipelineStage;
+using tcc::StageOptions;
+using tcc::StageStats;
+
+// --- Files ------------------------------------------------------------------
+
+using tcc::Advice;
+using tcc::has_advice;
+using tcc::lines;
+using tcc::LineRange;
+using tcc::MappedFile;
+using tcc::operator|;
+using tcc::RecordRange;
+using tcc::records;
+
+#if TCC_MODULE_HAVE_COMPRESSION
+using tcc::ByteSource;
+using tcc::Codec;
+using tcc::codec_available;
+using tcc::CompressionError;
+using tcc::CompressOptions;
+using tcc::CompressStream;
+using tcc::DecompressStream;
+using tcc::FrameReader;
+using tcc::span_source;
+#endif
+
+}  // namespace tcc
+
+export namespace tcc::soa {
+using tcc::soa::ConstRef;
+using tcc::soa::ConstSpan;
+using tcc::soa::Ref;
+using tcc::soa::Span;
+using tcc::soa::Tag;
+using tcc::soa::Value;
+}  // namespace tcc::soa
+
+export namespace tcc::simd {
+using tcc::simd::active_isa;
+using tcc::simd::active_kernels;
+using tcc::simd::count_byte;
+using tcc::simd::detected_isa;
+using tcc::simd::dot;
+using tcc::simd::find_byte;
+using tcc::simd::Isa;
+using tcc::simd::isa_name;
+using tcc::simd::Kernels;
+using tcc::simd::kernels;
+using tcc::simd::max;
+using tcc::simd::min;
+using tcc::simd::npos;
+using tcc::simd::prefix_sum;
+using tcc::simd::set_active_isa;
+using tcc::simd::sum;
+using tcc::simd::supported_isas;
+}  // namespace tcc::simd
+
+export namespace tcc::numa {
+using tcc::numa::current_node;
+using tcc::numa::local_resource;
+using tcc::numa::Node;
+using tcc::numa::node_resource;
+using tcc::numa::NodeResource;
+using tcc::numa::pin_current_thread;
+using tcc::numa::Placement;
+using tcc::numa::Topology;
+using tcc::numa::topology;
+}  // namespace tcc::numa
+
+export namespace tcc::wire {
+using tcc::wire::Builder;
+using tcc::wire::Error;
+using tcc::wire::Field;
+using tcc::wire::FixedString;
+using tcc::wire::root;
+using tcc::wire::root_unchecked;
+using tcc::wire::Schema;
+using tcc::wire::String;
+using tcc::wire::StringRef;
+using tcc::wire::Table;
+using tcc::wire::TableRef;
+using tcc::wire::TableVectorView;
+using tcc::wire::Vector;
+using tcc::wire::VectorRef;
+using tcc::wire::VectorView;
+using tcc::wire::View;
+}  // namespace tcc::wire
+
+export namespace tcc::metrics {
+using tcc::metrics::Counter;
+using tcc::metrics::Gauge;
+using tcc::metrics::Histogram;
+using tcc::metrics::HistogramOptions;
+using tcc::metrics::Labels;
+using tcc::metrics::Registry;
+using tcc::metrics::ScopedTimer;
+}  // namespace tcc::metrics
+
+export namespace tcc::trace {
+using tcc::trace::complete;
+using tcc::trace::dropped_events;
+using tcc::trace::enabled;
+using tcc::trace::flush;
+using tcc::trace::Options;
+using tcc::trace::set_thread_name;
+using tcc::trace::start;
+using tcc::trace::stop;
+#if TCC_TRACING
+using tcc::trace::counter;
+using tcc::trace::instant;
+using tcc::trace::Scope;
+#endif
+}  // namespace tcc::trace
+
+export namespace tcc::startup {
+using tcc::startup::enabled;
+using tcc::startup::main_entered;
+using tcc::startup::Phase;
+using tcc::startup::phases;
+using tcc::startup::PhaseTiming;
+using tcc::startup::write_trace;
+}  // namespace tcc::startup
+
+#if TCC_MODULE_HAVE_IO
+export namespace tcc::io {
+using tcc::io::async_fsync;
+using tcc::io::async_read;
+using tcc::io::async_read_fixed;
+using tcc::io::async_recv;
+using tcc::io::async_send;
+using tcc::io::async_write;
+using tcc::io::async_write_fixed;
+using tcc::io::backend_name;
+using tcc::io::BackendKind;
+using tcc::io::Callback;
+using tcc::io::FileRef;
+using tcc::io::FixedFile;
+using tcc::io::io_uring_supported;
+using tcc::io::Ring;
+using tcc::io::RingOptions;
+using tcc::io::sleep_for;
+}  // namespace tcc::io
+#endif
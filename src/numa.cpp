@@ -0,0 +1,221 @@
+#include "tcc/numa.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+
+#include "tcc/startup.hpp"
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace tcc::numa {
+
+namespace {
+
+#if defined(__linux__)
+
+// Large enough for any machine sysfs will describe; CPU_ALLOC sizes the mask.
+constexpr int kMaxCpus = 8192;
+constexpr int kMaxNodes = 1024;
+
+/// Parses a sysfs CPU list such as "0-3,8,10-11".
+std::vector<int> parse_cpu_list(const std::string& text) {
+  std::vector<int> cpus;
+  std::size_t pos = 0;
+  while (pos < text.size()) {
+    std::size_t end = text.find(',', pos);
+    if (end == std::string::npos) end = text.size();
+    const std::string item = text.substr(pos, end - pos);
+    pos = end + 1;
+    if (item.empty() || item[0] < '0' || item[0] > '9') continue;
+    const std::size_t dash = item.find('-');
+    const int lo = std::stoi(item.substr(0, dash));
+    const int hi = dash == std::string::npos ? lo : std::stoi(item.substr(dash + 1));
+    for (int c = lo; c <= hi && c < kMaxCpus; ++c) cpus.push_back(c);
+  }
+  return cpus;
+}
+
+/// CPUs the process may run on, or empty when the kernel does not say.
+std::vector<int> allowed_cpus() {
+  cpu_set_t* set = CPU_ALLOC(kMaxCpus);
+  const std::size_t size = CPU_ALLOC_SIZE(kMaxCpus);
+  std::vector<int> cpus;
+  if (set != nullptr && sched_getaffinity(0, size, set) == 0) {
+    for (int c = 0; c < kMaxCpus; ++c) {
+      if (CPU_ISSET_S(c, size, set)) cpus.push_back(c);
+    }
+  }
+  CPU_FREE(set);
+  return cpus;
+}
+
+Topology detect() {
+  const std::vector<int> allowed = allowed_cpus();
+  Topology topo;
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", ec)) {
+    const std::string name = entry.path().filename().string();
+    if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+        !std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+      continue;
+    }
+    std::ifstream in(entry.path() / "cpulist");
+    std::string list;
+    std::getline(in, list);
+    Node node{std::stoi(name.substr(4)), {}};
+    for (int c : parse_cpu_list(list)) {
+      if (allowed.empty() || std::binary_search(allowed.begin(), allowed.end(), c)) node.cpus.push_back(c);
+    }
+    if (!node.cpus.empty()) topo.nodes.push_back(std::move(node));
+  }
+  std::sort(topo.nodes.begin(), topo.nodes.end(), [](const Node& a, const Node& b) { return a.id < b.id; });
+  if (topo.nodes.empty()) topo.nodes.push_back({0, allowed});
+  return topo;
+}
+
+std::size_t page_size() noexcept {
+  static const auto size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  return size;
+}
+
+std::size_t round_to_pages(std::size_t bytes) noexcept {
+  const std::size_t page = page_size();
+  return (std::max<std::size_t>(bytes, 1) + page - 1) / page * page;
+}
+
+#else
+
+Topology detect() {
+  Node node{0, {}};
+  const unsigned n = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned c = 0; c < n; ++c) node.cpus.push_back(static_cast<int>(c));
+  return Topology{{std::move(node)}};
+}
+
+#endif
+
+}  // namespace
+
+const Topology& topology() {
+  static const Topology topo = [] {
+    startup::Phase phase("numa: topology");
+    Topology t = detect();
+    if (t.nodes.front().cpus.empty()) {
+      const unsigned n = std::max(1u, std::thread::hardware_concurrency());
+      for (unsigned c = 0; c < n; ++c) t.nodes.front().cpus.push_back(static_cast<int>(c));
+    }
+    return t;
+  }();
+  return topo;
+}
+
+int current_node() noexcept {
+#if defined(__linux__)
+  unsigned cpu = 0, node = 0;
+  if (::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) return static_cast<int>(node);
+#endif
+  return 0;
+}
+
+bool pin_current_thread(const std::vector<int>& cpus) noexcept {
+#if defined(__linux__)
+  if (cpus.empty()) return false;
+  cpu_set_t* set = CPU_ALLOC(kMaxCpus);
+  if (set == nullptr) return false;
+  const std::size_t size = CPU_ALLOC_SIZE(kMaxCpus);
+  CPU_ZERO_S(size, set);
+  for (int c : cpus) {
+    if (c >= 0 && c < kMaxCpus) CPU_SET_S(c, size, set);
+  }
+  const bool ok = sched_setaffinity(0, size, set) == 0;
+  CPU_FREE(set);
+  return ok;
+#else
+  (void)cpus;
+  return false;
+#endif
+}
+
+// --- NodeResource -----------------------------------------------------------
+
+void* NodeResource::do_allocate(std::size_t bytes, std::size_t align) {
+#if defined(__linux__)
+  if (align > page_size()) throw std::bad_alloc();
+  const std::size_t length = round_to_pages(bytes);
+  void* p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) throw std::bad_alloc();
+  if (placement_ != Placement::first_touch && node_ >= 0 && node_ < kMaxNodes) {
+    constexpr std::size_t kBits = 8 * sizeof(unsigned long);
+    unsigned long mask[kMaxNodes / kBits] = {};
+    mask[static_cast<std::size_t>(node_) / kBits] = 1ul << (static_cast<std::size_t>(node_) % kBits);
+    const int mode = placement_ == Placement::bind ? MPOL_BIND : MPOL_PREFERRED;
+    // maxnode counts one past the highest bit the kernel should read.
+    const long rc = ::syscall(SYS_mbind, p, length, mode, mask, static_cast<unsigned long>(kMaxNodes) + 1, 0u);
+    if (rc != 0 && placement_ == Placement::bind) {
+      ::munmap(p, length);
+      throw std::bad_alloc();
+    }
+  }
+  return p;
+#else
+  return std::pmr::new_delete_resource()->allocate(bytes, align);
+#endif
+}
+
+void NodeResource::do_deallocate(void* p, std::size_t bytes, std::size_t align) {
+#if defined(__linux__)
+  (void)align;
+  ::munmap(p, round_to_pages(bytes));
+#else
+  std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+#endif
+}
+
+std::size_t NodeResource::granularity() const noexcept {
+#if defined(__linux__)
+  return page_size();
+#else
+  return 1;
+#endif
+}
+
+bool NodeResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+  // Pages are returned with munmap, so any NodeResource can free them.
+  return dynamic_cast<const NodeResource*>(&other) != nullptr;
+}
+
+NodeResource& node_resource(int node) {
+  static std::mutex mutex;
+  static auto* resources = new std::map<int, std::unique_ptr<NodeResource>>();  // leaked: outlives every arena
+  std::lock_guard lock(mutex);
+  auto& slot = (*resources)[node];
+  if (!slot) slot = std::make_unique<NodeResource>(node);
+  return *slot;
+}
+
+NodeResource& local_resource() {
+  thread_local int cached_node = -1;
+  thread_local NodeResource* cached = nullptr;
+  const int node = current_node();
+  if (node != cached_node) {
+    cached = &node_resource(node);
+    cached_node = node;
+  }
+  return *cached;
+}
+
+}  // namespace tcc::numa
@@ -0,0 +1,32 @@
+#pragma once
+
+// extern "C" declarations of rust/src/lib.rs. Keep the two in sync; the
+// layouts are checked in interop.cpp.
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C" {
+
+struct TccSlice {
+  const std::uint8_t* ptr;
+  std::size_t len;
+};
+
+struct TccRustBuf {
+  std::uint8_t* ptr;
+  std::size_t len;
+  std::size_t cap;
+};
+
+TccSlice tcc_rs_version() noexcept;
+std::uint64_t tcc_rs_fnv1a(TccSlice bytes) noexcept;
+std::size_t tcc_rs_split(TccSlice text, std::uint8_t delimiter, void (*on_field)(void*, TccSlice),
+                         void* ctx) noexcept;
+TccRustBuf tcc_rs_to_upper(TccSlice bytes) noexcept;
+TccRustBuf tcc_rs_buf_with_capacity(std::size_t capacity) noexcept;
+TccRustBuf tcc_rs_buf_reserve(TccRustBuf buf, std::size_t additional) noexcept;
+TccRustBuf tcc_rs_buf_append(TccRustBuf buf, TccSlice tail) noexcept;
+void tcc_rs_buf_free(TccRustBuf buf) noexcept;
+
+}  // extern "C"
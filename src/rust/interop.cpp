@@ -0,0 +1,90 @@
+#include "tcc/rust.hpp"
+
+#include <stdexcept>
+#include <type_traits>
+
+#include "ffi.hpp"
+
+namespace tcc::rust {
+
+static_assert(sizeof(std::byte) == sizeof(std::uint8_t));
+static_assert(std::is_standard_layout_v<TccSlice> && sizeof(TccSlice) == 2 * sizeof(std::size_t));
+static_assert(std::is_standard_layout_v<TccRustBuf> && sizeof(TccRustBuf) == 3 * sizeof(std::size_t));
+
+namespace {
+
+TccSlice slice(std::span<const std::byte> bytes) noexcept {
+  return {reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size()};
+}
+
+TccSlice slice(std::string_view text) noexcept {
+  return {reinterpret_cast<const std::uint8_t*>(text.data()), text.size()};
+}
+
+std::string_view view(TccSlice s) noexcept { return {reinterpret_cast<const char*>(s.ptr), s.len}; }
+
+struct SplitContext {
+  detail::FieldCallback on_field;
+  void* ctx;
+};
+
+void forward_field(void* ctx, TccSlice field) {
+  auto* split = static_cast<SplitContext*>(ctx);
+  split->on_field(split->ctx, view(field));
+}
+
+}  // namespace
+
+/// Converts between Buffer and the Vec parts Rust hands over.
+struct BufferAccess {
+  static Buffer adopt(TccRustBuf buf) noexcept {
+    return Buffer(reinterpret_cast<std::byte*>(buf.ptr), buf.len, buf.cap);
+  }
+
+  static TccRustBuf release(Buffer& buffer) noexcept {
+    TccRustBuf buf{reinterpret_cast<std::uint8_t*>(buffer.data_), buffer.size_, buffer.capacity_};
+    buffer.data_ = nullptr;
+    buffer.size_ = buffer.capacity_ = 0;
+    return buf;
+  }
+};
+
+// --- Buffer -----------------------------------------------------------------
+
+Buffer::~Buffer() {
+  if (data_ != nullptr) tcc_rs_buf_free(BufferAccess::release(*this));
+}
+
+Buffer Buffer::with_capacity(std::size_t capacity) {
+  return BufferAccess::adopt(tcc_rs_buf_with_capacity(capacity));
+}
+
+void Buffer::commit(std::size_t n) {
+  if (n > capacity_ - size_) throw std::length_error("tcc::rust::Buffer::commit: past capacity");
+  size_ += n;
+}
+
+void Buffer::reserve(std::size_t additional) {
+  if (capacity_ - size_ >= additional) return;
+  *this = BufferAccess::adopt(tcc_rs_buf_reserve(BufferAccess::release(*this), additional));
+}
+
+void Buffer::append(std::span<const std::byte> tail) {
+  if (tail.empty()) return;
+  *this = BufferAccess::adopt(tcc_rs_buf_append(BufferAccess::release(*this), slice(tail)));
+}
+
+// --- Free functions ---------------------------------------------------------
+
+std::string_view crate_version() noexcept { return view(tcc_rs_version()); }
+
+std::uint64_t fnv1a(std::span<const std::byte> bytes) noexcept { return tcc_rs_fnv1a(slice(bytes)); }
+
+Buffer to_upper(std::span<const std::byte> bytes) { return BufferAccess::adopt(tcc_rs_to_upper(slice(bytes))); }
+
+std::size_t detail::split(std::string_view text, char delimiter, FieldCallback on_field, void* ctx) noexcept {
+  SplitContext split{on_field, ctx};
+  return tcc_rs_split(slice(text), static_cast<std::uint8_t>(delimiter), forward_field, &split);
+}
+
+}  // namespace tcc::rust
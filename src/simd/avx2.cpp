@@ -0,0 +1,108 @@
+// AVX2 kernels (built with -mavx2 -mbmi -mbmi2). Two 8-wide accumulators
+// cover the 16 canonical lanes.
+
+#include <immintrin.h>
+
+#include "common.hpp"
+
+namespace tcc::simd::detail {
+
+namespace {
+
+template <class Op, class VecOp>
+float reduce(const float* data, std::size_t n, float init, Op op, VecOp vop) noexcept {
+  __m256 acc0 = _mm256_set1_ps(init);
+  __m256 acc1 = acc0;
+  std::size_t i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    acc0 = vop(acc0, _mm256_loadu_ps(data + i));
+    acc1 = vop(acc1, _mm256_loadu_ps(data + i + 8));
+  }
+  alignas(32) float lanes[kLanes];
+  _mm256_store_ps(lanes, acc0);
+  _mm256_store_ps(lanes + 8, acc1);
+  return fold_lanes(lanes, data + i, n - i, op);
+}
+
+float sum(const float* data, std::size_t n) noexcept {
+  return reduce(data, n, 0.0f, AddOp{}, [](__m256 a, __m256 x) { return _mm256_add_ps(a, x); });
+}
+float min(const float* data, std::size_t n) noexcept {
+  return reduce(data, n, kPosInf, MinOp{}, [](__m256 a, __m256 x) { return _mm256_min_ps(a, x); });
+}
+float max(const float* data, std::size_t n) noexcept {
+  return reduce(data, n, kNegInf, MaxOp{}, [](__m256 a, __m256 x) { return _mm256_max_ps(a, x); });
+}
+
+float dot(const float* a, const float* b, std::size_t n) noexcept {
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = acc0;
+  std::size_t i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+  }
+  alignas(32) float lanes[kLanes];
+  _mm256_store_ps(lanes, acc0);
+  _mm256_store_ps(lanes + 8, acc1);
+  return fold_dot(lanes, a + i, b + i, n - i);
+}
+
+std::size_t find_byte(const std::byte* data, std::size_t n, std::byte needle) noexcept {
+  const __m256i pattern = _mm256_set1_epi8(static_cast<char>(needle));
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, pattern)));
+    if (mask != 0) return i + ctz32(mask);
+  }
+  return find_byte_tail(data, i, n, needle);
+}
+
+std::size_t count_byte(const std::byte* data, std::size_t n, std::byte needle) noexcept {
+  const __m256i pattern = _mm256_set1_epi8(static_cast<char>(needle));
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i total = zero;
+  std::size_t i = 0;
+  while (i + 32 <= n) {
+    // Per-byte counters overflow after 255 blocks; widen before that.
+    __m256i acc = zero;
+    for (int blocks = 0; blocks < 255 && i + 32 <= n; ++blocks, i += 32) {
+      const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+      acc = _mm256_sub_epi8(acc, _mm256_cmpeq_epi8(block, pattern));
+    }
+    total = _mm256_add_epi64(total, _mm256_sad_epu8(acc, zero));
+  }
+  alignas(32) std::uint64_t parts[4];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(parts), total);
+  const auto count = static_cast<std::size_t>(parts[0] + parts[1] + parts[2] + parts[3]);
+  return count + count_byte_tail(data, i, n, needle);
+}
+
+void prefix_sum(const std::uint32_t* in, std::uint32_t* out, std::size_t n) noexcept {
+  const __m256i last = _mm256_set1_epi32(7);
+  __m256i carry = _mm256_setzero_si256();
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+    // Scan each 128-bit half, then add the low half's total to the high half.
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+    const __m256i low_total = _mm256_shuffle_epi32(x, 0xFF);
+    x = _mm256_add_epi32(x, _mm256_permute2x128_si256(low_total, low_total, 0x08));
+    x = _mm256_add_epi32(x, carry);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), x);
+    carry = _mm256_permutevar8x32_epi32(x, last);
+  }
+  auto running = static_cast<std::uint32_t>(_mm256_cvtsi256_si32(carry));
+  for (; i < n; ++i) {
+    running += in[i];
+    out[i] = running;
+  }
+}
+
+}  // namespace
+
+extern const Kernels kAvx2Kernels = {Isa::avx2, sum, min, max, dot, find_byte, count_byte, prefix_sum};
+
+}  // namespace tcc::simd::detail
@@ -0,0 +1,108 @@
+// AVX-512 kernels (built with -mavx512f -mavx512bw -mavx512vl -mbmi2). A single
+// 16-wide accumulator is exactly the canonical lane layout.
+
+// GCC 12's AVX-512 headers self-initialize their "undefined" vectors and
+// trip -Wuninitialized at every use (GCC PR 105593).
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include "common.hpp"
+
+namespace tcc::simd::detail {
+
+namespace {
+
+template <class Op, class VecOp>
+float reduce(const float* data, std::size_t n, float init, Op op, VecOp vop) noexcept {
+  __m512 acc = _mm512_set1_ps(init);
+  std::size_t i = 0;
+  for (; i + kLanes <= n; i += kLanes) acc = vop(acc, _mm512_loadu_ps(data + i));
+  alignas(64) float lanes[kLanes];
+  _mm512_store_ps(lanes, acc);
+  return fold_lanes(lanes, data + i, n - i, op);
+}
+
+float sum(const float* data, std::size_t n) noexcept {
+  return reduce(data, n, 0.0f, AddOp{}, [](__m512 a, __m512 x) { return _mm512_add_ps(a, x); });
+}
+float min(const float* data, std::size_t n) noexcept {
+  return reduce(data, n, kPosInf, MinOp{}, [](__m512 a, __m512 x) { return _mm512_min_ps(a, x); });
+}
+float max(const float* data, std::size_t n) noexcept {
+  return reduce(data, n, kNegInf, MaxOp{}, [](__m512 a, __m512 x) { return _mm512_max_ps(a, x); });
+}
+
+float dot(const float* a, const float* b, std::size_t n) noexcept {
+  __m512 acc = _mm512_setzero_ps();
+  std::size_t i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    acc = _mm512_add_ps(acc, _mm512_mul_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+  }
+  alignas(64) float lanes[kLanes];
+  _mm512_store_ps(lanes, acc);
+  return fold_dot(lanes, a + i, b + i, n - i);
+}
+
+std::size_t find_byte(const std::byte* data, std::size_t n, std::byte needle) noexcept {
+  const __m512i pattern = _mm512_set1_epi8(static_cast<char>(needle));
+  std::size_t i = 0;
+  for (; i + 64 <= n; i += 64) {
+    const __m512i block = _mm512_loadu_si512(data + i);
+    const std::uint64_t mask = _mm512_cmpeq_epi8_mask(block, pattern);
+    if (mask != 0) return i + ctz64(mask);
+  }
+  // Masked-off bytes are never read, so the tail cannot fault.
+  if (i < n) {
+    const __mmask64 live = _bzhi_u64(~0ULL, static_cast<unsigned>(n - i));
+    const std::uint64_t mask = _mm512_mask_cmpeq_epi8_mask(live, _mm512_maskz_loadu_epi8(live, data + i), pattern);
+    if (mask != 0) return i + ctz64(mask);
+  }
+  return npos;
+}
+
+std::size_t count_byte(const std::byte* data, std::size_t n, std::byte needle) noexcept {
+  const __m512i pattern = _mm512_set1_epi8(static_cast<char>(needle));
+  std::size_t count = 0;
+  std::size_t i = 0;
+  for (; i + 64 <= n; i += 64) {
+    const __m512i block = _mm512_loadu_si512(data + i);
+    count += static_cast<std::size_t>(__builtin_popcountll(_mm512_cmpeq_epi8_mask(block, pattern)));
+  }
+  return count + count_byte_tail(data, i, n, needle);
+}
+
+void prefix_sum(const std::uint32_t* in, std::uint32_t* out, std::size_t n) noexcept {
+  const __m512i zero = _mm512_setzero_si512();
+  const __m512i last = _mm512_set1_epi32(15);
+  __m512i carry = zero;
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m512i x = _mm512_loadu_si512(in + i);
+    // alignr(x, 0, 16 - k) shifts x up by k elements, filling with zeros.
+    x = _mm512_add_epi32(x, _mm512_alignr_epi32(x, zero, 15));
+    x = _mm512_add_epi32(x, _mm512_alignr_epi32(x, zero, 14));
+    x = _mm512_add_epi32(x, _mm512_alignr_epi32(x, zero, 12));
+    x = _mm512_add_epi32(x, _mm512_alignr_epi32(x, zero, 8));
+    x = _mm512_add_epi32(x, carry);
+    _mm512_storeu_si512(out + i, x);
+    carry = _mm512_permutexvar_epi32(last, x);
+  }
+  auto running = static_cast<std::uint32_t>(_mm_cvtsi128_si32(_mm512_castsi512_si128(carry)));
+  for (; i < n; ++i) {
+    running += in[i];
+    out[i] = running;
+  }
+}
+
+}  // namespace
+
+extern const Kernels kAvx512Kernels = {Isa::avx512, sum, min, max, dot, find_byte, count_byte, prefix_sum};
+
+}  // namespace tcc::simd::detail
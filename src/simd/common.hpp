@@ -0,0 +1,101 @@
+#pragma once
+
+// Shared by the per-ISA kernel translation units.
+//
+// Everything below has internal linkage on purpose. Each kernel TU is built
+// with different -m flags; an inline function with external linkage would
+// be emitted in each of them and the linker could keep the AVX-512 copy for
+// the scalar path. For the same reason the kernel TUs avoid inline helpers
+// from the standard library and use compiler builtins directly.
+
+#include <cstddef>
+#include <cstdint>
+
+#include "tcc/simd.hpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace tcc::simd::detail {
+
+extern const Kernels kScalarKernels;
+extern const Kernels kSse42Kernels;
+extern const Kernels kAvx2Kernels;
+extern const Kernels kAvx512Kernels;
+extern const Kernels kNeonKernels;
+
+namespace {
+
+/// Canonical lane count of every floating-point reduction. Element i of a
+/// block always lands in accumulator lane i % kLanes, whatever the vector
+/// width, which is what makes results identical across ISA levels.
+constexpr std::size_t kLanes = 16;
+
+struct AddOp {
+  float operator()(float acc, float x) const noexcept { return acc + x; }
+};
+// Same operand order as minps/maxps: on an unordered compare, x wins.
+struct MinOp {
+  float operator()(float acc, float x) const noexcept { return acc < x ? acc : x; }
+};
+struct MaxOp {
+  float operator()(float acc, float x) const noexcept { return acc > x ? acc : x; }
+};
+
+constexpr float kPosInf = __builtin_huge_valf();
+constexpr float kNegInf = -__builtin_huge_valf();
+
+/// Folds the partial block `tail[0..rem)` into lanes 0..rem-1, then folds the
+/// lanes pairwise (lane i with lane i + w for w = 8, 4, 2, 1).
+template <class Op>
+float fold_lanes(float* lanes, const float* tail, std::size_t rem, Op op) noexcept {
+  for (std::size_t i = 0; i < rem; ++i) lanes[i] = op(lanes[i], tail[i]);
+  for (std::size_t w = kLanes / 2; w >= 1; w /= 2) {
+    for (std::size_t i = 0; i < w; ++i) lanes[i] = op(lanes[i], lanes[i + w]);
+  }
+  return lanes[0];
+}
+
+inline float fold_dot(float* lanes, const float* a, const float* b, std::size_t rem) noexcept {
+  for (std::size_t i = 0; i < rem; ++i) lanes[i] = lanes[i] + a[i] * b[i];
+  const float* none = nullptr;
+  return fold_lanes(lanes, none, 0, AddOp{});
+}
+
+inline std::size_t find_byte_tail(const std::byte* data, std::size_t i, std::size_t n, std::byte needle) noexcept {
+  for (; i < n; ++i) {
+    if (data[i] == needle) return i;
+  }
+  return npos;
+}
+
+inline std::size_t count_byte_tail(const std::byte* data, std::size_t i, std::size_t n, std::byte needle) noexcept {
+  std::size_t count = 0;
+  for (; i < n; ++i) count += data[i] == needle;
+  return count;
+}
+
+inline unsigned ctz32(std::uint32_t v) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index;
+  _BitScanForward(&index, v);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(v));
+#endif
+}
+
+inline unsigned ctz64(std::uint64_t v) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index;
+  _BitScanForward64(&index, v);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctzll(v));
+#endif
+}
+
+}  // namespace
+
+}  // namespace tcc::simd::detail
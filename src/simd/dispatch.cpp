@@ -0,0 +1,134 @@
+#include "tcc/simd.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+#include "common.hpp"
+#include "tcc/startup.hpp"
+
+namespace tcc::simd {
+
+namespace {
+
+// Tables compiled into this binary, best first. Which ones exist is decided
+// by CMake from the target architecture and compiler.
+const Kernels* const kCompiled[] = {
+#if defined(TCC_SIMD_HAVE_AVX512)
+    &detail::kAvx512Kernels,
+#endif
+#if defined(TCC_SIMD_HAVE_AVX2)
+    &detail::kAvx2Kernels,
+#endif
+#if defined(TCC_SIMD_HAVE_SSE42)
+    &detail::kSse42Kernels,
+#endif
+#if defined(TCC_SIMD_HAVE_NEON)
+    &detail::kNeonKernels,
+#endif
+    &detail::kScalarKernels,
+};
+
+bool cpu_supports(Isa isa) noexcept {
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+  // May run before libgcc's own constructor has filled in the CPU model.
+  __builtin_cpu_init();
+  switch (isa) {
+    case Isa::scalar:
+      return true;
+    case Isa::sse42:
+      return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+    case Isa::avx2:
+      // Also checks that the OS saves the YMM state (XGETBV).
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi") &&
+             __builtin_cpu_supports("bmi2");
+    case Isa::avx512:
+      return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+             __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("bmi2");
+    case Isa::neon:
+      return false;
+  }
+  return false;
+#else
+  // AArch64 mandates Advanced SIMD; other targets only build scalar.
+  return isa == Isa::scalar || isa == Isa::neon;
+#endif
+}
+
+const Kernels* detect() noexcept {
+  for (const Kernels* table : kCompiled) {
+    if (cpu_supports(table->isa)) return table;
+  }
+  return &detail::kScalarKernels;
+}
+
+const Kernels* find_supported(Isa isa) {
+  for (const Kernels* table : kCompiled) {
+    if (table->isa == isa && cpu_supports(isa)) return table;
+  }
+  throw std::invalid_argument("tcc::simd: ISA level '" + std::string(isa_name(isa)) +
+                              "' is not supported on this CPU or not compiled in");
+}
+
+// Detected on first use, not by a static initializer: a process that never
+// calls a kernel never runs cpuid. nullptr until then.
+constinit std::atomic<const Kernels*> g_active{nullptr};
+
+const Kernels* detected() noexcept {
+  static const Kernels* const table = [] {
+    startup::Phase phase("simd: detect ISA");
+    return detect();
+  }();
+  return table;
+}
+
+const Kernels* resolve_active() noexcept {
+  const Kernels* expected = nullptr;
+  const Kernels* table = detected();
+  // A concurrent set_active_isa() wins.
+  if (!g_active.compare_exchange_strong(expected, table, std::memory_order_acq_rel)) return expected;
+  return table;
+}
+
+}  // namespace
+
+std::string_view isa_name(Isa isa) noexcept {
+  switch (isa) {
+    case Isa::scalar:
+      return "scalar";
+    case Isa::sse42:
+      return "sse42";
+    case Isa::avx2:
+      return "avx2";
+    case Isa::avx512:
+      return "avx512";
+    case Isa::neon:
+      return "neon";
+  }
+  return "unknown";
+}
+
+std::vector<Isa> supported_isas() {
+  std::vector<Isa> isas;
+  // kCompiled is best first; report from scalar upwards.
+  for (auto it = std::rbegin(kCompiled); it != std::rend(kCompiled); ++it) {
+    if (cpu_supports((*it)->isa)) isas.push_back((*it)->isa);
+  }
+  return isas;
+}
+
+Isa detected_isa() noexcept { return detected()->isa; }
+
+Isa active_isa() noexcept { return active_kernels().isa; }
+
+void set_active_isa(Isa isa) { g_active.store(find_supported(isa), std::memory_order_release); }
+
+const Kernels& kernels(Isa isa) { return *find_supported(isa); }
+
+const Kernels& active_kernels() noexcept {
+  const Kernels* table = g_active.load(std::memory_order_acquire);
+  if (table == nullptr) [[unlikely]] table = resolve_active();
+  return *table;
+}
+
+}  // namespace tcc::simd
@@ -0,0 +1,107 @@
+// NEON kernels (AArch64, where Advanced SIMD is always present). Four
+// 4-wide accumulators cover the 16 canonical lanes.
+
+#include <arm_neon.h>
+
+#include "common.hpp"
+
+namespace tcc::simd::detail {
+
+namespace {
+
+template <class Op, class VecOp>
+float reduce(const float* data, std::size_t n, float init, Op op, VecOp vop) noexcept {
+  float32x4_t acc[4];
+  for (float32x4_t& a : acc) a = vdupq_n_f32(init);
+  std::size_t i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    for (int k = 0; k < 4; ++k) acc[k] = vop(acc[k], vld1q_f32(data + i + 4 * k));
+  }
+  float lanes[kLanes];
+  for (int k = 0; k < 4; ++k) vst1q_f32(lanes + 4 * k, acc[k]);
+  return fold_lanes(lanes, data + i, n - i, op);
+}
+
+float sum(const float* data, std::size_t n) noexcept {
+  return reduce(data, n, 0.0f, AddOp{}, [](float32x4_t a, float32x4_t x) { return vaddq_f32(a, x); });
+}
+// vminq/vmaxq propagate NaN from either side; select explicitly to keep the
+// minps/maxps convention shared by every level.
+float min(const float* data, std::size_t n) noexcept {
+  return reduce(data, n, kPosInf, MinOp{},
+                [](float32x4_t a, float32x4_t x) { return vbslq_f32(vcltq_f32(a, x), a, x); });
+}
+float max(const float* data, std::size_t n) noexcept {
+  return reduce(data, n, kNegInf, MaxOp{},
+                [](float32x4_t a, float32x4_t x) { return vbslq_f32(vcgtq_f32(a, x), a, x); });
+}
+
+float dot(const float* a, const float* b, std::size_t n) noexcept {
+  float32x4_t acc[4];
+  for (float32x4_t& v : acc) v = vdupq_n_f32(0.0f);
+  std::size_t i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    for (int k = 0; k < 4; ++k) {
+      // vmul + vadd, not vfma: the fused form rounds differently.
+      acc[k] = vaddq_f32(acc[k], vmulq_f32(vld1q_f32(a + i + 4 * k), vld1q_f32(b + i + 4 * k)));
+    }
+  }
+  float lanes[kLanes];
+  for (int k = 0; k < 4; ++k) vst1q_f32(lanes + 4 * k, acc[k]);
+  return fold_dot(lanes, a + i, b + i, n - i);
+}
+
+std::size_t find_byte(const std::byte* data, std::size_t n, std::byte needle) noexcept {
+  const uint8x16_t pattern = vdupq_n_u8(static_cast<std::uint8_t>(needle));
+  const auto* bytes = reinterpret_cast<const std::uint8_t*>(data);
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const uint8x16_t eq = vceqq_u8(vld1q_u8(bytes + i), pattern);
+    // Narrow to 4 bits per byte so the match mask fits one 64-bit lane.
+    const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+    const std::uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+    if (mask != 0) return i + ctz64(mask) / 4;
+  }
+  return find_byte_tail(data, i, n, needle);
+}
+
+std::size_t count_byte(const std::byte* data, std::size_t n, std::byte needle) noexcept {
+  const uint8x16_t pattern = vdupq_n_u8(static_cast<std::uint8_t>(needle));
+  const auto* bytes = reinterpret_cast<const std::uint8_t*>(data);
+  std::size_t count = 0;
+  std::size_t i = 0;
+  while (i + 16 <= n) {
+    // Per-byte counters overflow after 255 blocks; widen before that.
+    uint8x16_t acc = vdupq_n_u8(0);
+    for (int blocks = 0; blocks < 255 && i + 16 <= n; ++blocks, i += 16) {
+      acc = vsubq_u8(acc, vceqq_u8(vld1q_u8(bytes + i), pattern));
+    }
+    count += vaddlvq_u8(acc);
+  }
+  return count + count_byte_tail(data, i, n, needle);
+}
+
+void prefix_sum(const std::uint32_t* in, std::uint32_t* out, std::size_t n) noexcept {
+  const uint32x4_t zero = vdupq_n_u32(0);
+  uint32x4_t carry = zero;
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    uint32x4_t x = vld1q_u32(in + i);
+    x = vaddq_u32(x, vextq_u32(zero, x, 3));
+    x = vaddq_u32(x, vextq_u32(zero, x, 2));
+    x = vaddq_u32(x, carry);
+    vst1q_u32(out + i, x);
+    carry = vdupq_laneq_u32(x, 3);
+  }
+  std::uint32_t running = vgetq_lane_u32(carry, 0);
+  for (; i < n; ++i) {
+    running += in[i];
+    out[i] = running;
+  }
+}
+
+}  // namespace
+
+extern const Kernels kNeonKernels = {Isa::neon, sum, min, max, dot, find_byte, count_byte, prefix_sum};
+
+}  // namespace tcc::simd::detail
@@ -0,0 +1,54 @@
+// Portable reference kernels. They follow the same lane layout as the
+// vector paths, so they double as the specification those must match.
+
+#include "common.hpp"
+
+namespace tcc::simd::detail {
+
+namespace {
+
+template <class Op>
+float reduce(const float* data, std::size_t n, float init, Op op) noexcept {
+  float lanes[kLanes];
+  for (float& lane : lanes) lane = init;
+  std::size_t i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    for (std::size_t l = 0; l < kLanes; ++l) lanes[l] = op(lanes[l], data[i + l]);
+  }
+  return fold_lanes(lanes, data + i, n - i, op);
+}
+
+float sum(const float* data, std::size_t n) noexcept { return reduce(data, n, 0.0f, AddOp{}); }
+float min(const float* data, std::size_t n) noexcept { return reduce(data, n, kPosInf, MinOp{}); }
+float max(const float* data, std::size_t n) noexcept { return reduce(data, n, kNegInf, MaxOp{}); }
+
+float dot(const float* a, const float* b, std::size_t n) noexcept {
+  float lanes[kLanes] = {};
+  std::size_t i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    for (std::size_t l = 0; l < kLanes; ++l) lanes[l] = lanes[l] + a[i + l] * b[i + l];
+  }
+  return fold_dot(lanes, a + i, b + i, n - i);
+}
+
+std::size_t find_byte(const std::byte* data, std::size_t n, std::byte needle) noexcept {
+  return find_byte_tail(data, 0, n, needle);
+}
+
+std::size_t count_byte(const std::byte* data, std::size_t n, std::byte needle) noexcept {
+  return count_byte_tail(data, 0, n, needle);
+}
+
+void prefix_sum(const std::uint32_t* in, std::uint32_t* out, std::size_t n) noexcept {
+  std::uint32_t running = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    running += in[i];
+    out[i] = running;
+  }
+}
+
+}  // namespace
+
+extern const Kernels kScalarKernels = {Isa::scalar, sum, min, max, dot, find_byte, count_byte, prefix_sum};
+
+}  // namespace tcc::simd::detail
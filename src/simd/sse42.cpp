@@ -0,0 +1,102 @@
+// SSE4.2 kernels (built with -msse4.2 -mpopcnt). Four 4-wide accumulators
+// cover the 16 canonical lanes.
+
+#include <immintrin.h>
+
+#include "common.hpp"
+
+namespace tcc::simd::detail {
+
+namespace {
+
+template <class Op, class VecOp>
+float reduce(const float* data, std::size_t n, float init, Op op, VecOp vop) noexcept {
+  __m128 acc[4];
+  for (__m128& a : acc) a = _mm_set1_ps(init);
+  std::size_t i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    for (int k = 0; k < 4; ++k) acc[k] = vop(acc[k], _mm_loadu_ps(data + i + 4 * k));
+  }
+  alignas(16) float lanes[kLanes];
+  for (int k = 0; k < 4; ++k) _mm_store_ps(lanes + 4 * k, acc[k]);
+  return fold_lanes(lanes, data + i, n - i, op);
+}
+
+float sum(const float* data, std::size_t n) noexcept {
+  return reduce(data, n, 0.0f, AddOp{}, [](__m128 a, __m128 x) { return _mm_add_ps(a, x); });
+}
+float min(const float* data, std::size_t n) noexcept {
+  return reduce(data, n, kPosInf, MinOp{}, [](__m128 a, __m128 x) { return _mm_min_ps(a, x); });
+}
+float max(const float* data, std::size_t n) noexcept {
+  return reduce(data, n, kNegInf, MaxOp{}, [](__m128 a, __m128 x) { return _mm_max_ps(a, x); });
+}
+
+float dot(const float* a, const float* b, std::size_t n) noexcept {
+  __m128 acc[4];
+  for (__m128& v : acc) v = _mm_setzero_ps();
+  std::size_t i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    for (int k = 0; k < 4; ++k) {
+      const __m128 prod = _mm_mul_ps(_mm_loadu_ps(a + i + 4 * k), _mm_loadu_ps(b + i + 4 * k));
+      acc[k] = _mm_add_ps(acc[k], prod);
+    }
+  }
+  alignas(16) float lanes[kLanes];
+  for (int k = 0; k < 4; ++k) _mm_store_ps(lanes + 4 * k, acc[k]);
+  return fold_dot(lanes, a + i, b + i, n - i);
+}
+
+std::size_t find_byte(const std::byte* data, std::size_t n, std::byte needle) noexcept {
+  const __m128i pattern = _mm_set1_epi8(static_cast<char>(needle));
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, pattern)));
+    if (mask != 0) return i + ctz32(mask);
+  }
+  return find_byte_tail(data, i, n, needle);
+}
+
+std::size_t count_byte(const std::byte* data, std::size_t n, std::byte needle) noexcept {
+  const __m128i pattern = _mm_set1_epi8(static_cast<char>(needle));
+  const __m128i zero = _mm_setzero_si128();
+  __m128i total = zero;
+  std::size_t i = 0;
+  while (i + 16 <= n) {
+    // Per-byte counters overflow after 255 blocks; widen before that.
+    __m128i acc = zero;
+    for (int blocks = 0; blocks < 255 && i + 16 <= n; ++blocks, i += 16) {
+      const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+      acc = _mm_sub_epi8(acc, _mm_cmpeq_epi8(block, pattern));
+    }
+    total = _mm_add_epi64(total, _mm_sad_epu8(acc, zero));
+  }
+  const auto count = static_cast<std::size_t>(_mm_cvtsi128_si64(total)) +
+                     static_cast<std::size_t>(_mm_extract_epi64(total, 1));
+  return count + count_byte_tail(data, i, n, needle);
+}
+
+void prefix_sum(const std::uint32_t* in, std::uint32_t* out, std::size_t n) noexcept {
+  __m128i carry = _mm_setzero_si128();
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+    x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+    x = _mm_add_epi32(x, carry);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), x);
+    carry = _mm_shuffle_epi32(x, 0xFF);
+  }
+  auto running = static_cast<std::uint32_t>(_mm_cvtsi128_si32(carry));
+  for (; i < n; ++i) {
+    running += in[i];
+    out[i] = running;
+  }
+}
+
+}  // namespace
+
+extern const Kernels kSse42Kernels = {Isa::sse42, sum, min, max, dot, find_byte, count_byte, prefix_sum};
+
+}  // namespace tcc::simd::detail
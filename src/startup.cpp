@@ -0,0 +1,106 @@
+#include "tcc/startup.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include "tcc/trace.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#endif
+
+namespace tcc::startup {
+
+namespace {
+
+constexpr std::size_t kMaxPhases = 64;
+constexpr const char* kLoading = "exec and dynamic loading";
+constexpr const char* kConstructors = "static constructors";
+
+struct Slot {
+  const char* name;
+  std::int64_t begin_ns;
+  std::int64_t end_ns;
+};
+
+// Plain storage, usable from other constructors before this TU's own.
+constinit Slot g_slots[kMaxPhases] = {};
+constinit std::atomic<std::size_t> g_claimed{0};
+constinit std::atomic<std::size_t> g_published{0};
+constinit std::int64_t g_process_start_ns = 0;
+constinit std::int64_t g_loaded_ns = 0;  // when on_load() ran
+constinit std::atomic<bool> g_main_entered{false};
+
+std::int64_t process_cpu_ns() noexcept {
+#if defined(CLOCK_PROCESS_CPUTIME_ID)
+  timespec ts{};
+  if (::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) == 0) {
+    return static_cast<std::int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+  }
+#endif
+  return 0;
+}
+
+void on_load() noexcept {
+  const char* env = std::getenv("TCC_STARTUP_PROFILE");
+  if (env == nullptr || std::strcmp(env, "1") != 0) return;
+  g_loaded_ns = detail::now_ns();
+  g_process_start_ns = g_loaded_ns - process_cpu_ns();
+  detail::g_enabled = true;
+  detail::record(kLoading, g_process_start_ns, g_loaded_ns);
+}
+
+}  // namespace
+
+// The earliest user constructor priority, so that "static constructors"
+// covers every other one in this binary. The only work without the
+// variable is one getenv().
+#if defined(__GNUC__)
+__attribute__((constructor(101))) static void tcc_startup_on_load() { on_load(); }
+#else
+[[maybe_unused]] static const bool g_loaded = (on_load(), true);
+#endif
+
+void detail::record(const char* name, std::int64_t begin_ns, std::int64_t end_ns) noexcept {
+  const std::size_t i = g_claimed.fetch_add(1, std::memory_order_relaxed);
+  if (i >= kMaxPhases) return;
+  g_slots[i] = {name, begin_ns, end_ns};
+  // Publish in claim order so phases() never reads a half-written slot.
+  while (g_published.load(std::memory_order_acquire) != i) {
+  }
+  g_published.store(i + 1, std::memory_order_release);
+}
+
+void main_entered() noexcept {
+  if (!enabled() || g_main_entered.exchange(true)) return;
+  detail::record(kConstructors, g_loaded_ns, detail::now_ns());
+}
+
+std::vector<PhaseTiming> phases() {
+  std::vector<PhaseTiming> out;
+  const std::size_t n = g_published.load(std::memory_order_acquire);
+  out.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const Slot& s = g_slots[i];
+    out.push_back({s.name, std::chrono::nanoseconds(s.begin_ns - g_process_start_ns),
+                   std::chrono::nanoseconds(s.end_ns - s.begin_ns)});
+  }
+  std::stable_sort(out.begin(), out.end(), [](const PhaseTiming& a, const PhaseTiming& b) { return a.start < b.start; });
+  return out;
+}
+
+void write_trace(const std::filesystem::path& path) {
+  if (trace::enabled()) throw std::logic_error("tcc::startup::write_trace: a trace is already being recorded");
+  using Clock = std::chrono::steady_clock;
+  const auto at = [](std::int64_t ns) { return Clock::time_point(std::chrono::nanoseconds(ns)); };
+  trace::start({.path = path, .origin = at(g_process_start_ns)});
+  trace::set_thread_name("startup");
+  const std::size_t n = g_published.load(std::memory_order_acquire);
+  for (std::size_t i = 0; i < n; ++i) trace::complete(g_slots[i].name, at(g_slots[i].begin_ns), at(g_slots[i].end_ns));
+  trace::stop();
+}
+
+}  // namespace tcc::startup
@@ -0,0 +1,221 @@
+#include "tcc/thread_pool.hpp"
+
+#include <algorithm>
+#include <string>
+
+#include "tcc/startup.hpp"
+#include "tcc/trace.hpp"
+
+namespace tcc {
+
+namespace {
+
+// Identity of the calling thread when it is a pool worker.
+thread_local ThreadPool* tls_pool = nullptr;
+thread_local std::size_t tls_index = 0;
+
+// Empty find_job() rounds before a worker parks. Short: most of the win is
+// catching work that arrives right behind the last job.
+constexpr int kSpinRounds = 32;
+constexpr int kRelaxRounds = 8;
+
+std::uint64_t next_random(std::uint64_t& state) noexcept {
+  // xorshift64*
+  state ^= state >> 12;
+  state ^= state << 25;
+  state ^= state >> 27;
+  return state * 0x2545F4914F6CDD1DULL;
+}
+
+void idle_pause(int round) noexcept {
+  if (round < kRelaxRounds) {
+    cpu_relax();
+  } else {
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace
+
+ThreadPool::ThreadPool(std::size_t threads) : ThreadPool(ThreadPoolOptions{.threads = threads}) {}
+
+ThreadPool::ThreadPool(const ThreadPoolOptions& options) {
+  const numa::Topology& topo = options.topology != nullptr ? *options.topology : numa::topology();
+  std::size_t threads = options.threads;
+  if (threads == 0) {
+    threads = options.affinity == Affinity::none ? std::max(1u, std::thread::hardware_concurrency())
+                                                 : std::max<std::size_t>(1, topo.cpu_count());
+  }
+  workers_.reserve(threads);
+  for (std::size_t i = 0; i < threads; ++i) {
+    auto worker = std::make_unique<Worker>();
+    worker->rng = 0x9E3779B97F4A7C15ULL * (i + 1);
+    workers_.push_back(std::move(worker));
+  }
+  if (options.affinity != Affinity::none && !topo.nodes.empty()) place_workers(options.affinity, topo);
+  // Start threads only once every deque exists: workers steal from all.
+  for (std::size_t i = 0; i < threads; ++i) {
+    workers_[i]->thread = std::thread([this, i] { worker_loop(i); });
+  }
+}
+
+void ThreadPool::place_workers(Affinity affinity, const numa::Topology& topo) {
+  // Round-robin over nodes, so every socket gets an equal share of workers
+  // however many there are; within a node, successive workers take
+  // successive CPUs.
+  const std::vector<numa::Node>& nodes = topo.nodes;
+  for (std::size_t i = 0; i < workers_.size(); ++i) {
+    const numa::Node& node = nodes[i % nodes.size()];
+    Worker& worker = *workers_[i];
+    worker.node = node.id;
+    if (affinity == Affinity::node) {
+      worker.cpus = node.cpus;
+    } else if (!node.cpus.empty()) {
+      worker.cpus = {node.cpus[(i / nodes.size()) % node.cpus.size()]};
+    }
+  }
+  if (nodes.size() < 2 || workers_.size() < 2) return;
+  for (auto& worker : workers_) {
+    for (auto& peer : workers_) {
+      if (peer != worker && peer->node == worker->node) worker->local_peers.push_back(peer.get());
+    }
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  stopping_.store(true, std::memory_order_seq_cst);
+  epoch_.fetch_add(1, std::memory_order_seq_cst);
+  epoch_.notify_all();
+  for (auto& worker : workers_) worker->thread.join();
+}
+
+void ThreadPool::submit(Job& job) {
+  if (tls_pool == this) {
+    workers_[tls_index]->deque.push(&job);
+  } else {
+    std::lock_guard lock(inject_mutex_);
+    injected_.push_back(&job);
+    injected_count_.fetch_add(1, std::memory_order_seq_cst);
+  }
+  notify_work();
+}
+
+void ThreadPool::notify_work() {
+  // Pairs with the sleeping_ increment in worker_loop(): either we see the
+  // sleeper and bump the epoch, or the sleeper's re-check sees our job.
+  if (sleeping_.load(std::memory_order_seq_cst) != 0) {
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+    epoch_.notify_one();
+  }
+}
+
+void ThreadPool::wait(const std::atomic<bool>& done) {
+  if (tls_pool == this) {
+    Worker* self = workers_[tls_index].get();
+    int idle = 0;
+    while (!done.load(std::memory_order_acquire)) {
+      if (Job* job = find_job(self)) {
+        job->execute();
+        idle = 0;
+      } else {
+        idle_pause(idle++);
+      }
+    }
+    return;
+  }
+  for (;;) {
+    const std::uint32_t seen = completions_.load(std::memory_order_acquire);
+    if (done.load(std::memory_order_acquire)) return;
+    completions_.wait(seen, std::memory_order_acquire);
+  }
+}
+
+void ThreadPool::notify_waiters() noexcept {
+  completions_.fetch_add(1, std::memory_order_release);
+  completions_.notify_all();
+}
+
+int ThreadPool::current_worker() const noexcept {
+  return tls_pool == this ? static_cast<int>(tls_index) : -1;
+}
+
+ThreadPool& ThreadPool::global() {
+  static ThreadPool pool = [] {
+    startup::Phase phase("thread pool: global workers");
+    return ThreadPool();
+  }();
+  return pool;
+}
+
+void ThreadPool::worker_loop(std::size_t index) {
+  tls_pool = this;
+  tls_index = index;
+  trace::set_thread_name("tcc-worker-" + std::to_string(index));
+  Worker* self = workers_[index].get();
+  if (!self->cpus.empty()) numa::pin_current_thread(self->cpus);  // best effort
+
+  for (;;) {
+    Job* job = find_job(self);
+    for (int round = 0; job == nullptr && round < kSpinRounds; ++round) {
+      idle_pause(round);
+      job = find_job(self);
+    }
+    if (job != nullptr) {
+      job->execute();
+      continue;
+    }
+
+    // Park. Announce ourselves first, then look once more so a submit that
+    // raced with the announcement is not lost.
+    const std::uint32_t epoch = epoch_.load(std::memory_order_seq_cst);
+    sleeping_.fetch_add(1, std::memory_order_seq_cst);
+    job = find_job(self);
+    if (job == nullptr && !stopping_.load(std::memory_order_seq_cst)) {
+      epoch_.wait(epoch, std::memory_order_seq_cst);
+    }
+    sleeping_.fetch_sub(1, std::memory_order_seq_cst);
+
+    if (job == nullptr && stopping_.load(std::memory_order_seq_cst)) {
+      job = find_job(self);
+      if (job == nullptr) return;  // drained
+    }
+    if (job != nullptr) job->execute();
+  }
+}
+
+Job* ThreadPool::find_job(Worker* self) {
+  if (auto job = self->deque.pop()) return *job;
+  if (Job* job = steal_from_others(self)) return job;
+  return pop_injected();
+}
+
+Job* ThreadPool::steal_from_others(Worker* self) {
+  const std::size_t n = workers_.size();
+  if (n <= 1) return nullptr;
+  if (const std::size_t local = self->local_peers.size(); local != 0) {
+    // Same-node victims first: their work most likely touches memory on our node.
+    const std::size_t first = static_cast<std::size_t>(next_random(self->rng) % local);
+    for (std::size_t k = 0; k < local; ++k) {
+      if (auto job = self->local_peers[(first + k) % local]->deque.steal()) return *job;
+    }
+  }
+  const std::size_t start = static_cast<std::size_t>(next_random(self->rng) % n);
+  for (std::size_t k = 0; k < n; ++k) {
+    Worker* victim = workers_[(start + k) % n].get();
+    if (victim == self) continue;
+    if (auto job = victim->deque.steal()) return *job;
+  }
+  return nullptr;
+}
+
+Job* ThreadPool::pop_injected() {
+  if (injected_count_.load(std::memory_order_seq_cst) == 0) return nullptr;
+  std::lock_guard lock(inject_mutex_);
+  if (injected_.empty()) return nullptr;
+  Job* job = injected_.front();
+  injected_.pop_front();
+  injected_count_.fetch_sub(1, std::memory_order_relaxed);
+  return job;
+}
+
+}  // namespace tcc
@@ -0,0 +1,334 @@
+#include "tcc/trace.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace tcc::trace {
+
+namespace detail {
+
+namespace {
+
+constexpr std::size_t kMinBufferEvents = 1024;
+constexpr std::size_t kMaxThreadName = 64;
+
+struct Entry {
+  ThreadBuffer buffer;
+  std::unique_ptr<Event[]> storage;
+  std::string name;
+  std::uint32_t tid = 0;
+  bool name_written = false;
+  bool retired = false;  // the thread has exited; freed once drained
+};
+
+struct Recorder {
+  std::mutex mutex;  // everything below
+  std::vector<std::unique_ptr<Entry>> threads;
+  std::uint64_t dropped_by_retired = 0;
+  std::size_t buffer_events = Options{}.buffer_events;
+  std::uint32_t next_tid = 1;
+
+  std::FILE* file = nullptr;
+  bool first_event = true;
+  std::uint64_t tick0 = 0;  // ts 0
+  double ticks_per_us = 1;
+  std::uint64_t start_ticks = 0;  // the same instant on both clocks, for complete()
+  std::chrono::steady_clock::time_point start_time{};
+
+  std::thread flusher;
+  std::condition_variable wake;
+  bool stopping = false;
+  std::chrono::milliseconds interval{100};
+};
+
+// Leaked: exiting threads retire their rings through it, possibly after
+// static destructors have run.
+Recorder& recorder() {
+  static Recorder* r = new Recorder;
+  return *r;
+}
+
+// Name given before the thread first records; plain storage so naming a
+// thread that never traces costs no ring and no destructor.
+thread_local char tls_pending_name[kMaxThreadName] = {};
+thread_local bool tls_exited = false;
+
+struct ExitHook {
+  Entry* entry = nullptr;
+  ~ExitHook() {
+    tls_buffer = nullptr;
+    tls_exited = true;
+    Recorder& r = recorder();
+    std::lock_guard lock(r.mutex);
+    if (r.file != nullptr) {
+      entry->retired = true;  // the flusher frees it after the last drain
+      return;
+    }
+    std::erase_if(r.threads, [&](const std::unique_ptr<Entry>& e) { return e.get() == entry; });
+  }
+};
+
+std::size_t round_up_pow2(std::size_t n) {
+  std::size_t p = kMinBufferEvents;
+  while (p < n) p <<= 1;
+  return p;
+}
+
+void append_escaped(std::string& out, const char* s) {
+  for (; *s != '\0'; ++s) {
+    const char c = *s;
+    if (c == '"' || c == '\\') {
+      out.push_back('\\');
+      out.push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[8];
+      std::snprintf(buf, sizeof buf, "\\u%04x", static_cast<unsigned>(c));
+      out.append(buf);
+    } else {
+      out.push_back(c);
+    }
+  }
+}
+
+class JsonWriter {
+ public:
+  explicit JsonWriter(Recorder& r) : r_(r) { out_.reserve(1 << 16); }
+  ~JsonWriter() { flush(); }
+
+  void event(const Entry& entry, const Event& e) {
+    begin_object();
+    out_.append("\"name\":\"");
+    append_escaped(out_, e.name);
+    const double ts = to_us(e.begin);
+    char buf[160];
+    switch (e.kind) {
+      case Kind::complete:
+        std::snprintf(buf, sizeof buf, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", entry.tid, ts,
+                      static_cast<double>(e.value - e.begin) / r_.ticks_per_us);
+        break;
+      case Kind::instant:
+        std::snprintf(buf, sizeof buf, "\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}", entry.tid, ts);
+        break;
+      case Kind::counter:
+        std::snprintf(buf, sizeof buf, "\",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%.17g}}",
+                      entry.tid, ts, std::bit_cast<double>(e.value));
+        break;
+    }
+    out_.append(buf);
+    if (out_.size() > (1 << 16) - 256) flush();
+  }
+
+  void thread_name(const Entry& entry) {
+    begin_object();
+    char buf[96];
+    std::snprintf(buf, sizeof buf, "\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"",
+                  entry.tid);
+    out_.append(buf);
+    append_escaped(out_, entry.name.c_str());
+    out_.append("\"}}");
+  }
+
+  void flush() {
+    std::fwrite(out_.data(), 1, out_.size(), r_.file);
+    out_.clear();
+  }
+
+ private:
+  void begin_object() {
+    out_.append(r_.first_event ? "{" : ",\n{");
+    r_.first_event = false;
+  }
+
+  double to_us(std::uint64_t t) const {
+    return static_cast<double>(static_cast<std::int64_t>(t - r_.tick0)) / r_.ticks_per_us;
+  }
+
+  Recorder& r_;
+  std::string out_;
+};
+
+/// Writes out every ring. Caller holds r.mutex and r.file is open.
+void drain(Recorder& r) {
+  JsonWriter json(r);
+  for (auto it = r.threads.begin(); it != r.threads.end();) {
+    Entry& entry = **it;
+    if (!entry.name_written && !entry.name.empty()) {
+      json.thread_name(entry);
+      entry.name_written = true;
+    }
+    ThreadBuffer& b = entry.buffer;
+    const std::uint64_t head = b.head.load(std::memory_order_acquire);
+    const std::uint64_t tail = b.tail.load(std::memory_order_relaxed);
+    for (std::uint64_t i = tail; i != head; ++i) json.event(entry, b.events[i & b.mask]);
+    b.tail.store(head, std::memory_order_release);
+    if (entry.retired) {
+      r.dropped_by_retired += b.dropped.load(std::memory_order_relaxed);
+      it = r.threads.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+/// Ticks per microsecond, measured against steady_clock over ~10 ms.
+double calibrate() {
+  using Clock = std::chrono::steady_clock;
+  const auto t0 = Clock::now();
+  const std::uint64_t k0 = ticks();
+  while (Clock::now() - t0 < std::chrono::milliseconds(10)) {
+  }
+  const std::uint64_t k1 = ticks();
+  const double us = std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+  return static_cast<double>(k1 - k0) / us;
+}
+
+void flusher_loop(Recorder& r) {
+  std::unique_lock lock(r.mutex);
+  while (!r.stopping) {
+    r.wake.wait_for(lock, r.interval, [&] { return r.stopping; });
+    drain(r);
+    std::fflush(r.file);
+  }
+}
+
+std::uint64_t to_ticks(const Recorder& r, std::chrono::steady_clock::duration d) {
+  return static_cast<std::uint64_t>(std::chrono::duration<double, std::micro>(d).count() * r.ticks_per_us);
+}
+
+}  // namespace
+
+ThreadBuffer* register_thread() {
+  if (tls_exited) return nullptr;
+  Recorder& r = recorder();
+  Entry* entry = nullptr;
+  {
+    std::lock_guard lock(r.mutex);
+    auto owned = std::make_unique<Entry>();
+    entry = owned.get();
+    const std::size_t capacity = round_up_pow2(r.buffer_events);
+    entry->storage = std::make_unique<Event[]>(capacity);
+    entry->buffer.events = entry->storage.get();
+    entry->buffer.mask = capacity - 1;
+    entry->tid = r.next_tid++;
+    entry->name = tls_pending_name;
+    r.threads.push_back(std::move(owned));
+  }
+  thread_local ExitHook hook;
+  hook.entry = entry;
+  tls_buffer = &entry->buffer;
+  return tls_buffer;
+}
+
+}  // namespace detail
+
+void start(const Options& options) {
+  detail::Recorder& r = detail::recorder();
+  std::lock_guard lock(r.mutex);
+  if (r.file != nullptr) throw std::logic_error("tcc::trace::start: already started");
+  std::FILE* file = std::fopen(options.path.string().c_str(), "wb");
+  if (file == nullptr) {
+    throw std::system_error(errno, std::generic_category(), "tcc::trace: cannot create " + options.path.string());
+  }
+  r.file = file;
+  r.buffer_events = options.buffer_events;
+  r.interval = options.flush_interval;
+  r.first_event = true;
+  r.dropped_by_retired = 0;
+  // Events left over from an earlier session would carry stale ticks.
+  for (auto& entry : r.threads) {
+    entry->buffer.tail.store(entry->buffer.head.load(std::memory_order_acquire), std::memory_order_release);
+    entry->buffer.dropped.store(0, std::memory_order_relaxed);
+    entry->name_written = false;
+  }
+  r.ticks_per_us = detail::calibrate();
+  r.start_time = std::chrono::steady_clock::now();
+  r.start_ticks = detail::ticks();
+  r.tick0 = r.start_ticks;
+  if (options.origin != std::chrono::steady_clock::time_point{} && options.origin < r.start_time) {
+    r.tick0 -= detail::to_ticks(r, r.start_time - options.origin);
+  }
+  std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", file);
+  r.stopping = false;
+  r.flusher = std::thread(detail::flusher_loop, std::ref(r));
+  detail::g_enabled.store(true, std::memory_order_release);
+}
+
+void stop() {
+  detail::Recorder& r = detail::recorder();
+  std::thread flusher;
+  {
+    std::lock_guard lock(r.mutex);
+    if (r.file == nullptr) return;
+    detail::g_enabled.store(false, std::memory_order_release);
+    r.stopping = true;
+    flusher = std::move(r.flusher);
+  }
+  r.wake.notify_all();
+  flusher.join();
+  std::lock_guard lock(r.mutex);
+  detail::drain(r);
+  std::fputs("\n]}\n", r.file);
+  std::fclose(r.file);
+  r.file = nullptr;
+}
+
+void flush() {
+  detail::Recorder& r = detail::recorder();
+  std::lock_guard lock(r.mutex);
+  if (r.file == nullptr) return;
+  detail::drain(r);
+  std::fflush(r.file);
+}
+
+void set_thread_name(std::string_view name) {
+  name = name.substr(0, detail::kMaxThreadName - 1);
+  std::memcpy(detail::tls_pending_name, name.data(), name.size());
+  detail::tls_pending_name[name.size()] = '\0';
+  if (detail::tls_buffer == nullptr) return;
+  detail::Recorder& r = detail::recorder();
+  std::lock_guard lock(r.mutex);
+  for (auto& entry : r.threads) {
+    if (&entry->buffer == detail::tls_buffer) {
+      entry->name = detail::tls_pending_name;
+      entry->name_written = false;
+    }
+  }
+}
+
+void complete(const char* name, std::chrono::steady_clock::time_point begin,
+              std::chrono::steady_clock::time_point end) noexcept {
+  if (!enabled()) return;
+  std::uint64_t b = 0, e = 0;
+  {
+    detail::Recorder& r = detail::recorder();
+    std::lock_guard lock(r.mutex);
+    const auto at = [&](std::chrono::steady_clock::time_point t) {
+      return t < r.start_time ? r.start_ticks - detail::to_ticks(r, r.start_time - t)
+                              : r.start_ticks + detail::to_ticks(r, t - r.start_time);
+    };
+    b = at(begin);
+    e = at(end < begin ? begin : end);
+  }
+  // Outside the lock: the first record() of a thread registers it.
+  detail::record({b, e, name, detail::Kind::complete, 0});
+}
+
+std::uint64_t dropped_events() noexcept {
+  detail::Recorder& r = detail::recorder();
+  std::lock_guard lock(r.mutex);
+  std::uint64_t total = r.dropped_by_retired;
+  for (auto& entry : r.threads) total += entry->buffer.dropped.load(std::memory_order_relaxed);
+  return total;
+}
+
+}  // namespace tcc::trace
@@ -0,0 +1,29 @@
+#include "tcc/version.hpp"
+
+#ifndef TCC_VERSION_STRING
+#define TCC_VERSION_STRING "unknown"
+#endif
+
+#if defined(__clang__)
+#define TCC_COMPILER "clang " __clang_version__
+#elif defined(__GNUC__)
+#define TCC_COMPILER "gcc " __VERSION__
+#elif defined(_MSC_VER)
+#define TCC_COMPILER "msvc"
+#else
+#define TCC_COMPILER "unknown compiler"
+#endif
+
+#if defined(NDEBUG)
+#define TCC_ASSERTS "asserts=off"
+#else
+#define TCC_ASSERTS "asserts=on"
+#endif
+
+namespace tcc {
+
+std::string_view version() noexcept { return TCC_VERSION_STRING; }
+
+std::string_view build_info() noexcept { return TCC_COMPILER ", " TCC_ASSERTS; }
+
+}  // namespace tcc
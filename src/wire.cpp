@@ -0,0 +1,67 @@
+#include "tcc/wire.hpp"
+
+#include <limits>
+#include <string>
+
+namespace tcc::wire {
+
+namespace detail {
+
+void fail(const char* what) { throw Error(std::string("tcc::wire: ") + what); }
+
+std::uint32_t check_header(std::span<const std::byte> buffer, std::uint32_t& size) {
+  if (buffer.size() < kHeaderSize) fail("buffer shorter than the header");
+  if (reinterpret_cast<std::uintptr_t>(buffer.data()) % kTableAlign != 0) fail("buffer not 8-byte aligned");
+  if (load<std::uint32_t>(buffer.data()) != kMagic) fail("bad magic");
+  const auto root = load<std::uint32_t>(buffer.data() + 4);
+  size = load<std::uint32_t>(buffer.data() + 8);
+  if (size < kHeaderSize || size > buffer.size()) fail("message size exceeds the buffer");
+  return root;
+}
+
+}  // namespace detail
+
+Builder::Builder(std::size_t initial_capacity) {
+  buffer_.resize(std::max(initial_capacity, detail::kHeaderSize));
+}
+
+StringRef Builder::add_string(std::string_view s) {
+  const std::uint32_t off = allocate(s.size() + 1, 1);
+  if (!s.empty()) std::memcpy(buffer_.data() + off, s.data(), s.size());
+  return {off, static_cast<std::uint32_t>(s.size())};
+}
+
+std::uint32_t Builder::allocate(std::size_t bytes, std::size_t align) {
+  const std::size_t start = detail::align_up(size_, align);
+  if (bytes > std::numeric_limits<std::uint32_t>::max() - start) {
+    throw std::length_error("tcc::wire::Builder: message larger than 4 GiB");
+  }
+  const std::size_t end = start + bytes;
+  if (end > buffer_.size()) buffer_.resize(std::max(end, buffer_.size() * 2));
+  // Padding and the new object start zeroed even when clear() left old bytes.
+  std::memset(buffer_.data() + size_, 0, end - size_);
+  size_ = end;
+  return static_cast<std::uint32_t>(start);
+}
+
+std::span<const std::byte> Builder::finish_root(std::uint32_t root) {
+  allocate(0, detail::kTableAlign);  // whole messages concatenate cleanly
+  std::byte* header = buffer_.data();
+  detail::store(header, detail::kMagic);
+  detail::store(header + 4, root);
+  detail::store(header + 8, static_cast<std::uint32_t>(size_));
+  detail::store(header + 12, std::uint32_t{0});
+  return data();
+}
+
+std::vector<std::byte> Builder::release() {
+  buffer_.resize(size_);
+  std::vector<std::byte> out = std::move(buffer_);
+  buffer_.assign(detail::kHeaderSize, std::byte{0});
+  size_ = detail::kHeaderSize;
+  return out;
+}
+
+void Builder::clear() noexcept { size_ = detail::kHeaderSize; }
+
+}  // namespace tcc::wire
@@ -0,0 +1,134 @@
+#include "harness.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <regex>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace tcc::test {
+
+namespace {
+
+struct Case {
+  const char* suite;
+  const char* name;
+  const char* label;
+  Function fn;
+};
+
+std::vector<Case>& registry() {
+  static std::vector<Case> cases;
+  return cases;
+}
+
+struct Options {
+  std::string suite;
+  std::string label;
+  std::string filter;
+  bool list = false;
+};
+
+// Failures recorded by the case currently running.
+int current_failures = 0;
+
+bool parse_flag(std::string_view arg, std::string_view name, std::string_view& value) {
+  if (arg.substr(0, name.size()) != name) return false;
+  arg.remove_prefix(name.size());
+  if (arg.empty() || arg.front() != '=') return false;
+  value = arg.substr(1);
+  return true;
+}
+
+Options parse_options(int argc, char** argv) {
+  Options opts;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    std::string_view value;
+    if (parse_flag(arg, "--suite", value)) {
+      opts.suite = value;
+    } else if (parse_flag(arg, "--label", value)) {
+      opts.label = value;
+    } else if (parse_flag(arg, "--filter", value)) {
+      opts.filter = value;
+    } else if (arg == "--list") {
+      opts.list = true;
+    } else {
+      throw std::invalid_argument("unknown option: " + std::string(arg));
+    }
+  }
+  return opts;
+}
+
+std::vector<const Case*> select(const Options& opts) {
+  std::regex filter(opts.filter.empty() ? std::string(".*") : opts.filter);
+  std::vector<const Case*> selected;
+  for (const Case& c : registry()) {
+    if (!opts.suite.empty() && opts.suite != c.suite) continue;
+    if (!opts.label.empty() && opts.label != c.label) continue;
+    if (!std::regex_search(std::string(c.suite) + "." + c.name, filter)) continue;
+    selected.push_back(&c);
+  }
+  return selected;
+}
+
+bool run_case(const Case& c) {
+  std::printf("[ RUN      ] %s.%s\n", c.suite, c.name);
+  std::fflush(stdout);
+  current_failures = 0;
+  const auto start = std::chrono::steady_clock::now();
+  try {
+    c.fn();
+  } catch (const RequireFailure&) {
+    // Already reported; the case just stops here.
+  } catch (const std::exception& e) {
+    report_failure(__FILE__, __LINE__, std::string("unexpected exception: ") + e.what());
+  } catch (...) {
+    report_failure(__FILE__, __LINE__, "unexpected non-std exception");
+  }
+  const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  const bool passed = current_failures == 0;
+  std::printf("[ %s ] %s.%s (%.2f ms)\n", passed ? "      OK" : " FAILED ", c.suite, c.name, ms);
+  std::fflush(stdout);
+  return passed;
+}
+
+}  // namespace
+
+bool register_case(const char* suite, const char* name, const char* label, Function fn) {
+  registry().push_back({suite, name, label, fn});
+  return true;
+}
+
+void report_failure(const char* file, int line, const std::string& message) {
+  ++current_failures;
+  std::printf("%s:%d: failure: %s\n", file, line, message.c_str());
+}
+
+int run_main(int argc, char** argv) {
+  try {
+    const Options opts = parse_options(argc, argv);
+    const std::vector<const Case*> cases = select(opts);
+    if (opts.list) {
+      for (const Case* c : cases) std::printf("%s.%s [%s]\n", c->suite, c->name, c->label);
+      return 0;
+    }
+    if (cases.empty()) throw std::invalid_argument("no test cases match the given options");
+
+    std::vector<const Case*> failed;
+    for (const Case* c : cases) {
+      if (!run_case(*c)) failed.push_back(c);
+    }
+    std::printf("\n%zu cases, %zu passed, %zu failed\n", cases.size(), cases.size() - failed.size(),
+                failed.size());
+    for (const Case* c : failed) std::printf("  FAILED %s.%s\n", c->suite, c->name);
+    return failed.empty() ? 0 : 1;
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "tcc_tests: %s\n", e.what());
+    return 2;
+  }
+}
+
+}  // namespace tcc::test
@@ -0,0 +1,184 @@
+#pragma once
+
+// Minimal unit-test harness used by tcc_tests.
+//
+//   TCC_TEST(arena, ResetKeepsChunks) {
+//     tcc::Arena arena(1024);
+//     arena.allocate(100);
+//     arena.reset();
+//     TCC_CHECK_EQ(arena.chunk_count(), 1u);
+//   }
+//
+// Cases belong to a suite (one per component, named after its test file)
+// and carry a label: "unit" for TCC_TEST, "perf-smoke" for TCC_PERF_TEST.
+// TCC_CHECK* records a failure and lets the case continue; TCC_REQUIRE*
+// records it and ends the case. An exception escaping a case fails it.
+// tests/CMakeLists.txt registers one CTest test per suite and one per
+// perf-smoke suite, each running a filtered tcc_tests process.
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace tcc::test {
+
+// --- Registration -----------------------------------------------------------
+
+using Function = void (*)();
+
+/// Adds a case to the registry; used by TCC_TEST at static-init time.
+bool register_case(const char* suite, const char* name, const char* label, Function fn);
+
+/// Runs the registered cases selected by the command line options below and
+/// returns the process exit code (0 all passed, 1 a case failed, 2 usage).
+///
+///   --suite=<name>       only cases of this suite
+///   --label=<label>      only cases with this label (unit, perf-smoke)
+///   --filter=<regex>     only cases whose suite.name matches
+///   --list               print case names and labels and exit
+int run_main(int argc, char** argv);
+
+// --- Failures ---------------------------------------------------------------
+
+/// Thrown by TCC_REQUIRE*; caught by the runner, never by test code.
+struct RequireFailure {};
+
+/// Records a failed expectation in the running case.
+void report_failure(const char* file, int line, const std::string& message);
+
+namespace detail {
+
+template <class T>
+std::string describe(const T& value) {
+  if constexpr (std::is_same_v<T, bool>) {
+    return value ? "true" : "false";
+  } else if constexpr (std::is_enum_v<T>) {
+    return std::to_string(static_cast<std::underlying_type_t<T>>(value));
+  } else if constexpr (requires(std::ostream& os) { os << value; }) {
+    std::ostringstream os;
+    os << value;
+    return os.str();
+  } else {
+    return "<value>";
+  }
+}
+
+template <class T>
+constexpr bool kPlainInteger = std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                               !std::is_same_v<T, char>;
+
+/// Integer comparisons go through std::cmp_* so `size() == 3` does not trip
+/// -Wsign-compare or compare a negative value as huge.
+struct Equal {
+  template <class A, class B>
+  bool operator()(const A& a, const B& b) const {
+    if constexpr (kPlainInteger<A> && kPlainInteger<B>) {
+      return std::cmp_equal(a, b);
+    } else {
+      return a == b;
+    }
+  }
+};
+
+struct Less {
+  template <class A, class B>
+  bool operator()(const A& a, const B& b) const {
+    if constexpr (kPlainInteger<A> && kPlainInteger<B>) {
+      return std::cmp_less(a, b);
+    } else {
+      return a < b;
+    }
+  }
+};
+
+/// Evaluates both operands once, then compares them with `op`; `negate`
+/// and `swap` turn Equal/Less into !=, <= and the like.
+template <class A, class B, class Op>
+bool check_compare(const char* file, int line, const char* expr, const A& a, const B& b, Op op,
+                   bool negate = false, bool swap = false) {
+  const bool ok = (swap ? op(b, a) : op(a, b)) != negate;
+  if (!ok) [[unlikely]] {
+    report_failure(file, line, std::string(expr) + " with " + describe(a) + " vs " + describe(b));
+  }
+  return ok;
+}
+
+}  // namespace detail
+
+// --- Timing -----------------------------------------------------------------
+
+/// Fastest of `repetitions` runs of `fn`, in nanoseconds. The minimum is the
+/// sample least disturbed by the scheduler, which is what a coarse bound
+/// needs on a shared CI machine.
+template <std::invocable Fn>
+double best_time_ns(Fn&& fn, int repetitions = 5) {
+  double best = std::numeric_limits<double>::infinity();
+  for (int i = 0; i < repetitions; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto stop = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+  }
+  return best;
+}
+
+}  // namespace tcc::test
+
+#define TCC_TEST_CONCAT_IMPL(a, b) a##b
+#define TCC_TEST_CONCAT(a, b) TCC_TEST_CONCAT_IMPL(a, b)
+
+#define TCC_TEST_CASE_IMPL(suite, name, label)                                                  \
+  static void tcc_test_##suite##_##name();                                                      \
+  [[maybe_unused]] static const bool TCC_TEST_CONCAT(tcc_test_registration_, __COUNTER__) =     \
+      ::tcc::test::register_case(#suite, #name, label, &tcc_test_##suite##_##name);             \
+  static void tcc_test_##suite##_##name()
+
+/// Defines a unit test case `suite.name`.
+#define TCC_TEST(suite, name) TCC_TEST_CASE_IMPL(suite, name, "unit")
+
+/// Defines a coarse performance check `suite.name`, run by the perf-smoke tier.
+#define TCC_PERF_TEST(suite, name) TCC_TEST_CASE_IMPL(suite, name, "perf-smoke")
+
+#define TCC_CHECK(expr)                                                                     \
+  ((expr) ? true : (::tcc::test::report_failure(__FILE__, __LINE__, "TCC_CHECK(" #expr ")"), false))
+
+#define TCC_TEST_COMPARE_IMPL(a, b, expr, op, negate, swap)                              \
+  ::tcc::test::detail::check_compare(__FILE__, __LINE__, expr, (a), (b), ::tcc::test::detail::op{}, \
+                                     negate, swap)
+
+#define TCC_CHECK_EQ(a, b) TCC_TEST_COMPARE_IMPL(a, b, #a " == " #b, Equal, false, false)
+#define TCC_CHECK_NE(a, b) TCC_TEST_COMPARE_IMPL(a, b, #a " != " #b, Equal, true, false)
+#define TCC_CHECK_LT(a, b) TCC_TEST_COMPARE_IMPL(a, b, #a " < " #b, Less, false, false)
+#define TCC_CHECK_LE(a, b) TCC_TEST_COMPARE_IMPL(a, b, #a " <= " #b, Less, true, true)
+
+/// Passes when `expr` throws `type` (or a type derived from it).
+#define TCC_CHECK_THROWS(expr, type)                                                         \
+  do {                                                                                       \
+    bool tcc_test_threw = false;                                                             \
+    try {                                                                                    \
+      static_cast<void>(expr);                                                               \
+    } catch (const type&) {                                                                  \
+      tcc_test_threw = true;                                                                 \
+    } catch (...) {                                                                          \
+    }                                                                                        \
+    if (!tcc_test_threw) {                                                                   \
+      ::tcc::test::report_failure(__FILE__, __LINE__, #expr " did not throw " #type);        \
+    }                                                                                        \
+  } while (false)
+
+#define TCC_REQUIRE(expr)                                      \
+  do {                                                         \
+    if (!TCC_CHECK(expr)) throw ::tcc::test::RequireFailure{}; \
+  } while (false)
+
+#define TCC_REQUIRE_EQ(a, b)                                      \
+  do {                                                            \
+    if (!TCC_CHECK_EQ(a, b)) throw ::tcc::test::RequireFailure{}; \
+  } while (false)
@@ -0,0 +1,3 @@
+#include "harness.hpp"
+
+int main(int argc, char** argv) { return tcc::test::run_main(argc, argv); }
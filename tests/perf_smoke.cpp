@@ -0,0 +1,295 @@
+// Coarse performance guards for the perf-smoke tier. Absolute timings mean
+// nothing across CI machines, so every bound here is a ratio measured in
+// the same process:
+//
+//   scaling    per-item cost at 16n against n. Linear code stays within
+//              cache effects (about 1-3x); an accidental O(n^2) shows 16x.
+//              Fails above kGrowthLimit.
+//   reference  a tcc component against the std:: (or scalar) code it
+//              replaces, which it normally beats. Fails when it is more
+//              than a generous factor slower, i.e. after a regression of
+//              roughly an order of magnitude.
+//
+// Each side is the best of several runs, small enough that the whole suite
+// takes a few seconds.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/arena.hpp"
+#include "tcc/external_sort.hpp"
+#include "tcc/flat_hash_map.hpp"
+#include "tcc/mapped_file.hpp"
+#include "tcc/metrics.hpp"
+#include "tcc/mpmc_ring.hpp"
+#include "tcc/simd.hpp"
+#include "tcc/soa_vector.hpp"
+#include "tcc/spsc_ring.hpp"
+#include "tcc/thread_pool.hpp"
+#include "tcc/wire.hpp"
+
+namespace {
+
+constexpr double kGrowthLimit = 6.0;
+constexpr std::size_t kGrowth = 16;
+
+volatile std::uint64_t g_sink = 0;
+
+/// Per-item cost of `run(n)` at n and 16n; checks their ratio.
+template <class Fn>
+void check_scaling(const char* what, std::size_t n, Fn run) {
+  run(n);  // warm caches and allocator
+  const double small = tcc::test::best_time_ns([&] { run(n); }) / static_cast<double>(n);
+  const double large = tcc::test::best_time_ns([&] { run(n * kGrowth); }, 3) / static_cast<double>(n * kGrowth);
+  const double growth = large / small;
+  std::printf("  %s: %.2f ns/item at n=%zu, %.2f at n=%zu (x%.2f)\n", what, small, n, large, n * kGrowth, growth);
+  TCC_CHECK_LE(growth, kGrowthLimit);
+}
+
+/// Time of `candidate` against `reference` doing the same work.
+template <class A, class B>
+void check_against(const char* what, double limit, A candidate, B reference) {
+  candidate();
+  reference();
+  const double a = tcc::test::best_time_ns(candidate);
+  const double b = tcc::test::best_time_ns(reference);
+  std::printf("  %s: %.0f ns vs reference %.0f ns (x%.2f, limit x%.1f)\n", what, a, b, a / b, limit);
+  TCC_CHECK_LE(a / b, limit);
+}
+
+// --- Scaling ----------------------------------------------------------------
+
+TCC_PERF_TEST(perf_smoke, FlatHashMapInsertFindScales) {
+  check_scaling("insert+find", 4096, [](std::size_t n) {
+    tcc::FlatHashMap<std::uint64_t, std::uint64_t> map;
+    for (std::uint64_t i = 0; i < n; ++i) map[i * 64] = i;
+    std::uint64_t hits = 0;
+    for (std::uint64_t i = 0; i < n; ++i) hits += map.contains(i * 64);
+    g_sink = hits;
+  });
+}
+
+TCC_PERF_TEST(perf_smoke, FlatHashMapEraseScales) {
+  check_scaling("insert+erase", 4096, [](std::size_t n) {
+    tcc::FlatHashMap<std::uint64_t, std::uint64_t> map;
+    for (std::uint64_t i = 0; i < n; ++i) map[i] = i;
+    for (std::uint64_t i = 0; i < n; ++i) map.erase(i);
+    g_sink = map.size();
+  });
+}
+
+template <template <class> class F = tcc::soa::Value>
+struct Particle {
+  F<float> x;
+  F<float> y;
+  F<std::uint32_t> id;
+};
+
+TCC_PERF_TEST(perf_smoke, SoaVectorPushBackScales) {
+  check_scaling("push_back", 4096, [](std::size_t n) {
+    tcc::SoaVector<Particle> v;
+    for (std::size_t i = 0; i < n; ++i) v.push_back({1.0f, 2.0f, static_cast<std::uint32_t>(i)});
+    g_sink = v.size();
+  });
+}
+
+TCC_PERF_TEST(perf_smoke, ArenaAllocateScales) {
+  check_scaling("allocate", 4096, [](std::size_t n) {
+    tcc::Arena arena;
+    for (std::size_t i = 0; i < n; ++i) arena.allocate(48);
+    g_sink = arena.bytes_used();
+  });
+}
+
+TCC_PERF_TEST(perf_smoke, MpmcRingThroughputScales) {
+  check_scaling("push+pop", 4096, [](std::size_t n) {
+    tcc::MpmcRing<std::uint64_t> ring(1024);
+    std::uint64_t v = 0, sum = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      ring.try_push(i);
+      ring.try_pop(v);
+      sum += v;
+    }
+    g_sink = sum;
+  });
+}
+
+namespace w = tcc::wire;
+using Item = w::Schema<w::Field<"id", std::uint32_t>, w::Field<"name", w::String>>;
+using ItemList = w::Schema<w::Field<"items", w::Vector<w::Table<Item>>>>;
+
+TCC_PERF_TEST(perf_smoke, WireVerifyScales) {
+  check_scaling("build+verify", 1024, [](std::size_t n) {
+    w::Builder b;
+    std::vector<w::TableRef<Item>> items;
+    items.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) items.push_back(b.add_table<Item>(static_cast<std::uint32_t>(i), b.add_string("x")));
+    const auto list = b.add_vector<Item>(std::span<const w::TableRef<Item>>(items));
+    g_sink = w::root<ItemList>(b.finish(b.add_table<ItemList>(list))).get<"items">().size();
+  });
+}
+
+TCC_PERF_TEST(perf_smoke, LineSplittingScales) {
+  std::string text;
+  for (int i = 0; i < 4096 * static_cast<int>(kGrowth); ++i) text += "a line of about forty bytes of text....\n";
+  check_scaling("lines", 4096, [&](std::size_t n) {
+    std::size_t bytes = 0;
+    for (std::string_view line : tcc::lines(std::string_view(text).substr(0, n * 40))) bytes += line.size();
+    g_sink = bytes;
+  });
+}
+
+TCC_PERF_TEST(perf_smoke, PrometheusScrapeScales) {
+  auto make = [](std::size_t n) {
+    auto reg = std::make_unique<tcc::metrics::Registry>(1);
+    for (std::size_t i = 0; i < n; ++i) reg->counter("smoke_total", "Smoke", {{"series", std::to_string(i)}}).inc(i);
+    return reg;
+  };
+  const auto small = make(64), large = make(64 * kGrowth);
+  check_scaling("scrape", 64, [&](std::size_t n) {
+    g_sink = (n == 64 ? *small : *large).prometheus_text().size();
+  });
+}
+
+TCC_PERF_TEST(perf_smoke, ParallelForScales) {
+  tcc::ThreadPool pool(2);
+  std::vector<float> data(4096 * kGrowth, 1.0f);
+  check_scaling("parallel_for", 4096, [&](std::size_t n) {
+    tcc::parallel_for(pool, {0, n}, 256, [&](tcc::IndexRange r) {
+      for (std::size_t i = r.begin; i < r.end; ++i) data[i] *= 1.0001f;
+    });
+  });
+}
+
+// --- Against a reference ----------------------------------------------------
+
+TCC_PERF_TEST(perf_smoke, FlatHashMapFindVsUnorderedMap) {
+  constexpr std::uint64_t kKeys = 1 << 15;
+  tcc::FlatHashMap<std::uint64_t, std::uint64_t> flat;
+  std::unordered_map<std::uint64_t, std::uint64_t> std_map;
+  for (std::uint64_t i = 0; i < kKeys; ++i) flat[i * 7] = std_map[i * 7] = i;
+  check_against(
+      "find", 3.0,
+      [&] {
+        std::uint64_t hits = 0;
+        for (std::uint64_t i = 0; i < 2 * kKeys; ++i) hits += flat.contains(i * 7 / 2);
+        g_sink = hits;
+      },
+      [&] {
+        std::uint64_t hits = 0;
+        for (std::uint64_t i = 0; i < 2 * kKeys; ++i) hits += std_map.count(i * 7 / 2);
+        g_sink = hits;
+      });
+}
+
+TCC_PERF_TEST(perf_smoke, ArenaVsNewDelete) {
+  constexpr int kAllocs = 1 << 14;
+  std::vector<void*> ptrs(kAllocs);
+  check_against(
+      "allocate", 2.0,
+      [&] {
+        tcc::Arena arena;
+        for (int i = 0; i < kAllocs; ++i) ptrs[static_cast<std::size_t>(i)] = arena.allocate(64);
+        g_sink = reinterpret_cast<std::uintptr_t>(ptrs[kAllocs / 2]);
+      },
+      [&] {
+        for (int i = 0; i < kAllocs; ++i) ptrs[static_cast<std::size_t>(i)] = ::operator new(64);
+        g_sink = reinterpret_cast<std::uintptr_t>(ptrs[kAllocs / 2]);
+        for (void* p : ptrs) ::operator delete(p);
+      });
+}
+
+TCC_PERF_TEST(perf_smoke, CounterVsAtomic) {
+  constexpr int kOps = 1 << 18;
+  tcc::metrics::Registry reg;
+  auto& counter = reg.counter("smoke_ops_total", "Ops");
+  std::atomic<std::uint64_t> atomic{0};
+  check_against(
+      "inc", 4.0, [&] { for (int i = 0; i < kOps; ++i) counter.inc(); },
+      [&] { for (int i = 0; i < kOps; ++i) atomic.fetch_add(1, std::memory_order_relaxed); });
+}
+
+template <class Push, class Pop>
+void ring_traffic(Push push, Pop pop) {
+  std::uint64_t sum = 0, v = 0;
+  for (std::uint64_t i = 0; i < (1 << 16); ++i) {
+    push(i);
+    if (i % 4 == 3) {
+      for (int k = 0; k < 4; ++k) sum += pop(v) ? v : 0;
+    }
+  }
+  g_sink = sum;
+}
+
+TCC_PERF_TEST(perf_smoke, RingsVsMutexDeque) {
+  std::mutex mutex;
+  std::deque<std::uint64_t> deque;
+  auto reference = [&] {
+    ring_traffic([&](std::uint64_t x) { std::lock_guard lock(mutex); deque.push_back(x); },
+                 [&](std::uint64_t& x) {
+                   std::lock_guard lock(mutex);
+                   if (deque.empty()) return false;
+                   x = deque.front();
+                   deque.pop_front();
+                   return true;
+                 });
+  };
+  tcc::MpmcRing<std::uint64_t> mpmc(64);
+  check_against(
+      "mpmc", 2.0,
+      [&] { ring_traffic([&](std::uint64_t x) { mpmc.try_push(x); }, [&](std::uint64_t& x) { return mpmc.try_pop(x); }); },
+      reference);
+  tcc::SpscRing<std::uint64_t, 64> spsc;
+  check_against(
+      "spsc", 2.0,
+      [&] { ring_traffic([&](std::uint64_t x) { spsc.try_push(x); }, [&](std::uint64_t& x) { return spsc.try_pop(x); }); },
+      reference);
+}
+
+TCC_PERF_TEST(perf_smoke, RadixSortVsStdSort) {
+  std::mt19937_64 rng(5);
+  std::vector<std::uint64_t> input(1 << 16), keys;
+  for (auto& k : input) k = rng();
+  check_against(
+      "sort", 2.0,
+      [&] {
+        keys = input;
+        tcc::radix_sort(std::span(keys));
+        g_sink = keys[keys.size() / 2];
+      },
+      [&] {
+        keys = input;
+        std::sort(keys.begin(), keys.end());
+        g_sink = keys[keys.size() / 2];
+      });
+}
+
+TCC_PERF_TEST(perf_smoke, SimdKernelsVsScalar) {
+  std::vector<float> v(1 << 16);
+  std::iota(v.begin(), v.end(), 0.0f);
+  std::vector<std::byte> bytes(1 << 18, std::byte{'a'});
+  const tcc::simd::Kernels& active = tcc::simd::active_kernels();
+  const tcc::simd::Kernels& scalar = tcc::simd::kernels(tcc::simd::Isa::scalar);
+  check_against(
+      "sum", 2.0, [&] { g_sink = static_cast<std::uint64_t>(active.sum(v.data(), v.size())); },
+      [&] { g_sink = static_cast<std::uint64_t>(scalar.sum(v.data(), v.size())); });
+  check_against(
+      "count_byte", 2.0, [&] { g_sink = active.count_byte(bytes.data(), bytes.size(), std::byte{'\n'}); },
+      [&] { g_sink = scalar.count_byte(bytes.data(), bytes.size(), std::byte{'\n'}); });
+}
+
+}  // namespace
@@ -0,0 +1,150 @@
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/arena.hpp"
+
+namespace {
+
+bool aligned(const void* p, std::size_t align) {
+  return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+}
+
+TCC_TEST(arena, AllocateHonoursAlignment) {
+  tcc::Arena arena(256);
+  for (std::size_t align : {1u, 2u, 8u, 16u, 64u, 256u}) {
+    arena.allocate(3, 1);  // knock the bump pointer off alignment
+    TCC_CHECK(aligned(arena.allocate(24, align), align));
+  }
+}
+
+TCC_TEST(arena, GrowsAcrossChunks) {
+  tcc::Arena arena(1024);
+  std::vector<char*> blocks;
+  for (int i = 0; i < 100; ++i) {
+    auto* p = static_cast<char*>(arena.allocate(100, 1));
+    std::memset(p, i, 100);
+    blocks.push_back(p);
+  }
+  TCC_CHECK_LT(1u, arena.chunk_count());
+  TCC_CHECK_LE(100u * 100u, arena.bytes_used());
+  TCC_CHECK_LE(arena.bytes_used(), arena.bytes_reserved());
+  for (int i = 0; i < 100; ++i) TCC_CHECK_EQ(static_cast<int>(blocks[i][99]), i);
+}
+
+TCC_TEST(arena, OversizedAllocationGetsItsOwnChunk) {
+  tcc::Arena arena(1024);
+  void* big = arena.allocate(1 << 20);
+  TCC_CHECK(big != nullptr);
+  TCC_CHECK_LE(std::size_t{1} << 20, arena.bytes_reserved());
+}
+
+TCC_TEST(arena, ResetKeepsChunksReleaseReturnsThem) {
+  tcc::Arena arena(1024);
+  for (int i = 0; i < 50; ++i) arena.allocate(100);
+  const std::size_t reserved = arena.bytes_reserved();
+  const std::size_t chunks = arena.chunk_count();
+
+  arena.reset();
+  TCC_CHECK_EQ(arena.bytes_used(), 0u);
+  TCC_CHECK_EQ(arena.bytes_reserved(), reserved);
+  TCC_CHECK_EQ(arena.chunk_count(), chunks);
+  for (int i = 0; i < 50; ++i) arena.allocate(100);
+  TCC_CHECK_EQ(arena.chunk_count(), chunks);
+
+  arena.release();
+  TCC_CHECK_EQ(arena.bytes_reserved(), 0u);
+  TCC_CHECK_EQ(arena.chunk_count(), 0u);
+}
+
+TCC_TEST(arena, MoveTransfersChunks) {
+  tcc::Arena a(1024);
+  a.allocate(100);
+  const std::size_t reserved = a.bytes_reserved();
+  tcc::Arena b(std::move(a));
+  TCC_CHECK_EQ(b.bytes_reserved(), reserved);
+  TCC_CHECK_EQ(a.bytes_reserved(), 0u);
+  a = std::move(b);
+  TCC_CHECK_EQ(a.bytes_reserved(), reserved);
+}
+
+TCC_TEST(arena, AllocateArrayRejectsOverflow) {
+  tcc::Arena arena;
+  TCC_CHECK_THROWS(arena.allocate_array<std::uint64_t>(SIZE_MAX / 4), std::bad_array_new_length);
+}
+
+TCC_TEST(arena, CreateConstructsInPlace) {
+  struct Point {
+    int x, y;
+  };
+  tcc::Arena arena;
+  Point* p = arena.create<Point>(3, 4);
+  TCC_CHECK_EQ(p->x, 3);
+  TCC_CHECK_EQ(p->y, 4);
+  TCC_CHECK(aligned(p, alignof(Point)));
+}
+
+TCC_TEST(arena, ResourceBacksPmrContainers) {
+  tcc::Arena arena;
+  tcc::ArenaResource resource(arena);
+  {
+    std::pmr::vector<std::pmr::string> names(&resource);
+    for (int i = 0; i < 100; ++i) names.emplace_back("a string too long for the small buffer " + std::to_string(i));
+    TCC_CHECK_EQ(names[42], std::pmr::string("a string too long for the small buffer 42"));
+  }
+  TCC_CHECK_LT(0u, arena.bytes_used());
+
+  tcc::ArenaResource same(arena);
+  tcc::Arena other;
+  tcc::ArenaResource different(other);
+  TCC_CHECK(resource.is_equal(same));
+  TCC_CHECK(!resource.is_equal(different));
+}
+
+TCC_TEST(arena, FixedPoolReusesFreedBlocksLifo) {
+  tcc::FixedPool pool(48);
+  void* a = pool.allocate();
+  void* b = pool.allocate();
+  TCC_CHECK(a != b);
+  TCC_CHECK(aligned(a, alignof(std::max_align_t)));
+  pool.deallocate(a);
+  pool.deallocate(b);
+  TCC_CHECK_EQ(pool.allocate(), b);
+  TCC_CHECK_EQ(pool.allocate(), a);
+  TCC_CHECK_EQ(pool.block_size(), 48u);
+}
+
+TCC_TEST(arena, PoolNewRunsConstructorAndDestructor) {
+  static int live = 0;
+  struct Tracked {
+    explicit Tracked(int v) : value(v) { ++live; }
+    ~Tracked() { --live; }
+    int value;
+  };
+  Tracked* t = tcc::pool_new<Tracked>(7);
+  TCC_CHECK_EQ(t->value, 7);
+  TCC_CHECK_EQ(live, 1);
+  tcc::pool_delete(t);
+  TCC_CHECK_EQ(live, 0);
+  tcc::pool_delete<Tracked>(nullptr);
+}
+
+TCC_TEST(arena, PoolNewReturnsBlockWhenConstructorThrows) {
+  struct Throws {
+    Throws() { throw std::runtime_error("boom"); }
+    char pad[32];
+  };
+  TCC_CHECK_THROWS(tcc::pool_new<Throws>(), std::runtime_error);
+  tcc::FixedPool& pool = tcc::thread_local_pool<Throws>();
+  void* p = pool.allocate();
+  pool.deallocate(p);
+  TCC_CHECK_THROWS(tcc::pool_new<Throws>(), std::runtime_error);
+  TCC_CHECK_EQ(pool.allocate(), p);  // the failed construction handed its block back
+}
+
+}  // namespace
@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/compression.hpp"
+#include "tcc/thread_pool.hpp"
+
+namespace {
+
+constexpr std::size_t kBlock = 4096;
+
+/// Text-like input that compresses, with a random tail that does not.
+std::vector<std::byte> sample_input(std::size_t size) {
+  std::vector<std::byte> data(size);
+  const std::string words = "the quick brown fox jumps over the lazy dog ";
+  for (std::size_t i = 0; i < size; ++i) data[i] = static_cast<std::byte>(words[i % words.size()]);
+  std::mt19937 rng(7);
+  for (std::size_t i = size - std::min<std::size_t>(size, 3 * kBlock); i < size; ++i) {
+    data[i] = static_cast<std::byte>(rng());
+  }
+  return data;
+}
+
+std::vector<std::byte> drain(auto& stream) {
+  std::vector<std::byte> out;
+  std::byte buf[1000];  // deliberately not a multiple of the block size
+  while (std::size_t n = stream.read(buf)) out.insert(out.end(), buf, buf + n);
+  return out;
+}
+
+std::uint32_t load_u32(const std::vector<std::byte>& v, std::size_t at) {
+  std::uint32_t x = 0;
+  for (int i = 0; i < 4; ++i) x |= static_cast<std::uint32_t>(v[at + i]) << (8 * i);
+  return x;
+}
+
+void store_u32(std::vector<std::byte>& v, std::size_t at, std::uint32_t x) {
+  for (int i = 0; i < 4; ++i) v[at + i] = static_cast<std::byte>(x >> (8 * i));
+}
+
+std::vector<std::byte> compress(tcc::ThreadPool& pool, std::span<const std::byte> raw, tcc::Codec codec) {
+  tcc::CompressStream z(pool, tcc::span_source(raw), {.codec = codec, .block_size = kBlock, .max_in_flight = 3});
+  std::vector<std::byte> frame = drain(z);
+  TCC_CHECK_EQ(z.raw_bytes(), raw.size());
+  TCC_CHECK_EQ(z.compressed_bytes(), frame.size());
+  return frame;
+}
+
+TCC_TEST(compression, Lz4AndStoreAlwaysAvailable) {
+  TCC_CHECK(tcc::codec_available(tcc::Codec::store));
+  TCC_CHECK(tcc::codec_available(tcc::Codec::lz4));
+}
+
+TCC_TEST(compression, StreamsRoundTripEveryCodec) {
+  tcc::ThreadPool pool(2);
+  const std::vector<std::byte> raw = sample_input(20 * kBlock + 123);
+  for (tcc::Codec codec : {tcc::Codec::store, tcc::Codec::lz4, tcc::Codec::zstd}) {
+    if (!tcc::codec_available(codec)) continue;
+    const std::vector<std::byte> frame = compress(pool, raw, codec);
+    if (codec != tcc::Codec::store) TCC_CHECK_LT(frame.size(), raw.size());
+    tcc::DecompressStream d(pool, tcc::span_source(frame), 2);
+    TCC_CHECK(drain(d) == raw);
+  }
+}
+
+TCC_TEST(compression, EmptyInputMakesValidFrame) {
+  tcc::ThreadPool pool(1);
+  const std::vector<std::byte> frame = compress(pool, {}, tcc::Codec::lz4);
+  tcc::DecompressStream d(pool, tcc::span_source(frame));
+  TCC_CHECK(drain(d).empty());
+  tcc::FrameReader reader(frame);
+  TCC_CHECK_EQ(reader.size(), 0u);
+  TCC_CHECK_EQ(reader.block_count(), 0u);
+}
+
+TCC_TEST(compression, FrameReaderSeeks) {
+  tcc::ThreadPool pool(2);
+  const std::vector<std::byte> raw = sample_input(10 * kBlock + 77);
+  const std::vector<std::byte> frame = compress(pool, raw, tcc::Codec::lz4);
+  tcc::FrameReader reader(frame);
+  TCC_CHECK_EQ(reader.size(), raw.size());
+  TCC_CHECK_EQ(reader.block_size(), kBlock);
+  TCC_CHECK_EQ(reader.block_count(), 11u);
+  TCC_CHECK_EQ(reader.block_raw_size(10), 77u);
+  TCC_CHECK(reader.codec() == tcc::Codec::lz4);
+
+  for (std::uint64_t offset : {0ull, 1ull, 4095ull, 4096ull, 12345ull, 40'000ull}) {
+    std::vector<std::byte> out(5000);
+    const std::size_t n = reader.read(offset, out);
+    const std::size_t expected = std::min<std::size_t>(out.size(), raw.size() - offset);
+    TCC_REQUIRE_EQ(n, expected);
+    TCC_CHECK(std::equal(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(n),
+                         raw.begin() + static_cast<std::ptrdiff_t>(offset)));
+  }
+  std::vector<std::byte> all(raw.size());
+  TCC_CHECK_EQ(reader.read(pool, 0, all), raw.size());
+  TCC_CHECK(all == raw);
+}
+
+TCC_TEST(compression, InvalidOptionsThrow) {
+  tcc::ThreadPool pool(1);
+  const std::vector<std::byte> raw(10);
+  TCC_CHECK_THROWS(tcc::CompressStream(pool, tcc::span_source(raw), {.block_size = 100}), std::invalid_argument);
+  if (!tcc::codec_available(tcc::Codec::zstd)) {
+    TCC_CHECK_THROWS(tcc::CompressStream(pool, tcc::span_source(raw), {.codec = tcc::Codec::zstd}),
+                     std::invalid_argument);
+  }
+}
+
+TCC_TEST(compression, CorruptFramesAreRejected) {
+  tcc::ThreadPool pool(2);
+  const std::vector<std::byte> raw = sample_input(4 * kBlock);
+  const std::vector<std::byte> frame = compress(pool, raw, tcc::Codec::lz4);
+
+  std::vector<std::byte> bad_magic = frame;
+  bad_magic[0] = std::byte{0};
+  TCC_CHECK_THROWS(tcc::FrameReader{bad_magic}, tcc::CompressionError);
+  {
+    tcc::DecompressStream d(pool, tcc::span_source(bad_magic));
+    TCC_CHECK_THROWS(drain(d), tcc::CompressionError);
+  }
+
+  const std::span<const std::byte> truncated(frame.data(), frame.size() / 2);
+  TCC_CHECK_THROWS(tcc::FrameReader{truncated}, tcc::CompressionError);
+  tcc::DecompressStream d(pool, tcc::span_source(truncated));
+  TCC_CHECK_THROWS(drain(d), tcc::CompressionError);
+}
+
+// The second header is read while the first block is still decoding on
+// the pool; the error must not free that block under the worker.
+TCC_TEST(compression, CorruptHeaderBehindABlockInFlight) {
+  tcc::ThreadPool pool(2);
+  const std::vector<std::byte> raw = sample_input(4 * kBlock);
+  std::vector<std::byte> frame = compress(pool, raw, tcc::Codec::lz4);
+  const std::size_t first = 16;  // after the frame header
+  const std::uint32_t stored = load_u32(frame, first) & 0x7fffffffu;
+  store_u32(frame, first + 8 + stored + 4, 0);  // second block: raw size 0
+  tcc::DecompressStream d(pool, tcc::span_source(frame), 1);
+  TCC_CHECK_THROWS(drain(d), tcc::CompressionError);
+}
+
+// A few bytes of lz4 cannot decode to half a GiB: rejected before a
+// reader allocates the block.
+TCC_TEST(compression, ImplausibleBlockSizesAreRejected) {
+  tcc::ThreadPool pool(2);
+  const std::vector<std::byte> raw(2000, std::byte{'a'});
+  std::vector<std::byte> frame = compress(pool, raw, tcc::Codec::lz4);
+  TCC_REQUIRE((load_u32(frame, 16) & 0x80000000u) == 0);  // compressed, not stored
+  constexpr std::uint32_t kClaimed = 1u << 29;
+  store_u32(frame, 8, 1u << 30);        // block size
+  store_u32(frame, 16 + 4, kClaimed);   // raw size of the only block
+  store_u32(frame, frame.size() - 16, kClaimed);  // raw size in the footer (low half)
+  TCC_CHECK_THROWS(tcc::FrameReader{frame}, tcc::CompressionError);
+  tcc::DecompressStream d(pool, tcc::span_source(frame));
+  TCC_CHECK_THROWS(drain(d), tcc::CompressionError);
+}
+
+// A footer claiming 2^64 - 1 raw bytes in zero blocks: the block count
+// must not wrap round to match.
+TCC_TEST(compression, FooterRawSizeNearTwoToThe64) {
+  tcc::ThreadPool pool(1);
+  std::vector<std::byte> frame = compress(pool, {}, tcc::Codec::lz4);
+  TCC_REQUIRE_EQ(frame.size(), 40u);
+  store_u32(frame, frame.size() - 16, 0xffffffffu);
+  store_u32(frame, frame.size() - 12, 0xffffffffu);
+  TCC_CHECK_THROWS(tcc::FrameReader{frame}, tcc::CompressionError);
+}
+
+TCC_TEST(compression, SourceExceptionsPropagate) {
+  tcc::ThreadPool pool(1);
+  int calls = 0;
+  tcc::CompressStream z(pool, [&](std::span<std::byte> out) -> std::size_t {
+    if (++calls > 2) throw std::runtime_error("source failed");
+    std::fill(out.begin(), out.end(), std::byte{'a'});
+    return out.size();
+  }, {.block_size = kBlock});
+  TCC_CHECK_THROWS(drain(z), std::runtime_error);
+}
+
+}  // namespace
@@ -0,0 +1,133 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/concurrent_cache.hpp"
+#include "tcc/metrics.hpp"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+TCC_TEST(concurrent_cache, GetPutEraseClear) {
+  tcc::ConcurrentCache<std::string, int> cache({.capacity = 100});
+  TCC_CHECK(!cache.get("a").has_value());
+  TCC_CHECK(cache.put("a", 1));
+  TCC_CHECK(cache.put("b", 2));
+  TCC_CHECK(cache.put("a", 3));  // replace
+  TCC_CHECK_EQ(cache.get("a").value_or(0), 3);
+  TCC_CHECK_EQ(cache.get("b").value_or(0), 2);
+  TCC_CHECK(cache.erase("b"));
+  TCC_CHECK(!cache.erase("b"));
+  TCC_CHECK(!cache.get("b").has_value());
+
+  auto s = cache.stats();
+  TCC_CHECK_EQ(s.hits, 2u);
+  TCC_CHECK_EQ(s.misses, 2u);
+  TCC_CHECK_EQ(s.inserts, 2u);
+  TCC_CHECK_EQ(s.entries, 1u);
+  TCC_CHECK_EQ(s.weight, 1u);
+  cache.clear();
+  TCC_CHECK_EQ(cache.stats().entries, 0u);
+  TCC_CHECK_EQ(cache.get_or_load("c", [] { return 7; }), 7);
+  TCC_CHECK_EQ(cache.get_or_load("c", [] { return 8; }), 7);
+}
+
+TCC_TEST(concurrent_cache, ClockGivesReadEntriesASecondChance) {
+  tcc::ConcurrentCache<int, int> cache({.capacity = 3, .shards = 1});
+  for (int k = 0; k < 3; ++k) cache.put(k, k);
+  TCC_CHECK(cache.get(0).has_value());  // referenced
+  cache.put(3, 3);                      // hand skips 0, evicts 1
+  TCC_CHECK(cache.get(0).has_value());
+  TCC_CHECK(!cache.get(1).has_value());
+  TCC_CHECK(cache.get(2).has_value());
+  TCC_CHECK(cache.get(3).has_value());
+  TCC_CHECK_EQ(cache.stats().evictions, 1u);
+  TCC_CHECK_EQ(cache.stats().entries, 3u);
+}
+
+TCC_TEST(concurrent_cache, CapacityIsWeighted) {
+  const auto by_length = [](const int&, const std::string& v) { return v.size(); };
+  tcc::ConcurrentCache<int, std::string, tcc::FlatHash<int>, std::equal_to<>, decltype(by_length)> cache(
+      {.capacity = 10, .shards = 1}, by_length);
+  TCC_CHECK(cache.put(1, "aaaa"));
+  TCC_CHECK(cache.put(2, "bbbb"));
+  TCC_CHECK_EQ(cache.stats().weight, 8u);
+  TCC_CHECK(cache.put(3, "cccc"));  // 12 > 10: one of the others goes
+  TCC_CHECK_EQ(cache.stats().entries, 2u);
+  TCC_CHECK_LE(cache.stats().weight, 10u);
+  TCC_CHECK(!cache.put(3, "much too heavy"));  // rejected, old value dropped
+  TCC_CHECK(!cache.get(3).has_value());
+  // Growing an entry in place evicts others, never the entry itself.
+  TCC_CHECK(cache.put(4, "dd"));
+  TCC_CHECK(cache.put(4, "dddddddddd"));
+  TCC_CHECK_EQ(cache.get(4).value_or(""), "dddddddddd");
+  TCC_CHECK_EQ(cache.stats().weight, 10u);
+}
+
+TCC_TEST(concurrent_cache, EntriesExpire) {
+  tcc::ConcurrentCache<int, int> cache({.capacity = 2, .shards = 1, .ttl = 20ms});
+  cache.put(1, 1);
+  cache.put(2, 2, 0ns);  // never expires
+  TCC_CHECK(cache.get(1).has_value());
+  std::this_thread::sleep_for(40ms);
+  TCC_CHECK(!cache.get(1).has_value());
+  TCC_CHECK(cache.get(2).has_value());
+  cache.put(3, 3);  // the expired entry is the victim, despite its reference bit
+  TCC_CHECK(cache.get(2).has_value());
+  const auto s = cache.stats();
+  TCC_CHECK_EQ(s.expirations, 1u);
+  TCC_CHECK_EQ(s.evictions, 0u);
+}
+
+TCC_TEST(concurrent_cache, ExportsMetrics) {
+  tcc::metrics::Registry registry(1);
+  {
+    tcc::ConcurrentCache<int, int> cache({.capacity = 8, .registry = &registry, .name = "users"});
+    cache.put(1, 1);
+    cache.get(1);
+    cache.get(2);
+    const std::string text = registry.prometheus_text();
+    TCC_CHECK(text.find("tcc_cache_hits_total{cache=\"users\"} 1") != std::string::npos);
+    TCC_CHECK(text.find("tcc_cache_misses_total{cache=\"users\"} 1") != std::string::npos);
+    TCC_CHECK(text.find("tcc_cache_entries{cache=\"users\"} 1") != std::string::npos);
+  }
+  // Destroying the cache empties its gauges.
+  TCC_CHECK(registry.prometheus_text().find("tcc_cache_entries{cache=\"users\"} 0") != std::string::npos);
+}
+
+TCC_TEST(concurrent_cache, ConcurrentReadersAndWriters) {
+  tcc::ConcurrentCache<std::uint64_t, std::uint64_t> cache({.capacity = 512, .shards = 8});
+  constexpr int kThreads = 4, kOps = 20'000;
+  std::atomic<bool> wrong{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      std::uint64_t x = static_cast<std::uint64_t>(t) + 1;
+      for (int i = 0; i < kOps; ++i) {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        const std::uint64_t key = (x >> 33) % 1024;
+        if (i % 4 == 0) {
+          cache.put(key, key * 3);
+        } else if (auto v = cache.get(key); v && *v != key * 3) {
+          wrong = true;
+        }
+      }
+    });
+  }
+  for (auto& th : threads) th.join();
+  TCC_CHECK(!wrong.load());
+  const auto s = cache.stats();
+  TCC_CHECK_EQ(s.hits + s.misses, std::uint64_t{kThreads} * kOps * 3 / 4);
+  TCC_CHECK_LE(s.weight, 512u);
+  TCC_CHECK_EQ(s.entries, s.weight);
+  TCC_CHECK_EQ(s.inserts - s.evictions, s.entries);
+}
+
+}  // namespace
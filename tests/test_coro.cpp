@@ -0,0 +1,147 @@
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/coro.hpp"
+#include "tcc/thread_pool.hpp"
+
+namespace {
+
+tcc::Task<int> answer() { co_return 42; }
+
+tcc::Task<int> add_answers() {
+  const int a = co_await answer();
+  co_return a + co_await answer();
+}
+
+tcc::Task<int> chain(int depth) {
+  if (depth == 0) co_return 0;
+  co_return 1 + co_await chain(depth - 1);
+}
+
+tcc::Task<void> fails() {
+  throw std::runtime_error("task failed");
+  co_return;
+}
+
+tcc::Task<std::thread::id> hop(tcc::ThreadPool& pool) {
+  co_await tcc::schedule(pool);
+  co_return std::this_thread::get_id();
+}
+
+tcc::Generator<int> iota(int n) {
+  for (int i = 0; i < n; ++i) co_yield i;
+}
+
+tcc::Generator<int> throws_after(int n) {
+  for (int i = 0; i < n; ++i) co_yield i;
+  throw std::runtime_error("generator failed");
+}
+
+TCC_TEST(coro, TaskIsLazyAndReturnsValue) {
+  tcc::Task<int> task = answer();
+  TCC_CHECK(task.valid());
+  TCC_CHECK(!task.done());
+  TCC_CHECK_EQ(tcc::sync_wait(std::move(task)), 42);
+  TCC_CHECK_EQ(tcc::sync_wait(add_answers()), 84);
+}
+
+TCC_TEST(coro, DeepChainDoesNotGrowTheStack) {
+  // Symmetric transfer: 100k nested awaits would overflow a recursive resume.
+  TCC_CHECK_EQ(tcc::sync_wait(chain(100'000)), 100'000);
+}
+
+TCC_TEST(coro, ExceptionPropagatesToAwaiter) {
+  TCC_CHECK_THROWS(tcc::sync_wait(fails()), std::runtime_error);
+}
+
+TCC_TEST(coro, AwaitingAnEmptyTaskThrows) {
+  auto await_empty = []() -> tcc::Task<int> { co_return co_await tcc::Task<int>{}; };
+  TCC_CHECK_THROWS(tcc::sync_wait(await_empty()), std::logic_error);
+  tcc::Task<int> task = answer();
+  tcc::Task<int> moved = std::move(task);
+  TCC_CHECK(!task.valid());
+  TCC_CHECK_THROWS(tcc::sync_wait(std::move(task)), std::logic_error);
+  TCC_CHECK_EQ(tcc::sync_wait(std::move(moved)), 42);
+}
+
+TCC_TEST(coro, MoveOnlyResult) {
+  auto make = []() -> tcc::Task<std::unique_ptr<std::string>> {
+    co_return std::make_unique<std::string>("moved");
+  };
+  std::unique_ptr<std::string> s = tcc::sync_wait(make());
+  TCC_REQUIRE(s != nullptr);
+  TCC_CHECK_EQ(*s, std::string("moved"));
+}
+
+TCC_TEST(coro, ScheduleResumesOnPoolWorker) {
+  tcc::ThreadPool pool(2);
+  const std::thread::id worker = tcc::sync_wait(hop(pool));
+  TCC_CHECK(worker != std::this_thread::get_id());
+}
+
+TCC_TEST(coro, SpawnRunsDetachedTasks) {
+  tcc::ThreadPool pool(2);
+  std::atomic<int> ran{0};
+  std::atomic<bool> done{false};
+  constexpr int kTasks = 64;
+  auto work = [&]() -> tcc::Task<void> {
+    if (ran.fetch_add(1) + 1 == kTasks) {
+      done.store(true);
+      pool.notify_waiters();
+    }
+    co_return;
+  };
+  for (int i = 0; i < kTasks; ++i) tcc::spawn(pool, work());
+  pool.wait(done);
+  TCC_CHECK_EQ(ran.load(), kTasks);
+}
+
+TCC_TEST(coro, DestroyingUnstartedTaskSkipsBody) {
+  bool ran = false;
+  {
+    auto body = [&]() -> tcc::Task<void> {
+      ran = true;
+      co_return;
+    };
+    tcc::Task<void> task = body();
+  }
+  TCC_CHECK(!ran);
+}
+
+TCC_TEST(coro, GeneratorYieldsInOrder) {
+  std::vector<int> seen;
+  for (int x : iota(5)) seen.push_back(x);
+  TCC_CHECK(seen == std::vector<int>({0, 1, 2, 3, 4}));
+  int count = 0;
+  for ([[maybe_unused]] int x : iota(0)) ++count;
+  TCC_CHECK_EQ(count, 0);
+}
+
+TCC_TEST(coro, GeneratorRethrowsFromIncrement) {
+  int seen = 0;
+  TCC_CHECK_THROWS(
+      [&] {
+        for (int x : throws_after(3)) seen += x;
+      }(),
+      std::runtime_error);
+  TCC_CHECK_EQ(seen, 0 + 1 + 2);
+}
+
+TCC_TEST(coro, FrameAllocatorRecyclesPerThread) {
+  void* a = tcc::detail::frame_allocate(200);
+  tcc::detail::frame_deallocate(a, 200);
+  void* b = tcc::detail::frame_allocate(200);
+  TCC_CHECK_EQ(a, b);
+  tcc::detail::frame_deallocate(b, 200);
+
+  void* big = tcc::detail::frame_allocate(tcc::detail::kMaxRecycledFrame * 4);
+  TCC_CHECK(big != nullptr);
+  tcc::detail::frame_deallocate(big, tcc::detail::kMaxRecycledFrame * 4);
+}
+
+}  // namespace
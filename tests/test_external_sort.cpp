@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/external_sort.hpp"
+#include "tcc/mapped_file.hpp"
+#include "tcc/thread_pool.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+struct Row {
+  std::uint32_t key;
+  std::uint32_t seq;  // input position, to check stability
+};
+
+constexpr auto kRowKey = [](const Row& r) { return r.key; };
+
+std::vector<Row> make_rows(std::size_t n, std::uint32_t key_range) {
+  std::mt19937 rng(42);
+  std::vector<Row> rows(n);
+  for (std::size_t i = 0; i < n; ++i) rows[i] = {static_cast<std::uint32_t>(rng() % key_range), static_cast<std::uint32_t>(i)};
+  return rows;
+}
+
+bool stably_sorted(std::span<const Row> rows) {
+  return std::is_sorted(rows.begin(), rows.end(),
+                        [](const Row& a, const Row& b) { return a.key < b.key || (a.key == b.key && a.seq < b.seq); });
+}
+
+template <class T>
+std::vector<T> read_records(const fs::path& path) {
+  tcc::MappedFile file(path, tcc::Advice::normal);
+  const auto* first = reinterpret_cast<const T*>(file.data());
+  return {first, first + file.size() / sizeof(T)};
+}
+
+/// A fresh directory for spill files, removed when the test ends.
+class TempDir {
+ public:
+  TempDir() : path_(fs::temp_directory_path() / ("tcc_tests_sort_" + std::to_string(std::random_device{}()))) {
+    fs::create_directories(path_);
+  }
+  ~TempDir() {
+    std::error_code ec;
+    fs::remove_all(path_, ec);
+  }
+  const fs::path& path() const noexcept { return path_; }
+  bool only_holds(std::size_t files) const {
+    return static_cast<std::size_t>(std::distance(fs::directory_iterator(path_), fs::directory_iterator())) == files;
+  }
+
+ private:
+  fs::path path_;
+};
+
+// --- radix_sort ---------------------------------------------------------------
+
+TCC_TEST(external_sort, RadixSortMatchesStdSort) {
+  std::mt19937_64 rng(7);
+  std::vector<std::uint64_t> keys(10'000);
+  for (auto& k : keys) k = rng();
+  std::vector<std::uint64_t> expected = keys;
+  std::sort(expected.begin(), expected.end());
+  tcc::radix_sort(std::span(keys));
+  TCC_CHECK(keys == expected);
+}
+
+TCC_TEST(external_sort, RadixSortOrdersSignedKeys) {
+  std::vector<std::int32_t> keys = {5, -1, 0, std::numeric_limits<std::int32_t>::min(), 42, -42,
+                                    std::numeric_limits<std::int32_t>::max(), -1};
+  std::vector<std::int32_t> expected = keys;
+  std::sort(expected.begin(), expected.end());
+  tcc::radix_sort(std::span(keys));
+  TCC_CHECK(keys == expected);
+}
+
+TCC_TEST(external_sort, RadixSortIsStableWithProjection) {
+  // A small key range leaves the upper key bytes constant: those passes are skipped.
+  std::vector<Row> rows = make_rows(5'000, 100);
+  tcc::radix_sort(std::span(rows), kRowKey);
+  TCC_CHECK(stably_sorted(rows));
+}
+
+TCC_TEST(external_sort, ParallelRadixSortMatchesSequential) {
+  tcc::ThreadPool pool(3);
+  std::vector<Row> rows = make_rows(300'000, 1u << 20), scratch(rows.size());
+  std::vector<Row> sequential = rows;
+  tcc::radix_sort(pool, std::span(rows), std::span(scratch), kRowKey);
+  tcc::radix_sort(std::span(sequential), kRowKey);
+  TCC_CHECK(stably_sorted(rows));
+  TCC_CHECK(std::equal(rows.begin(), rows.end(), sequential.begin(),
+                       [](const Row& a, const Row& b) { return a.key == b.key && a.seq == b.seq; }));
+  std::vector<Row> small(rows.size() - 1);
+  TCC_CHECK_THROWS(tcc::radix_sort(pool, std::span(rows), std::span(small), kRowKey), std::invalid_argument);
+}
+
+// --- LoserTree ----------------------------------------------------------------
+
+TCC_TEST(external_sort, LoserTreeMergesInOrder) {
+  const std::vector<std::vector<int>> sources = {{1, 4, 9}, {}, {2, 2, 8}, {0}, {3, 5, 6, 7}};
+  tcc::detail::LoserTree<int> tree(sources.size());
+  std::vector<std::size_t> pos(sources.size(), 0);
+  for (std::size_t i = 0; i < sources.size(); ++i) {
+    if (!sources[i].empty()) tree.set(i, sources[i][0]);
+  }
+  tree.build();
+  std::vector<int> merged;
+  while (!tree.empty()) {
+    const std::size_t w = tree.winner();
+    merged.push_back(sources[w][pos[w]]);
+    if (++pos[w] == sources[w].size()) {
+      tree.pop();
+    } else {
+      tree.replace(sources[w][pos[w]]);
+    }
+  }
+  TCC_CHECK((merged == std::vector<int>{0, 1, 2, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+// --- external_sort ------------------------------------------------------------
+
+TCC_TEST(external_sort, SortsInMemoryWhenOneRunFits) {
+  TempDir dir;
+  const std::vector<Row> rows = make_rows(1'000, 50);
+  const auto stats = tcc::external_sort<Row>(std::span(rows), dir.path() / "out.bin", {}, kRowKey);
+  TCC_CHECK_EQ(stats.records, 1'000u);
+  TCC_CHECK_EQ(stats.runs, 1u);
+  TCC_CHECK_EQ(stats.merge_passes, 0u);
+  TCC_CHECK_EQ(stats.bytes_spilled, 0u);
+  const auto sorted = read_records<Row>(dir.path() / "out.bin");
+  TCC_CHECK_EQ(sorted.size(), rows.size());
+  TCC_CHECK(stably_sorted(sorted));
+}
+
+TCC_TEST(external_sort, SpillsAndMergesInSeveralPasses) {
+  TempDir dir, spill;
+  tcc::ThreadPool pool(2);
+  const std::vector<Row> rows = make_rows(20'000, 1'000);
+  // 20 runs of 1000 records, fan-in 3: 20 -> 7 -> 3 -> output.
+  const tcc::ExternalSortOptions options{
+      .run_bytes = 1'000 * sizeof(Row), .fan_in = 3, .temp_dir = spill.path(), .pool = &pool};
+  const auto stats = tcc::external_sort<Row>(std::span(rows), dir.path() / "out.bin", options, kRowKey);
+  TCC_CHECK_EQ(stats.runs, 20u);
+  TCC_CHECK_EQ(stats.merge_passes, 3u);
+  TCC_CHECK_EQ(stats.bytes_spilled, 3 * rows.size() * sizeof(Row));
+  const auto sorted = read_records<Row>(dir.path() / "out.bin");
+  TCC_CHECK_EQ(sorted.size(), rows.size());
+  TCC_CHECK(stably_sorted(sorted));
+  TCC_CHECK(spill.only_holds(0));
+}
+
+TCC_TEST(external_sort, SortsFiles) {
+  TempDir dir;
+  std::mt19937_64 rng(3);
+  std::vector<std::int64_t> keys(50'000);
+  for (auto& k : keys) k = static_cast<std::int64_t>(rng());
+  const fs::path input = dir.path() / "in.bin", output = dir.path() / "out.bin";
+  std::ofstream(input, std::ios::binary)
+      .write(reinterpret_cast<const char*>(keys.data()), static_cast<std::streamsize>(keys.size() * sizeof(keys[0])));
+
+  const auto stats = tcc::external_sort<std::int64_t>(input, output, {.run_bytes = 64 * 1024, .temp_dir = dir.path()});
+  TCC_CHECK_LE(std::uint64_t{2}, stats.runs);
+  std::sort(keys.begin(), keys.end());
+  TCC_CHECK(read_records<std::int64_t>(output) == keys);
+  TCC_CHECK(dir.only_holds(2));  // spill directory gone
+
+  TCC_CHECK_THROWS(tcc::external_sort<std::int64_t>(input, input), std::invalid_argument);
+  TCC_CHECK_THROWS(tcc::external_sort<Row>(output, dir.path() / "x.bin", {.fan_in = 1}, kRowKey), std::invalid_argument);
+  std::ofstream(input, std::ios::binary | std::ios::app).write("abc", 3);
+  TCC_CHECK_THROWS(tcc::external_sort<std::int64_t>(input, output), std::invalid_argument);
+}
+
+TCC_TEST(external_sort, EmptyInputWritesEmptyOutput) {
+  TempDir dir;
+  const auto stats = tcc::external_sort<std::uint32_t>(std::span<const std::uint32_t>(), dir.path() / "out.bin");
+  TCC_CHECK_EQ(stats.records, 0u);
+  TCC_CHECK(fs::exists(dir.path() / "out.bin"));
+  TCC_CHECK_EQ(fs::file_size(dir.path() / "out.bin"), 0u);
+}
+
+}  // namespace
@@ -0,0 +1,128 @@
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "harness.hpp"
+#include "tcc/flat_hash_map.hpp"
+
+namespace {
+
+TCC_TEST(flat_hash_map, InsertFindErase) {
+  tcc::FlatHashMap<int, int> map;
+  TCC_CHECK(map.empty());
+  TCC_CHECK(map.find(1) == map.end());
+
+  auto [it, inserted] = map.try_emplace(1, 10);
+  TCC_CHECK(inserted);
+  TCC_CHECK_EQ(it->second, 10);
+  TCC_CHECK(!map.try_emplace(1, 20).second);
+  TCC_CHECK_EQ(map.at(1), 10);
+  TCC_CHECK(!map.insert_or_assign(1, 30).second);
+  TCC_CHECK_EQ(map[1], 30);
+  ++map[2];
+  TCC_CHECK_EQ(map.size(), 2u);
+  TCC_CHECK_EQ(map.count(2), 1u);
+
+  TCC_CHECK_EQ(map.erase(1), 1u);
+  TCC_CHECK_EQ(map.erase(1), 0u);
+  TCC_CHECK(!map.contains(1));
+  TCC_CHECK_THROWS(map.at(1), std::out_of_range);
+}
+
+TCC_TEST(flat_hash_map, MatchesUnorderedMapUnderRandomOps) {
+  tcc::FlatHashMap<std::uint64_t, std::uint64_t> map;
+  std::unordered_map<std::uint64_t, std::uint64_t> reference;
+  std::mt19937_64 rng(12345);
+  for (int i = 0; i < 200'000; ++i) {
+    const std::uint64_t key = rng() % 5000 * 64;  // multiples of 64 stress H2
+    switch (rng() % 3) {
+      case 0:
+        map[key] = static_cast<std::uint64_t>(i);
+        reference[key] = static_cast<std::uint64_t>(i);
+        break;
+      case 1:
+        TCC_CHECK_EQ(map.erase(key), reference.erase(key));
+        break;
+      default:
+        TCC_CHECK_EQ(map.contains(key), reference.count(key) == 1);
+    }
+  }
+  TCC_REQUIRE_EQ(map.size(), reference.size());
+  std::size_t seen = 0;
+  for (const auto& [k, v] : map) {
+    ++seen;
+    auto it = reference.find(k);
+    TCC_REQUIRE(it != reference.end());
+    TCC_CHECK_EQ(v, it->second);
+  }
+  TCC_CHECK_EQ(seen, reference.size());
+}
+
+TCC_TEST(flat_hash_map, CapacityIsPowerOfTwoMinusOne) {
+  tcc::FlatHashMap<int, int> map;
+  for (int i = 0; i < 1000; ++i) map[i] = i;
+  const std::size_t cap = map.capacity();
+  TCC_CHECK_EQ(cap & (cap + 1), 0u);
+  TCC_CHECK_LE(map.load_factor(), 7.0f / 8.0f);
+}
+
+TCC_TEST(flat_hash_map, ReserveAvoidsRehash) {
+  tcc::FlatHashMap<int, int> map;
+  map.reserve(10'000);
+  const std::size_t cap = map.capacity();
+  map[0] = 0;
+  const auto* first = &*map.find(0);
+  for (int i = 1; i < 10'000; ++i) map[i] = i;
+  TCC_CHECK_EQ(map.capacity(), cap);
+  TCC_CHECK_EQ(&*map.find(0), first);
+
+  for (int i = 0; i < 9'990; ++i) map.erase(i);
+  map.rehash(0);
+  TCC_CHECK_LT(map.capacity(), cap);
+  TCC_CHECK_EQ(map.size(), 10u);
+  TCC_CHECK_EQ(map.at(9'995), 9'995);
+}
+
+TCC_TEST(flat_hash_map, HeterogeneousStringLookup) {
+  tcc::FlatHashMap<std::string, int> map{{"alpha", 1}, {"beta", 2}};
+  const std::string_view key = "beta";
+  TCC_CHECK(map.find(key) != map.end());
+  TCC_CHECK_EQ(map.at("alpha"), 1);
+  TCC_CHECK_EQ(map.erase(std::string_view("alpha")), 1u);
+  TCC_CHECK(!map.contains("alpha"));
+}
+
+TCC_TEST(flat_hash_map, CopyMoveAndEquality) {
+  tcc::FlatHashMap<std::string, std::string> a;
+  for (int i = 0; i < 100; ++i) a[std::to_string(i)] = std::string(40, static_cast<char>('a' + i % 26));
+  tcc::FlatHashMap<std::string, std::string> b = a;
+  TCC_CHECK(a == b);
+  b["0"] = "changed";
+  TCC_CHECK(!(a == b));
+
+  tcc::FlatHashMap<std::string, std::string> c = std::move(b);
+  TCC_CHECK_EQ(c.size(), 100u);
+  TCC_CHECK(b.empty());
+  c.swap(b);
+  TCC_CHECK(c.empty());
+  TCC_CHECK_EQ(b.at("0"), std::string("changed"));
+}
+
+TCC_TEST(flat_hash_map, MoveOnlyValuesAndEraseByIterator) {
+  tcc::FlatHashMap<int, std::unique_ptr<int>> map;
+  for (int i = 0; i < 100; ++i) map.emplace(i, std::make_unique<int>(i * 2));
+  for (auto it = map.begin(); it != map.end();) {
+    it = it->first % 2 == 0 ? map.erase(it) : std::next(it);
+  }
+  TCC_CHECK_EQ(map.size(), 50u);
+  TCC_CHECK_EQ(*map.at(7), 14);
+  map.clear();
+  TCC_CHECK(map.empty());
+  TCC_CHECK(map.begin() == map.end());
+}
+
+}  // namespace
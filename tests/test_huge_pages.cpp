@@ -0,0 +1,160 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <string>
+#include <system_error>
+
+#include "harness.hpp"
+#include "tcc/arena.hpp"
+#include "tcc/huge_pages.hpp"
+#include "tcc/mapped_file.hpp"
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+constexpr std::size_t kMiB = std::size_t{1} << 20;
+
+#if defined(__linux__)
+/// This process's mapped address space (VmSize in /proc/self/status).
+std::size_t address_space_bytes() {
+  std::ifstream in("/proc/self/status");
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.compare(0, 7, "VmSize:") == 0) return std::stoull(line.substr(7)) * 1024;
+  }
+  return 0;
+}
+#endif
+
+// Every policy must hand back usable memory whatever the machine offers;
+// the tier that served it is only visible in the counters.
+TCC_TEST(huge_pages, EveryPolicyAllocates) {
+  for (auto policy : {tcc::PagePolicy::small, tcc::PagePolicy::transparent, tcc::PagePolicy::hugetlb}) {
+    tcc::HugePageResource resource({.policy = policy});
+    void* p = resource.allocate(3 * kMiB, 64);
+    TCC_REQUIRE(p != nullptr);
+    std::memset(p, 0x5a, 3 * kMiB);
+    const auto s = resource.stats();
+    TCC_CHECK_EQ(s.hugetlb_bytes + s.transparent_bytes + s.small_bytes, s.mapped_bytes);
+    TCC_CHECK_LE(3 * kMiB, s.mapped_bytes);
+    if (policy == tcc::PagePolicy::small) TCC_CHECK_EQ(s.fallbacks, 0u);
+    resource.deallocate(p, 3 * kMiB, 64);
+    TCC_CHECK_EQ(resource.stats().mapped_bytes, 0u);
+  }
+}
+
+TCC_TEST(huge_pages, HugeMappingsAreHugePageAligned) {
+  tcc::HugePageResource resource({.policy = tcc::PagePolicy::transparent});
+  TCC_CHECK_EQ(resource.granularity(), tcc::huge_page_size());
+  void* p = resource.allocate(100, tcc::huge_page_size());
+  TCC_CHECK_EQ(reinterpret_cast<std::uintptr_t>(p) % tcc::huge_page_size(), 0u);
+  TCC_CHECK_EQ(resource.stats().mapped_bytes, tcc::huge_page_size());
+  resource.deallocate(p, 100, tcc::huge_page_size());
+  TCC_CHECK_THROWS(resource.allocate(100, 2 * tcc::huge_page_size()), std::bad_alloc);
+}
+
+// With no room for the aligned over-mapping, a transparent request lands on
+// small pages; it must still map the whole huge page deallocate unmaps.
+TCC_TEST(huge_pages, SmallPageFallbackKeepsHugePageLength) {
+#if defined(__linux__)
+  const std::size_t huge = tcc::huge_page_size();
+  tcc::HugePageResource resource({.policy = tcc::PagePolicy::transparent});
+  rlimit old{};
+  TCC_REQUIRE(::getrlimit(RLIMIT_AS, &old) == 0);
+  const std::size_t used = address_space_bytes();
+  TCC_REQUIRE(used != 0);
+  rlimit tight = old;
+  tight.rlim_cur = used + huge + huge / 2;  // room for one huge page, not for huge + alignment
+  if (tight.rlim_cur > old.rlim_cur || ::setrlimit(RLIMIT_AS, &tight) != 0) return;
+  void* p = nullptr;
+  try {
+    p = resource.allocate(100);
+  } catch (const std::bad_alloc&) {
+  }
+  ::setrlimit(RLIMIT_AS, &old);
+  TCC_REQUIRE(p != nullptr);
+  const auto s = resource.stats();
+  TCC_CHECK_EQ(s.fallbacks, 1u);
+  TCC_CHECK_EQ(s.small_bytes, huge);
+  TCC_CHECK_EQ(s.mapped_bytes, huge);
+  resource.deallocate(p, 100);
+  TCC_CHECK_EQ(resource.stats().mapped_bytes, 0u);
+#endif
+}
+
+TCC_TEST(huge_pages, PrefaultMakesTheRangeResident) {
+  tcc::HugePageResource resource({.policy = tcc::PagePolicy::transparent, .prefault = true});
+  constexpr std::size_t kBytes = 8 * kMiB;
+  auto* p = static_cast<std::byte*>(resource.allocate(kBytes));
+  const tcc::PageBacking backing = tcc::page_backing({p, kBytes});
+  TCC_CHECK_EQ(backing.bytes, kBytes);
+  if (backing.small_page_size != 0) {  // smaps readable
+    TCC_CHECK_LE(kBytes / 2, backing.resident);
+    TCC_CHECK_LE(backing.huge, backing.resident);
+    TCC_CHECK_LE(std::size_t{1}, backing.tlb_entries());
+    TCC_CHECK_LE(backing.tlb_entries(), kBytes / backing.small_page_size);
+  }
+  resource.deallocate(p, kBytes);
+}
+
+TCC_TEST(huge_pages, UntouchedSmallPagesAreNotResident) {
+  tcc::HugePageResource resource({.policy = tcc::PagePolicy::small});
+  auto* p = static_cast<std::byte*>(resource.allocate(4 * kMiB));
+  const tcc::PageBacking backing = tcc::page_backing({p, 4 * kMiB});
+  TCC_CHECK_EQ(backing.huge, 0u);
+  TCC_CHECK_LE(backing.resident, kMiB);
+  resource.deallocate(p, 4 * kMiB);
+}
+
+TCC_TEST(huge_pages, ArenaChunksFillWholeHugePages) {
+  tcc::HugePageResource resource;
+  tcc::Arena arena(64 * 1024, &resource);
+  for (int i = 0; i < 1000; ++i) std::memset(arena.allocate(1000), i, 1000);
+  // The first 64 KiB chunk grows to a whole huge page, which holds all 1 MB.
+  TCC_CHECK_EQ(arena.chunk_count(), 1u);
+  TCC_CHECK_EQ(resource.stats().mapped_bytes, tcc::huge_page_size());
+  TCC_CHECK_LE(tcc::huge_page_size() - 4096, arena.bytes_reserved());
+  arena.release();
+  TCC_CHECK_EQ(resource.stats().mapped_bytes, 0u);
+}
+
+TCC_TEST(huge_pages, MappedFileLoadsIntoHugePages) {
+  const auto path = std::filesystem::temp_directory_path() / "tcc_tests_huge_pages.bin";
+  std::string contents;
+  for (int i = 0; i < 100'000; ++i) contents += "line " + std::to_string(i) + '\n';
+  std::ofstream(path, std::ios::binary | std::ios::trunc)
+      .write(contents.data(), static_cast<std::streamsize>(contents.size()));
+  {
+    tcc::MappedFile file(path, tcc::Advice::random, tcc::HugePageOptions{.policy = tcc::PagePolicy::transparent});
+    TCC_REQUIRE_EQ(file.size(), contents.size());
+    TCC_CHECK(file.text() == contents);
+    TCC_CHECK_EQ(reinterpret_cast<std::uintptr_t>(file.data()) % 4096, 0u);
+    tcc::MappedFile moved = std::move(file);
+    TCC_CHECK(!file.is_open());
+    std::size_t count = 0;
+    for (std::string_view line : tcc::lines(moved)) count += !line.empty();
+    TCC_CHECK_EQ(count, 100'000u);
+  }
+  std::ofstream(path, std::ios::trunc).close();
+  TCC_CHECK(tcc::MappedFile(path, tcc::Advice::normal, tcc::HugePageOptions{}).empty());
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+  TCC_CHECK_THROWS(tcc::MappedFile(path, tcc::Advice::normal, tcc::HugePageOptions{}), std::system_error);
+}
+
+TCC_TEST(huge_pages, SystemReportIsConsistent) {
+  const tcc::SystemHugePages sys = tcc::system_huge_pages();
+  TCC_CHECK_LE(sys.hugetlb_free, sys.hugetlb_total);
+  if (!sys.thp_mode.empty()) {
+    TCC_CHECK(sys.thp_mode == "always" || sys.thp_mode == "madvise" || sys.thp_mode == "never");
+  }
+  TCC_CHECK_LE(std::size_t{4096}, tcc::huge_page_size());
+}
+
+}  // namespace
@@ -0,0 +1,174 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "harness.hpp"
+#include "tcc/coro.hpp"
+#include "tcc/io_await.hpp"
+#include "tcc/io_ring.hpp"
+#include "tcc/thread_pool.hpp"
+
+namespace {
+
+/// An unlinked temp file, closed when the test ends.
+class TempFd {
+ public:
+  TempFd() {
+    char name[] = "/tmp/tcc_tests_io_XXXXXX";
+    fd_ = ::mkstemp(name);
+    if (fd_ >= 0) ::unlink(name);
+  }
+  ~TempFd() {
+    if (fd_ >= 0) ::close(fd_);
+  }
+  int get() const noexcept { return fd_; }
+
+ private:
+  int fd_ = -1;
+};
+
+std::vector<tcc::io::RingOptions> backends(tcc::ThreadPool& pool) {
+  std::vector<tcc::io::RingOptions> out{{.pool = &pool, .force_fallback = true}};
+  if (tcc::io::io_uring_supported()) out.push_back({.pool = &pool});
+  return out;
+}
+
+std::span<const std::byte> bytes_of(const std::string& s) { return std::as_bytes(std::span(s.data(), s.size())); }
+
+TCC_TEST(io, BackendNames) {
+  TCC_CHECK_EQ(tcc::io::backend_name(tcc::io::BackendKind::io_uring), std::string_view("io_uring"));
+  TCC_CHECK_EQ(tcc::io::backend_name(tcc::io::BackendKind::fallback), std::string_view("fallback"));
+  tcc::ThreadPool pool(1);
+  tcc::io::Ring forced({.pool = &pool, .force_fallback = true});
+  TCC_CHECK(forced.backend() == tcc::io::BackendKind::fallback);
+}
+
+TCC_TEST(io, FileWriteReadFsync) {
+  tcc::ThreadPool pool(2);
+  for (const auto& options : backends(pool)) {
+    TempFd file;
+    TCC_REQUIRE(file.get() >= 0);
+    tcc::io::Ring ring(options);
+    const std::string text = "hello, ring";
+    std::atomic<int> wrote{-1}, synced{-1};
+    ring.write(file.get(), bytes_of(text), 100, [&](int n) { wrote = n; });
+    ring.submit();
+    ring.drain();
+    ring.fsync(file.get(), [&](int r) { synced = r; });
+    ring.drain();
+    TCC_CHECK_EQ(wrote.load(), static_cast<int>(text.size()));
+    TCC_CHECK_EQ(synced.load(), 0);
+
+    std::vector<std::byte> buf(text.size());
+    std::atomic<int> read{-1};
+    ring.read(file.get(), buf, 100, [&](int n) { read = n; });
+    ring.drain();
+    TCC_CHECK_EQ(read.load(), static_cast<int>(text.size()));
+    TCC_CHECK_EQ(std::memcmp(buf.data(), text.data(), text.size()), 0);
+    TCC_CHECK_EQ(ring.in_flight(), 0u);
+  }
+}
+
+TCC_TEST(io, ErrorsArriveAsNegativeErrno) {
+  tcc::ThreadPool pool(1);
+  for (const auto& options : backends(pool)) {
+    tcc::io::Ring ring(options);
+    std::byte buf[8];
+    std::atomic<int> result{0};
+    ring.read(-1, buf, 0, [&](int r) { result = r; });
+    ring.drain();
+    TCC_CHECK_EQ(result.load(), -EBADF);
+  }
+}
+
+TCC_TEST(io, SocketSendRecv) {
+  tcc::ThreadPool pool(2);
+  for (const auto& options : backends(pool)) {
+    int fds[2];
+    TCC_REQUIRE_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    {
+      tcc::io::Ring ring(options);
+      std::vector<std::byte> buf(64);
+      std::atomic<int> received{-1}, sent{-1};
+      ring.recv(fds[1], buf, [&](int n) { received = n; });  // parks until data arrives
+      ring.submit();
+      const std::string msg = "ping";
+      ring.send(fds[0], bytes_of(msg), [&](int n) { sent = n; });
+      ring.drain();
+      TCC_CHECK_EQ(sent.load(), 4);
+      TCC_CHECK_EQ(received.load(), 4);
+      TCC_CHECK_EQ(std::memcmp(buf.data(), "ping", 4), 0);
+    }
+    ::close(fds[0]);
+    ::close(fds[1]);
+  }
+}
+
+TCC_TEST(io, TimeoutAndNop) {
+  tcc::ThreadPool pool(1);
+  for (const auto& options : backends(pool)) {
+    tcc::io::Ring ring(options);
+    std::atomic<int> order{0}, nop_at{-1}, timeout_at{-1};
+    const auto start = std::chrono::steady_clock::now();
+    ring.timeout(std::chrono::milliseconds(20), [&](int r) { timeout_at = r == 0 ? ++order : -2; });
+    ring.nop([&](int r) { nop_at = r == 0 ? ++order : -2; });
+    TCC_CHECK_EQ(ring.submit(), 2u);
+    ring.drain();
+    TCC_CHECK_LE(std::chrono::milliseconds(15), std::chrono::steady_clock::now() - start);
+    TCC_CHECK_EQ(nop_at.load(), 1);
+    TCC_CHECK_EQ(timeout_at.load(), 2);
+  }
+}
+
+TCC_TEST(io, RegisteredBuffersAndFiles) {
+  tcc::ThreadPool pool(1);
+  for (const auto& options : backends(pool)) {
+    TempFd file;
+    TCC_REQUIRE(file.get() >= 0);
+    tcc::io::Ring ring(options);
+    std::vector<std::byte> storage(4096, std::byte{'x'});
+    const std::span<std::byte> buffers[] = {storage};
+    ring.register_buffers(buffers);
+    const int fds[] = {file.get()};
+    ring.register_files(fds);
+
+    std::atomic<int> wrote{-1}, read{-1};
+    ring.write_fixed(tcc::io::FixedFile{0}, 0, std::span(storage).first(100), 0, [&](int n) { wrote = n; });
+    ring.drain();
+    std::fill(storage.begin(), storage.end(), std::byte{0});
+    ring.read_fixed(tcc::io::FixedFile{0}, 0, std::span(storage).subspan(200, 100), 0, [&](int n) { read = n; });
+    ring.drain();
+    TCC_CHECK_EQ(wrote.load(), 100);
+    TCC_CHECK_EQ(read.load(), 100);
+    TCC_CHECK(storage[299] == std::byte{'x'});
+  }
+}
+
+tcc::Task<int> copy_through(tcc::io::Ring& ring, int fd) {
+  const std::string text = "awaited";
+  const int wrote = co_await tcc::io::async_write(ring, fd, bytes_of(text), 0);
+  co_await tcc::io::sleep_for(ring, std::chrono::milliseconds(1));
+  std::vector<std::byte> buf(16);
+  const int read = co_await tcc::io::async_read(ring, fd, buf, 0);
+  co_return wrote == read && std::memcmp(buf.data(), text.data(), text.size()) == 0 ? read : -1;
+}
+
+TCC_TEST(io, CoAwaitAdapters) {
+  tcc::ThreadPool pool(2);
+  for (const auto& options : backends(pool)) {
+    TempFd file;
+    TCC_REQUIRE(file.get() >= 0);
+    tcc::io::Ring ring(options);
+    TCC_CHECK_EQ(tcc::sync_wait(copy_through(ring, file.get())), 7);
+  }
+}
+
+}  // namespace
@@ -0,0 +1,108 @@
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/mapped_file.hpp"
+
+namespace {
+
+/// A file in the temp directory, removed when the test ends.
+class TempFile {
+ public:
+  explicit TempFile(std::string_view contents) {
+    path_ = std::filesystem::temp_directory_path() /
+            ("tcc_tests_mapped_" + std::to_string(reinterpret_cast<std::uintptr_t>(this)) + ".txt");
+    std::ofstream(path_, std::ios::binary | std::ios::trunc).write(contents.data(),
+                                                                   static_cast<std::streamsize>(contents.size()));
+  }
+  ~TempFile() {
+    std::error_code ec;
+    std::filesystem::remove(path_, ec);
+  }
+  const std::filesystem::path& path() const noexcept { return path_; }
+
+ private:
+  std::filesystem::path path_;
+};
+
+std::vector<std::string> collect(tcc::LineRange range) {
+  std::vector<std::string> out;
+  for (std::string_view line : range) out.emplace_back(line);
+  return out;
+}
+
+TCC_TEST(mapped_file, MapsWholeFile) {
+  TempFile tmp("hello\nworld\n");
+  tcc::MappedFile file(tmp.path(), tcc::Advice::sequential | tcc::Advice::willneed);
+  TCC_CHECK(file.is_open());
+  TCC_CHECK_EQ(file.size(), 12u);
+  TCC_CHECK_EQ(file.text(), std::string_view("hello\nworld\n"));
+  TCC_CHECK(file.advise(tcc::Advice::random, 0, 4));
+}
+
+TCC_TEST(mapped_file, EmptyFileMapsToEmptySpan) {
+  TempFile tmp("");
+  tcc::MappedFile file(tmp.path());
+  TCC_CHECK(file.is_open());
+  TCC_CHECK(file.empty());
+  TCC_CHECK(tcc::lines(file).begin() == tcc::lines(file).end());
+}
+
+TCC_TEST(mapped_file, MissingFileThrows) {
+  TCC_CHECK_THROWS(tcc::MappedFile("/nonexistent/tcc_tests/file"), std::system_error);
+}
+
+TCC_TEST(mapped_file, MoveAndClose) {
+  TempFile tmp("abc");
+  tcc::MappedFile a(tmp.path());
+  tcc::MappedFile b(std::move(a));
+  TCC_CHECK(!a.is_open());
+  TCC_CHECK_EQ(b.text(), std::string_view("abc"));
+  b.close();
+  TCC_CHECK(!b.is_open());
+  TCC_CHECK_EQ(b.size(), 0u);
+}
+
+TCC_TEST(mapped_file, LinesFollowGetlineSemantics) {
+  TCC_CHECK(collect(tcc::lines("a\nb\n")) == std::vector<std::string>({"a", "b"}));
+  TCC_CHECK(collect(tcc::lines("a\n\nb")) == std::vector<std::string>({"a", "", "b"}));
+  TCC_CHECK(collect(tcc::lines("crlf\r\nline\r\n")) == std::vector<std::string>({"crlf", "line"}));
+  TCC_CHECK(collect(tcc::lines("")).empty());
+}
+
+TCC_TEST(mapped_file, LongFileAcrossSimdBlocks) {
+  std::string text;
+  for (int i = 0; i < 10'000; ++i) text += std::string(static_cast<std::size_t>(i % 70), 'x') + "\n";
+  TempFile tmp(text);
+  tcc::MappedFile file(tmp.path());
+  std::size_t count = 0;
+  bool lengths_ok = true;
+  for (std::string_view line : tcc::lines(file)) {
+    lengths_ok = lengths_ok && line.size() == count % 70;
+    ++count;
+  }
+  TCC_CHECK_EQ(count, 10'000u);
+  TCC_CHECK(lengths_ok);
+}
+
+TCC_TEST(mapped_file, RecordsSplitOnAnyDelimiter) {
+  TempFile tmp("a,bb,,ccc");
+  tcc::MappedFile file(tmp.path());
+  std::vector<std::size_t> sizes;
+  for (auto record : tcc::records(file, std::byte{','})) sizes.push_back(record.size());
+  TCC_CHECK(sizes == std::vector<std::size_t>({1, 2, 0, 3}));
+}
+
+TCC_TEST(mapped_file, AdviceFlagsCombine) {
+  constexpr tcc::Advice set = tcc::Advice::sequential | tcc::Advice::hugepage;
+  static_assert(tcc::has_advice(set, tcc::Advice::hugepage));
+  TCC_CHECK(tcc::has_advice(set, tcc::Advice::sequential));
+  TCC_CHECK(!tcc::has_advice(set, tcc::Advice::random));
+}
+
+}  // namespace
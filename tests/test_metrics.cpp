@@ -0,0 +1,124 @@
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/metrics.hpp"
+
+namespace {
+
+using tcc::metrics::Histogram;
+
+bool contains(const std::string& text, const std::string& needle) { return text.find(needle) != std::string::npos; }
+
+TCC_TEST(metrics, CounterSumsConcurrentShards) {
+  tcc::metrics::Registry reg(4);
+  TCC_CHECK_EQ(reg.shard_count(), 4u);
+  auto& c = reg.counter("events_total", "Events");
+  constexpr int kThreads = 4, kPerThread = 100'000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < kPerThread; ++i) c.inc();
+    });
+  }
+  for (auto& t : threads) t.join();
+  c.inc(5);
+  TCC_CHECK_EQ(c.value(), std::uint64_t{kThreads} * kPerThread + 5);
+}
+
+TCC_TEST(metrics, RegistrationReturnsTheSameSeries) {
+  tcc::metrics::Registry reg;
+  auto& a = reg.counter("requests_total", "Requests", {{"method", "GET"}});
+  auto& b = reg.counter("requests_total", "ignored", {{"method", "GET"}});
+  auto& c = reg.counter("requests_total", "Requests", {{"method", "PUT"}});
+  TCC_CHECK_EQ(&a, &b);
+  TCC_CHECK(&a != &c);
+  TCC_CHECK_EQ(&tcc::metrics::Registry::global(), &tcc::metrics::Registry::global());
+}
+
+TCC_TEST(metrics, InvalidNamesAndTypeClashesThrow) {
+  tcc::metrics::Registry reg;
+  reg.counter("used_total", "x");
+  TCC_CHECK_THROWS(reg.gauge("used_total", "x"), std::invalid_argument);
+  TCC_CHECK_THROWS(reg.counter("9starts_with_digit", "x"), std::invalid_argument);
+  TCC_CHECK_THROWS(reg.counter("has-dash", "x"), std::invalid_argument);
+  TCC_CHECK_THROWS(reg.counter("ok_total", "x", {{"bad label", "v"}}), std::invalid_argument);
+  TCC_CHECK_THROWS(reg.histogram("h", "x", {{"le", "1"}}), std::invalid_argument);
+  TCC_CHECK_THROWS(reg.histogram("bad_opts", "x", {}, {1e-9, 20, 10}), std::invalid_argument);
+  // A rejected registration leaves nothing behind.
+  TCC_CHECK(!contains(reg.prometheus_text(), "bad_opts"));
+}
+
+TCC_TEST(metrics, GaugeMovesBothWays) {
+  tcc::metrics::Registry reg;
+  auto& g = reg.gauge("in_flight", "In flight");
+  g.set(10);
+  g.add(2.5);
+  g.sub(0.5);
+  TCC_CHECK_EQ(g.value(), 12.0);
+}
+
+TCC_TEST(metrics, HistogramBucketsAreWithinOneEighth) {
+  static_assert(Histogram::bucket_of(0) == 0);
+  static_assert(Histogram::bucket_of(7) == 7);
+  static_assert(Histogram::bucket_of(~std::uint64_t{0}) == Histogram::kBucketCount - 1);
+  for (std::uint64_t v : {8ull, 9ull, 100ull, 1000ull, 123456789ull, 1ull << 40, (1ull << 63) + 12345}) {
+    const std::size_t b = Histogram::bucket_of(v);
+    const std::uint64_t lower = Histogram::bucket_lower(b);
+    TCC_CHECK_LE(lower, v);
+    TCC_CHECK_LE(static_cast<double>(v - lower), static_cast<double>(v) / 8.0);
+    TCC_CHECK_EQ(Histogram::bucket_of(lower), b);
+  }
+  for (std::size_t i = 1; i < Histogram::kBucketCount; ++i) {
+    TCC_REQUIRE(Histogram::bucket_lower(i - 1) < Histogram::bucket_lower(i));
+  }
+}
+
+TCC_TEST(metrics, HistogramSnapshotAndQuantiles) {
+  tcc::metrics::Registry reg(2);
+  auto& h = reg.histogram("latency_seconds", "Latency");
+  for (std::uint64_t v = 1; v <= 1000; ++v) h.record(v * 1000);
+  const Histogram::Snapshot s = h.snapshot();
+  TCC_CHECK_EQ(s.count, 1000u);
+  TCC_CHECK_EQ(s.sum, 1000u * 1001u / 2u * 1000u);
+  const std::uint64_t p50 = s.quantile(0.5);
+  TCC_CHECK_LE(500'000u, p50);
+  TCC_CHECK_LE(p50, 500'000u + 500'000u / 8u + 1000u);
+  TCC_CHECK_LE(s.quantile(0.99), s.quantile(1.0));
+  TCC_CHECK_EQ(Histogram::Snapshot{}.quantile(0.5), 0u);
+}
+
+TCC_TEST(metrics, ScopedTimerRecordsOnce) {
+  tcc::metrics::Registry reg;
+  auto& h = reg.histogram("op_seconds", "Op");
+  { tcc::metrics::ScopedTimer timer(h); }
+  TCC_CHECK_EQ(h.snapshot().count, 1u);
+}
+
+TCC_TEST(metrics, PrometheusExposition) {
+  tcc::metrics::Registry reg(2);
+  reg.counter("a_total", "help \\ x\ny", {{"k", "v\"q"}}).inc(3);
+  reg.gauge("g", "gauge").set(1.5);
+  auto& h = reg.histogram("h_seconds", "lat", {}, {1e-9, 2, 4});
+  h.record(3);
+  h.record(20);
+
+  const std::string text = reg.prometheus_text();
+  TCC_CHECK(contains(text, "# HELP a_total help \\\\ x\\ny\n# TYPE a_total counter\n"));
+  TCC_CHECK(contains(text, "a_total{k=\"v\\\"q\"} 3\n"));
+  TCC_CHECK(contains(text, "# TYPE g gauge\ng 1.5\n"));
+  TCC_CHECK(contains(text, "h_seconds_bucket{le=\"4e-09\"} 1\n"));
+  TCC_CHECK(contains(text, "h_seconds_bucket{le=\"+Inf\"} 2\n"));
+  TCC_CHECK(contains(text, "h_seconds_count 2\n"));
+  TCC_CHECK_LT(text.find("a_total"), text.find("\ng "));  // families sorted by name
+
+  std::ostringstream out;
+  reg.write_prometheus(out);
+  TCC_CHECK_EQ(out.str(), text);
+}
+
+}  // namespace
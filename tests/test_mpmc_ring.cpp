@@ -0,0 +1,96 @@
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/mpmc_ring.hpp"
+
+namespace {
+
+TCC_TEST(mpmc_ring, CapacityRoundsUpToPowerOfTwo) {
+  TCC_CHECK_EQ(tcc::MpmcRing<int>(0).capacity(), 2u);
+  TCC_CHECK_EQ(tcc::MpmcRing<int>(5).capacity(), 8u);
+  TCC_CHECK_EQ(tcc::MpmcRing<int>(64).capacity(), 64u);
+}
+
+TCC_TEST(mpmc_ring, FifoUntilFullThenEmpty) {
+  tcc::MpmcRing<int> ring(4);
+  TCC_CHECK(ring.empty_approx());
+  for (int i = 0; i < 4; ++i) TCC_CHECK(ring.try_push(i));
+  TCC_CHECK(!ring.try_push(99));
+  TCC_CHECK_EQ(ring.size_approx(), 4u);
+  for (int i = 0; i < 4; ++i) TCC_CHECK_EQ(ring.try_pop().value_or(-1), i);
+  TCC_CHECK(!ring.try_pop().has_value());
+  int out = 0;
+  TCC_CHECK(!ring.try_pop(out));
+}
+
+TCC_TEST(mpmc_ring, MoveOnlyElementsAndDestructorDrains) {
+  auto counter = std::make_shared<int>(0);
+  {
+    tcc::MpmcRing<std::shared_ptr<int>> ring(8);
+    for (int i = 0; i < 5; ++i) TCC_CHECK(ring.try_emplace(counter));
+    TCC_CHECK_EQ(counter.use_count(), 6);
+    ring.try_pop();
+    TCC_CHECK_EQ(counter.use_count(), 5);
+  }
+  TCC_CHECK_EQ(counter.use_count(), 1);
+
+  tcc::MpmcRing<std::unique_ptr<int>> ring(2);
+  TCC_CHECK(ring.try_push(std::make_unique<int>(7)));
+  std::unique_ptr<int> p;
+  TCC_REQUIRE(ring.try_pop(p));
+  TCC_CHECK_EQ(*p, 7);
+}
+
+TCC_TEST(mpmc_ring, BatchesArePartialWhenNearlyFull) {
+  tcc::MpmcRing<int> ring(8);
+  std::vector<int> in(10);
+  std::iota(in.begin(), in.end(), 0);
+  TCC_CHECK_EQ(ring.try_push_batch(in.begin(), in.size()), 8u);
+  std::vector<int> out;
+  TCC_CHECK_EQ(ring.try_pop_batch(std::back_inserter(out), 3), 3u);
+  TCC_CHECK_EQ(ring.try_pop_batch(std::back_inserter(out), 100), 5u);
+  TCC_CHECK(out == std::vector<int>(in.begin(), in.begin() + 8));
+  TCC_CHECK_EQ(ring.try_pop_batch(std::back_inserter(out), 1), 0u);
+}
+
+TCC_TEST(mpmc_ring, ConcurrentProducersAndConsumersLoseNothing) {
+  constexpr int kProducers = 3, kConsumers = 3;
+  constexpr std::uint64_t kPerProducer = 50'000;
+  tcc::MpmcRing<std::uint64_t> ring(256);
+  std::atomic<std::uint64_t> sum{0}, popped{0};
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < kProducers; ++p) {
+    threads.emplace_back([&, p] {
+      for (std::uint64_t i = 1; i <= kPerProducer; ++i) {
+        const std::uint64_t v = i + static_cast<std::uint64_t>(p) * kPerProducer;
+        while (!ring.try_push(v)) std::this_thread::yield();
+      }
+    });
+  }
+  for (int c = 0; c < kConsumers; ++c) {
+    threads.emplace_back([&] {
+      std::uint64_t v;
+      while (popped.load(std::memory_order_relaxed) < kProducers * kPerProducer) {
+        if (ring.try_pop(v)) {
+          sum.fetch_add(v, std::memory_order_relaxed);
+          popped.fetch_add(1, std::memory_order_relaxed);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  const std::uint64_t n = kProducers * kPerProducer;
+  TCC_CHECK_EQ(popped.load(), n);
+  TCC_CHECK_EQ(sum.load(), n * (n + 1) / 2);
+}
+
+}  // namespace
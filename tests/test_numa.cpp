@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/arena.hpp"
+#include "tcc/numa.hpp"
+#include "tcc/thread_pool.hpp"
+
+namespace {
+
+TCC_TEST(numa, TopologyCoversUsableCpus) {
+  const tcc::numa::Topology& topo = tcc::numa::topology();
+  TCC_REQUIRE(!topo.nodes.empty());
+  TCC_CHECK_LE(std::size_t{1}, topo.cpu_count());
+  for (const tcc::numa::Node& node : topo.nodes) {
+    TCC_CHECK(!node.cpus.empty());
+    TCC_CHECK(std::is_sorted(node.cpus.begin(), node.cpus.end()));
+    TCC_CHECK_EQ(topo.node_of_cpu(node.cpus.front()), node.id);
+  }
+  TCC_CHECK_EQ(topo.node_of_cpu(-1), -1);
+}
+
+TCC_TEST(numa, NodeResourcePlacesPages) {
+  const int node = tcc::numa::topology().nodes.front().id;
+  for (auto placement : {tcc::numa::Placement::first_touch, tcc::numa::Placement::preferred,
+                         tcc::numa::Placement::bind}) {
+    tcc::numa::NodeResource resource(node, placement);
+    void* p = resource.allocate(100'000, 64);
+    TCC_REQUIRE(p != nullptr);
+    TCC_CHECK_EQ(reinterpret_cast<std::uintptr_t>(p) % 64, 0u);
+    std::memset(p, 0xab, 100'000);  // first touch
+    resource.deallocate(p, 100'000, 64);
+  }
+  TCC_CHECK(tcc::numa::NodeResource(node) == tcc::numa::node_resource(node));
+  TCC_CHECK(&tcc::numa::node_resource(node) == &tcc::numa::node_resource(node));
+}
+
+TCC_TEST(numa, ArenaOnLocalNode) {
+  tcc::Arena arena(64 * 1024, &tcc::numa::local_resource());
+  for (int i = 0; i < 1000; ++i) std::memset(arena.allocate(200), i, 200);
+  TCC_CHECK_LE(std::size_t{200'000}, arena.bytes_used());
+  TCC_CHECK_LE(std::size_t{2}, arena.chunk_count());
+}
+
+TCC_TEST(numa, PinnedPoolPlacesWorkersPerNode) {
+  const tcc::numa::Topology& topo = tcc::numa::topology();
+  for (auto affinity : {tcc::Affinity::node, tcc::Affinity::core}) {
+    tcc::ThreadPool pool({.threads = 3, .affinity = affinity});
+    TCC_REQUIRE_EQ(pool.size(), 3u);
+    for (std::size_t i = 0; i < pool.size(); ++i) {
+      TCC_CHECK_EQ(pool.worker_node(i), topo.nodes[i % topo.nodes.size()].id);
+    }
+    std::atomic<long> sum{0};
+    tcc::parallel_for(pool, {0, 10'000}, 64, [&](tcc::IndexRange r) {
+      sum += static_cast<long>(r.size());
+    });
+    TCC_CHECK_EQ(sum.load(), 10'000);
+  }
+  tcc::ThreadPool unpinned(2);
+  TCC_CHECK_EQ(unpinned.worker_node(0), -1);
+}
+
+TCC_TEST(numa, SyntheticTwoNodePoolStealsAndJoins) {
+  // Two "nodes" sharing the real CPUs exercise the local-first steal path
+  // on any machine.
+  const std::vector<int> cpus = tcc::numa::topology().nodes.front().cpus;
+  const tcc::numa::Topology two{{{0, cpus}, {1, cpus}}};
+  tcc::ThreadPool pool({.threads = 4, .affinity = tcc::Affinity::node, .topology = &two});
+  TCC_CHECK_EQ(pool.worker_node(0), 0);
+  TCC_CHECK_EQ(pool.worker_node(1), 1);
+  TCC_CHECK_EQ(pool.worker_node(2), 0);
+  TCC_CHECK_EQ(pool.worker_node(3), 1);
+  const double total = tcc::parallel_reduce(
+      pool, {0, 100'000}, 100, 0.0, [](tcc::IndexRange r) { return static_cast<double>(r.size()); },
+      [](double a, double b) { return a + b; });
+  TCC_CHECK_EQ(total, 100'000.0);
+}
+
+TCC_TEST(numa, PinningRejectsEmptySet) { TCC_CHECK(!tcc::numa::pin_current_thread({})); }
+
+}  // namespace
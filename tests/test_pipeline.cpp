@@ -0,0 +1,260 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/pipeline.hpp"
+#include "tcc/soa_vector.hpp"
+#include "tcc/thread_pool.hpp"
+
+namespace {
+
+template <template <class> class F = tcc::soa::Value>
+struct Reading {
+  F<std::uint32_t> id;
+  F<float> value;
+};
+
+template <template <class> class F = tcc::soa::Value>
+struct Scaled {
+  F<std::uint32_t> id;
+  F<double> value;
+};
+
+/// Source of readings 0, 1, ..., total - 1, `rows` per call.
+class Counter {
+ public:
+  Counter(std::uint32_t total, std::size_t rows) : total_(total), rows_(rows) {}
+
+  bool operator()(tcc::SoaVector<Reading>& out) {
+    for (std::size_t i = 0; i < rows_ && next_ < total_; ++i, ++next_) {
+      out.push_back({next_, static_cast<float>(next_)});
+    }
+    return next_ < total_;
+  }
+
+ private:
+  std::uint32_t total_;
+  std::size_t rows_;
+  std::uint32_t next_ = 0;
+};
+
+void scale(const tcc::SoaVector<Reading>& in, tcc::SoaVector<Scaled>& out) {
+  for (std::size_t i = 0; i < in.size(); ++i) out.push_back({in[i].id, 2.0 * in[i].value});
+}
+
+TCC_TEST(pipeline, SerialStagesKeepOrder) {
+  tcc::ThreadPool pool(2);
+  tcc::Pipeline p({.batch_rows = 100, .queue_batches = 2, .pool = &pool});
+  std::vector<std::uint32_t> ids;
+  std::vector<double> values;
+  p.source<Reading>(Counter(10'000, p.batch_rows()))
+      .transform<Scaled>(scale)
+      .sink([&](const tcc::SoaVector<Scaled>& in) {
+        ids.insert(ids.end(), in.column<0>().begin(), in.column<0>().end());
+        values.insert(values.end(), in.column<1>().begin(), in.column<1>().end());
+      });
+  p.run();
+  TCC_REQUIRE_EQ(ids.size(), 10'000u);
+  for (std::uint32_t i = 0; i < 10'000; ++i) {
+    TCC_REQUIRE_EQ(ids[i], i);
+    TCC_REQUIRE_EQ(values[i], 2.0 * i);
+  }
+  const auto stats = p.stats();
+  TCC_REQUIRE_EQ(stats.size(), 3u);
+  TCC_CHECK(stats[0].name == "source");
+  TCC_CHECK(stats[1].name == "transform 1");
+  TCC_CHECK(stats[2].name == "sink");
+  for (const auto& s : stats) {
+    TCC_CHECK_EQ(s.batches, 100u);
+    TCC_CHECK_EQ(s.rows, 10'000u);
+  }
+}
+
+TCC_TEST(pipeline, ParallelStagesSeeEveryRow) {
+  tcc::ThreadPool pool(4);
+  tcc::Pipeline p({.batch_rows = 64, .queue_batches = 4, .pool = &pool});
+  std::atomic<std::uint64_t> sum{0}, rows{0};
+  p.source<Reading>(Counter(50'000, p.batch_rows()))
+      .transform<Scaled>(scale, {.parallelism = 4})
+      .sink(
+          [&](const tcc::SoaVector<Scaled>& in) {
+            std::uint64_t s = 0;
+            for (std::uint32_t id : in.column<0>()) s += id;
+            sum += s;
+            rows += in.size();
+          },
+          {.parallelism = 2, .name = "sum"});
+  p.run();
+  TCC_CHECK_EQ(rows.load(), 50'000u);
+  TCC_CHECK_EQ(sum.load(), std::uint64_t{50'000} * 49'999 / 2);
+  TCC_CHECK(p.stats().back().name == "sum");
+}
+
+// More stages than workers: tasks yield when they run out of input or room,
+// so one worker gets through the whole chain.
+TCC_TEST(pipeline, RunsOnOneWorker) {
+  tcc::ThreadPool pool(1);
+  tcc::Pipeline p({.batch_rows = 32, .queue_batches = 1, .pool = &pool});
+  std::uint64_t rows = 0;
+  p.source<Reading>(Counter(5'000, p.batch_rows()))
+      .transform_in_place([](tcc::SoaVector<Reading>& b) {
+        for (float& v : b.column<1>()) v += 1.0f;
+      })
+      .transform<Scaled>(scale, {.parallelism = 3})
+      .transform_in_place([](tcc::SoaVector<Scaled>&) {})
+      .sink([&](const tcc::SoaVector<Scaled>& in) { rows += in.size(); });
+  p.run();
+  TCC_CHECK_EQ(rows, 5'000u);
+}
+
+TCC_TEST(pipeline, EmptyOutputsAreDropped) {
+  tcc::ThreadPool pool(2);
+  tcc::Pipeline p({.batch_rows = 10, .queue_batches = 2, .pool = &pool});
+  std::vector<std::uint32_t> kept;
+  std::size_t batches = 0;
+  p.source<Reading>(Counter(1'000, p.batch_rows()))
+      .transform_in_place([](tcc::SoaVector<Reading>& b) {
+        // Keep ids divisible by 100: one row in every tenth batch.
+        for (std::size_t i = b.size(); i-- > 0;) {
+          if (b[i].id % 100 != 0) b.swap_remove(i);
+        }
+      })
+      .sink([&](const tcc::SoaVector<Reading>& in) {
+        ++batches;
+        kept.insert(kept.end(), in.column<0>().begin(), in.column<0>().end());
+      });
+  p.run();
+  TCC_CHECK_EQ(batches, 10u);
+  TCC_REQUIRE_EQ(kept.size(), 10u);
+  for (std::size_t i = 0; i < kept.size(); ++i) TCC_CHECK_EQ(kept[i], i * 100);
+}
+
+TCC_TEST(pipeline, EmptySourceFinishes) {
+  tcc::ThreadPool pool(2);
+  tcc::Pipeline p({.pool = &pool});
+  bool called = false;
+  p.source<Reading>([](tcc::SoaVector<Reading>&) { return false; }).sink([&](const tcc::SoaVector<Reading>&) {
+    called = true;
+  });
+  p.run();
+  TCC_CHECK(!called);
+  TCC_CHECK_EQ(p.stats()[0].batches, 0u);
+}
+
+// The producer stops while the sink is behind: batches started by the
+// source but not yet finished by the sink never exceed the channel's
+// credits plus the one the sink is working on.
+TCC_TEST(pipeline, BackpressureBoundsBatchesInFlight) {
+  tcc::ThreadPool pool(2);
+  constexpr std::size_t kQueue = 3;
+  tcc::Pipeline p({.batch_rows = 16, .queue_batches = kQueue, .pool = &pool});
+  std::atomic<std::size_t> started{0}, finished{0};
+  std::size_t worst = 0;
+  Counter counter(16 * 200, p.batch_rows());
+  p.source<Reading>([&](tcc::SoaVector<Reading>& out) {
+     worst = std::max(worst, ++started - finished.load());
+     return counter(out);
+   }).sink([&](const tcc::SoaVector<Reading>&) {
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+    ++finished;
+  });
+  p.run();
+  TCC_CHECK_EQ(finished.load(), 200u);
+  TCC_CHECK_LE(worst, kQueue + 1);
+  TCC_CHECK(p.stats()[0].stalls > 0);
+}
+
+TCC_TEST(pipeline, StageExceptionCancelsAndRethrows) {
+  tcc::ThreadPool pool(2);
+  tcc::Pipeline p({.batch_rows = 8, .queue_batches = 2, .pool = &pool});
+  std::atomic<std::size_t> sunk{0};
+  // An endless source: only the cancellation stops it.
+  p.source<Reading>([](tcc::SoaVector<Reading>& out) {
+     out.push_back({1, 1.0f});
+     return true;
+   })
+      .transform<Scaled>(
+          [n = 0](const tcc::SoaVector<Reading>& in, tcc::SoaVector<Scaled>& out) mutable {
+            if (++n == 5) throw std::runtime_error("bad batch");
+            scale(in, out);
+          })
+      .sink([&](const tcc::SoaVector<Scaled>&) { ++sunk; });
+  TCC_CHECK_THROWS(p.run(), std::runtime_error);
+  TCC_CHECK_LE(sunk.load(), 4u);
+}
+
+TCC_TEST(pipeline, CancelFromSinkStopsEndlessSource) {
+  tcc::ThreadPool pool(2);
+  tcc::Pipeline p({.batch_rows = 8, .queue_batches = 2, .pool = &pool});
+  std::atomic<std::size_t> sunk{0};
+  p.source<Reading>([](tcc::SoaVector<Reading>& out) {
+     out.push_back({1, 1.0f});
+     return true;
+   }).sink([&](const tcc::SoaVector<Reading>&) {
+    if (++sunk == 10) p.cancel();
+  });
+  p.run();
+  TCC_CHECK_EQ(sunk.load(), 10u);
+}
+
+// cancel() from another thread lands anywhere in run(), including while it
+// starts the source; the pipeline is destroyed as soon as run() returns.
+TCC_TEST(pipeline, CancelRacingRunFromAnotherThread) {
+  tcc::ThreadPool pool(2);
+  for (int i = 0; i < 200; ++i) {
+    tcc::Pipeline p({.batch_rows = 8, .queue_batches = 2, .pool = &pool});
+    p.source<Reading>([](tcc::SoaVector<Reading>& out) {
+       out.push_back({1, 1.0f});
+       return true;
+     }).sink([](const tcc::SoaVector<Reading>&) {});
+    std::thread canceller([&] {
+      const auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(i % 50);
+      while (std::chrono::steady_clock::now() < until) {
+      }
+      p.cancel();
+    });
+    p.run();
+    canceller.join();
+  }
+}
+
+TCC_TEST(pipeline, RunFromAPoolWorker) {
+  tcc::ThreadPool pool(2);
+  std::atomic<bool> done{false};
+  std::uint64_t rows = 0;
+  pool.post([&] {
+    tcc::Pipeline p({.batch_rows = 50, .pool = &pool});
+    p.source<Reading>(Counter(1'000, p.batch_rows())).sink([&](const tcc::SoaVector<Reading>& in) {
+      rows += in.size();
+    });
+    p.run();
+    done.store(true);
+    pool.notify_waiters();
+  });
+  pool.wait(done);
+  TCC_CHECK_EQ(rows, 1'000u);
+}
+
+TCC_TEST(pipeline, RejectsMisuse) {
+  tcc::ThreadPool pool(1);
+  TCC_CHECK_THROWS(tcc::Pipeline({.batch_rows = 0}), std::invalid_argument);
+
+  tcc::Pipeline incomplete({.pool = &pool});
+  auto src = incomplete.source<Reading>(Counter(10, 10));
+  TCC_CHECK_THROWS(incomplete.run(), std::logic_error);
+  TCC_CHECK_THROWS(incomplete.source<Reading>(Counter(10, 10)), std::logic_error);
+
+  src.sink([](const tcc::SoaVector<Reading>&) {});
+  TCC_CHECK_THROWS(src.sink([](const tcc::SoaVector<Reading>&) {}), std::logic_error);
+  incomplete.run();
+  TCC_CHECK_THROWS(incomplete.run(), std::logic_error);
+}
+
+}  // namespace
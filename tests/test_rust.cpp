@@ -0,0 +1,71 @@
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/rust.hpp"
+
+namespace {
+
+TCC_TEST(rust, CrateVersion) { TCC_CHECK_EQ(tcc::rust::crate_version(), std::string_view("0.1.0")); }
+
+TCC_TEST(rust, Fnv1aMatchesReference) {
+  TCC_CHECK_EQ(tcc::rust::fnv1a(std::string_view()), 0xcbf29ce484222325ull);
+  TCC_CHECK_EQ(tcc::rust::fnv1a(std::string_view("a")), 0xaf63dc4c8601ec8cull);
+  TCC_CHECK_EQ(tcc::rust::fnv1a(std::string_view("foobar")), 0x85944171f73967e8ull);
+}
+
+TCC_TEST(rust, SplitReturnsViewsIntoInput) {
+  const std::string line = "a,,bc,";
+  std::vector<std::string_view> fields;
+  const std::size_t n = tcc::rust::split(line, ',', [&](std::string_view f) { fields.push_back(f); });
+  TCC_REQUIRE_EQ(n, 4u);
+  TCC_REQUIRE_EQ(fields.size(), 4u);
+  TCC_CHECK_EQ(fields[0], std::string_view("a"));
+  TCC_CHECK(fields[1].empty());
+  TCC_CHECK_EQ(fields[2], std::string_view("bc"));
+  TCC_CHECK(fields[3].empty());
+  TCC_CHECK(fields[2].data() == line.data() + 3);  // borrowed, not copied
+  TCC_CHECK_EQ(tcc::rust::split(std::string_view(), ',', [](std::string_view) {}), 1u);
+}
+
+TCC_TEST(rust, ToUpperHandsOverRustBuffer) {
+  tcc::rust::Buffer up = tcc::rust::to_upper(std::string_view("hello, rust"));
+  TCC_CHECK_EQ(up.text(), std::string_view("HELLO, RUST"));
+  TCC_CHECK_LE(up.size(), up.capacity());
+  tcc::rust::Buffer moved = std::move(up);
+  TCC_CHECK(up.empty());
+  TCC_CHECK(up.data() == nullptr);
+  TCC_CHECK_EQ(moved.text(), std::string_view("HELLO, RUST"));
+}
+
+TCC_TEST(rust, AppendKeepsBytesInPlace) {
+  tcc::rust::Buffer buf = tcc::rust::Buffer::with_capacity(64);
+  TCC_REQUIRE(buf.data() != nullptr);
+  const std::byte* before = buf.data();
+  buf.append(std::string_view("abc"));
+  buf.append(std::string_view("def"));
+  TCC_CHECK(buf.data() == before);
+  TCC_CHECK_EQ(buf.text(), std::string_view("abcdef"));
+
+  tcc::rust::Buffer grown;
+  for (int i = 0; i < 1000; ++i) grown.append(std::string_view("0123456789"));
+  TCC_CHECK_EQ(grown.size(), 10'000u);
+  TCC_CHECK_EQ(grown.text().substr(9'990), std::string_view("0123456789"));
+}
+
+TCC_TEST(rust, SpareAndCommitFillInPlace) {
+  tcc::rust::Buffer buf;
+  buf.reserve(16);
+  TCC_REQUIRE(buf.spare().size() >= 16);
+  std::memcpy(buf.spare().data(), "0123", 4);
+  buf.commit(4);
+  TCC_CHECK_EQ(buf.text(), std::string_view("0123"));
+  TCC_CHECK_THROWS(buf.commit(buf.spare().size() + 1), std::length_error);
+  TCC_CHECK_EQ(buf.size(), 4u);
+}
+
+}  // namespace
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/simd.hpp"
+#include "tcc/simd_group.hpp"
+
+namespace {
+
+std::vector<float> random_floats(std::size_t n, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-1000.0f, 1000.0f);
+  std::vector<float> v(n);
+  for (float& x : v) x = dist(rng);
+  return v;
+}
+
+bool same_bits(float a, float b) { return std::memcmp(&a, &b, sizeof a) == 0; }
+
+TCC_TEST(simd, DetectedIsaIsSupported) {
+  const std::vector<tcc::simd::Isa> isas = tcc::simd::supported_isas();
+  TCC_REQUIRE(!isas.empty());
+  TCC_CHECK(isas.front() == tcc::simd::Isa::scalar);
+  TCC_CHECK(isas.back() == tcc::simd::detected_isa());
+  TCC_CHECK(!tcc::simd::isa_name(tcc::simd::detected_isa()).empty());
+  TCC_CHECK(tcc::simd::active_kernels().isa == tcc::simd::active_isa());
+}
+
+TCC_TEST(simd, UnsupportedIsaIsRejected) {
+  const auto isas = tcc::simd::supported_isas();
+  for (auto isa : {tcc::simd::Isa::sse42, tcc::simd::Isa::avx2, tcc::simd::Isa::avx512, tcc::simd::Isa::neon}) {
+    if (std::find(isas.begin(), isas.end(), isa) == isas.end()) {
+      TCC_CHECK_THROWS(tcc::simd::set_active_isa(isa), std::invalid_argument);
+      TCC_CHECK_THROWS(tcc::simd::kernels(isa), std::invalid_argument);
+    }
+  }
+}
+
+TCC_TEST(simd, FloatKernelsAreBitIdenticalAcrossIsas) {
+  const tcc::simd::Kernels& scalar = tcc::simd::kernels(tcc::simd::Isa::scalar);
+  for (std::size_t n : {0u, 1u, 7u, 15u, 16u, 17u, 63u, 1000u, 4099u}) {
+    const std::vector<float> a = random_floats(n, 1), b = random_floats(n, 2);
+    for (tcc::simd::Isa isa : tcc::simd::supported_isas()) {
+      const tcc::simd::Kernels& k = tcc::simd::kernels(isa);
+      TCC_CHECK(same_bits(k.sum(a.data(), n), scalar.sum(a.data(), n)));
+      TCC_CHECK(same_bits(k.dot(a.data(), b.data(), n), scalar.dot(a.data(), b.data(), n)));
+      if (n > 0) {
+        TCC_CHECK(same_bits(k.min(a.data(), n), scalar.min(a.data(), n)));
+        TCC_CHECK(same_bits(k.max(a.data(), n), scalar.max(a.data(), n)));
+      }
+    }
+  }
+}
+
+TCC_TEST(simd, MinMaxMatchStdAlgorithms) {
+  const std::vector<float> v = random_floats(1001, 3);
+  TCC_CHECK_EQ(tcc::simd::min(v), *std::min_element(v.begin(), v.end()));
+  TCC_CHECK_EQ(tcc::simd::max(v), *std::max_element(v.begin(), v.end()));
+  const std::vector<float> ones(100, 1.0f);
+  TCC_CHECK_EQ(tcc::simd::sum(ones), 100.0f);
+  TCC_CHECK_EQ(tcc::simd::dot(ones, ones), 100.0f);
+}
+
+TCC_TEST(simd, ByteKernelsAgreeWithScalarScan) {
+  std::vector<std::byte> data(5000, std::byte{'a'});
+  for (std::size_t i = 0; i < data.size(); i += 97) data[i] = std::byte{'\n'};
+  for (tcc::simd::Isa isa : tcc::simd::supported_isas()) {
+    const tcc::simd::Kernels& k = tcc::simd::kernels(isa);
+    for (std::size_t start : {0u, 1u, 31u, 100u, 4990u}) {
+      const std::size_t n = data.size() - start;
+      const auto it = std::find(data.begin() + static_cast<std::ptrdiff_t>(start), data.end(), std::byte{'\n'});
+      const std::size_t expected = it == data.end() ? tcc::simd::npos : static_cast<std::size_t>(it - data.begin()) - start;
+      TCC_CHECK_EQ(k.find_byte(data.data() + start, n, std::byte{'\n'}), expected);
+      TCC_CHECK_EQ(k.count_byte(data.data() + start, n, std::byte{'\n'}),
+                   static_cast<std::size_t>(std::count(data.begin() + static_cast<std::ptrdiff_t>(start), data.end(),
+                                                       std::byte{'\n'})));
+    }
+    TCC_CHECK_EQ(k.find_byte(data.data(), data.size(), std::byte{'z'}), tcc::simd::npos);
+  }
+}
+
+TCC_TEST(simd, PrefixSumIsInclusive) {
+  std::vector<std::uint32_t> in(1037);
+  for (std::size_t i = 0; i < in.size(); ++i) in[i] = static_cast<std::uint32_t>(i * 7 + 1);
+  std::vector<std::uint32_t> expected(in.size());
+  std::uint32_t running = 0;
+  for (std::size_t i = 0; i < in.size(); ++i) expected[i] = running += in[i];
+  for (tcc::simd::Isa isa : tcc::simd::supported_isas()) {
+    std::vector<std::uint32_t> out(in.size());
+    tcc::simd::kernels(isa).prefix_sum(in.data(), out.data(), in.size());
+    TCC_CHECK(out == expected);
+  }
+}
+
+TCC_TEST(simd, SetActiveIsaSwitchesDispatch) {
+  const tcc::simd::Isa original = tcc::simd::active_isa();
+  tcc::simd::set_active_isa(tcc::simd::Isa::scalar);
+  TCC_CHECK(tcc::simd::active_isa() == tcc::simd::Isa::scalar);
+  TCC_CHECK(tcc::simd::active_kernels().isa == tcc::simd::Isa::scalar);
+  tcc::simd::set_active_isa(original);
+  TCC_CHECK(tcc::simd::active_isa() == original);
+}
+
+TCC_TEST(simd, Group16MatchesLanes) {
+  std::int8_t ctrl[16];
+  for (int i = 0; i < 16; ++i) ctrl[i] = static_cast<std::int8_t>(i % 4 == 0 ? -128 : i);
+  const tcc::simd::Group16 group(ctrl);
+
+  std::vector<unsigned> lanes;
+  for (unsigned i : group.match(-128)) lanes.push_back(i);
+  TCC_CHECK(lanes == std::vector<unsigned>({0, 4, 8, 12}));
+  TCC_CHECK(!group.match(100));
+  TCC_CHECK_EQ(group.match(7).lowest(), 7u);
+  TCC_CHECK_EQ(group.below(0).highest(), 12u);
+  TCC_CHECK_EQ(group.non_negative().lowest(), 1u);
+  TCC_CHECK_EQ(group.match(100).leading_clear(), 16u);
+  TCC_CHECK_EQ(group.match(15).trailing_clear(), 0u);
+}
+
+}  // namespace
@@ -0,0 +1,131 @@
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "harness.hpp"
+#include "tcc/simd.hpp"
+#include "tcc/soa_vector.hpp"
+
+namespace {
+
+template <template <class> class F = tcc::soa::Value>
+struct Quote {
+  F<double> price;
+  F<std::int64_t> volume;
+  F<std::uint32_t> venue;
+};
+
+template <template <class> class F = tcc::soa::Value>
+struct Named {
+  F<std::string> name;
+  F<float> weight;
+};
+
+using Book = tcc::SoaVector<Quote>;
+
+static_assert(Book::kFields == 3);
+static_assert(std::is_same_v<Book::field_type<0>, double>);
+static_assert(std::is_same_v<Book::field_type<2>, std::uint32_t>);
+
+bool aligned(const void* p) { return reinterpret_cast<std::uintptr_t>(p) % Book::kAlignment == 0; }
+
+TCC_TEST(soa_vector, PushBackAndRefAccess) {
+  Book book;
+  TCC_CHECK(book.empty());
+  book.push_back({101.5, 300, 7});
+  book.emplace_back(99.0, 100, 3);
+  TCC_CHECK_EQ(book.size(), 2u);
+
+  book[0].price *= 2;
+  TCC_CHECK_EQ(book[0].price, 203.0);
+  auto [price, volume, venue] = book[1];
+  volume += 1;
+  TCC_CHECK_EQ(book.get(1).volume, 101);
+  TCC_CHECK_EQ(price, 99.0);
+  TCC_CHECK_EQ(venue, 3u);
+
+  book.set(1, {1.0, 2, 3});
+  TCC_CHECK_EQ(book.back().price, 1.0);
+  TCC_CHECK_THROWS(book.at(2), std::out_of_range);
+}
+
+TCC_TEST(soa_vector, ColumnsAreContiguousAndAligned) {
+  Book book;
+  for (int i = 0; i < 1000; ++i) book.push_back({static_cast<double>(i), i, static_cast<std::uint32_t>(i % 5)});
+  const std::span<double> prices = book.columns().price;
+  TCC_CHECK_EQ(prices.size(), 1000u);
+  TCC_CHECK(aligned(prices.data()));
+  TCC_CHECK(aligned(book.column<1>().data()));
+  TCC_CHECK(aligned(book.column<2>().data()));
+  TCC_CHECK_EQ(prices[999], 999.0);
+  TCC_CHECK_EQ(book.column<1>()[500], 500);
+}
+
+TCC_TEST(soa_vector, FloatColumnFeedsSimdKernels) {
+  tcc::SoaVector<Named> v;
+  for (int i = 0; i < 100; ++i) v.emplace_back(std::to_string(i), 0.5f);
+  TCC_CHECK_EQ(tcc::simd::sum(v.column<1>()), 50.0f);
+}
+
+TCC_TEST(soa_vector, IteratorsAreRandomAccess) {
+  Book book;
+  for (int i = 0; i < 10; ++i) book.push_back({0.0, i, 0});
+  std::int64_t total = 0;
+  for (auto q : book) total += q.volume;
+  TCC_CHECK_EQ(total, 45);
+  auto it = book.begin() + 4;
+  TCC_CHECK_EQ((*it).volume, 4);
+  TCC_CHECK_EQ(it[2].volume, 6);
+  TCC_CHECK_EQ(book.end() - book.begin(), 10);
+  TCC_CHECK(book.begin() < it);
+}
+
+TCC_TEST(soa_vector, SwapRemoveAndPopBack) {
+  Book book;
+  for (int i = 0; i < 5; ++i) book.push_back({0.0, i, 0});
+  book.swap_remove(1);
+  TCC_CHECK_EQ(book.size(), 4u);
+  TCC_CHECK_EQ(book[1].volume, 4);
+  book.swap_remove(3);  // last element: plain pop
+  TCC_CHECK_EQ(book.size(), 3u);
+  book.pop_back();
+  TCC_CHECK_EQ(book.size(), 2u);
+  TCC_CHECK_EQ(book[0].volume, 0);
+  TCC_CHECK_EQ(book[1].volume, 4);
+}
+
+TCC_TEST(soa_vector, NonTrivialFieldsSurviveGrowthCopyAndMove) {
+  tcc::SoaVector<Named> v;
+  for (int i = 0; i < 300; ++i) v.push_back({std::string(30, static_cast<char>('a' + i % 26)), 1.0f});
+  tcc::SoaVector<Named> copy = v;
+  TCC_CHECK_EQ(copy.size(), 300u);
+  TCC_CHECK_EQ(copy[27].name, std::string(30, 'b'));
+  copy[0].name = "changed";
+  TCC_CHECK_EQ(v[0].name, std::string(30, 'a'));
+
+  tcc::SoaVector<Named> moved = std::move(copy);
+  TCC_CHECK(copy.empty());
+  TCC_CHECK_EQ(moved[0].name, std::string("changed"));
+
+  moved.resize(10);
+  moved.shrink_to_fit();
+  TCC_CHECK_EQ(moved.size(), 10u);
+  TCC_CHECK_LE(moved.size(), moved.capacity());
+  moved.clear();
+  TCC_CHECK(moved.empty());
+}
+
+TCC_TEST(soa_vector, ReserveAndResizeValueInitialise) {
+  Book book;
+  book.reserve(100);
+  TCC_CHECK_LE(100u, book.capacity());
+  TCC_CHECK_EQ(book.size(), 0u);
+  book.resize(3);
+  TCC_CHECK_EQ(book[2].price, 0.0);
+  TCC_CHECK_EQ(book[2].volume, 0);
+}
+
+}  // namespace
@@ -0,0 +1,87 @@
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/spsc_ring.hpp"
+
+namespace {
+
+TCC_TEST(spsc_ring, FifoUntilFullThenEmpty) {
+  tcc::SpscRing<int, 4> ring;
+  static_assert(tcc::SpscRing<int, 4>::capacity() == 4);
+  TCC_CHECK(ring.empty_approx());
+  for (int i = 0; i < 4; ++i) TCC_CHECK(ring.try_push(i));
+  TCC_CHECK(!ring.try_push(99));
+  TCC_CHECK_EQ(ring.size_approx(), 4u);
+  for (int i = 0; i < 4; ++i) TCC_CHECK_EQ(ring.try_pop().value_or(-1), i);
+  TCC_CHECK(!ring.try_pop().has_value());
+}
+
+TCC_TEST(spsc_ring, WrapsAroundManyTimes) {
+  tcc::SpscRing<std::string, 8> ring;
+  for (int i = 0; i < 1000; ++i) {
+    TCC_REQUIRE(ring.try_emplace(std::to_string(i)));
+    if (i % 3 == 2) {
+      for (int j = 0; j < 3; ++j) ring.try_pop();
+    }
+  }
+  TCC_CHECK_EQ(ring.size_approx(), 1u);
+  TCC_CHECK_EQ(ring.try_pop().value_or(""), std::string("999"));
+}
+
+TCC_TEST(spsc_ring, MoveOnlyElementsAndDestructorDrains) {
+  auto counter = std::make_shared<int>(0);
+  {
+    tcc::SpscRing<std::shared_ptr<int>, 8> ring;
+    for (int i = 0; i < 5; ++i) ring.try_push(counter);
+    TCC_CHECK_EQ(counter.use_count(), 6);
+  }
+  TCC_CHECK_EQ(counter.use_count(), 1);
+
+  tcc::SpscRing<std::unique_ptr<int>, 2> ring;
+  TCC_CHECK(ring.try_push(std::make_unique<int>(3)));
+  std::unique_ptr<int> p;
+  TCC_REQUIRE(ring.try_pop(p));
+  TCC_CHECK_EQ(*p, 3);
+}
+
+TCC_TEST(spsc_ring, BatchesArePartialWhenNearlyFull) {
+  tcc::SpscRing<int, 8> ring;
+  std::vector<int> in(10);
+  std::iota(in.begin(), in.end(), 0);
+  TCC_CHECK_EQ(ring.try_push_batch(in.begin(), in.size()), 8u);
+  std::vector<int> out;
+  TCC_CHECK_EQ(ring.try_pop_batch(std::back_inserter(out), 100), 8u);
+  TCC_CHECK(out == std::vector<int>(in.begin(), in.begin() + 8));
+}
+
+TCC_TEST(spsc_ring, ProducerConsumerThreadsKeepOrder) {
+  constexpr std::uint32_t kCount = 500'000;
+  tcc::SpscRing<std::uint32_t, 1024> ring;
+  std::thread producer([&] {
+    for (std::uint32_t i = 0; i < kCount; ++i) {
+      while (!ring.try_push(i)) std::this_thread::yield();
+    }
+  });
+  std::uint32_t expected = 0;
+  bool ordered = true;
+  while (expected < kCount) {
+    std::uint32_t v;
+    if (ring.try_pop(v)) {
+      ordered = ordered && v == expected;
+      ++expected;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  TCC_CHECK(ordered);
+  TCC_CHECK(ring.empty_approx());
+}
+
+}  // namespace
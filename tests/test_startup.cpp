@@ -0,0 +1,77 @@
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "harness.hpp"
+#include "tcc/startup.hpp"
+#include "tcc/trace.hpp"
+
+namespace {
+
+/// Turns profiling on for one test, as TCC_STARTUP_PROFILE=1 would have.
+class ProfilingOn {
+ public:
+  ProfilingOn() : was_(tcc::startup::detail::g_enabled) { tcc::startup::detail::g_enabled = true; }
+  ~ProfilingOn() { tcc::startup::detail::g_enabled = was_; }
+
+ private:
+  bool was_;
+};
+
+bool has_phase(const char* name) {
+  for (const auto& p : tcc::startup::phases()) {
+    if (p.name == name) return true;
+  }
+  return false;
+}
+
+TCC_TEST(startup, DisabledPhasesRecordNothing) {
+  if (tcc::startup::enabled()) return;  // the suite itself runs under TCC_STARTUP_PROFILE=1
+  { tcc::startup::Phase phase("test: disabled"); }
+  tcc::startup::main_entered();
+  TCC_CHECK(!has_phase("test: disabled"));
+  TCC_CHECK(!has_phase("static constructors"));
+}
+
+TCC_TEST(startup, RecordsPhasesInStartOrder) {
+  ProfilingOn on;
+  {
+    tcc::startup::Phase outer("test: outer");
+    tcc::startup::Phase inner("test: inner");
+  }
+  const auto phases = tcc::startup::phases();
+  std::size_t outer = phases.size(), inner = phases.size();
+  for (std::size_t i = 0; i < phases.size(); ++i) {
+    if (phases[i].name == "test: outer") outer = i;
+    if (phases[i].name == "test: inner") inner = i;
+  }
+  TCC_REQUIRE(outer < phases.size() && inner < phases.size());
+  TCC_CHECK(outer < inner);  // inner ends first but starts later
+  TCC_CHECK(phases[outer].duration >= phases[inner].duration);
+  TCC_CHECK(phases[inner].start >= phases[outer].start);
+}
+
+#if TCC_TRACING
+TCC_TEST(startup, WritesPhasesThroughTrace) {
+  ProfilingOn on;
+  { tcc::startup::Phase phase("test: traced"); }
+  const auto path = std::filesystem::temp_directory_path() / "tcc_tests_startup.json";
+  tcc::startup::write_trace(path);
+  std::ifstream in(path, std::ios::binary);
+  const std::string json{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+  TCC_CHECK(json.find("\"name\":\"test: traced\",\"ph\":\"X\"") != std::string::npos);
+  TCC_CHECK(!tcc::trace::enabled());
+
+  tcc::trace::start({.path = path});
+  TCC_CHECK_THROWS(tcc::startup::write_trace(path), std::logic_error);
+  tcc::trace::stop();
+  std::filesystem::remove(path, ec);
+}
+#endif
+
+}  // namespace
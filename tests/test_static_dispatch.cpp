@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/static_dispatch.hpp"
+
+namespace {
+
+struct Scale : tcc::BatchPolicy<Scale> {
+  float k = 1.0f;
+  float apply(float x) const noexcept { return x * k; }
+};
+
+struct Clamp : tcc::BatchPolicy<Clamp> {
+  float lo = 0.0f;
+  float hi = 1.0f;
+  float apply(float x) const noexcept { return std::clamp(x, lo, hi); }
+};
+
+struct Count : tcc::BatchPolicy<Count> {
+  int* seen;
+  void apply(float) const noexcept { ++*seen; }
+};
+
+std::span<const std::byte> bytes(std::string_view s) { return std::as_bytes(std::span(s.data(), s.size())); }
+
+TCC_TEST(static_dispatch, MakeTableIsConstexpr) {
+  constexpr auto squares = tcc::make_table<16>([](std::size_t i) { return i * i; });
+  static_assert(squares[15] == 225);
+  TCC_CHECK_EQ(squares.size(), 16u);
+  TCC_CHECK_EQ(squares[3], 9u);
+}
+
+TCC_TEST(static_dispatch, Crc32MatchesReferenceValues) {
+  static_assert(tcc::crc32(std::span<const std::byte>()) == 0);
+  TCC_CHECK_EQ(tcc::crc32(bytes("123456789")), 0xcbf43926u);
+  TCC_CHECK_EQ(tcc::crc32(bytes("The quick brown fox jumps over the lazy dog")), 0x414fa339u);
+  // Incremental over every split point, across the 8-byte fast path.
+  const std::string_view text = "incremental crc over a few blocks of text";
+  for (std::size_t cut = 0; cut <= text.size(); ++cut) {
+    TCC_CHECK_EQ(tcc::crc32(bytes(text.substr(cut)), tcc::crc32(bytes(text.substr(0, cut)))), tcc::crc32(bytes(text)));
+  }
+}
+
+TCC_TEST(static_dispatch, WithConstantPassesACompileTimeValue) {
+  const auto twice = [](auto n) {
+    static_assert(decltype(n)::value % 2 == 0 || decltype(n)::value == 1);
+    return 2 * n();
+  };
+  const auto pick = [&](int n) { return tcc::with_constant<1, 2, 4, 8>(n, twice); };
+  TCC_CHECK_EQ(pick(4), 8);
+  TCC_CHECK_EQ(pick(1), 2);
+  TCC_CHECK_THROWS(pick(3), std::invalid_argument);
+}
+
+TCC_TEST(static_dispatch, VariantFromIndex) {
+  using V = std::variant<int, Scale, Clamp>;
+  TCC_CHECK_EQ(tcc::variant_from_index<V>(0).index(), 0u);
+  TCC_CHECK_EQ(tcc::variant_from_index<V>(2).index(), 2u);
+  TCC_CHECK_THROWS(tcc::variant_from_index<V>(3), std::out_of_range);
+}
+
+TCC_TEST(static_dispatch, TransformsThroughTheChosenPolicy) {
+  using Op = tcc::StaticDispatch<Scale, Clamp>;
+  std::vector<float> in(100), out(100);
+  std::iota(in.begin(), in.end(), -50.0f);
+
+  Op scale = Scale{{}, 0.5f};
+  TCC_CHECK_EQ(scale.index(), 0u);
+  scale.transform(std::span<const float>(in), std::span(out));
+  TCC_CHECK_EQ(out[0], -25.0f);
+  TCC_CHECK_EQ(out[99], 24.5f);
+
+  const Op clamp = Op::from_index(1);
+  clamp.transform(std::span<const float>(in), std::span(out));
+  TCC_CHECK_EQ(*std::min_element(out.begin(), out.end()), 0.0f);
+  TCC_CHECK_EQ(*std::max_element(out.begin(), out.end()), 1.0f);
+
+  clamp.transform_in_place(std::span(in));
+  TCC_CHECK(in == out);
+  TCC_CHECK_EQ(clamp.visit([](const auto& p) { return p.apply(7.0f); }), 1.0f);
+  TCC_CHECK_THROWS(Op::from_index(2), std::out_of_range);
+}
+
+// The header's example: spans straight from non-const vectors.
+TCC_TEST(static_dispatch, TransformAcceptsMutableInputSpans) {
+  using Op = tcc::StaticDispatch<Scale, Clamp>;
+  std::vector<float> in = {-1.0f, 0.5f, 3.0f}, out(3);
+  const Op op = Clamp{};
+  op.transform(std::span(in), std::span(out));
+  TCC_CHECK(out == (std::vector<float>{0.0f, 0.5f, 1.0f}));
+  Scale{{}, 2.0f}.transform(std::span(in), std::span(out));
+  TCC_CHECK_EQ(out[2], 6.0f);
+  TCC_CHECK_EQ(in[2], 3.0f);
+}
+
+TCC_TEST(static_dispatch, ForEachVisitsEveryElement) {
+  int seen = 0;
+  tcc::StaticDispatch<Count> count = Count{{}, &seen};
+  std::vector<float> data(37);
+  count.for_each(std::span(data));
+  TCC_CHECK_EQ(seen, 37);
+}
+
+}  // namespace
@@ -0,0 +1,122 @@
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/thread_pool.hpp"
+
+namespace {
+
+TCC_TEST(thread_pool, SizeAndWorkerIndex) {
+  tcc::ThreadPool pool(3);
+  TCC_CHECK_EQ(pool.size(), 3u);
+  TCC_CHECK_EQ(pool.current_worker(), -1);
+
+  std::atomic<int> index{-2};
+  std::atomic<bool> done{false};
+  pool.post([&] {
+    index = pool.current_worker();
+    done = true;
+    pool.notify_waiters();
+  });
+  pool.wait(done);
+  TCC_CHECK_LE(0, index.load());
+  TCC_CHECK_LT(index.load(), 3);
+}
+
+TCC_TEST(thread_pool, DestructorDrainsPostedWork) {
+  std::atomic<int> ran{0};
+  {
+    tcc::ThreadPool pool(2);
+    for (int i = 0; i < 1000; ++i) pool.post([&] { ran.fetch_add(1, std::memory_order_relaxed); });
+  }
+  TCC_CHECK_EQ(ran.load(), 1000);
+}
+
+TCC_TEST(thread_pool, ParallelForCoversRangeOnce) {
+  tcc::ThreadPool pool(4);
+  std::vector<std::atomic<int>> hits(100'003);
+  tcc::parallel_for(pool, {0, hits.size()}, 1000, [&](tcc::IndexRange r) {
+    TCC_CHECK_LE(r.size(), 1000u);
+    for (std::size_t i = r.begin; i < r.end; ++i) hits[i].fetch_add(1, std::memory_order_relaxed);
+  });
+  std::size_t wrong = 0;
+  for (const auto& h : hits) wrong += h.load() != 1;
+  TCC_CHECK_EQ(wrong, 0u);
+
+  bool called = false;
+  tcc::parallel_for(pool, {5, 5}, 1, [&](tcc::IndexRange) { called = true; });
+  TCC_CHECK(!called);
+}
+
+TCC_TEST(thread_pool, ParallelReduceMatchesSerial) {
+  tcc::ThreadPool pool(4);
+  std::vector<std::uint64_t> values(1 << 16);
+  std::iota(values.begin(), values.end(), 1);
+  const std::uint64_t expected = std::accumulate(values.begin(), values.end(), std::uint64_t{0});
+  const auto total = tcc::parallel_reduce(
+      pool, {0, values.size()}, 512, std::uint64_t{0},
+      [&](tcc::IndexRange r) {
+        return std::accumulate(values.begin() + r.begin, values.begin() + r.end, std::uint64_t{0});
+      },
+      std::plus<>{});
+  TCC_CHECK_EQ(total, expected);
+  TCC_CHECK_EQ(tcc::parallel_reduce(pool, {0, 0}, 1, 7, [](tcc::IndexRange) { return 1; }, std::plus<>{}), 7);
+}
+
+TCC_TEST(thread_pool, ParallelReduceIsDeterministic) {
+  // Floating-point addition is not associative; the fixed split tree makes
+  // the result independent of scheduling and of the worker count.
+  std::vector<double> values(50'000);
+  for (std::size_t i = 0; i < values.size(); ++i) values[i] = 1.0 / static_cast<double>(i + 1);
+  auto run = [&](tcc::ThreadPool& pool) {
+    return tcc::parallel_reduce(
+        pool, {0, values.size()}, 100, 0.0,
+        [&](tcc::IndexRange r) {
+          double s = 0;
+          for (std::size_t i = r.begin; i < r.end; ++i) s += values[i];
+          return s;
+        },
+        std::plus<>{});
+  };
+  tcc::ThreadPool one(1), four(4);
+  const double reference = run(one);
+  for (int i = 0; i < 5; ++i) TCC_CHECK_EQ(run(four), reference);
+}
+
+TCC_TEST(thread_pool, ParallelForRethrows) {
+  tcc::ThreadPool pool(4);
+  TCC_CHECK_THROWS(tcc::parallel_for(pool, {0, 10'000}, 10,
+                                     [](tcc::IndexRange r) {
+                                       if (r.begin <= 5000 && 5000 < r.end) throw std::runtime_error("chunk");
+                                     }),
+                   std::runtime_error);
+  // The pool is still usable afterwards.
+  std::atomic<int> n{0};
+  tcc::parallel_for(pool, {0, 100}, 1, [&](tcc::IndexRange) { ++n; });
+  TCC_CHECK_EQ(n.load(), 100);
+}
+
+TCC_TEST(thread_pool, NestedParallelForDoesNotDeadlock) {
+  tcc::ThreadPool pool(2);
+  std::atomic<std::size_t> total{0};
+  tcc::parallel_for(pool, {0, 16}, 1, [&](tcc::IndexRange) {
+    tcc::parallel_for(pool, {0, 1000}, 10, [&](tcc::IndexRange inner) {
+      total.fetch_add(inner.size(), std::memory_order_relaxed);
+    });
+  });
+  TCC_CHECK_EQ(total.load(), 16u * 1000u);
+}
+
+TCC_TEST(thread_pool, GlobalPoolIsShared) {
+  TCC_CHECK_EQ(&tcc::ThreadPool::global(), &tcc::ThreadPool::global());
+  TCC_CHECK_LE(1u, tcc::ThreadPool::global().size());
+  std::atomic<int> n{0};
+  tcc::parallel_for({0, 64}, 4, [&](tcc::IndexRange r) { n += static_cast<int>(r.size()); });
+  TCC_CHECK_EQ(n.load(), 64);
+}
+
+}  // namespace
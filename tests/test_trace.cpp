@@ -0,0 +1,101 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include "harness.hpp"
+#include "tcc/trace.hpp"
+
+namespace {
+
+std::filesystem::path trace_path() {
+  return std::filesystem::temp_directory_path() / "tcc_tests_trace.json";
+}
+
+std::string read_file(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+std::size_t occurrences(const std::string& text, const std::string& needle) {
+  std::size_t n = 0;
+  for (auto pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) ++n;
+  return n;
+}
+
+TCC_TEST(trace, DisabledScopesRecordNothing) {
+  TCC_CHECK(!tcc::trace::enabled());
+  { TCC_TRACE_SCOPE("never recorded"); }
+  TCC_TRACE_INSTANT("never recorded");
+  tcc::trace::stop();  // no-op when not started
+  TCC_CHECK(!tcc::trace::enabled());
+}
+
+TCC_TEST(trace, WritesChromeTraceJson) {
+  const auto path = trace_path();
+  tcc::trace::start({.path = path});
+  TCC_CHECK(tcc::trace::enabled());
+  TCC_CHECK_THROWS(tcc::trace::start({.path = path}), std::logic_error);
+
+  tcc::trace::set_thread_name("test-main");
+  for (int i = 0; i < 100; ++i) {
+    TCC_TRACE_SCOPE("outer");
+    TCC_TRACE_COUNTER("depth", i);
+  }
+  std::thread worker([] {
+    tcc::trace::set_thread_name("test-worker");
+    TCC_TRACE_SCOPE("worker");
+    TCC_TRACE_INSTANT("tick");
+  });
+  worker.join();
+  tcc::trace::flush();
+  tcc::trace::stop();
+  TCC_CHECK(!tcc::trace::enabled());
+
+  const std::string json = read_file(path);
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+  TCC_CHECK_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+  TCC_CHECK_EQ(occurrences(json, "\"name\":\"outer\",\"ph\":\"X\""), 100u);
+  TCC_CHECK_EQ(occurrences(json, "\"name\":\"depth\",\"ph\":\"C\""), 100u);
+  TCC_CHECK_EQ(occurrences(json, "\"name\":\"worker\""), 1u);
+  TCC_CHECK_EQ(occurrences(json, "\"name\":\"tick\",\"ph\":\"i\""), 1u);
+  TCC_CHECK_EQ(occurrences(json, "test-worker"), 1u);
+  TCC_CHECK_EQ(tcc::trace::dropped_events(), 0u);
+}
+
+// Events measured before start() land at their own time once the origin
+// is set early enough.
+TCC_TEST(trace, CompleteAcceptsEarlierEvents) {
+  using Clock = std::chrono::steady_clock;
+  const auto path = trace_path();
+  const Clock::time_point t0 = Clock::now();
+  const Clock::time_point t1 = t0 + std::chrono::milliseconds(2);
+  tcc::trace::complete("ignored", t0, t1);  // not started
+  tcc::trace::start({.path = path, .origin = t0 - std::chrono::milliseconds(1)});
+  tcc::trace::complete("early", t0, t1);
+  tcc::trace::stop();
+
+  const std::string json = read_file(path);
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+  TCC_CHECK_EQ(occurrences(json, "ignored"), 0u);
+  const auto at = json.find("\"name\":\"early\",\"ph\":\"X\"");
+  TCC_REQUIRE(at != std::string::npos);
+  // ts ~1000 us after the origin, dur ~2000 us; calibration allows some slack.
+  const double ts = std::stod(json.substr(json.find("\"ts\":", at) + 5));
+  const double dur = std::stod(json.substr(json.find("\"dur\":", at) + 6));
+  TCC_CHECK(ts > 900 && ts < 1100);
+  TCC_CHECK(dur > 1900 && dur < 2100);
+}
+
+TCC_TEST(trace, UnwritablePathThrows) {
+  TCC_CHECK_THROWS(tcc::trace::start({.path = "/nonexistent/tcc_tests/trace.json"}), std::system_error);
+  TCC_CHECK(!tcc::trace::enabled());
+}
+
+}  // namespace
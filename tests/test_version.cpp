@@ -0,0 +1,18 @@
+#include <string_view>
+
+#include "harness.hpp"
+#include "tcc/version.hpp"
+
+namespace {
+
+TCC_TEST(version, MatchesProjectVersion) {
+  TCC_CHECK_EQ(tcc::version(), std::string_view(TCC_TESTS_EXPECTED_VERSION));
+}
+
+TCC_TEST(version, BuildInfoNamesCompiler) {
+  const std::string_view info = tcc::build_info();
+  TCC_CHECK(!info.empty());
+  TCC_CHECK(info.find("assert") != std::string_view::npos);
+}
+
+}  // namespace
@@ -0,0 +1,177 @@
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/wire.hpp"
+
+namespace {
+
+namespace w = tcc::wire;
+
+using Fill = w::Schema<w::Field<"qty", std::int32_t>, w::Field<"price", double>>;
+using Order = w::Schema<w::Field<"id", std::uint64_t>,
+                        w::Field<"symbol", w::String>,
+                        w::Field<"levels", w::Vector<float>>,
+                        w::Field<"fills", w::Vector<w::Table<Fill>>>,
+                        w::Field<"best", w::Table<Fill>>>;
+
+// Order as an older writer knew it: the trailing fields did not exist yet.
+using OrderV1 = w::Schema<w::Field<"id", std::uint64_t>, w::Field<"symbol", w::String>>;
+
+struct Node : w::Schema<w::Field<"value", std::int32_t>, w::Field<"next", w::Table<Node>>> {};
+
+// Both fields may point at the same child: n levels make 2^n paths.
+struct Pair
+    : w::Schema<w::Field<"depth", std::int32_t>, w::Field<"a", w::Table<Pair>>, w::Field<"b", w::Table<Pair>>> {};
+
+static_assert(!w::detail::Scalar<bool>, "bool fields would load arbitrary bytes as bool");
+
+std::vector<std::byte> build_order() {
+  w::Builder b;
+  const auto sym = b.add_string("AAPL");
+  const auto levels = b.add_vector<float>({1.5f, 2.5f, 3.5f});
+  const auto f0 = b.add_table<Fill>(100, 187.25);
+  const auto f1 = b.add_table<Fill>(-5, 187.5);
+  const auto fills = b.add_vector<Fill>({f0, f1});
+  b.finish(b.add_table<Order>(std::uint64_t{42}, sym, levels, fills, f1));
+  return b.release();
+}
+
+TCC_TEST(wire, RoundTripsEveryFieldKind) {
+  const std::vector<std::byte> buffer = build_order();
+  const w::View<Order> order = w::root<Order>(buffer);
+  TCC_REQUIRE(static_cast<bool>(order));
+  TCC_CHECK_EQ(order.get<"id">(), 42u);
+  TCC_CHECK_EQ(order.get<"symbol">(), std::string_view("AAPL"));
+
+  const auto levels = order.get<"levels">();
+  TCC_REQUIRE_EQ(levels.size(), 3u);
+  TCC_CHECK_EQ(levels[1], 2.5f);
+  TCC_CHECK_EQ(levels.span()[2], 3.5f);
+
+  const auto fills = order.get<"fills">();
+  TCC_REQUIRE_EQ(fills.size(), 2u);
+  TCC_CHECK_EQ(fills[0].get<"qty">(), 100);
+  TCC_CHECK_EQ(fills[1].get<"price">(), 187.5);
+  TCC_CHECK_EQ(order.get<"best">().get<"qty">(), -5);
+}
+
+TCC_TEST(wire, UncheckedRootReadsTheSameData) {
+  const std::vector<std::byte> buffer = build_order();
+  const auto order = w::root_unchecked<Order>(buffer);
+  TCC_CHECK_EQ(order.get<0>(), 42u);
+  TCC_CHECK_EQ(order.get<1>(), std::string_view("AAPL"));
+}
+
+TCC_TEST(wire, DefaultRefsReadAsEmptyOrAbsent) {
+  w::Builder b;
+  b.finish(b.add_table<Order>(7, w::StringRef{}, w::VectorRef<float>{}, w::VectorRef<w::Table<Fill>>{},
+                              w::TableRef<Fill>{}));
+  const auto order = w::root<Order>(b.data());
+  TCC_CHECK(order.get<"symbol">().empty());
+  TCC_CHECK(order.get<"levels">().empty());
+  TCC_CHECK(order.get<"fills">().empty());
+  TCC_CHECK(!order.get<"best">());
+  TCC_CHECK_EQ(order.get<"best">().get<"qty">(), 0);
+}
+
+TCC_TEST(wire, NewReaderOfOldDataSeesDefaults) {
+  w::Builder b;
+  b.finish(b.add_table<OrderV1>(9, b.add_string("MSFT")));
+  const auto order = w::root<Order>(b.data());
+  TCC_CHECK(order.has<1>());
+  TCC_CHECK(!order.has<2>());
+  TCC_CHECK_EQ(order.get<"symbol">(), std::string_view("MSFT"));
+  TCC_CHECK(order.get<"levels">().empty());
+  TCC_CHECK(!order.get<"best">());
+}
+
+TCC_TEST(wire, RecursiveSchemas) {
+  w::Builder b;
+  w::TableRef<Node> next{};
+  for (int i = 0; i < 10; ++i) next = b.add_table<Node>(i, next);
+  b.finish(next);
+  int sum = 0, depth = 0;
+  for (auto n = w::root<Node>(b.data()); n; n = n.get<"next">()) {
+    sum += n.get<"value">();
+    ++depth;
+  }
+  TCC_CHECK_EQ(depth, 10);
+  TCC_CHECK_EQ(sum, 45);
+}
+
+TCC_TEST(wire, TooDeepNestingIsRejected) {
+  w::Builder b;
+  w::TableRef<Node> next{};
+  for (int i = 0; i < 100; ++i) next = b.add_table<Node>(i, next);
+  b.finish(next);
+  TCC_CHECK_THROWS(w::root<Node>(b.data()), w::Error);
+}
+
+// Builder accepts a TableRef any number of times; root() must accept the
+// result, however often a child is shared.
+TCC_TEST(wire, SharedChildrenVerify) {
+  w::Builder b;
+  const auto f0 = b.add_table<Fill>(7, 1.5);
+  const std::vector<w::TableRef<Fill>> refs(1000, f0);
+  const auto fills = b.add_vector<Fill>(refs);
+  b.finish(b.add_table<Order>(std::uint64_t{1}, w::StringRef{}, w::VectorRef<float>{}, fills, f0));
+  const auto order = w::root<Order>(b.data());
+  TCC_REQUIRE_EQ(order.get<"fills">().size(), 1000u);
+  TCC_CHECK_EQ(order.get<"fills">()[999].get<"qty">(), 7);
+
+  w::Builder diamond;
+  w::TableRef<Pair> prev{};
+  for (int i = 0; i < 50; ++i) prev = diamond.add_table<Pair>(i, prev, prev);
+  diamond.finish(prev);
+  TCC_CHECK_EQ(w::root<Pair>(diamond.data()).get<"a">().get<"b">().get<"depth">(), 47);
+}
+
+TCC_TEST(wire, TruncatedBuffersAreRejected) {
+  const std::vector<std::byte> buffer = build_order();
+  for (std::size_t n = 0; n < buffer.size(); ++n) {
+    TCC_CHECK_THROWS(w::root<Order>(std::span<const std::byte>(buffer.data(), n)), w::Error);
+  }
+}
+
+TCC_TEST(wire, CorruptedMagicIsRejected) {
+  std::vector<std::byte> buffer = build_order();
+  buffer[0] = std::byte{'X'};
+  TCC_CHECK_THROWS(w::root<Order>(buffer), w::Error);
+}
+
+TCC_TEST(wire, BitFlipsNeverEscapeTheBuffer) {
+  // Either verification fails, or every read stays inside the buffer (which
+  // the sanitizer presets would flag otherwise).
+  const std::vector<std::byte> original = build_order();
+  for (std::size_t i = 0; i < original.size(); ++i) {
+    for (int bit : {0, 3, 7}) {
+      std::vector<std::byte> buffer = original;
+      buffer[i] ^= static_cast<std::byte>(1u << bit);
+      try {
+        const auto order = w::root<Order>(buffer);
+        std::size_t touched = order.get<"symbol">().size() + order.get<"levels">().size();
+        for (std::size_t f = 0; f < order.get<"fills">().size(); ++f) {
+          touched += static_cast<std::size_t>(order.get<"fills">()[f].get<"qty">() != 0);
+        }
+        static_cast<void>(touched);
+      } catch (const w::Error&) {
+      }
+    }
+  }
+}
+
+TCC_TEST(wire, BuilderClearStartsOver) {
+  w::Builder b;
+  b.finish(b.add_table<OrderV1>(1, b.add_string("first")));
+  const std::size_t first_size = b.data().size();
+  b.clear();
+  b.finish(b.add_table<OrderV1>(2, b.add_string("second")));
+  TCC_CHECK_EQ(w::root<OrderV1>(b.data()).get<"symbol">(), std::string_view("second"));
+  TCC_CHECK_LE(first_size, b.data().size());
+}
+
+}  // namespace
@@ -0,0 +1,61 @@
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "harness.hpp"
+#include "tcc/work_stealing_deque.hpp"
+
+namespace {
+
+TCC_TEST(work_stealing_deque, OwnerIsLifoThiefIsFifo) {
+  tcc::ChaseLevDeque<int> deque(4);
+  TCC_CHECK(deque.empty_approx());
+  for (int i = 0; i < 4; ++i) deque.push(i);
+  TCC_CHECK_EQ(deque.pop().value_or(-1), 3);
+  TCC_CHECK_EQ(deque.steal().value_or(-1), 0);
+  TCC_CHECK_EQ(deque.pop().value_or(-1), 2);
+  TCC_CHECK_EQ(deque.steal().value_or(-1), 1);
+  TCC_CHECK(!deque.pop().has_value());
+  TCC_CHECK(!deque.steal().has_value());
+  TCC_CHECK(deque.empty_approx());
+}
+
+TCC_TEST(work_stealing_deque, GrowsPastInitialCapacity) {
+  tcc::ChaseLevDeque<int> deque(2);
+  for (int i = 0; i < 1000; ++i) deque.push(i);
+  for (int i = 0; i < 500; ++i) TCC_CHECK_EQ(deque.steal().value_or(-1), i);
+  for (int i = 999; i >= 500; --i) TCC_CHECK_EQ(deque.pop().value_or(-1), i);
+}
+
+TCC_TEST(work_stealing_deque, EveryValueTakenExactlyOnceUnderContention) {
+  constexpr int kValues = 200'000;
+  constexpr int kThieves = 3;
+  tcc::ChaseLevDeque<std::uint32_t> deque;
+  std::vector<std::atomic<std::uint8_t>> taken(kValues);
+  std::atomic<bool> stop{false};
+
+  std::vector<std::thread> thieves;
+  for (int t = 0; t < kThieves; ++t) {
+    thieves.emplace_back([&] {
+      while (!stop.load(std::memory_order_acquire)) {
+        if (auto v = deque.steal()) taken[*v].fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+  for (int i = 0; i < kValues; ++i) {
+    deque.push(static_cast<std::uint32_t>(i));
+    if (i % 3 == 0) {
+      if (auto v = deque.pop()) taken[*v].fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  while (auto v = deque.pop()) taken[*v].fetch_add(1, std::memory_order_relaxed);
+  stop.store(true, std::memory_order_release);
+  for (auto& t : thieves) t.join();
+
+  int wrong = 0;
+  for (const auto& count : taken) wrong += count.load() != 1;
+  TCC_CHECK_EQ(wrong, 0);
+}
+
+}  // namespace